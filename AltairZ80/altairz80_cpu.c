@@ -1762,6 +1762,25 @@ void PutByteDMA(const uint32 Addr, const uint32 Value) {
 #define PUT_BYTE_MM(a,v) PutBYTE(a--, v)
 #define MM_PUT_BYTE(a,v) PutBYTE(--a, v)
 
+/*  Threaded dispatch (SIM_COMPUTED_GOTO). Each case of the main opcode switch
+    is also a label in op_tab, and NEXT_OP at the end of a case fetches and
+    dispatches the following opcode directly, each from its own indirect jump,
+    unless an event, special processing or a CPU switch is due. Otherwise, and
+    in the portable build, NEXT_OP leaves the switch for the top of the loop. */
+#if defined(SIM_COMPUTED_GOTO)
+#define OP(op)      case op: op_##op
+#define NEXT_OP {                                                               \
+    if ((sim_interval <= 0) || specialProcessing || (switch_cpu_now != TRUE))   \
+        break;                                                                  \
+    PCX = PC;                                                                   \
+    sim_interval--;                                                             \
+    goto *op_tab[RAM_PP(PC)];                                                   \
+}
+#else
+#define OP(op)      case op
+#define NEXT_OP     break
+#endif
+
 #define MASK_BRK (TRUE + 1)
 
 /* this is a modified version of sim_brk_test with two differences:
@@ -1907,6 +1926,42 @@ static t_stat sim_instr_mmu (void) {
     uint32 tStatesInSlice; /* number of t-states in 10 mSec time-slice */
     uint32 startTime, now;
     int32 tStateModifier = FALSE;
+#if defined(SIM_COMPUTED_GOTO)
+    static const void *const op_tab[256] = {
+        &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+        &&op_0x08, &&op_0x09, &&op_0x0a, &&op_0x0b, &&op_0x0c, &&op_0x0d, &&op_0x0e, &&op_0x0f,
+        &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+        &&op_0x18, &&op_0x19, &&op_0x1a, &&op_0x1b, &&op_0x1c, &&op_0x1d, &&op_0x1e, &&op_0x1f,
+        &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+        &&op_0x28, &&op_0x29, &&op_0x2a, &&op_0x2b, &&op_0x2c, &&op_0x2d, &&op_0x2e, &&op_0x2f,
+        &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+        &&op_0x38, &&op_0x39, &&op_0x3a, &&op_0x3b, &&op_0x3c, &&op_0x3d, &&op_0x3e, &&op_0x3f,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4a, &&op_0x4b, &&op_0x4c, &&op_0x4d, &&op_0x4e, &&op_0x4f,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5a, &&op_0x5b, &&op_0x5c, &&op_0x5d, &&op_0x5e, &&op_0x5f,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6a, &&op_0x6b, &&op_0x6c, &&op_0x6d, &&op_0x6e, &&op_0x6f,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_HALTINSTRUCTION, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7a, &&op_0x7b, &&op_0x7c, &&op_0x7d, &&op_0x7e, &&op_0x7f,
+        &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+        &&op_0x88, &&op_0x89, &&op_0x8a, &&op_0x8b, &&op_0x8c, &&op_0x8d, &&op_0x8e, &&op_0x8f,
+        &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+        &&op_0x98, &&op_0x99, &&op_0x9a, &&op_0x9b, &&op_0x9c, &&op_0x9d, &&op_0x9e, &&op_0x9f,
+        &&op_0xa0, &&op_0xa1, &&op_0xa2, &&op_0xa3, &&op_0xa4, &&op_0xa5, &&op_0xa6, &&op_0xa7,
+        &&op_0xa8, &&op_0xa9, &&op_0xaa, &&op_0xab, &&op_0xac, &&op_0xad, &&op_0xae, &&op_0xaf,
+        &&op_0xb0, &&op_0xb1, &&op_0xb2, &&op_0xb3, &&op_0xb4, &&op_0xb5, &&op_0xb6, &&op_0xb7,
+        &&op_0xb8, &&op_0xb9, &&op_0xba, &&op_0xbb, &&op_0xbc, &&op_0xbd, &&op_0xbe, &&op_0xbf,
+        &&op_0xc0, &&op_0xc1, &&op_0xc2, &&op_0xc3, &&op_0xc4, &&op_0xc5, &&op_0xc6, &&op_0xc7,
+        &&op_0xc8, &&op_0xc9, &&op_0xca, &&op_0xcb, &&op_0xcc, &&op_0xcd, &&op_0xce, &&op_0xcf,
+        &&op_0xd0, &&op_0xd1, &&op_0xd2, &&op_0xd3, &&op_0xd4, &&op_0xd5, &&op_0xd6, &&op_0xd7,
+        &&op_0xd8, &&op_0xd9, &&op_0xda, &&op_0xdb, &&op_0xdc, &&op_0xdd, &&op_0xde, &&op_0xdf,
+        &&op_0xe0, &&op_0xe1, &&op_0xe2, &&op_0xe3, &&op_0xe4, &&op_0xe5, &&op_0xe6, &&op_0xe7,
+        &&op_0xe8, &&op_0xe9, &&op_0xea, &&op_0xeb, &&op_0xec, &&op_0xed, &&op_0xee, &&op_0xef,
+        &&op_0xf0, &&op_0xf1, &&op_0xf2, &&op_0xf3, &&op_0xf4, &&op_0xf5, &&op_0xf6, &&op_0xf7,
+        &&op_0xf8, &&op_0xf9, &&op_0xfa, &&op_0xfb, &&op_0xfc, &&op_0xfd, &&op_0xfe, &&op_0xff
+    };
+#endif
 
     switch_cpu_now = TRUE; /* hharte */
 
@@ -2017,69 +2072,69 @@ static t_stat sim_instr_mmu (void) {
         */
         switch(RAM_PP(PC)) {
 
-            case 0x00:      /* NOP */
+            OP(0x00):       /* NOP */
                 tStates += 4;   /* NOP 4 */
                 sim_brk_pend[0] = FALSE;
-                break;
+                NEXT_OP;
 
-            case 0x01:      /* LD BC,nnnn */
+            OP(0x01):       /* LD BC,nnnn */
                 tStates += 10; /* LXI B,nnnn 10 */
                 sim_brk_pend[0] = FALSE;
                 BC = GET_WORD(PC);
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x02:      /* LD (BC),A */
+            OP(0x02):       /* LD (BC),A */
                 tStates += 7; /* STAX B 7 */
                 CHECK_BREAK_BYTE(BC)
                 PutBYTE(BC, HIGH_REGISTER(AF));
-                break;
+                NEXT_OP;
 
-            case 0x03:      /* INC BC */
+            OP(0x03):       /* INC BC */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* INX B 5 */
                 sim_brk_pend[0] = FALSE;
                 ++BC;
-                break;
+                NEXT_OP;
 
-            case 0x04:      /* INC B */
+            OP(0x04):       /* INC B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR B 5 */
                 sim_brk_pend[0] = FALSE;
                 BC += 0x100;
                 temp = HIGH_REGISTER(BC);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x05:      /* DEC B */
+            OP(0x05):       /* DEC B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR B 5 */
                 sim_brk_pend[0] = FALSE;
                 BC -= 0x100;
                 temp = HIGH_REGISTER(BC);
                 AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x06:      /* LD B,nn */
+            OP(0x06):       /* LD B,nn */
                 tStates += 7; /* MVI B,nn 7 */
                 sim_brk_pend[0] = FALSE;
                 SET_HIGH_REGISTER(BC, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x07:      /* RLCA */
+            OP(0x07):       /* RLCA */
                 tStates += 4; /* RLC 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = ((AF >> 7) & 0x0128) | ((AF << 1) & ~0x1ff) |
                     (AF & 0xc4) | ((AF >> 15) & 1);
-                break;
+                NEXT_OP;
 
-            case 0x08:      /* EX AF,AF' */
+            OP(0x08):       /* EX AF,AF' */
                 tStates += 4; /* NOP 4 */
                 sim_brk_pend[0] = FALSE;
                 CHECK_CPU_8080;
                 temp = AF;
                 AF = AF1_S;
                 AF1_S = temp;
-                break;
+                NEXT_OP;
 
-            case 0x09:      /* ADD HL,BC */
+            OP(0x09):       /* ADD HL,BC */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 : 11); /* DAD B 10 */
                 sim_brk_pend[0] = FALSE;
                 HL &= ADDRMASK;
@@ -2087,49 +2142,49 @@ static t_stat sim_instr_mmu (void) {
                 sum = HL + BC;
                 AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) | cbitsTable[(HL ^ BC ^ sum) >> 8];
                 HL = sum;
-                break;
+                NEXT_OP;
 
-            case 0x0a:      /* LD A,(BC) */
+            OP(0x0a):       /* LD A,(BC) */
                 tStates += 7; /* LDAX B 7 */
                 CHECK_BREAK_BYTE(BC)
                 SET_HIGH_REGISTER(AF, GetBYTE(BC));
-                break;
+                NEXT_OP;
 
-            case 0x0b:      /* DEC BC */
+            OP(0x0b):       /* DEC BC */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* DCX B 5 */
                 sim_brk_pend[0] = FALSE;
                 --BC;
-                break;
+                NEXT_OP;
 
-            case 0x0c:      /* INC C */
+            OP(0x0c):       /* INC C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR C 5 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(BC) + 1;
                 SET_LOW_REGISTER(BC, temp);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
-                break;
+                NEXT_OP;
 
-            case 0x0d:      /* DEC C */
+            OP(0x0d):       /* DEC C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR C 5 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(BC) - 1;
                 SET_LOW_REGISTER(BC, temp);
                 AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                break;
+                NEXT_OP;
 
-            case 0x0e:      /* LD C,nn */
+            OP(0x0e):       /* LD C,nn */
                 tStates += 7; /* MVI C,nn 7 */
                 sim_brk_pend[0] = FALSE;
                 SET_LOW_REGISTER(BC, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x0f:      /* RRCA */
+            OP(0x0f):       /* RRCA */
                 tStates += 4; /* RRC 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & 0xc4) | rrcaTable[HIGH_REGISTER(AF)];
-                break;
+                NEXT_OP;
 
-            case 0x10:      /* DJNZ dd */
+            OP(0x10):       /* DJNZ dd */
                 sim_brk_pend[0] = FALSE;
                 if (chiptype == CHIP_TYPE_8080)
                     tStates += 4; /* NOP 4 */
@@ -2143,65 +2198,65 @@ static t_stat sim_instr_mmu (void) {
                     PC++;
                     tStates += 8;
                 }
-                break;
+                NEXT_OP;
 
-            case 0x11:      /* LD DE,nnnn */
+            OP(0x11):       /* LD DE,nnnn */
                 tStates += 10; /* LXI D,nnnn 10 */
                 sim_brk_pend[0] = FALSE;
                 DE = GET_WORD(PC);
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x12:      /* LD (DE),A */
+            OP(0x12):       /* LD (DE),A */
                 tStates += 7; /* STAX D 7 */
                 CHECK_BREAK_BYTE(DE)
                 PutBYTE(DE, HIGH_REGISTER(AF));
-                break;
+                NEXT_OP;
 
-            case 0x13:      /* INC DE */
+            OP(0x13):       /* INC DE */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* INX D 5 */
                 sim_brk_pend[0] = FALSE;
                 ++DE;
-                break;
+                NEXT_OP;
 
-            case 0x14:      /* INC D */
+            OP(0x14):       /* INC D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR D 5 */
                 sim_brk_pend[0] = FALSE;
                 DE += 0x100;
                 temp = HIGH_REGISTER(DE);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x15:      /* DEC D */
+            OP(0x15):       /* DEC D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR D 5 */
                 sim_brk_pend[0] = FALSE;
                 DE -= 0x100;
                 temp = HIGH_REGISTER(DE);
                 AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x16:      /* LD D,nn */
+            OP(0x16):       /* LD D,nn */
                 tStates += 7; /* MVI D,nn 7 */
                 sim_brk_pend[0] = FALSE;
                 SET_HIGH_REGISTER(DE, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x17:      /* RLA */
+            OP(0x17):       /* RLA */
                 tStates += 4; /* RAL 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = ((AF << 8) & 0x0100) | ((AF >> 7) & 0x28) | ((AF << 1) & ~0x01ff) |
                     (AF & 0xc4) | ((AF >> 15) & 1);
-                break;
+                NEXT_OP;
 
-            case 0x18:      /* JR dd */
+            OP(0x18):       /* JR dd */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 4 : 12); /* NOP 4 */
                 sim_brk_pend[0] = FALSE;
                 CHECK_CPU_8080;
                 PCQ_ENTRY(PCX);
                 PC += (int8) GetBYTE(PC) + 1;
-                break;
+                NEXT_OP;
 
-            case 0x19:      /* ADD HL,DE */
+            OP(0x19):       /* ADD HL,DE */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 : 11); /* DAD D 10 */
                 sim_brk_pend[0] = FALSE;
                 HL &= ADDRMASK;
@@ -2209,49 +2264,49 @@ static t_stat sim_instr_mmu (void) {
                 sum = HL + DE;
                 AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) | cbitsTable[(HL ^ DE ^ sum) >> 8];
                 HL = sum;
-                break;
+                NEXT_OP;
 
-            case 0x1a:      /* LD A,(DE) */
+            OP(0x1a):       /* LD A,(DE) */
                 tStates += 7; /* LDAX D 7 */
                 CHECK_BREAK_BYTE(DE)
                 SET_HIGH_REGISTER(AF, GetBYTE(DE));
-                break;
+                NEXT_OP;
 
-            case 0x1b:      /* DEC DE */
+            OP(0x1b):       /* DEC DE */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* DCX D 5 */
                 sim_brk_pend[0] = FALSE;
                 --DE;
-                break;
+                NEXT_OP;
 
-            case 0x1c:      /* INC E */
+            OP(0x1c):       /* INC E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR E 5 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(DE) + 1;
                 SET_LOW_REGISTER(DE, temp);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
-                break;
+                NEXT_OP;
 
-            case 0x1d:      /* DEC E */
+            OP(0x1d):       /* DEC E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR E 5 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(DE) - 1;
                 SET_LOW_REGISTER(DE, temp);
                 AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                break;
+                NEXT_OP;
 
-            case 0x1e:      /* LD E,nn */
+            OP(0x1e):       /* LD E,nn */
                 tStates += 7; /* MVI E 7 */
                 sim_brk_pend[0] = FALSE;
                 SET_LOW_REGISTER(DE, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x1f:      /* RRA */
+            OP(0x1f):       /* RRA */
                 tStates += 4; /* RAR 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = ((AF & 1) << 15) | (AF & 0xc4) | rraTable[HIGH_REGISTER(AF)];
-                break;
+                NEXT_OP;
 
-            case 0x20:      /* JR NZ,dd */
+            OP(0x20):       /* JR NZ,dd */
                 if (chiptype == CHIP_TYPE_8080)
                     tStates += 4; /* NOP 4 */
                 sim_brk_pend[0] = FALSE;
@@ -2265,52 +2320,52 @@ static t_stat sim_instr_mmu (void) {
                     PC += (int8) GetBYTE(PC) + 1;
                     tStates += 12;
                 }
-                break;
+                NEXT_OP;
 
-            case 0x21:      /* LD HL,nnnn */
+            OP(0x21):       /* LD HL,nnnn */
                 tStates += 10; /* LXI H,nnnn 10 */
                 sim_brk_pend[0] = FALSE;
                 HL = GET_WORD(PC);
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x22:      /* LD (nnnn),HL */
+            OP(0x22):       /* LD (nnnn),HL */
                 tStates += 16; /* SHLD 16 */
                 temp = GET_WORD(PC);
                 CHECK_BREAK_WORD(temp);
                 PutWORD(temp, HL);
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x23:      /* INC HL */
+            OP(0x23):       /* INC HL */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* INX H 5 */
                 sim_brk_pend[0] = FALSE;
                 ++HL;
-                break;
+                NEXT_OP;
 
-            case 0x24:      /* INC H */
+            OP(0x24):       /* INC H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR H 5 */
                 sim_brk_pend[0] = FALSE;
                 HL += 0x100;
                 temp = HIGH_REGISTER(HL);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x25:      /* DEC H */
+            OP(0x25):       /* DEC H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR H 5 */
                 sim_brk_pend[0] = FALSE;
                 HL -= 0x100;
                 temp = HIGH_REGISTER(HL);
                 AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x26:      /* LD H,nn */
+            OP(0x26):       /* LD H,nn */
                 tStates += 7; /* MVI H,nn 7 */
                 sim_brk_pend[0] = FALSE;
                 SET_HIGH_REGISTER(HL, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x27:      /* DAA */
+            OP(0x27):       /* DAA */
                 tStates += 4; /* DAA 4 */
                 sim_brk_pend[0] = FALSE;
                 acu = HIGH_REGISTER(AF);
@@ -2337,9 +2392,9 @@ static t_stat sim_instr_mmu (void) {
                         acu += 0x60;   /* adjust high digit */
                 }
                 AF = (AF & 0x12) | rrdrldTable[acu & 0xff] | ((acu >> 8) & 1) | cbits;
-                break;
+                NEXT_OP;
 
-            case 0x28:      /* JR Z,dd */
+            OP(0x28):       /* JR Z,dd */
                 if (chiptype == CHIP_TYPE_8080)
                     tStates += 4; /* NOP 4 */
                 sim_brk_pend[0] = FALSE;
@@ -2353,60 +2408,60 @@ static t_stat sim_instr_mmu (void) {
                     PC++;
                     tStates += 7;
                 }
-                break;
+                NEXT_OP;
 
-            case 0x29:      /* ADD HL,HL */
+            OP(0x29):       /* ADD HL,HL */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 : 11); /* DAD H 10 */
                 sim_brk_pend[0] = FALSE;
                 HL &= ADDRMASK;
                 sum = HL + HL;
                 AF = (AF & ~0x3b) | cbitsDup16Table[sum >> 8];
                 HL = sum;
-                break;
+                NEXT_OP;
 
-            case 0x2a:      /* LD HL,(nnnn) */
+            OP(0x2a):       /* LD HL,(nnnn) */
                 tStates += 16; /* LHLD nnnn 16 */
                 temp = GET_WORD(PC);
                 CHECK_BREAK_WORD(temp);
                 HL = GET_WORD(temp);
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x2b:      /* DEC HL */
+            OP(0x2b):       /* DEC HL */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* DCX H 5 */
                 sim_brk_pend[0] = FALSE;
                 --HL;
-                break;
+                NEXT_OP;
 
-            case 0x2c:      /* INC L */
+            OP(0x2c):       /* INC L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR L 5 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(HL) + 1;
                 SET_LOW_REGISTER(HL, temp);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
-                break;
+                NEXT_OP;
 
-            case 0x2d:      /* DEC L */
+            OP(0x2d):       /* DEC L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR L 5 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(HL) - 1;
                 SET_LOW_REGISTER(HL, temp);
                 AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                break;
+                NEXT_OP;
 
-            case 0x2e:      /* LD L,nn */
+            OP(0x2e):       /* LD L,nn */
                 tStates += 7; /* MVI L,nn 7 */
                 sim_brk_pend[0] = FALSE;
                 SET_LOW_REGISTER(HL, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x2f:      /* CPL */
+            OP(0x2f):       /* CPL */
                 tStates += 4; /* CMA 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = (~AF & ~0xff) | (AF & 0xc5) | ((~AF >> 8) & 0x28) | 0x12;
-                break;
+                NEXT_OP;
 
-            case 0x30:      /* JR NC,dd */
+            OP(0x30):       /* JR NC,dd */
                 if (chiptype == CHIP_TYPE_8080)
                     tStates += 4; /* NOP 4 */
                 sim_brk_pend[0] = FALSE;
@@ -2420,58 +2475,58 @@ static t_stat sim_instr_mmu (void) {
                     PC += (int8) GetBYTE(PC) + 1;
                     tStates += 12;
                 }
-                break;
+                NEXT_OP;
 
-            case 0x31:      /* LD SP,nnnn */
+            OP(0x31):       /* LD SP,nnnn */
                 tStates += 10; /* LXI SP,nnnn 10 */
                 sim_brk_pend[0] = FALSE;
                 SP = GET_WORD(PC);
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x32:      /* LD (nnnn),A */
+            OP(0x32):       /* LD (nnnn),A */
                 tStates += 13; /* STA nnnn 13 */
                 temp = GET_WORD(PC);
                 CHECK_BREAK_BYTE(temp);
                 PutBYTE(temp, HIGH_REGISTER(AF));
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x33:      /* INC SP */
+            OP(0x33):       /* INC SP */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* INX SP 5 */
                 sim_brk_pend[0] = FALSE;
                 ++SP;
-                break;
+                NEXT_OP;
 
-            case 0x34:      /* INC (HL) */
+            OP(0x34):       /* INC (HL) */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 : 11); /* INR M 10 */
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL) + 1;
                 PutBYTE(HL, temp);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80);
-                break;
+                NEXT_OP;
 
-            case 0x35:      /* DEC (HL) */
+            OP(0x35):       /* DEC (HL) */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 : 11); /* DCR M 10 */
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL) - 1;
                 PutBYTE(HL, temp);
                 AF = (AF & ~0xfe) | decTable[temp & 0xff] | SET_PV2(0x7f);
-                break;
+                NEXT_OP;
 
-            case 0x36:      /* LD (HL),nn */
+            OP(0x36):       /* LD (HL),nn */
                 tStates += 10; /* MVI M 10 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x37:      /* SCF */
+            OP(0x37):       /* SCF */
                 tStates += 4; /* STC 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & ~0x3b) | ((AF >> 8) & 0x28) | 1;
-                break;
+                NEXT_OP;
 
-            case 0x38:      /* JR C,dd */
+            OP(0x38):       /* JR C,dd */
                 if (chiptype == CHIP_TYPE_8080)
                     tStates += 4; /* NOP 4 */
                 sim_brk_pend[0] = FALSE;
@@ -2485,9 +2540,9 @@ static t_stat sim_instr_mmu (void) {
                     PC++;
                     tStates += 7;
                 }
-                break;
+                NEXT_OP;
 
-            case 0x39:      /* ADD HL,SP */
+            OP(0x39):       /* ADD HL,SP */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 : 11); /* DAD SP 10 */
                 sim_brk_pend[0] = FALSE;
                 HL &= ADDRMASK;
@@ -2495,369 +2550,369 @@ static t_stat sim_instr_mmu (void) {
                 sum = HL + SP;
                 AF = (AF & ~0x3b) | ((sum >> 8) & 0x28) | cbitsTable[(HL ^ SP ^ sum) >> 8];
                 HL = sum;
-                break;
+                NEXT_OP;
 
-            case 0x3a:      /* LD A,(nnnn) */
+            OP(0x3a):       /* LD A,(nnnn) */
                 tStates += 13; /* LDA nnnn 13 */
                 temp = GET_WORD(PC);
                 CHECK_BREAK_BYTE(temp);
                 SET_HIGH_REGISTER(AF, GetBYTE(temp));
                 PC += 2;
-                break;
+                NEXT_OP;
 
-            case 0x3b:      /* DEC SP */
+            OP(0x3b):       /* DEC SP */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* DCX SP 5 */
                 sim_brk_pend[0] = FALSE;
                 --SP;
-                break;
+                NEXT_OP;
 
-            case 0x3c:      /* INC A */
+            OP(0x3c):       /* INC A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* INR A 5 */
                 sim_brk_pend[0] = FALSE;
                 AF += 0x100;
                 temp = HIGH_REGISTER(AF);
                 AF = (AF & ~0xfe) | incTable[temp] | SET_PV2(0x80); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x3d:      /* DEC A */
+            OP(0x3d):       /* DEC A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* DCR A 5 */
                 sim_brk_pend[0] = FALSE;
                 AF -= 0x100;
                 temp = HIGH_REGISTER(AF);
                 AF = (AF & ~0xfe) | decTable[temp] | SET_PV2(0x7f); /* SET_PV2 uses temp */
-                break;
+                NEXT_OP;
 
-            case 0x3e:      /* LD A,nn */
+            OP(0x3e):       /* LD A,nn */
                 tStates += 7; /* MVI A,nn 7 */
                 sim_brk_pend[0] = FALSE;
                 SET_HIGH_REGISTER(AF, RAM_PP(PC));
-                break;
+                NEXT_OP;
 
-            case 0x3f:      /* CCF */
+            OP(0x3f):       /* CCF */
                 tStates += 4; /* CMC 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & ~0x3b) | ((AF >> 8) & 0x28) | ((AF & 1) << 4) | (~AF & 1);
-                break;
+                NEXT_OP;
 
-            case 0x40:      /* LD B,B */
+            OP(0x40):       /* LD B,B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV B,B 5 */
                 sim_brk_pend[0] = FALSE; /* nop */
-                break;
+                NEXT_OP;
 
-            case 0x41:      /* LD B,C */
+            OP(0x41):       /* LD B,C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV B,C 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & 0xff) | ((BC & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x42:      /* LD B,D */
+            OP(0x42):       /* LD B,D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV B,D 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & 0xff) | (DE & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x43:      /* LD B,E */
+            OP(0x43):       /* LD B,E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV B,E 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & 0xff) | ((DE & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x44:      /* LD B,H */
+            OP(0x44):       /* LD B,H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV B,H 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & 0xff) | (HL & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x45:      /* LD B,L */
+            OP(0x45):       /* LD B,L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV B,L 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & 0xff) | ((HL & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x46:      /* LD B,(HL) */
+            OP(0x46):       /* LD B,(HL) */
                 tStates += 7; /* MOV B,M 7 */
                 CHECK_BREAK_BYTE(HL);
                 SET_HIGH_REGISTER(BC, GetBYTE(HL));
-                break;
+                NEXT_OP;
 
-            case 0x47:      /* LD B,A */
+            OP(0x47):       /* LD B,A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV B,A 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & 0xff) | (AF & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x48:      /* LD C,B */
+            OP(0x48):       /* LD C,B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV C,B 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & ~0xff) | ((BC >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x49:      /* LD C,C */
+            OP(0x49):       /* LD C,C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV C,C 5 */
                 sim_brk_pend[0] = FALSE; /* nop */
-                break;
+                NEXT_OP;
 
-            case 0x4a:      /* LD C,D */
+            OP(0x4a):       /* LD C,D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV C,D 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & ~0xff) | ((DE >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x4b:      /* LD C,E */
+            OP(0x4b):       /* LD C,E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV C,E 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & ~0xff) | (DE & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x4c:      /* LD C,H */
+            OP(0x4c):       /* LD C,H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV C,H 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & ~0xff) | ((HL >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x4d:      /* LD C,L */
+            OP(0x4d):       /* LD C,L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV C,L 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & ~0xff) | (HL & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x4e:      /* LD C,(HL) */
+            OP(0x4e):       /* LD C,(HL) */
                 tStates += 7; /* MOV C,M 7 */
                 CHECK_BREAK_BYTE(HL);
                 SET_LOW_REGISTER(BC, GetBYTE(HL));
-                break;
+                NEXT_OP;
 
-            case 0x4f:      /* LD C,A */
+            OP(0x4f):       /* LD C,A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV C,A 5 */
                 sim_brk_pend[0] = FALSE;
                 BC = (BC & ~0xff) | ((AF >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x50:      /* LD D,B */
+            OP(0x50):       /* LD D,B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV D,B 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & 0xff) | (BC & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x51:      /* LD D,C */
+            OP(0x51):       /* LD D,C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV D,C 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & 0xff) | ((BC & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x52:      /* LD D,D */
+            OP(0x52):       /* LD D,D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV D,D 5 */
                 sim_brk_pend[0] = FALSE; /* nop */
-                break;
+                NEXT_OP;
 
-            case 0x53:      /* LD D,E */
+            OP(0x53):       /* LD D,E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV D,E 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & 0xff) | ((DE & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x54:      /* LD D,H */
+            OP(0x54):       /* LD D,H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV D,H 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & 0xff) | (HL & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x55:      /* LD D,L */
+            OP(0x55):       /* LD D,L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV D,L 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & 0xff) | ((HL & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x56:      /* LD D,(HL) */
+            OP(0x56):       /* LD D,(HL) */
                 tStates += 7; /* MOV D,M 7 */
                 CHECK_BREAK_BYTE(HL);
                 SET_HIGH_REGISTER(DE, GetBYTE(HL));
-                break;
+                NEXT_OP;
 
-            case 0x57:      /* LD D,A */
+            OP(0x57):       /* LD D,A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV D,A 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & 0xff) | (AF & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x58:      /* LD E,B */
+            OP(0x58):       /* LD E,B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV E,B 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & ~0xff) | ((BC >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x59:      /* LD E,C */
+            OP(0x59):       /* LD E,C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV E,C 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & ~0xff) | (BC & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x5a:      /* LD E,D */
+            OP(0x5a):       /* LD E,D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV E,D 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & ~0xff) | ((DE >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x5b:      /* LD E,E */
+            OP(0x5b):       /* LD E,E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV E,E 5 */
                 sim_brk_pend[0] = FALSE; /* nop */
-                break;
+                NEXT_OP;
 
-            case 0x5c:      /* LD E,H */
+            OP(0x5c):       /* LD E,H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV E,H 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & ~0xff) | ((HL >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x5d:      /* LD E,L */
+            OP(0x5d):       /* LD E,L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV E,L 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & ~0xff) | (HL & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x5e:      /* LD E,(HL) */
+            OP(0x5e):       /* LD E,(HL) */
                 tStates += 7; /* MOV E,M 7 */
                 CHECK_BREAK_BYTE(HL);
                 SET_LOW_REGISTER(DE, GetBYTE(HL));
-                break;
+                NEXT_OP;
 
-            case 0x5f:      /* LD E,A */
+            OP(0x5f):       /* LD E,A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV E,A 5 */
                 sim_brk_pend[0] = FALSE;
                 DE = (DE & ~0xff) | ((AF >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x60:      /* LD H,B */
+            OP(0x60):       /* LD H,B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV H,B 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & 0xff) | (BC & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x61:      /* LD H,C */
+            OP(0x61):       /* LD H,C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV H,C 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & 0xff) | ((BC & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x62:      /* LD H,D */
+            OP(0x62):       /* LD H,D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV H,D 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & 0xff) | (DE & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x63:      /* LD H,E */
+            OP(0x63):       /* LD H,E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV H,E 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & 0xff) | ((DE & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x64:      /* LD H,H */
+            OP(0x64):       /* LD H,H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV H,H 5 */
                 sim_brk_pend[0] = FALSE; /* nop */
-                break;
+                NEXT_OP;
 
-            case 0x65:      /* LD H,L */
+            OP(0x65):       /* LD H,L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV H,L 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & 0xff) | ((HL & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x66:      /* LD H,(HL) */
+            OP(0x66):       /* LD H,(HL) */
                 tStates += 7; /* MOV H,M 7 */
                 CHECK_BREAK_BYTE(HL);
                 SET_HIGH_REGISTER(HL, GetBYTE(HL));
-                break;
+                NEXT_OP;
 
-            case 0x67:      /* LD H,A */
+            OP(0x67):       /* LD H,A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV H,A 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & 0xff) | (AF & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x68:      /* LD L,B */
+            OP(0x68):       /* LD L,B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV L,B 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & ~0xff) | ((BC >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x69:      /* LD L,C */
+            OP(0x69):       /* LD L,C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV L,C 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & ~0xff) | (BC & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x6a:      /* LD L,D */
+            OP(0x6a):       /* LD L,D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV L,D 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & ~0xff) | ((DE >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x6b:      /* LD L,E */
+            OP(0x6b):       /* LD L,E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV L,E 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & ~0xff) | (DE & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x6c:      /* LD L,H */
+            OP(0x6c):       /* LD L,H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV L,H 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & ~0xff) | ((HL >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x6d:      /* LD L,L */
+            OP(0x6d):       /* LD L,L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV L,L 5 */
                 sim_brk_pend[0] = FALSE; /* nop */
-                break;
+                NEXT_OP;
 
-            case 0x6e:      /* LD L,(HL) */
+            OP(0x6e):       /* LD L,(HL) */
                 tStates += 7; /* MOV L,M 7 */
                 CHECK_BREAK_BYTE(HL);
                 SET_LOW_REGISTER(HL, GetBYTE(HL));
-                break;
+                NEXT_OP;
 
-            case 0x6f:      /* LD L,A */
+            OP(0x6f):       /* LD L,A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV L,A 5 */
                 sim_brk_pend[0] = FALSE;
                 HL = (HL & ~0xff) | ((AF >> 8) & 0xff);
-                break;
+                NEXT_OP;
 
-            case 0x70:      /* LD (HL),B */
+            OP(0x70):       /* LD (HL),B */
                 tStates += 7; /* MOV M,B 7 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, HIGH_REGISTER(BC));
-                break;
+                NEXT_OP;
 
-            case 0x71:      /* LD (HL),C */
+            OP(0x71):       /* LD (HL),C */
                 tStates += 7; /* MOV M,C 7 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, LOW_REGISTER(BC));
-                break;
+                NEXT_OP;
 
-            case 0x72:      /* LD (HL),D */
+            OP(0x72):       /* LD (HL),D */
                 tStates += 7; /* MOV M,D 7 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, HIGH_REGISTER(DE));
-                break;
+                NEXT_OP;
 
-            case 0x73:      /* LD (HL),E */
+            OP(0x73):       /* LD (HL),E */
                 tStates += 7; /* MOV M,E 7 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, LOW_REGISTER(DE));
-                break;
+                NEXT_OP;
 
-            case 0x74:      /* LD (HL),H */
+            OP(0x74):       /* LD (HL),H */
                 tStates += 7; /* MOV M,H 7 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, HIGH_REGISTER(HL));
-                break;
+                NEXT_OP;
 
-            case 0x75:      /* LD (HL),L */
+            OP(0x75):       /* LD (HL),L */
                 tStates += 7; /* MOV M,L 7 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, LOW_REGISTER(HL));
-                break;
+                NEXT_OP;
 
-            case HALTINSTRUCTION:   /* HALT */
+            OP(HALTINSTRUCTION):    /* HALT */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 7 : 4); /* HLT 7 */
                 sim_brk_pend[0] = FALSE;
                 PC--;
@@ -2867,62 +2922,62 @@ static t_stat sim_instr_mmu (void) {
                 }
                 sim_interval = 0;
                 do_SIMH_sleep();    /* reduce CPU load in busy wait */
-                break;
+                NEXT_OP;
 
-            case 0x77:      /* LD (HL),A */
+            OP(0x77):       /* LD (HL),A */
                 tStates += 7; /* MOV M,A 7 */
                 CHECK_BREAK_BYTE(HL);
                 PutBYTE(HL, HIGH_REGISTER(AF));
-                break;
+                NEXT_OP;
 
-            case 0x78:      /* LD A,B */
+            OP(0x78):       /* LD A,B */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV A,B 5 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & 0xff) | (BC & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x79:      /* LD A,C */
+            OP(0x79):       /* LD A,C */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV A,C 5 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & 0xff) | ((BC & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x7a:      /* LD A,D */
+            OP(0x7a):       /* LD A,D */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV A,D 5 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & 0xff) | (DE & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x7b:      /* LD A,E */
+            OP(0x7b):       /* LD A,E */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV A,E 5 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & 0xff) | ((DE & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x7c:      /* LD A,H */
+            OP(0x7c):       /* LD A,H */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV A,H 5 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & 0xff) | (HL & ~0xff);
-                break;
+                NEXT_OP;
 
-            case 0x7d:      /* LD A,L */
+            OP(0x7d):       /* LD A,L */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV A,L 5 */
                 sim_brk_pend[0] = FALSE;
                 AF = (AF & 0xff) | ((HL & 0xff) << 8);
-                break;
+                NEXT_OP;
 
-            case 0x7e:      /* LD A,(HL) */
+            OP(0x7e):       /* LD A,(HL) */
                 tStates += 7; /* MOV A,M 7 */
                 CHECK_BREAK_BYTE(HL);
                 SET_HIGH_REGISTER(AF, GetBYTE(HL));
-                break;
+                NEXT_OP;
 
-            case 0x7f:      /* LD A,A */
+            OP(0x7f):       /* LD A,A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* MOV A,A 5 */
                 sim_brk_pend[0] = FALSE; /* nop */
-                break;
+                NEXT_OP;
 
-            case 0x80:      /* ADD A,B */
+            OP(0x80):       /* ADD A,B */
                 tStates += 4; /* ADD B 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(BC);
@@ -2930,9 +2985,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x81:      /* ADD A,C */
+            OP(0x81):       /* ADD A,C */
                 tStates += 4; /* ADD C 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(BC);
@@ -2940,9 +2995,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x82:      /* ADD A,D */
+            OP(0x82):       /* ADD A,D */
                 tStates += 4; /* ADD D 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(DE);
@@ -2950,9 +3005,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x83:      /* ADD A,E */
+            OP(0x83):       /* ADD A,E */
                 tStates += 4; /* ADD E 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(DE);
@@ -2960,9 +3015,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x84:      /* ADD A,H */
+            OP(0x84):       /* ADD A,H */
                 tStates += 4; /* ADD H 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(HL);
@@ -2970,9 +3025,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x85:      /* ADD A,L */
+            OP(0x85):       /* ADD A,L */
                 tStates += 4; /* ADD L 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(HL);
@@ -2980,9 +3035,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x86:      /* ADD A,(HL) */
+            OP(0x86):       /* ADD A,(HL) */
                 tStates += 7; /* ADD M 7 */
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL);
@@ -2990,16 +3045,16 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x87:      /* ADD A,A */
+            OP(0x87):       /* ADD A,A */
                 tStates += 4; /* ADD A 4 */
                 sim_brk_pend[0] = FALSE;
                 cbits = 2 * HIGH_REGISTER(AF);
                 AF = cbitsDup8Table[cbits] | (SET_PVS(cbits));
-                break;
+                NEXT_OP;
 
-            case 0x88:      /* ADC A,B */
+            OP(0x88):       /* ADC A,B */
                 tStates += 4; /* ADC B 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(BC);
@@ -3007,9 +3062,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x89:      /* ADC A,C */
+            OP(0x89):       /* ADC A,C */
                 tStates += 4; /* ADC C 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(BC);
@@ -3017,9 +3072,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x8a:      /* ADC A,D */
+            OP(0x8a):       /* ADC A,D */
                 tStates += 4; /* ADC D 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(DE);
@@ -3027,9 +3082,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x8b:      /* ADC A,E */
+            OP(0x8b):       /* ADC A,E */
                 tStates += 4; /* ADC E 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(DE);
@@ -3037,9 +3092,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x8c:      /* ADC A,H */
+            OP(0x8c):       /* ADC A,H */
                 tStates += 4; /* ADC H 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(HL);
@@ -3047,9 +3102,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x8d:      /* ADC A,L */
+            OP(0x8d):       /* ADC A,L */
                 tStates += 4; /* ADC L 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(HL);
@@ -3057,9 +3112,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x8e:      /* ADC A,(HL) */
+            OP(0x8e):       /* ADC A,(HL) */
                 tStates += 7; /* ADC M 7 */
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL);
@@ -3067,16 +3122,16 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x8f:      /* ADC A,A */
+            OP(0x8f):       /* ADC A,A */
                 tStates += 4; /* ADC A 4 */
                 sim_brk_pend[0] = FALSE;
                 cbits = 2 * HIGH_REGISTER(AF) + TSTFLAG(C);
                 AF = cbitsDup8Table[cbits] | (SET_PVS(cbits));
-                break;
+                NEXT_OP;
 
-            case 0x90:      /* SUB B */
+            OP(0x90):       /* SUB B */
                 tStates += 4; /* SUB B 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(BC);
@@ -3084,9 +3139,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x91:      /* SUB C */
+            OP(0x91):       /* SUB C */
                 tStates += 4; /* SUB C 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(BC);
@@ -3094,9 +3149,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x92:      /* SUB D */
+            OP(0x92):       /* SUB D */
                 tStates += 4; /* SUB D 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(DE);
@@ -3104,9 +3159,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x93:      /* SUB E */
+            OP(0x93):       /* SUB E */
                 tStates += 4; /* SUB E 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(DE);
@@ -3114,9 +3169,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x94:      /* SUB H */
+            OP(0x94):       /* SUB H */
                 tStates += 4; /* SUB H 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(HL);
@@ -3124,9 +3179,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x95:      /* SUB L */
+            OP(0x95):       /* SUB L */
                 tStates += 4; /* SUB L 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(HL);
@@ -3134,9 +3189,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x96:      /* SUB (HL) */
+            OP(0x96):       /* SUB (HL) */
                 tStates += 7; /* SUB M 7 */
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL);
@@ -3144,15 +3199,15 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x97:      /* SUB A */
+            OP(0x97):       /* SUB A */
                 tStates += 4; /* SUB A 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = (chiptype == CHIP_TYPE_Z80) ? 0x42 : 0x46;
-                break;
+                NEXT_OP;
 
-            case 0x98:      /* SBC A,B */
+            OP(0x98):       /* SBC A,B */
                 tStates += 4; /* SBB B 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(BC);
@@ -3160,9 +3215,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x99:      /* SBC A,C */
+            OP(0x99):       /* SBC A,C */
                 tStates += 4; /* SBB C 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(BC);
@@ -3170,9 +3225,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x9a:      /* SBC A,D */
+            OP(0x9a):       /* SBC A,D */
                 tStates += 4; /* SBB D 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(DE);
@@ -3180,9 +3235,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x9b:      /* SBC A,E */
+            OP(0x9b):       /* SBC A,E */
                 tStates += 4; /* SBB E 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(DE);
@@ -3190,9 +3245,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x9c:      /* SBC A,H */
+            OP(0x9c):       /* SBC A,H */
                 tStates += 4; /* SBB H 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(HL);
@@ -3200,9 +3255,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x9d:      /* SBC A,L */
+            OP(0x9d):       /* SBC A,L */
                 tStates += 4; /* SBB L 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(HL);
@@ -3210,9 +3265,9 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x9e:      /* SBC A,(HL) */
+            OP(0x9e):       /* SBC A,(HL) */
                 tStates += 7; /* SBB M 7 */
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL);
@@ -3220,160 +3275,160 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0x9f:      /* SBC A,A */
+            OP(0x9f):       /* SBC A,A */
                 tStates += 4; /* SBB A 4 */
                 sim_brk_pend[0] = FALSE;
                 cbits = -TSTFLAG(C);
                 AF = subTable[cbits & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PVS(cbits));
-                break;
+                NEXT_OP;
 
-            case 0xa0:      /* AND B */
+            OP(0xa0):       /* AND B */
                 tStates += 4; /* ANA B 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[((AF & BC) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa1:      /* AND C */
+            OP(0xa1):       /* AND C */
                 tStates += 4; /* ANA C 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[((AF >> 8) & BC) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa2:      /* AND D */
+            OP(0xa2):       /* AND D */
                 tStates += 4; /* ANA D 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[((AF & DE) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa3:      /* AND E */
+            OP(0xa3):       /* AND E */
                 tStates += 4; /* ANA E 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[((AF >> 8) & DE) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa4:      /* AND H */
+            OP(0xa4):       /* AND H */
                 tStates += 4; /* ANA H 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[((AF & HL) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa5:      /* AND L */
+            OP(0xa5):       /* AND L */
                 tStates += 4; /* ANA L 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[((AF >> 8) & HL) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa6:      /* AND (HL) */
+            OP(0xa6):       /* AND (HL) */
                 tStates += 7; /* ANA M 7 */
                 CHECK_BREAK_BYTE(HL);
                 AF = andTable[((AF >> 8) & GetBYTE(HL)) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa7:      /* AND A */
+            OP(0xa7):       /* AND A */
                 tStates += 4; /* ANA A 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[(AF >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa8:      /* XOR B */
+            OP(0xa8):       /* XOR B */
                 tStates += 4; /* XRA B 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF ^ BC) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xa9:      /* XOR C */
+            OP(0xa9):       /* XOR C */
                 tStates += 4; /* XRA C 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) ^ BC) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xaa:      /* XOR D */
+            OP(0xaa):       /* XOR D */
                 tStates += 4; /* XRA D 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF ^ DE) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xab:      /* XOR E */
+            OP(0xab):       /* XOR E */
                 tStates += 4; /* XRA E 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) ^ DE) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xac:      /* XOR H */
+            OP(0xac):       /* XOR H */
                 tStates += 4; /* XRA H 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF ^ HL) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xad:      /* XOR L */
+            OP(0xad):       /* XOR L */
                 tStates += 4; /* XRA L 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) ^ HL) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xae:      /* XOR (HL) */
+            OP(0xae):       /* XOR (HL) */
                 tStates += 7; /* XRA M 7 */
                 CHECK_BREAK_BYTE(HL);
                 AF = xororTable[((AF >> 8) ^ GetBYTE(HL)) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xaf:      /* XOR A */
+            OP(0xaf):       /* XOR A */
                 tStates += 4; /* XRA A 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = 0x44;
-                break;
+                NEXT_OP;
 
-            case 0xb0:      /* OR B */
+            OP(0xb0):       /* OR B */
                 tStates += 4; /* ORA B 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF | BC) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb1:      /* OR C */
+            OP(0xb1):       /* OR C */
                 tStates += 4; /* ORA C 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) | BC) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb2:      /* OR D */
+            OP(0xb2):       /* OR D */
                 tStates += 4; /* ORA D 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF | DE) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb3:      /* OR E */
+            OP(0xb3):       /* OR E */
                 tStates += 4; /* ORA E 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) | DE) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb4:      /* OR H */
+            OP(0xb4):       /* OR H */
                 tStates += 4; /* ORA H 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF | HL) >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb5:      /* OR L */
+            OP(0xb5):       /* OR L */
                 tStates += 4; /* ORA L 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) | HL) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb6:      /* OR (HL) */
+            OP(0xb6):       /* OR (HL) */
                 tStates += 7; /* ORA M 7 */
                 CHECK_BREAK_BYTE(HL);
                 AF = xororTable[((AF >> 8) | GetBYTE(HL)) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb7:      /* OR A */
+            OP(0xb7):       /* OR A */
                 tStates += 4; /* ORA A 4 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[(AF >> 8) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xb8:      /* CP B */
+            OP(0xb8):       /* CP B */
                 tStates += 4; /* CMP B 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(BC);
@@ -3383,9 +3438,9 @@ static t_stat sim_instr_mmu (void) {
                 cbits = acu ^ temp ^ sum;
                 AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                     (SET_PV) | cbits2Table[cbits & 0x1ff];
-                break;
+                NEXT_OP;
 
-            case 0xb9:      /* CP C */
+            OP(0xb9):       /* CP C */
                 tStates += 4; /* CMP C 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(BC);
@@ -3395,9 +3450,9 @@ static t_stat sim_instr_mmu (void) {
                 cbits = acu ^ temp ^ sum;
                 AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                     (SET_PV) | cbits2Table[cbits & 0x1ff];
-                break;
+                NEXT_OP;
 
-            case 0xba:      /* CP D */
+            OP(0xba):       /* CP D */
                 tStates += 4; /* CMP D 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(DE);
@@ -3407,9 +3462,9 @@ static t_stat sim_instr_mmu (void) {
                 cbits = acu ^ temp ^ sum;
                 AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                     (SET_PV) | cbits2Table[cbits & 0x1ff];
-                break;
+                NEXT_OP;
 
-            case 0xbb:      /* CP E */
+            OP(0xbb):       /* CP E */
                 tStates += 4; /* CMP E 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(DE);
@@ -3419,9 +3474,9 @@ static t_stat sim_instr_mmu (void) {
                 cbits = acu ^ temp ^ sum;
                 AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                     (SET_PV) | cbits2Table[cbits & 0x1ff];
-                break;
+                NEXT_OP;
 
-            case 0xbc:      /* CP H */
+            OP(0xbc):       /* CP H */
                 tStates += 4; /* CMP H 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = HIGH_REGISTER(HL);
@@ -3431,9 +3486,9 @@ static t_stat sim_instr_mmu (void) {
                 cbits = acu ^ temp ^ sum;
                 AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                     (SET_PV) | cbits2Table[cbits & 0x1ff];
-                break;
+                NEXT_OP;
 
-            case 0xbd:      /* CP L */
+            OP(0xbd):       /* CP L */
                 tStates += 4; /* CMP L 4 */
                 sim_brk_pend[0] = FALSE;
                 temp = LOW_REGISTER(HL);
@@ -3443,9 +3498,9 @@ static t_stat sim_instr_mmu (void) {
                 cbits = acu ^ temp ^ sum;
                 AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                     (SET_PV) | cbits2Table[cbits & 0x1ff];
-                break;
+                NEXT_OP;
 
-            case 0xbe:      /* CP (HL) */
+            OP(0xbe):       /* CP (HL) */
                 tStates += 7; /* CMP M 7 */
                 CHECK_BREAK_BYTE(HL);
                 temp = GetBYTE(HL);
@@ -3455,15 +3510,15 @@ static t_stat sim_instr_mmu (void) {
                 cbits = acu ^ temp ^ sum;
                 AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                     (SET_PV) | cbits2Table[cbits & 0x1ff];
-                break;
+                NEXT_OP;
 
-            case 0xbf:      /* CP A */
+            OP(0xbf):       /* CP A */
                 tStates += 4; /* CMP A 4 */
                 sim_brk_pend[0] = FALSE;
                 SET_LOW_REGISTER(AF, (HIGH_REGISTER(AF) & 0x28) | (chiptype == CHIP_TYPE_Z80 ? 0x42 : 0x46));
-                break;
+                NEXT_OP;
 
-            case 0xc0:      /* RET NZ */
+            OP(0xc0):       /* RET NZ */
                 if (TSTFLAG(Z)) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RNZ 5 */
@@ -3474,35 +3529,35 @@ static t_stat sim_instr_mmu (void) {
                     POP(PC);
                     tStates += 11; /* RNZ 11 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xc1:      /* POP BC */
+            OP(0xc1):       /* POP BC */
                 tStates += 10; /* POP B 10 */
                 CHECK_BREAK_WORD(SP);
                 POP(BC);
-                break;
+                NEXT_OP;
 
-            case 0xc2:      /* JP NZ,nnnn */
+            OP(0xc2):       /* JP NZ,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(!TSTFLAG(Z));       /* also updates tStates, Z80 and 8080 are equal */
-                break;
+                NEXT_OP;
 
-            case 0xc3:      /* JP nnnn */
+            OP(0xc3):       /* JP nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(1);                 /* also updates tStates, Z80 and 8080 are equal */
-                break;
+                NEXT_OP;
 
-            case 0xc4:      /* CALL NZ,nnnn */
+            OP(0xc4):       /* CALL NZ,nnnn */
                 CALLC(!TSTFLAG(Z));     /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xc5:      /* PUSH BC */
+            OP(0xc5):       /* PUSH BC */
                 tStates += 11; /* PUSH B 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(BC);
-                break;
+                NEXT_OP;
 
-            case 0xc6:      /* ADD A,nn */
+            OP(0xc6):       /* ADD A,nn */
                 tStates += 7; /* ADI nn 7 */
                 sim_brk_pend[0] = FALSE;
                 temp = RAM_PP(PC);
@@ -3510,17 +3565,17 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp;
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0xc7:      /* RST 0 */
+            OP(0xc7):       /* RST 0 */
                 tStates += 11; /* RST 0 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(PC);
                 PCQ_ENTRY(PCX);
                 PC = 0;
-                break;
+                NEXT_OP;
 
-            case 0xc8:      /* RET Z */
+            OP(0xc8):       /* RET Z */
                 if (TSTFLAG(Z)) {
                     CHECK_BREAK_WORD(SP);
                     PCQ_ENTRY(PCX);
@@ -3531,21 +3586,21 @@ static t_stat sim_instr_mmu (void) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RZ 5 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xc9:      /* RET */
+            OP(0xc9):       /* RET */
                 tStates += 10; /* RET 10 */
                 CHECK_BREAK_WORD(SP);
                 PCQ_ENTRY(PCX);
                 POP(PC);
-                break;
+                NEXT_OP;
 
-            case 0xca:      /* JP Z,nnnn */
+            OP(0xca):       /* JP Z,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(TSTFLAG(Z));        /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xcb:      /* CB prefix */
+            OP(0xcb):       /* CB prefix */
                 if (chiptype == CHIP_TYPE_8080) {
                     if (cpu_unit.flags & UNIT_CPU_OPSTOP) {
                         reason = STOP_OPCODE;
@@ -3721,17 +3776,17 @@ static t_stat sim_instr_mmu (void) {
                         SET_HIGH_REGISTER(AF, temp);
                         break;
                 }
-                break;
+                NEXT_OP;
 
-            case 0xcc:      /* CALL Z,nnnn */
+            OP(0xcc):       /* CALL Z,nnnn */
                 CALLC(TSTFLAG(Z));      /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xcd:      /* CALL nnnn */
+            OP(0xcd):       /* CALL nnnn */
                 CALLC(1);               /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xce:      /* ADC A,nn */
+            OP(0xce):       /* ADC A,nn */
                 tStates += 7; /* ACI nn 7 */
                 sim_brk_pend[0] = FALSE;
                 temp = RAM_PP(PC);
@@ -3739,17 +3794,17 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu + temp + TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = addTable[sum] | cbitsTable[cbits] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0xcf:      /* RST 8 */
+            OP(0xcf):       /* RST 8 */
                 tStates += 11; /* RST 1 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(PC);
                 PCQ_ENTRY(PCX);
                 PC = 8;
-                break;
+                NEXT_OP;
 
-            case 0xd0:      /* RET NC */
+            OP(0xd0):       /* RET NC */
                 if (TSTFLAG(C)) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RNC 5 */
@@ -3760,36 +3815,36 @@ static t_stat sim_instr_mmu (void) {
                     POP(PC);
                     tStates += 11; /* RNC 11 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xd1:      /* POP DE */
+            OP(0xd1):       /* POP DE */
                 tStates += 10; /* POP D 10 */
                 CHECK_BREAK_WORD(SP);
                 POP(DE);
-                break;
+                NEXT_OP;
 
-            case 0xd2:      /* JP NC,nnnn */
+            OP(0xd2):       /* JP NC,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(!TSTFLAG(C));       /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xd3:      /* OUT (nn),A */
+            OP(0xd3):       /* OUT (nn),A */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 :11); /* OUT nn 10 */
                 sim_brk_pend[0] = FALSE;
                 out(RAM_PP(PC), HIGH_REGISTER(AF));
-                break;
+                NEXT_OP;
 
-            case 0xd4:      /* CALL NC,nnnn */
+            OP(0xd4):       /* CALL NC,nnnn */
                 CALLC(!TSTFLAG(C));     /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xd5:      /* PUSH DE */
+            OP(0xd5):       /* PUSH DE */
                 tStates += 11; /* PUSH D 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(DE);
-                break;
+                NEXT_OP;
 
-            case 0xd6:      /* SUB nn */
+            OP(0xd6):       /* SUB nn */
                 tStates += 7; /* SUI nn 7 */
                 sim_brk_pend[0] = FALSE;
                 temp = RAM_PP(PC);
@@ -3797,17 +3852,17 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp;
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0xd7:      /* RST 10H */
+            OP(0xd7):       /* RST 10H */
                 tStates += 11; /* RST 2 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(PC);
                 PCQ_ENTRY(PCX);
                 PC = 0x10;
-                break;
+                NEXT_OP;
 
-            case 0xd8:      /* RET C */
+            OP(0xd8):       /* RET C */
                 if (TSTFLAG(C)) {
                     CHECK_BREAK_WORD(SP);
                     PCQ_ENTRY(PCX);
@@ -3818,9 +3873,9 @@ static t_stat sim_instr_mmu (void) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RC 5 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xd9:      /* EXX */
+            OP(0xd9):       /* EXX */
                 if (chiptype == CHIP_TYPE_8080) {
                     if (cpu_unit.flags & UNIT_CPU_OPSTOP) {
                         reason = STOP_OPCODE;
@@ -3845,24 +3900,24 @@ static t_stat sim_instr_mmu (void) {
                 temp = HL;
                 HL = HL1_S;
                 HL1_S = temp;
-                break;
+                NEXT_OP;
 
-            case 0xda:      /* JP C,nnnn */
+            OP(0xda):       /* JP C,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(TSTFLAG(C));        /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xdb:      /* IN A,(nn) */
+            OP(0xdb):       /* IN A,(nn) */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 10 : 11); /* IN nn 10 */
                 sim_brk_pend[0] = FALSE;
                 SET_HIGH_REGISTER(AF, in(RAM_PP(PC)));
-                break;
+                NEXT_OP;
 
-            case 0xdc:      /* CALL C,nnnn */
+            OP(0xdc):       /* CALL C,nnnn */
                 CALLC(TSTFLAG(C));      /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xdd:      /* DD prefix */
+            OP(0xdd):       /* DD prefix */
                 if (chiptype == CHIP_TYPE_8080) {
                     if (cpu_unit.flags & UNIT_CPU_OPSTOP) {
                         reason = STOP_OPCODE;
@@ -4644,9 +4699,9 @@ static t_stat sim_instr_mmu (void) {
                         CHECK_CPU_Z80;
                         PC--;
                 }
-                break;
+                NEXT_OP;
 
-            case 0xde:      /* SBC A,nn */
+            OP(0xde):       /* SBC A,nn */
                 tStates += 7; /* SBI nn 7 */
                 sim_brk_pend[0] = FALSE;
                 temp = RAM_PP(PC);
@@ -4654,17 +4709,17 @@ static t_stat sim_instr_mmu (void) {
                 sum = acu - temp - TSTFLAG(C);
                 cbits = acu ^ temp ^ sum;
                 AF = subTable[sum & 0xff] | cbitsTable[cbits & 0x1ff] | (SET_PV);
-                break;
+                NEXT_OP;
 
-            case 0xdf:      /* RST 18H */
+            OP(0xdf):       /* RST 18H */
                 tStates += 11; /* RST 3 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(PC);
                 PCQ_ENTRY(PCX);
                 PC = 0x18;
-                break;
+                NEXT_OP;
 
-            case 0xe0:      /* RET PO */
+            OP(0xe0):       /* RET PO */
                 if (TSTFLAG(P)) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RPO 5 */
@@ -4675,52 +4730,52 @@ static t_stat sim_instr_mmu (void) {
                     POP(PC);
                     tStates += 11; /* RPO 11 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xe1:      /* POP HL */
+            OP(0xe1):       /* POP HL */
                 tStates += 10; /* POP H 10 */
                 CHECK_BREAK_WORD(SP);
                 POP(HL);
-                break;
+                NEXT_OP;
 
-            case 0xe2:      /* JP PO,nnnn */
+            OP(0xe2):       /* JP PO,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(!TSTFLAG(P));       /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xe3:      /* EX (SP),HL */
+            OP(0xe3):       /* EX (SP),HL */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 18 : 19); /* XTHL 18 */
                 CHECK_BREAK_WORD(SP);
                 temp = HL;
                 POP(HL);
                 PUSH(temp);
-                break;
+                NEXT_OP;
 
-            case 0xe4:      /* CALL PO,nnnn */
+            OP(0xe4):       /* CALL PO,nnnn */
                 CALLC(!TSTFLAG(P));     /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xe5:      /* PUSH HL */
+            OP(0xe5):       /* PUSH HL */
                 tStates += 11; /* PUSH H 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(HL);
-                break;
+                NEXT_OP;
 
-            case 0xe6:      /* AND nn */
+            OP(0xe6):       /* AND nn */
                 tStates += 7; /* ANI nn 7 */
                 sim_brk_pend[0] = FALSE;
                 AF = andTable[((AF >> 8) & RAM_PP(PC)) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xe7:      /* RST 20H */
+            OP(0xe7):       /* RST 20H */
                 tStates += 11; /* RST 4 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(PC);
                 PCQ_ENTRY(PCX);
                 PC = 0x20;
-                break;
+                NEXT_OP;
 
-            case 0xe8:      /* RET PE */
+            OP(0xe8):       /* RET PE */
                 if (TSTFLAG(P)) {
                     CHECK_BREAK_WORD(SP);
                     PCQ_ENTRY(PCX);
@@ -4731,33 +4786,33 @@ static t_stat sim_instr_mmu (void) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RPE 5 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xe9:      /* JP (HL) */
+            OP(0xe9):       /* JP (HL) */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* PCHL 5 */
                 sim_brk_pend[0] = FALSE;
                 PCQ_ENTRY(PCX);
                 PC = HL;
-                break;
+                NEXT_OP;
 
-            case 0xea:      /* JP PE,nnnn */
+            OP(0xea):       /* JP PE,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(TSTFLAG(P));        /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xeb:      /* EX DE,HL */
+            OP(0xeb):       /* EX DE,HL */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 4); /* XCHG 5 */
                 sim_brk_pend[0] = FALSE;
                 temp = HL;
                 HL = DE;
                 DE = temp;
-                break;
+                NEXT_OP;
 
-            case 0xec:      /* CALL PE,nnnn */
+            OP(0xec):       /* CALL PE,nnnn */
                 CALLC(TSTFLAG(P));      /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xed:      /* ED prefix */
+            OP(0xed):       /* ED prefix */
                 if (chiptype == CHIP_TYPE_8080) {
                     if (cpu_unit.flags & UNIT_CPU_OPSTOP) {
                         reason = STOP_OPCODE;
@@ -5405,23 +5460,23 @@ static t_stat sim_instr_mmu (void) {
                         sim_brk_pend[0] = FALSE;
                         CHECK_CPU_Z80;
                 }
-                break;
+                NEXT_OP;
 
-            case 0xee:      /* XOR nn */
+            OP(0xee):       /* XOR nn */
                 tStates += 7; /* XRI nn 7 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) ^ RAM_PP(PC)) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xef:      /* RST 28H */
+            OP(0xef):       /* RST 28H */
                 tStates += 11; /* RST 5 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(PC);
                 PCQ_ENTRY(PCX);
                 PC = 0x28;
-                break;
+                NEXT_OP;
 
-            case 0xf0:      /* RET P */
+            OP(0xf0):       /* RET P */
                 if (TSTFLAG(S)) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RP 5 */
@@ -5432,50 +5487,50 @@ static t_stat sim_instr_mmu (void) {
                     POP(PC);
                     tStates += 11; /* RP 11 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xf1:      /* POP AF */
+            OP(0xf1):       /* POP AF */
                 tStates += 10; /* POP PSW 10 */
                 CHECK_BREAK_WORD(SP);
                 POP(AF);
-                break;
+                NEXT_OP;
 
-            case 0xf2:      /* JP P,nnnn */
+            OP(0xf2):       /* JP P,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(!TSTFLAG(S));       /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xf3:      /* DI */
+            OP(0xf3):       /* DI */
                 tStates += 4; /* DI 4 */
                 sim_brk_pend[0] = FALSE;
                 IFF_S = 0;
-                break;
+                NEXT_OP;
 
-            case 0xf4:      /* CALL P,nnnn */
+            OP(0xf4):       /* CALL P,nnnn */
                 CALLC(!TSTFLAG(S));     /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xf5:      /* PUSH AF */
+            OP(0xf5):       /* PUSH AF */
                 tStates += 11; /* PUSH PSW 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(AF);
-                break;
+                NEXT_OP;
 
-            case 0xf6:      /* OR nn */
+            OP(0xf6):       /* OR nn */
                 tStates += 7; /* ORI nn 7 */
                 sim_brk_pend[0] = FALSE;
                 AF = xororTable[((AF >> 8) | RAM_PP(PC)) & 0xff];
-                break;
+                NEXT_OP;
 
-            case 0xf7:      /* RST 30H */
+            OP(0xf7):       /* RST 30H */
                 tStates += 11; /* RST 6 11 */
                 CHECK_BREAK_WORD(SP - 2);
                 PUSH(PC);
                 PCQ_ENTRY(PCX);
                 PC = 0x30;
-                break;
+                NEXT_OP;
 
-            case 0xf8:      /* RET M */
+            OP(0xf8):       /* RET M */
                 if (TSTFLAG(S)) {
                     CHECK_BREAK_WORD(SP);
                     PCQ_ENTRY(PCX);
@@ -5486,30 +5541,30 @@ static t_stat sim_instr_mmu (void) {
                     sim_brk_pend[0] = FALSE;
                     tStates += 5; /* RM 5 */
                 }
-                break;
+                NEXT_OP;
 
-            case 0xf9:      /* LD SP,HL */
+            OP(0xf9):       /* LD SP,HL */
                 tStates += (chiptype == CHIP_TYPE_8080 ? 5 : 6); /* SPHL 5 */
                 sim_brk_pend[0] = FALSE;
                 SP = HL;
-                break;
+                NEXT_OP;
 
-            case 0xfa:      /* JP M,nnnn */
+            OP(0xfa):       /* JP M,nnnn */
                 sim_brk_pend[0] = FALSE;
                 JPC(TSTFLAG(S));        /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xfb:      /* EI */
+            OP(0xfb):       /* EI */
                 tStates += 4; /* EI 4 */
                 sim_brk_pend[0] = FALSE;
                 IFF_S = 3;
-                break;
+                NEXT_OP;
 
-            case 0xfc:      /* CALL M,nnnn */
+            OP(0xfc):       /* CALL M,nnnn */
                 CALLC(TSTFLAG(S));      /* also updates tStates */
-                break;
+                NEXT_OP;
 
-            case 0xfd:      /* FD prefix */
+            OP(0xfd):       /* FD prefix */
                 if (chiptype == CHIP_TYPE_8080) {
                     if (cpu_unit.flags & UNIT_CPU_OPSTOP) {
                         reason = STOP_OPCODE;
@@ -6291,9 +6346,9 @@ static t_stat sim_instr_mmu (void) {
                         CHECK_CPU_Z80;
                         PC--;
                 }
-            break;
+            NEXT_OP;
 
-        case 0xfe:  /* CP nn */
+        OP(0xfe):      /* CP nn */
             tStates += 7; /* CPI nn 7 */
             sim_brk_pend[0] = FALSE;
             temp = RAM_PP(PC);
@@ -6303,9 +6358,9 @@ static t_stat sim_instr_mmu (void) {
             cbits = acu ^ temp ^ sum;
             AF = (AF & ~0xff) | cpTable[sum & 0xff] | (temp & 0x28) |
                 (SET_PV) | cbits2Table[cbits & 0x1ff];
-            break;
+            NEXT_OP;
 
-        case 0xff:  /* RST 38H */
+        OP(0xff):      /* RST 38H */
             tStates += 11; /* RST 7 11 */
             CHECK_BREAK_WORD(SP - 2);
             PUSH(PC);
@@ -625,17 +625,206 @@ static t_stat jrst_tab[16] = {
 #define POPF            if (LRZ (AC(ac)) == RMASK) SETF (F_T2)
 #define DMOVNF          if (rs[1] == 0) { MOVNF (rs[0]); }
 
+/* Instruction decode and dispatch.  DECODE extracts the opcode and AC and
+   calculates the effective address.  Each opcode case is labelled with OP,
+   and an instruction which completes normally ends with NEXT_OP.  Built
+   with SIM_COMPUTED_GOTO, OP also defines a label for op_tab, and NEXT_OP
+   fetches and dispatches the following instruction directly, unless the
+   top of the loop has work to do (events, interrupts, traps, breakpoints,
+   ITS one-proceed); otherwise NEXT_OP just leaves the switch.
+*/
+
+#define DECODE                                                          \
+    op = GET_OP (inst);                                                 \
+    ac = GET_AC (inst);                                                 \
+    for (indrct = inst, i = 0; i < ind_max; i++) {                      \
+        ea = GET_ADDR (indrct);                                         \
+        xr = GET_XR (indrct);                                           \
+        if (xr)                                                         \
+            ea = (ea + ((a10) XR (xr, MM_EA))) & AMASK;                 \
+        if (TST_IND (indrct))                                           \
+            indrct = Read (ea, MM_EA);                                  \
+        else break;                                                     \
+        }                                                               \
+    if (i >= ind_max)                                                   \
+        ABORT (STOP_IND);                                               \
+    if (hst_lnt) {                                                      \
+        hst_p = (hst_p + 1);                                            \
+        if (hst_p >= hst_lnt)                                           \
+            hst_p = 0;                                                  \
+        hst[hst_p].pc = pager_PC | HIST_PC;                             \
+        hst[hst_p].ea = ea;                                             \
+        hst[hst_p].ir = inst;                                           \
+        hst[hst_p].ac = AC(ac);                                         \
+        }
+
+#if defined (SIM_COMPUTED_GOTO)
+#define OP(n)           case n: op_##n
+#define NEXT_OP         { if (its_2pr || (sim_interval <= 0) || qintr || \
+                              TSTF (F_T1 | F_T2) || sim_brk_summ)       \
+                              break;                                    \
+                          pager_PC = PC; pager_tc = FALSE;              \
+                          pflgs = 0; xct_cnt = 0;                       \
+                          inst = Read (PC, MM_CUR); INCPC;              \
+                          sim_interval = sim_interval - 1;              \
+                          SIM_PROF_SAMPLE (pager_PC,                    \
+                              SWMASK (TSTF (F_USR)? 'U': 'E'));         \
+                          its_2pr = its_1pr;                            \
+                          DECODE;                                       \
+                          goto *op_tab[op];                             \
+                          }
+#else
+#define OP(n)           case n
+#define NEXT_OP         break
+#endif
+
 t_stat sim_instr (void)
 {
 a10 PC;                                                 /* set by setjmp */
 int abortval = 0;                                       /* abort value */
 t_stat r;
+#if defined (SIM_COMPUTED_GOTO)
+static const void *const op_tab[512] = {               /* opcode labels */
+    &&op_0000, &&op_0001, &&op_0002, &&op_0003,
+    &&op_0004, &&op_0005, &&op_0006, &&op_0007,
+    &&op_0010, &&op_0011, &&op_0012, &&op_0013,
+    &&op_0014, &&op_0015, &&op_0016, &&op_0017,
+    &&op_0020, &&op_0021, &&op_0022, &&op_0023,
+    &&op_0024, &&op_0025, &&op_0026, &&op_0027,
+    &&op_0030, &&op_0031, &&op_0032, &&op_0033,
+    &&op_0034, &&op_0035, &&op_0036, &&op_0037,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&op_0102, &&op_0103,
+    &&MUUO,    &&op_0105, &&MUUO,    &&MUUO,
+    &&op_0110, &&op_0111, &&op_0112, &&op_0113,
+    &&op_0114, &&op_0115, &&op_0116, &&op_0117,
+    &&op_0120, &&op_0121, &&op_0122, &&op_0123,
+    &&op_0124, &&op_0125, &&op_0126, &&op_0127,
+    &&MUUO,    &&MUUO,    &&op_0132, &&op_0133,
+    &&op_0134, &&op_0135, &&op_0136, &&op_0137,
+    &&op_0140, &&MUUO,    &&op_0142, &&op_0143,
+    &&op_0144, &&op_0145, &&op_0146, &&op_0147,
+    &&op_0150, &&MUUO,    &&op_0152, &&op_0153,
+    &&op_0154, &&op_0155, &&op_0156, &&op_0157,
+    &&op_0160, &&MUUO,    &&op_0162, &&op_0163,
+    &&op_0164, &&op_0165, &&op_0166, &&op_0167,
+    &&op_0170, &&MUUO,    &&op_0172, &&op_0173,
+    &&op_0174, &&op_0175, &&op_0176, &&op_0177,
+    &&op_0200, &&op_0201, &&op_0202, &&op_0203,
+    &&op_0204, &&op_0205, &&op_0206, &&op_0207,
+    &&op_0210, &&op_0211, &&op_0212, &&op_0213,
+    &&op_0214, &&op_0215, &&op_0216, &&op_0217,
+    &&op_0220, &&op_0221, &&op_0222, &&op_0223,
+    &&op_0224, &&op_0225, &&op_0226, &&op_0227,
+    &&op_0230, &&op_0231, &&op_0232, &&op_0233,
+    &&op_0234, &&op_0235, &&op_0236, &&op_0237,
+    &&op_0240, &&op_0241, &&op_0242, &&op_0243,
+    &&op_0244, &&op_0245, &&op_0246, &&op_0247,
+    &&op_0250, &&op_0251, &&op_0252, &&op_0253,
+    &&op_0254, &&op_0255, &&op_0256, &&op_0257,
+    &&op_0260, &&op_0261, &&op_0262, &&op_0263,
+    &&op_0264, &&op_0265, &&op_0266, &&op_0267,
+    &&op_0270, &&op_0271, &&op_0272, &&op_0273,
+    &&op_0274, &&op_0275, &&op_0276, &&op_0277,
+    &&op_0300, &&op_0301, &&op_0302, &&op_0303,
+    &&op_0304, &&op_0305, &&op_0306, &&op_0307,
+    &&op_0310, &&op_0311, &&op_0312, &&op_0313,
+    &&op_0314, &&op_0315, &&op_0316, &&op_0317,
+    &&op_0320, &&op_0321, &&op_0322, &&op_0323,
+    &&op_0324, &&op_0325, &&op_0326, &&op_0327,
+    &&op_0330, &&op_0331, &&op_0332, &&op_0333,
+    &&op_0334, &&op_0335, &&op_0336, &&op_0337,
+    &&op_0340, &&op_0341, &&op_0342, &&op_0343,
+    &&op_0344, &&op_0345, &&op_0346, &&op_0347,
+    &&op_0350, &&op_0351, &&op_0352, &&op_0353,
+    &&op_0354, &&op_0355, &&op_0356, &&op_0357,
+    &&op_0360, &&op_0361, &&op_0362, &&op_0363,
+    &&op_0364, &&op_0365, &&op_0366, &&op_0367,
+    &&op_0370, &&op_0371, &&op_0372, &&op_0373,
+    &&op_0374, &&op_0375, &&op_0376, &&op_0377,
+    &&op_0400, &&op_0401, &&op_0402, &&op_0403,
+    &&op_0404, &&op_0405, &&op_0406, &&op_0407,
+    &&op_0410, &&op_0411, &&op_0412, &&op_0413,
+    &&op_0414, &&op_0415, &&op_0416, &&op_0417,
+    &&op_0420, &&op_0421, &&op_0422, &&op_0423,
+    &&op_0424, &&op_0425, &&op_0426, &&op_0427,
+    &&op_0430, &&op_0431, &&op_0432, &&op_0433,
+    &&op_0434, &&op_0435, &&op_0436, &&op_0437,
+    &&op_0440, &&op_0441, &&op_0442, &&op_0443,
+    &&op_0444, &&op_0445, &&op_0446, &&op_0447,
+    &&op_0450, &&op_0451, &&op_0452, &&op_0453,
+    &&op_0454, &&op_0455, &&op_0456, &&op_0457,
+    &&op_0460, &&op_0461, &&op_0462, &&op_0463,
+    &&op_0464, &&op_0465, &&op_0466, &&op_0467,
+    &&op_0470, &&op_0471, &&op_0472, &&op_0473,
+    &&op_0474, &&op_0475, &&op_0476, &&op_0477,
+    &&op_0500, &&op_0501, &&op_0502, &&op_0503,
+    &&op_0504, &&op_0505, &&op_0506, &&op_0507,
+    &&op_0510, &&op_0511, &&op_0512, &&op_0513,
+    &&op_0514, &&op_0515, &&op_0516, &&op_0517,
+    &&op_0520, &&op_0521, &&op_0522, &&op_0523,
+    &&op_0524, &&op_0525, &&op_0526, &&op_0527,
+    &&op_0530, &&op_0531, &&op_0532, &&op_0533,
+    &&op_0534, &&op_0535, &&op_0536, &&op_0537,
+    &&op_0540, &&op_0541, &&op_0542, &&op_0543,
+    &&op_0544, &&op_0545, &&op_0546, &&op_0547,
+    &&op_0550, &&op_0551, &&op_0552, &&op_0553,
+    &&op_0554, &&op_0555, &&op_0556, &&op_0557,
+    &&op_0560, &&op_0561, &&op_0562, &&op_0563,
+    &&op_0564, &&op_0565, &&op_0566, &&op_0567,
+    &&op_0570, &&op_0571, &&op_0572, &&op_0573,
+    &&op_0574, &&op_0575, &&op_0576, &&op_0577,
+    &&op_0600, &&op_0601, &&op_0602, &&op_0603,
+    &&op_0604, &&op_0605, &&op_0606, &&op_0607,
+    &&op_0610, &&op_0611, &&op_0612, &&op_0613,
+    &&op_0614, &&op_0615, &&op_0616, &&op_0617,
+    &&op_0620, &&op_0621, &&op_0622, &&op_0623,
+    &&op_0624, &&op_0625, &&op_0626, &&op_0627,
+    &&op_0630, &&op_0631, &&op_0632, &&op_0633,
+    &&op_0634, &&op_0635, &&op_0636, &&op_0637,
+    &&op_0640, &&op_0641, &&op_0642, &&op_0643,
+    &&op_0644, &&op_0645, &&op_0646, &&op_0647,
+    &&op_0650, &&op_0651, &&op_0652, &&op_0653,
+    &&op_0654, &&op_0655, &&op_0656, &&op_0657,
+    &&op_0660, &&op_0661, &&op_0662, &&op_0663,
+    &&op_0664, &&op_0665, &&op_0666, &&op_0667,
+    &&op_0670, &&op_0671, &&op_0672, &&op_0673,
+    &&op_0674, &&op_0675, &&op_0676, &&op_0677,
+    &&op_0700, &&op_0701, &&op_0702, &&MUUO,
+    &&op_0704, &&op_0705, &&MUUO,    &&MUUO,
+    &&op_0710, &&op_0711, &&op_0712, &&op_0713,
+    &&op_0714, &&op_0715, &&op_0716, &&op_0717,
+    &&op_0720, &&op_0721, &&op_0722, &&op_0723,
+    &&op_0724, &&op_0725, &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO,
+    &&MUUO,    &&MUUO,    &&MUUO,    &&MUUO
+    };
+#endif
 
 /* Restore register state */
 
 if ((r = build_dib_tab ()) != SCPE_OK)                  /* build, chk dib_tab */
     return r;
 pager_PC = PC = saved_PC & AMASK;                       /* load local PC */
+if (sim_brk_wchg) {                                     /* watchpoints changed? */
+    pag_reset (&pag_dev);                               /* drop cached pages */
+    sim_brk_wchg = FALSE;
+    }
 set_dyn_ptrs ();                                        /* set up local ptrs */
 pager_tc = FALSE;                                       /* not in trap cycle */
 pager_pi = FALSE;                                       /* not in pi sequence */
@@ -827,9 +1016,11 @@ if (TSTF (F_T1 | F_T2) && PAGING) {
 /* Test for instruction breakpoint */
 
 else {
-    if (sim_brk_summ &&
-        sim_brk_test (PC, SWMASK ('E'))) {              /* breakpoint? */
-        ABORT (STOP_IBKPT);                             /* stop simulation */
+    if (sim_brk_summ) {
+        if (sim_brk_test (PC, SWMASK ('E')))            /* breakpoint? */
+            ABORT (STOP_IBKPT);                         /* stop simulation */
+        if (sim_brk_wpend)                              /* watchpoint hit? */
+            ABORT (STOP_WBKPT);
         }
 
 /* Ready (at last) to get an instruction */
@@ -837,6 +1028,8 @@ else {
     inst = Read (pager_PC = PC, MM_CUR);                /* get instruction */
     INCPC;  
     sim_interval = sim_interval - 1;
+    SIM_PROF_SAMPLE (pager_PC,                          /* profile guest PC */
+        SWMASK (TSTF (F_USR)? 'U': 'E'));
     }
 
 its_2pr = its_1pr;                                      /* save 1-proc flag */
@@ -844,67 +1037,46 @@ its_2pr = its_1pr;                                      /* save 1-proc flag */
 /* Execute instruction.  XCT and PXCT also return here. */
 
 XCT:
-op = GET_OP (inst);                                     /* get opcode */
-ac = GET_AC (inst);                                     /* get AC */
-for (indrct = inst, i = 0; i < ind_max; i++) {          /* calc eff addr */
-    ea = GET_ADDR (indrct);
-    xr = GET_XR (indrct);
-    if (xr)
-        ea = (ea + ((a10) XR (xr, MM_EA))) & AMASK;
-    if (TST_IND (indrct))
-        indrct = Read (ea, MM_EA);
-    else break;
-    }
-if (i >= ind_max)
-    ABORT (STOP_IND);                                   /* too many ind? stop */
-if (hst_lnt) {                                          /* history enabled? */
-    hst_p = (hst_p + 1);                                /* next entry */
-    if (hst_p >= hst_lnt)
-        hst_p = 0;
-    hst[hst_p].pc = pager_PC | HIST_PC;
-    hst[hst_p].ea = ea;
-    hst[hst_p].ir = inst;
-    hst[hst_p].ac = AC(ac);
-    }
+DECODE;                                                 /* op, ac, ea, history */
 switch (op) {                                           /* case on opcode */
 
 /* UUO's (0000 - 0077) - checked against KS10 ucode */
 
-case 0000:  if (stop_op0) {
+OP (0000):  if (stop_op0) {
                 ABORT (STOP_ILLEG);
                 }
             goto MUUO;
-case 0001:                                              /* local UUO's */
-case 0002:
-case 0003:
-case 0004:
-case 0005:
-case 0006:
-case 0007:
-case 0010:
-case 0011:
-case 0012:
-case 0013:
-case 0014:
-case 0015:
-case 0016:
-case 0017:
-case 0020:
-case 0021:
-case 0022:
-case 0023:
-case 0024:
-case 0025:
-case 0026:
-case 0027:
-case 0030:
-case 0031:
-case 0032:
-case 0033:
-case 0034:
-case 0035:
-case 0036:
-case 0037:  Write (040, UUOWORD, MM_CUR);               /* store op, ac, ea */
+OP (0001):                                              /* local UUO's */
+OP (0002):
+OP (0003):
+OP (0004):
+OP (0005):
+OP (0006):
+OP (0007):
+OP (0010):
+OP (0011):
+OP (0012):
+OP (0013):
+OP (0014):
+OP (0015):
+OP (0016):
+OP (0017):
+OP (0020):
+OP (0021):
+OP (0022):
+OP (0023):
+OP (0024):
+OP (0025):
+OP (0026):
+OP (0027):
+OP (0030):
+OP (0031):
+OP (0032):
+OP (0033):
+OP (0034):
+OP (0035):
+OP (0036):
+OP (0037):  Write (040, UUOWORD, MM_CUR);               /* store op, ac, ea */
             inst = Read (041, MM_CUR);                  /* get new instr */
             goto XCT;
 
@@ -914,34 +1086,34 @@ case 0037:  Write (040, UUOWORD, MM_CUR);               /* store op, ac, ea */
 
 /* case 0100:   MUUO                                  *//* UJEN */
 /* case 0101:   MUUO                                  *//* unassigned */
-case 0102:  if (Q_ITS && !TSTF (F_USR)) {               /* GFAD (KL), XCTRI (ITS) */
+OP (0102):  if (Q_ITS && !TSTF (F_USR)) {               /* GFAD (KL), XCTRI (ITS) */
                 inst = Read (ea, MM_OPND);
                 pflgs = pflgs | ac;
                 goto XCT;
                 }
             goto MUUO;
-case 0103:  if (Q_ITS && !TSTF (F_USR)) {               /* GFSB (KL), XCTR (ITS) */
+OP (0103):  if (Q_ITS && !TSTF (F_USR)) {               /* GFSB (KL), XCTR (ITS) */
                 inst = Read (ea, MM_OPND);
                 pflgs = pflgs | ac;
                 goto XCT;
                 }
             goto MUUO;
 /* case 0104:   MUUO                                  *//* JSYS (T20) */
-case 0105:  AC(ac) = adjsp (AC(ac), ea); break;         /* ADJSP */
+OP (0105):  AC(ac) = adjsp (AC(ac), ea); NEXT_OP;       /* ADJSP */
 /* case 0106:   MUUO                                  *//* GFMP (KL)*/
 /* case 0107:   MUUO                                  *//* GFDV (KL) */
-case 0110:  RD2; dfad (ac, rs, 0); break;               /* DFAD */
-case 0111:  RD2; dfad (ac, rs, 1); break;               /* DFSB */
-case 0112:  RD2; dfmp (ac, rs); break;                  /* DFMP */
-case 0113:  RD2; dfdv (ac, rs); break;                  /* DFDV */
-case 0114:  RD2; dadd (ac, rs); break;                  /* DADD */
-case 0115:  RD2; dsub (ac, rs); break;                  /* DSUB */
-case 0116:  RD2; dmul (ac, rs); break;                  /* DMUL */
-case 0117:  RD2; ddiv (ac, rs); break;                  /* DDIV */
-case 0120:  RD2; S2AC; break;                           /* DMOVE */
-case 0121:  RD2; DMOVN (rs); S2AC; DMOVNF; break;       /* DMOVN */
-case 0122:  RD; fix(ac, mb, 0); break;                  /* FIX */
-case 0123:  st = xtend (ac, ea, pflgs);                 /* EXTEND */
+OP (0110):  RD2; dfad (ac, rs, 0); NEXT_OP;             /* DFAD */
+OP (0111):  RD2; dfad (ac, rs, 1); NEXT_OP;             /* DFSB */
+OP (0112):  RD2; dfmp (ac, rs); NEXT_OP;                /* DFMP */
+OP (0113):  RD2; dfdv (ac, rs); NEXT_OP;                /* DFDV */
+OP (0114):  RD2; dadd (ac, rs); NEXT_OP;                /* DADD */
+OP (0115):  RD2; dsub (ac, rs); NEXT_OP;                /* DSUB */
+OP (0116):  RD2; dmul (ac, rs); NEXT_OP;                /* DMUL */
+OP (0117):  RD2; ddiv (ac, rs); NEXT_OP;                /* DDIV */
+OP (0120):  RD2; S2AC; NEXT_OP;                         /* DMOVE */
+OP (0121):  RD2; DMOVN (rs); S2AC; DMOVNF; NEXT_OP;     /* DMOVN */
+OP (0122):  RD; fix(ac, mb, 0); NEXT_OP;                /* FIX */
+OP (0123):  st = xtend (ac, ea, pflgs);                 /* EXTEND */
             rlog = 0;                                   /* clear log */
             switch (st) {
             case XT_SKIP:
@@ -951,53 +1123,53 @@ case 0123:  st = xtend (ac, ea, pflgs);                 /* EXTEND */
             default:
                 goto MUUO;
                 }
-            break;
-case 0124:  G2AC; WR2; break;                           /* DMOVEM */
-case 0125:  G2AC; DMOVN (rs); WR2; DMOVNF; break;       /* DMOVNM */
-case 0126:  RD; fix (ac, mb, 1); break;                 /* FIXR */
-case 0127:  RD; AC(ac) = fltr (mb); break;              /* FLTR */
+            NEXT_OP;
+OP (0124):  G2AC; WR2; NEXT_OP;                         /* DMOVEM */
+OP (0125):  G2AC; DMOVN (rs); WR2; DMOVNF; NEXT_OP;     /* DMOVNM */
+OP (0126):  RD; fix (ac, mb, 1); NEXT_OP;               /* FIXR */
+OP (0127):  RD; AC(ac) = fltr (mb); NEXT_OP;            /* FLTR */
 /* case 0130:   MUUO                                  *//* UFA */
 /* case 0131:   MUUO                                  *//* DFN */
-case 0132:  AC(ac) = fsc (AC(ac), ea); break;           /* FSC */
-case 0133:  if (!ac)                                    /* IBP */
+OP (0132):  AC(ac) = fsc (AC(ac), ea); NEXT_OP;         /* FSC */
+OP (0133):  if (!ac)                                    /* IBP */
                 ibp (ea, pflgs);
-            else adjbp (ac, ea, pflgs); break;
-case 0134:  CIBP; LDB; CLRF (F_FPD); break;             /* ILBP */
-case 0135:  LDB; break;                                 /* LDB */
-case 0136:  CIBP; DPB; CLRF (F_FPD); break;             /* IDBP */
-case 0137:  DPB; break;                                 /* DPB */
-case 0140:  RD; AC(ac) = FAD (mb); break;               /* FAD */
+            else adjbp (ac, ea, pflgs); NEXT_OP;
+OP (0134):  CIBP; LDB; CLRF (F_FPD); NEXT_OP;           /* ILBP */
+OP (0135):  LDB; NEXT_OP;                               /* LDB */
+OP (0136):  CIBP; DPB; CLRF (F_FPD); NEXT_OP;           /* IDBP */
+OP (0137):  DPB; NEXT_OP;                               /* DPB */
+OP (0140):  RD; AC(ac) = FAD (mb); NEXT_OP;             /* FAD */
 /* case 0141:   MUUO                                  *//* FADL */
-case 0142:  RM; mb = FAD (mb); WR; break;               /* FADM */
-case 0143:  RM; AC(ac) = FAD (mb); WRAC; break;         /* FADB */
-case 0144:  RD; AC(ac) = FADR (mb); break;              /* FADR */
-case 0145:  AC(ac) = FADR (IMS); break;                 /* FADRI */
-case 0146:  RM; mb = FADR (mb); WR; break;              /* FADRM */
-case 0147:  RM; AC(ac) = FADR (mb); WRAC; break;        /* FADRB */
-case 0150:  RD; AC(ac) = FSB (mb); break;               /* FSB */
+OP (0142):  RM; mb = FAD (mb); WR; NEXT_OP;             /* FADM */
+OP (0143):  RM; AC(ac) = FAD (mb); WRAC; NEXT_OP;       /* FADB */
+OP (0144):  RD; AC(ac) = FADR (mb); NEXT_OP;            /* FADR */
+OP (0145):  AC(ac) = FADR (IMS); NEXT_OP;               /* FADRI */
+OP (0146):  RM; mb = FADR (mb); WR; NEXT_OP;            /* FADRM */
+OP (0147):  RM; AC(ac) = FADR (mb); WRAC; NEXT_OP;      /* FADRB */
+OP (0150):  RD; AC(ac) = FSB (mb); NEXT_OP;             /* FSB */
 /* case 0151:   MUUO                                  *//* FSBL */
-case 0152:  RM; mb = FSB (mb); WR; break;               /* FSBM */
-case 0153:  RM; AC(ac) = FSB (mb); WRAC; break;         /* FSBB */
-case 0154:  RD; AC(ac) = FSBR (mb); break;              /* FSBR */
-case 0155:  AC(ac) = FSBR (IMS);  break;                /* FSBRI */
-case 0156:  RM; mb = FSBR (mb); WR; break;              /* FSBRM */
-case 0157:  RM; AC(ac) = FSBR (mb); WRAC; break;        /* FSBRB */
-case 0160:  RD; AC(ac) = FMP (mb); break;               /* FMP */
+OP (0152):  RM; mb = FSB (mb); WR; NEXT_OP;             /* FSBM */
+OP (0153):  RM; AC(ac) = FSB (mb); WRAC; NEXT_OP;       /* FSBB */
+OP (0154):  RD; AC(ac) = FSBR (mb); NEXT_OP;            /* FSBR */
+OP (0155):  AC(ac) = FSBR (IMS);  NEXT_OP;              /* FSBRI */
+OP (0156):  RM; mb = FSBR (mb); WR; NEXT_OP;            /* FSBRM */
+OP (0157):  RM; AC(ac) = FSBR (mb); WRAC; NEXT_OP;      /* FSBRB */
+OP (0160):  RD; AC(ac) = FMP (mb); NEXT_OP;             /* FMP */
 /* case 0161:   MUUO                                  *//* FMPL */
-case 0162:  RM; mb = FMP (mb); WR; break;               /* FMPM */
-case 0163:  RM; AC(ac) = FMP (mb); WRAC; break;         /* FMPB */
-case 0164:  RD; AC(ac) = FMPR (mb); break;              /* FMPR */
-case 0165:  AC(ac) = FMPR (IMS); break;                 /* FMPRI */
-case 0166:  RM; mb = FMPR (mb); WR; break;              /* FMPRM */
-case 0167:  RM; AC(ac) = FMPR (mb); WRAC; break;        /* FMPRB */
-case 0170:  RD; if (FDV (mb)) S1AC; break;              /* FDV */
+OP (0162):  RM; mb = FMP (mb); WR; NEXT_OP;             /* FMPM */
+OP (0163):  RM; AC(ac) = FMP (mb); WRAC; NEXT_OP;       /* FMPB */
+OP (0164):  RD; AC(ac) = FMPR (mb); NEXT_OP;            /* FMPR */
+OP (0165):  AC(ac) = FMPR (IMS); NEXT_OP;               /* FMPRI */
+OP (0166):  RM; mb = FMPR (mb); WR; NEXT_OP;            /* FMPRM */
+OP (0167):  RM; AC(ac) = FMPR (mb); WRAC; NEXT_OP;      /* FMPRB */
+OP (0170):  RD; if (FDV (mb)) S1AC; NEXT_OP;            /* FDV */
 /* case 0171:   MUUO                                  *//* FDVL */
-case 0172:  RM; if (FDV (mb)) WR1; break;               /* FDVM */
-case 0173:  RM; if (FDV (mb)) { S1AC; WRAC; } break;    /* FDVB */
-case 0174:  RD; if (FDVR (mb)) S1AC; break;             /* FDVR */
-case 0175:  if (FDVR (IMS)) S1AC; break;                /* FDVRI */
-case 0176:  RM; if (FDVR (mb)) WR1; break;              /* FDVRM */
-case 0177:  RM; if (FDVR (mb)) { S1AC; WRAC; } break;   /* FDVRB */
+OP (0172):  RM; if (FDV (mb)) WR1; NEXT_OP;             /* FDVM */
+OP (0173):  RM; if (FDV (mb)) { S1AC; WRAC; } NEXT_OP;  /* FDVB */
+OP (0174):  RD; if (FDVR (mb)) S1AC; NEXT_OP;           /* FDVR */
+OP (0175):  if (FDVR (IMS)) S1AC; NEXT_OP;              /* FDVRI */
+OP (0176):  RM; if (FDVR (mb)) WR1; NEXT_OP;            /* FDVRM */
+OP (0177):  RM; if (FDVR (mb)) { S1AC; WRAC; } NEXT_OP; /* FDVRB */
 
 /* Move, arithmetic, shift, and jump (0200 - 0277)
 
@@ -1007,153 +1179,153 @@ case 0177:  RM; if (FDVR (mb)) { S1AC; WRAC; } break;   /* FDVRB */
    if not implemented, are nops, not MUUO's.
 */
 
-case 0200:  RDAC; break;                                /* MOVE */
-case 0201:  AC(ac) = ea; break;                         /* MOVEI */
-case 0202:  WRAC; break;                                /* MOVEM */
-case 0203:  RM; LAC; break;                             /* MOVES */
-case 0204:  RD; AC(ac) = SWP (mb); break;               /* MOVS */
-case 0205:  AC(ac) = IMS; break;                        /* MOVSI */
-case 0206:  mb = SWP (AC(ac)); WR; break;               /* MOVSM */
-case 0207:  RM; mb = SWP (mb); WR; LAC; break;          /* MOVSS */
-case 0210:  RD; AC(ac) = MOVN (mb); break;              /* MOVN */
-case 0211:  AC(ac) = NEG (IM);                          /* MOVNI */
+OP (0200):  RDAC; NEXT_OP;                              /* MOVE */
+OP (0201):  AC(ac) = ea; NEXT_OP;                       /* MOVEI */
+OP (0202):  WRAC; NEXT_OP;                              /* MOVEM */
+OP (0203):  RM; LAC; NEXT_OP;                           /* MOVES */
+OP (0204):  RD; AC(ac) = SWP (mb); NEXT_OP;             /* MOVS */
+OP (0205):  AC(ac) = IMS; NEXT_OP;                      /* MOVSI */
+OP (0206):  mb = SWP (AC(ac)); WR; NEXT_OP;             /* MOVSM */
+OP (0207):  RM; mb = SWP (mb); WR; LAC; NEXT_OP;        /* MOVSS */
+OP (0210):  RD; AC(ac) = MOVN (mb); NEXT_OP;            /* MOVN */
+OP (0211):  AC(ac) = NEG (IM);                          /* MOVNI */
             if (AC(ac) == 0) SETF (F_C0 | F_C1);
-            break;
-case 0212:  RM; mb = MOVN (AC(ac)); WR; break;          /* MOVNM */
-case 0213:  RM; mb = MOVN (mb); WR; LAC; break;         /* MOVNS */
-case 0214:  RD; AC(ac) = MOVM (mb); break;              /* MOVM */
-case 0215:  AC(ac) = ea; break;                         /* MOVMI */
-case 0216:  RM; mb = MOVM (AC(ac)); WR; break;          /* MOVMM */
-case 0217:  RM; mb = MOVM (mb); WR; LAC; break;         /* MOVMS */
-case 0220:  RD; AC(ac) = IMUL (mb); break;              /* IMUL */
-case 0221:  AC(ac) = IMUL (IM); break;                  /* IMULI */
-case 0222:  RM; mb = IMUL (mb); WR; break;              /* IMULM */
-case 0223:  RM; AC(ac) = IMUL (mb); WRAC; break;        /* IMULB */
-case 0224:  RD; MUL (mb); S2AC; break;                  /* MUL */
-case 0225:  MUL (IM); S2AC; break;                      /* MULI */
-case 0226:  RM; MUL (mb); WR1; break;                   /* MULM */
-case 0227:  RM; MUL (mb); WR1; S2AC; break;             /* MULB */
-case 0230:  RD; if (IDIV (mb)) S2AC; break;             /* IDIV */
-case 0231:  if (IDIV (IM)) S2AC; break;                 /* IDIVI */
-case 0232:  RM; if (IDIV (mb)) WR1; break;              /* IDIVM */
-case 0233:  RM; if (IDIV (mb)) { WR1; S2AC; } break;    /* IDIVB */
-case 0234:  RD; if (DIV (mb)) S2AC; break;              /* DIV */
-case 0235:  if (DIV (IM)) S2AC; break;                  /* DIVI */
-case 0236:  RM; if (DIV (mb)) WR1; break;               /* DIVM */
-case 0237:  RM; if (DIV (mb)) { WR1; S2AC; } break;     /* DIVB */
-case 0240:  AC(ac) = ash (AC(ac), ea); break;           /* ASH */
-case 0241:  AC(ac) = rot (AC(ac), ea); break;           /* ROT */
-case 0242:  AC(ac) = lsh (AC(ac), ea); break;           /* LSH */
-case 0243:  AC(P1) = jffo (AC(ac));                     /* JFFO */
+            NEXT_OP;
+OP (0212):  RM; mb = MOVN (AC(ac)); WR; NEXT_OP;        /* MOVNM */
+OP (0213):  RM; mb = MOVN (mb); WR; LAC; NEXT_OP;       /* MOVNS */
+OP (0214):  RD; AC(ac) = MOVM (mb); NEXT_OP;            /* MOVM */
+OP (0215):  AC(ac) = ea; NEXT_OP;                       /* MOVMI */
+OP (0216):  RM; mb = MOVM (AC(ac)); WR; NEXT_OP;        /* MOVMM */
+OP (0217):  RM; mb = MOVM (mb); WR; LAC; NEXT_OP;       /* MOVMS */
+OP (0220):  RD; AC(ac) = IMUL (mb); NEXT_OP;            /* IMUL */
+OP (0221):  AC(ac) = IMUL (IM); NEXT_OP;                /* IMULI */
+OP (0222):  RM; mb = IMUL (mb); WR; NEXT_OP;            /* IMULM */
+OP (0223):  RM; AC(ac) = IMUL (mb); WRAC; NEXT_OP;      /* IMULB */
+OP (0224):  RD; MUL (mb); S2AC; NEXT_OP;                /* MUL */
+OP (0225):  MUL (IM); S2AC; NEXT_OP;                    /* MULI */
+OP (0226):  RM; MUL (mb); WR1; NEXT_OP;                 /* MULM */
+OP (0227):  RM; MUL (mb); WR1; S2AC; NEXT_OP;           /* MULB */
+OP (0230):  RD; if (IDIV (mb)) S2AC; NEXT_OP;           /* IDIV */
+OP (0231):  if (IDIV (IM)) S2AC; NEXT_OP;               /* IDIVI */
+OP (0232):  RM; if (IDIV (mb)) WR1; NEXT_OP;            /* IDIVM */
+OP (0233):  RM; if (IDIV (mb)) { WR1; S2AC; } NEXT_OP;  /* IDIVB */
+OP (0234):  RD; if (DIV (mb)) S2AC; NEXT_OP;            /* DIV */
+OP (0235):  if (DIV (IM)) S2AC; NEXT_OP;                /* DIVI */
+OP (0236):  RM; if (DIV (mb)) WR1; NEXT_OP;             /* DIVM */
+OP (0237):  RM; if (DIV (mb)) { WR1; S2AC; } NEXT_OP;   /* DIVB */
+OP (0240):  AC(ac) = ash (AC(ac), ea); NEXT_OP;         /* ASH */
+OP (0241):  AC(ac) = rot (AC(ac), ea); NEXT_OP;         /* ROT */
+OP (0242):  AC(ac) = lsh (AC(ac), ea); NEXT_OP;         /* LSH */
+OP (0243):  AC(P1) = jffo (AC(ac));                     /* JFFO */
             if (AC(ac)) JUMP (ea);
-            break;
-case 0244:  ashc (ac, ea); break;                       /* ASHC */
-case 0245:  rotc (ac, ea); break;                       /* ROTC */
-case 0246:  lshc (ac, ea); break;                       /* LSHC */
-case 0247:  if (Q_ITS) circ (ac, ea); break;            /* (ITS) CIRC */
-case 0250:  RM; WRAC; AC(ac) = mb; break;               /* EXCH */
-case 0251:  blt (ac, ea, pflgs); break;                 /* BLT */
-case 0252:  AOBAC; if (TGE (AC(ac))) JUMP (ea); break;  /* AOBJP */
-case 0253:  AOBAC; if (TL (AC(ac))) JUMP (ea); break;   /* AOBJN */
+            NEXT_OP;
+OP (0244):  ashc (ac, ea); NEXT_OP;                     /* ASHC */
+OP (0245):  rotc (ac, ea); NEXT_OP;                     /* ROTC */
+OP (0246):  lshc (ac, ea); NEXT_OP;                     /* LSHC */
+OP (0247):  if (Q_ITS) circ (ac, ea); NEXT_OP;          /* (ITS) CIRC */
+OP (0250):  RM; WRAC; AC(ac) = mb; NEXT_OP;             /* EXCH */
+OP (0251):  blt (ac, ea, pflgs); NEXT_OP;               /* BLT */
+OP (0252):  AOBAC; if (TGE (AC(ac))) JUMP (ea); NEXT_OP;  /* AOBJP */
+OP (0253):  AOBAC; if (TL (AC(ac))) JUMP (ea); NEXT_OP; /* AOBJN */
 /* case 0254: *//* shown later                        *//* JRST */
-case 0255:  if (flags & (ac << 14)) {                   /* JFCL */
+OP (0255):  if (flags & (ac << 14)) {                   /* JFCL */
                 JUMP (ea);
                 CLRF (ac << 14);
                 }
-            break;
-case 0256:  if (xct_cnt++ >= xct_max)                   /* XCT */
+            NEXT_OP;
+OP (0256):  if (xct_cnt++ >= xct_max)                   /* XCT */
                 ABORT (STOP_XCT);
             inst = Read (ea, MM_OPND);
             if (ac && !TSTF (F_USR) && !Q_ITS)
                 pflgs = pflgs | ac;
             goto XCT;
-case 0257:  if (Q_ITS) goto MUUO;                       /* MAP */
+OP (0257):  if (Q_ITS) goto MUUO;                       /* MAP */
             AC(ac) = map (ea, MM_OPND);
-            break;
-case 0260:  WRP (FLPC); AOBAC;                          /* PUSHJ */
-            SUBJ (ea); PUSHF; break;
-case 0261:  RD; WRP (mb); AOBAC; PUSHF; break;          /* PUSH */
-case 0262:  RDP; WR; SOBAC; POPF; break;                /* POP */
-case 0263:  RDP; JUMP (mb); SOBAC; POPF; break;         /* POPJ */
-case 0264:  Write (ea, FLPC, MM_OPND);                  /* JSR */
-            SUBJ (INCR (ea)); break;
-case 0265:  AC(ac) = FLPC; SUBJ (ea); break;            /* JSP */
-case 0266:  WRAC; AC(ac) = XWD (ea, PC);                /* JSA */
-            JUMP (INCR (ea)); break;
-case 0267:  AC(ac) = Read ((a10) LRZ (AC(ac)), MM_OPND);/* JRA */
-            JUMP (ea); break;
-case 0270:  RD; AC(ac) = ADD (mb); break;               /* ADD */
-case 0271:  AC(ac) = ADD (IM); break;                   /* ADDI */
-case 0272:  RM; mb = ADD (mb); WR; break;               /* ADDM */
-case 0273:  RM; AC(ac) = ADD (mb); WRAC; break;         /* ADDB */
-case 0274:  RD; AC(ac) = SUB (mb); break;               /* SUB */
-case 0275:  AC(ac) = SUB (IM); break;                   /* SUBI */
-case 0276:  RM; mb = SUB (mb); WR; break;               /* SUBM */
-case 0277:  RM; AC(ac) = SUB (mb); WRAC; break;         /* SUBB */
+            NEXT_OP;
+OP (0260):  WRP (FLPC); AOBAC;                          /* PUSHJ */
+            SUBJ (ea); PUSHF; NEXT_OP;
+OP (0261):  RD; WRP (mb); AOBAC; PUSHF; NEXT_OP;        /* PUSH */
+OP (0262):  RDP; WR; SOBAC; POPF; NEXT_OP;              /* POP */
+OP (0263):  RDP; JUMP (mb); SOBAC; POPF; NEXT_OP;       /* POPJ */
+OP (0264):  Write (ea, FLPC, MM_OPND);                  /* JSR */
+            SUBJ (INCR (ea)); NEXT_OP;
+OP (0265):  AC(ac) = FLPC; SUBJ (ea); NEXT_OP;          /* JSP */
+OP (0266):  WRAC; AC(ac) = XWD (ea, PC);                /* JSA */
+            JUMP (INCR (ea)); NEXT_OP;
+OP (0267):  AC(ac) = Read ((a10) LRZ (AC(ac)), MM_OPND);/* JRA */
+            JUMP (ea); NEXT_OP;
+OP (0270):  RD; AC(ac) = ADD (mb); NEXT_OP;             /* ADD */
+OP (0271):  AC(ac) = ADD (IM); NEXT_OP;                 /* ADDI */
+OP (0272):  RM; mb = ADD (mb); WR; NEXT_OP;             /* ADDM */
+OP (0273):  RM; AC(ac) = ADD (mb); WRAC; NEXT_OP;       /* ADDB */
+OP (0274):  RD; AC(ac) = SUB (mb); NEXT_OP;             /* SUB */
+OP (0275):  AC(ac) = SUB (IM); NEXT_OP;                 /* SUBI */
+OP (0276):  RM; mb = SUB (mb); WR; NEXT_OP;             /* SUBM */
+OP (0277):  RM; AC(ac) = SUB (mb); WRAC; NEXT_OP;       /* SUBB */
 
 /* Compare, jump, skip instructions (0300 - 0377) - checked against KS10 ucode */
 
-case 0300:  break;                                      /* CAI */
-case 0301:  if (CL (IM)) INCPC; break;                  /* CAIL */
-case 0302:  if (CE (IM)) INCPC; break;                  /* CAIE */
-case 0303:  if (CLE (IM)) INCPC; break;                 /* CAILE */
-case 0304:  INCPC; break;                               /* CAIA */
-case 0305:  if (CGE (IM)) INCPC; break;                 /* CAIGE */
-case 0306:  if (CN (IM)) INCPC; break;                  /* CAIN */
-case 0307:  if (CG (IM)) INCPC; break;                  /* CAIG */
-case 0310:  RD; break;                                  /* CAM */
-case 0311:  RD; if (CL (mb)) INCPC; break;              /* CAML */
-case 0312:  RD; if (CE (mb)) INCPC; break;              /* CAME */
-case 0313:  RD; if (CLE (mb)) INCPC; break;             /* CAMLE */
-case 0314:  RD; INCPC; break;                           /* CAMA */
-case 0315:  RD; if (CGE (mb)) INCPC; break;             /* CAMGE */
-case 0316:  RD; if (CN (mb)) INCPC; break;              /* CAMN */
-case 0317:  RD; if (CG (mb)) INCPC; break;              /* CAMG */
-case 0320:  break;                                      /* JUMP */
-case 0321:  if (TL (AC(ac))) JUMP (ea); break;          /* JUMPL */
-case 0322:  if (TE (AC(ac))) JUMP (ea); break;          /* JUMPE */
-case 0323:  if (TLE( AC(ac))) JUMP (ea); break;         /* JUMPLE */
-case 0324:  JUMP (ea); break;                           /* JUMPA */
-case 0325:  if (TGE (AC(ac))) JUMP (ea); break;         /* JUMPGE */
-case 0326:  if (TN (AC(ac))) JUMP (ea); break;          /* JUMPN */
-case 0327:  if (TG (AC(ac))) JUMP (ea); break;          /* JUMPG */
-case 0330:  RD; LAC; break;                             /* SKIP */
-case 0331:  RD; LAC; if (TL (mb)) INCPC; break;         /* SKIPL */
-case 0332:  RD; LAC; if (TE (mb)) INCPC; break;         /* SKIPE */
-case 0333:  RD; LAC; if (TLE (mb)) INCPC; break;        /* SKIPLE */
-case 0334:  RD; LAC; INCPC; break;                      /* SKIPA */
-case 0335:  RD; LAC; if (TGE (mb)) INCPC; break;        /* SKIPGE */
-case 0336:  RD; LAC; if (TN (mb)) INCPC; break;         /* SKIPN */
-case 0337:  RD; LAC; if (TG (mb)) INCPC; break;         /* SKIPG */
-case 0340:  AOJ; break;                                 /* AOJ */
-case 0341:  AOJ; if (TL (AC(ac))) JUMP (ea); break;     /* AOJL */
-case 0342:  AOJ; if (TE (AC(ac))) JUMP (ea); break;     /* AOJE */
-case 0343:  AOJ; if (TLE (AC(ac))) JUMP (ea); break;    /* AOJLE */
-case 0344:  AOJ; JUMP(ea);                              /* AOJA */
+OP (0300):  NEXT_OP;                                    /* CAI */
+OP (0301):  if (CL (IM)) INCPC; NEXT_OP;                /* CAIL */
+OP (0302):  if (CE (IM)) INCPC; NEXT_OP;                /* CAIE */
+OP (0303):  if (CLE (IM)) INCPC; NEXT_OP;               /* CAILE */
+OP (0304):  INCPC; NEXT_OP;                             /* CAIA */
+OP (0305):  if (CGE (IM)) INCPC; NEXT_OP;               /* CAIGE */
+OP (0306):  if (CN (IM)) INCPC; NEXT_OP;                /* CAIN */
+OP (0307):  if (CG (IM)) INCPC; NEXT_OP;                /* CAIG */
+OP (0310):  RD; NEXT_OP;                                /* CAM */
+OP (0311):  RD; if (CL (mb)) INCPC; NEXT_OP;            /* CAML */
+OP (0312):  RD; if (CE (mb)) INCPC; NEXT_OP;            /* CAME */
+OP (0313):  RD; if (CLE (mb)) INCPC; NEXT_OP;           /* CAMLE */
+OP (0314):  RD; INCPC; NEXT_OP;                         /* CAMA */
+OP (0315):  RD; if (CGE (mb)) INCPC; NEXT_OP;           /* CAMGE */
+OP (0316):  RD; if (CN (mb)) INCPC; NEXT_OP;            /* CAMN */
+OP (0317):  RD; if (CG (mb)) INCPC; NEXT_OP;            /* CAMG */
+OP (0320):  NEXT_OP;                                    /* JUMP */
+OP (0321):  if (TL (AC(ac))) JUMP (ea); NEXT_OP;        /* JUMPL */
+OP (0322):  if (TE (AC(ac))) JUMP (ea); NEXT_OP;        /* JUMPE */
+OP (0323):  if (TLE( AC(ac))) JUMP (ea); NEXT_OP;       /* JUMPLE */
+OP (0324):  JUMP (ea); NEXT_OP;                         /* JUMPA */
+OP (0325):  if (TGE (AC(ac))) JUMP (ea); NEXT_OP;       /* JUMPGE */
+OP (0326):  if (TN (AC(ac))) JUMP (ea); NEXT_OP;        /* JUMPN */
+OP (0327):  if (TG (AC(ac))) JUMP (ea); NEXT_OP;        /* JUMPG */
+OP (0330):  RD; LAC; NEXT_OP;                           /* SKIP */
+OP (0331):  RD; LAC; if (TL (mb)) INCPC; NEXT_OP;       /* SKIPL */
+OP (0332):  RD; LAC; if (TE (mb)) INCPC; NEXT_OP;       /* SKIPE */
+OP (0333):  RD; LAC; if (TLE (mb)) INCPC; NEXT_OP;      /* SKIPLE */
+OP (0334):  RD; LAC; INCPC; NEXT_OP;                    /* SKIPA */
+OP (0335):  RD; LAC; if (TGE (mb)) INCPC; NEXT_OP;      /* SKIPGE */
+OP (0336):  RD; LAC; if (TN (mb)) INCPC; NEXT_OP;       /* SKIPN */
+OP (0337):  RD; LAC; if (TG (mb)) INCPC; NEXT_OP;       /* SKIPG */
+OP (0340):  AOJ; NEXT_OP;                               /* AOJ */
+OP (0341):  AOJ; if (TL (AC(ac))) JUMP (ea); NEXT_OP;   /* AOJL */
+OP (0342):  AOJ; if (TE (AC(ac))) JUMP (ea); NEXT_OP;   /* AOJE */
+OP (0343):  AOJ; if (TLE (AC(ac))) JUMP (ea); NEXT_OP;  /* AOJLE */
+OP (0344):  AOJ; JUMP(ea);                              /* AOJA */
             if (Q_ITS && Q_IDLE &&                      /* ITS idle? */
                 TSTF (F_USR) && (pager_PC == 017) &&    /* user mode, loc 17? */
                 (ac == 0) && (ea == 017))               /* AOJA 0,17? */
                 sim_idle (0, FALSE);
-            break;
-case 0345:  AOJ; if (TGE (AC(ac))) JUMP (ea); break;    /* AOJGE */
-case 0346:  AOJ; if (TN (AC(ac))) JUMP (ea); break;     /* AOJN */
-case 0347:  AOJ; if (TG (AC(ac))) JUMP (ea); break;     /* AOJG */
-case 0350:  AOS; break;                                 /* AOS */
-case 0351:  AOS; if (TL (mb)) INCPC; break;             /* AOSL */
-case 0352:  AOS; if (TE (mb)) INCPC; break;             /* AOSE */
-case 0353:  AOS; if (TLE (mb)) INCPC; break;            /* AOSLE */
-case 0354:  AOS; INCPC; break;                          /* AOSA */
-case 0355:  AOS; if (TGE (mb)) INCPC; break;            /* AOSGE */
-case 0356:  AOS; if (TN (mb)) INCPC; break;             /* AOSN */
-case 0357:  AOS; if (TG (mb)) INCPC; break;             /* AOSG */
-case 0360:  SOJ; break;                                 /* SOJ */
-case 0361:  SOJ; if (TL (AC(ac))) JUMP (ea); break;     /* SOJL */
-case 0362:  SOJ; if (TE (AC(ac))) JUMP (ea); break;     /* SOJE */
-case 0363:  SOJ; if (TLE (AC(ac))) JUMP (ea); break;    /* SOJLE */
-case 0364:  SOJ; JUMP(ea); break;                       /* SOJA */
-case 0365:  SOJ; if (TGE (AC(ac))) JUMP (ea); break;    /* SOJGE */
-case 0366:  SOJ; if (TN (AC(ac))) JUMP (ea); break;     /* SOJN */
-case 0367:  SOJ; if (TG (AC(ac))) JUMP (ea);            /* SOJG */
+            NEXT_OP;
+OP (0345):  AOJ; if (TGE (AC(ac))) JUMP (ea); NEXT_OP;  /* AOJGE */
+OP (0346):  AOJ; if (TN (AC(ac))) JUMP (ea); NEXT_OP;   /* AOJN */
+OP (0347):  AOJ; if (TG (AC(ac))) JUMP (ea); NEXT_OP;   /* AOJG */
+OP (0350):  AOS; NEXT_OP;                               /* AOS */
+OP (0351):  AOS; if (TL (mb)) INCPC; NEXT_OP;           /* AOSL */
+OP (0352):  AOS; if (TE (mb)) INCPC; NEXT_OP;           /* AOSE */
+OP (0353):  AOS; if (TLE (mb)) INCPC; NEXT_OP;          /* AOSLE */
+OP (0354):  AOS; INCPC; NEXT_OP;                        /* AOSA */
+OP (0355):  AOS; if (TGE (mb)) INCPC; NEXT_OP;          /* AOSGE */
+OP (0356):  AOS; if (TN (mb)) INCPC; NEXT_OP;           /* AOSN */
+OP (0357):  AOS; if (TG (mb)) INCPC; NEXT_OP;           /* AOSG */
+OP (0360):  SOJ; NEXT_OP;                               /* SOJ */
+OP (0361):  SOJ; if (TL (AC(ac))) JUMP (ea); NEXT_OP;   /* SOJL */
+OP (0362):  SOJ; if (TE (AC(ac))) JUMP (ea); NEXT_OP;   /* SOJE */
+OP (0363):  SOJ; if (TLE (AC(ac))) JUMP (ea); NEXT_OP;  /* SOJLE */
+OP (0364):  SOJ; JUMP(ea); NEXT_OP;                     /* SOJA */
+OP (0365):  SOJ; if (TGE (AC(ac))) JUMP (ea); NEXT_OP;  /* SOJGE */
+OP (0366):  SOJ; if (TN (AC(ac))) JUMP (ea); NEXT_OP;   /* SOJN */
+OP (0367):  SOJ; if (TG (AC(ac))) JUMP (ea);            /* SOJG */
             if ((ea == pager_PC) && Q_IDLE) {           /* to self, idle enab? */
                 extern int32 tmr_poll;
                 if ((ac == 6) && (ea == 1) &&           /* SOJG 6,1? */
@@ -1168,15 +1340,15 @@ case 0367:  SOJ; if (TG (AC(ac))) JUMP (ea);            /* SOJG */
                         sim_interval = 0;               /* if ok, sched event */
                     }
                 }                    
-            break;
-case 0370:  SOS; break;                                 /* SOS */
-case 0371:  SOS; if (TL (mb)) INCPC; break;             /* SOSL */
-case 0372:  SOS; if (TE (mb)) INCPC; break;             /* SOSE */
-case 0373:  SOS; if (TLE (mb)) INCPC; break;            /* SOSLE */
-case 0374:  SOS; INCPC; break;                          /* SOSA */
-case 0375:  SOS; if (TGE (mb)) INCPC; break;            /* SOSGE */
-case 0376:  SOS; if (TN (mb)) INCPC; break;             /* SOSN */
-case 0377:  SOS; if (TG (mb)) INCPC; break;             /* SOSG */
+            NEXT_OP;
+OP (0370):  SOS; NEXT_OP;                               /* SOS */
+OP (0371):  SOS; if (TL (mb)) INCPC; NEXT_OP;           /* SOSL */
+OP (0372):  SOS; if (TE (mb)) INCPC; NEXT_OP;           /* SOSE */
+OP (0373):  SOS; if (TLE (mb)) INCPC; NEXT_OP;          /* SOSLE */
+OP (0374):  SOS; INCPC; NEXT_OP;                        /* SOSA */
+OP (0375):  SOS; if (TGE (mb)) INCPC; NEXT_OP;          /* SOSGE */
+OP (0376):  SOS; if (TN (mb)) INCPC; NEXT_OP;           /* SOSN */
+OP (0377):  SOS; if (TG (mb)) INCPC; NEXT_OP;           /* SOSG */
 
 /* Boolean instructions (0400 - 0477) - checked against KS10 ucode
 
@@ -1184,207 +1356,207 @@ case 0377:  SOS; if (TG (mb)) INCPC; break;             /* SOSG */
    the memory operand; hence, it is safe to modify the AC.
 */
 
-case 0400:  AC(ac) = 0; break;                          /* SETZ */
-case 0401:  AC(ac) = 0; break;                          /* SETZI */
-case 0402:  mb = 0; WR; break;                          /* SETZM */
-case 0403:  mb = 0; WR; AC(ac) = 0; break;              /* SETZB */
-case 0404:  RD; AC(ac) = AND (mb); break;               /* AND */
-case 0405:  AC(ac) = AND (IM); break;                   /* ANDI */
-case 0406:  RM; mb = AND (mb); WR; break;               /* ANDM */
-case 0407:  RM; AC(ac) = AND (mb); WRAC; break;         /* ANDB */
-case 0410:  RD; AC(ac) = ANDCA (mb); break;             /* ANDCA */
-case 0411:  AC(ac) = ANDCA (IM); break;                 /* ANDCAI */
-case 0412:  RM; mb = ANDCA (mb); WR; break;             /* ANDCAM */
-case 0413:  RM; AC(ac) = ANDCA (mb); WRAC; break;       /* ANDCAB */
-case 0414:  RDAC; break;                                /* SETM */
-case 0415:  AC(ac) = ea; break;                         /* SETMI */
-case 0416:  RM; WR; break;                              /* SETMM */
-case 0417:  RMAC; WRAC; break;                          /* SETMB */
-case 0420:  RD; AC(ac) = ANDCM (mb); break;             /* ANDCM */
-case 0421:  AC(ac) = ANDCM (IM); break;                 /* ANDCMI */
-case 0422:  RM; mb = ANDCM (mb); WR; break;             /* ANDCMM */
-case 0423:  RM; AC(ac) = ANDCM (mb); WRAC; break;       /* ANDCMB */
-case 0424:  break;                                      /* SETA */
-case 0425:  break;                                      /* SETAI */
-case 0426:  WRAC; break;                                /* SETAM */
-case 0427:  WRAC; break;                                /* SETAB */
-case 0430:  RD; AC(ac) = XOR (mb); break;               /* XOR */
-case 0431:  AC(ac) = XOR (IM); break;                   /* XORI */
-case 0432:  RM; mb = XOR (mb); WR; break;               /* XORM */
-case 0433:  RM; AC(ac) = XOR (mb); WRAC; break;         /* XORB */
-case 0434:  RD; AC(ac) = IOR (mb); break;               /* IOR */
-case 0435:  AC(ac) = IOR (IM); break;                   /* IORI */
-case 0436:  RM; mb = IOR (mb); WR; break;               /* IORM */
-case 0437:  RM; AC(ac) = IOR (mb); WRAC; break;         /* IORB */
-case 0440:  RD; AC(ac) = ANDCB (mb); break;             /* ANDCB */
-case 0441:  AC(ac) = ANDCB (IM); break;                 /* ANDCBI */
-case 0442:  RM; mb = ANDCB (mb); WR; break;             /* ANDCBM */
-case 0443:  RM; AC(ac) = ANDCB (mb); WRAC; break;       /* ANDCBB */
-case 0444:  RD; AC(ac) = EQV (mb); break;               /* EQV */
-case 0445:  AC(ac) = EQV (IM); break;                   /* EQVI */
-case 0446:  RM; mb = EQV (mb); WR; break;               /* EQVM */
-case 0447:  RM; AC(ac) = EQV (mb); WRAC; break;         /* EQVB */
-case 0450:  RD; AC(ac) = SETCA (mb); break;             /* SETCA */
-case 0451:  AC(ac) = SETCA (IM); break;                 /* SETCAI */
-case 0452:  RM; mb = SETCA (mb); WR; break;             /* SETCAM */
-case 0453:  RM; AC(ac) = SETCA (mb); WRAC; break;       /* SETCAB */
-case 0454:  RD; AC(ac) = ORCA (mb); break;              /* ORCA */
-case 0455:  AC(ac) = ORCA (IM); break;                  /* ORCAI */
-case 0456:  RM; mb = ORCA (mb); WR; break;              /* ORCAM */
-case 0457:  RM; AC(ac) = ORCA (mb); WRAC; break;        /* ORCAB */
-case 0460:  RD; AC(ac) = SETCM (mb); break;             /* SETCM */
-case 0461:  AC(ac) = SETCM (IM); break;                 /* SETCMI */
-case 0462:  RM; mb = SETCM (mb); WR; break;             /* SETCMM */
-case 0463:  RM; AC(ac) = SETCM (mb); WRAC; break;       /* SETCMB */
-case 0464:  RD; AC(ac) = ORCM (mb); break;              /* ORCM */
-case 0465:  AC(ac) = ORCM (IM); break;                  /* ORCMI */
-case 0466:  RM; mb = ORCM (mb); WR; break;              /* ORCMM */
-case 0467:  RM; AC(ac) = ORCM (mb); WRAC; break;        /* ORCMB */
-case 0470:  RD; AC(ac) = ORCB (mb); break;              /* ORCB */
-case 0471:  AC(ac) = ORCB (IM); break;                  /* ORCBI */
-case 0472:  RM; mb = ORCB (mb); WR; break;              /* ORCBM */
-case 0473:  RM; AC(ac) = ORCB (mb); WRAC; break;        /* ORCBB */
-case 0474:  AC(ac) = ONES; break;                       /* SETO */
-case 0475:  AC(ac) = ONES; break;                       /* SETOI */
-case 0476:  mb = ONES; WR; break;                       /* SETOM */
-case 0477:  mb = ONES; WR; AC(ac) = ONES; break;        /* SETOB */
+OP (0400):  AC(ac) = 0; NEXT_OP;                        /* SETZ */
+OP (0401):  AC(ac) = 0; NEXT_OP;                        /* SETZI */
+OP (0402):  mb = 0; WR; NEXT_OP;                        /* SETZM */
+OP (0403):  mb = 0; WR; AC(ac) = 0; NEXT_OP;            /* SETZB */
+OP (0404):  RD; AC(ac) = AND (mb); NEXT_OP;             /* AND */
+OP (0405):  AC(ac) = AND (IM); NEXT_OP;                 /* ANDI */
+OP (0406):  RM; mb = AND (mb); WR; NEXT_OP;             /* ANDM */
+OP (0407):  RM; AC(ac) = AND (mb); WRAC; NEXT_OP;       /* ANDB */
+OP (0410):  RD; AC(ac) = ANDCA (mb); NEXT_OP;           /* ANDCA */
+OP (0411):  AC(ac) = ANDCA (IM); NEXT_OP;               /* ANDCAI */
+OP (0412):  RM; mb = ANDCA (mb); WR; NEXT_OP;           /* ANDCAM */
+OP (0413):  RM; AC(ac) = ANDCA (mb); WRAC; NEXT_OP;     /* ANDCAB */
+OP (0414):  RDAC; NEXT_OP;                              /* SETM */
+OP (0415):  AC(ac) = ea; NEXT_OP;                       /* SETMI */
+OP (0416):  RM; WR; NEXT_OP;                            /* SETMM */
+OP (0417):  RMAC; WRAC; NEXT_OP;                        /* SETMB */
+OP (0420):  RD; AC(ac) = ANDCM (mb); NEXT_OP;           /* ANDCM */
+OP (0421):  AC(ac) = ANDCM (IM); NEXT_OP;               /* ANDCMI */
+OP (0422):  RM; mb = ANDCM (mb); WR; NEXT_OP;           /* ANDCMM */
+OP (0423):  RM; AC(ac) = ANDCM (mb); WRAC; NEXT_OP;     /* ANDCMB */
+OP (0424):  NEXT_OP;                                    /* SETA */
+OP (0425):  NEXT_OP;                                    /* SETAI */
+OP (0426):  WRAC; NEXT_OP;                              /* SETAM */
+OP (0427):  WRAC; NEXT_OP;                              /* SETAB */
+OP (0430):  RD; AC(ac) = XOR (mb); NEXT_OP;             /* XOR */
+OP (0431):  AC(ac) = XOR (IM); NEXT_OP;                 /* XORI */
+OP (0432):  RM; mb = XOR (mb); WR; NEXT_OP;             /* XORM */
+OP (0433):  RM; AC(ac) = XOR (mb); WRAC; NEXT_OP;       /* XORB */
+OP (0434):  RD; AC(ac) = IOR (mb); NEXT_OP;             /* IOR */
+OP (0435):  AC(ac) = IOR (IM); NEXT_OP;                 /* IORI */
+OP (0436):  RM; mb = IOR (mb); WR; NEXT_OP;             /* IORM */
+OP (0437):  RM; AC(ac) = IOR (mb); WRAC; NEXT_OP;       /* IORB */
+OP (0440):  RD; AC(ac) = ANDCB (mb); NEXT_OP;           /* ANDCB */
+OP (0441):  AC(ac) = ANDCB (IM); NEXT_OP;               /* ANDCBI */
+OP (0442):  RM; mb = ANDCB (mb); WR; NEXT_OP;           /* ANDCBM */
+OP (0443):  RM; AC(ac) = ANDCB (mb); WRAC; NEXT_OP;     /* ANDCBB */
+OP (0444):  RD; AC(ac) = EQV (mb); NEXT_OP;             /* EQV */
+OP (0445):  AC(ac) = EQV (IM); NEXT_OP;                 /* EQVI */
+OP (0446):  RM; mb = EQV (mb); WR; NEXT_OP;             /* EQVM */
+OP (0447):  RM; AC(ac) = EQV (mb); WRAC; NEXT_OP;       /* EQVB */
+OP (0450):  RD; AC(ac) = SETCA (mb); NEXT_OP;           /* SETCA */
+OP (0451):  AC(ac) = SETCA (IM); NEXT_OP;               /* SETCAI */
+OP (0452):  RM; mb = SETCA (mb); WR; NEXT_OP;           /* SETCAM */
+OP (0453):  RM; AC(ac) = SETCA (mb); WRAC; NEXT_OP;     /* SETCAB */
+OP (0454):  RD; AC(ac) = ORCA (mb); NEXT_OP;            /* ORCA */
+OP (0455):  AC(ac) = ORCA (IM); NEXT_OP;                /* ORCAI */
+OP (0456):  RM; mb = ORCA (mb); WR; NEXT_OP;            /* ORCAM */
+OP (0457):  RM; AC(ac) = ORCA (mb); WRAC; NEXT_OP;      /* ORCAB */
+OP (0460):  RD; AC(ac) = SETCM (mb); NEXT_OP;           /* SETCM */
+OP (0461):  AC(ac) = SETCM (IM); NEXT_OP;               /* SETCMI */
+OP (0462):  RM; mb = SETCM (mb); WR; NEXT_OP;           /* SETCMM */
+OP (0463):  RM; AC(ac) = SETCM (mb); WRAC; NEXT_OP;     /* SETCMB */
+OP (0464):  RD; AC(ac) = ORCM (mb); NEXT_OP;            /* ORCM */
+OP (0465):  AC(ac) = ORCM (IM); NEXT_OP;                /* ORCMI */
+OP (0466):  RM; mb = ORCM (mb); WR; NEXT_OP;            /* ORCMM */
+OP (0467):  RM; AC(ac) = ORCM (mb); WRAC; NEXT_OP;      /* ORCMB */
+OP (0470):  RD; AC(ac) = ORCB (mb); NEXT_OP;            /* ORCB */
+OP (0471):  AC(ac) = ORCB (IM); NEXT_OP;                /* ORCBI */
+OP (0472):  RM; mb = ORCB (mb); WR; NEXT_OP;            /* ORCBM */
+OP (0473):  RM; AC(ac) = ORCB (mb); WRAC; NEXT_OP;      /* ORCBB */
+OP (0474):  AC(ac) = ONES; NEXT_OP;                     /* SETO */
+OP (0475):  AC(ac) = ONES; NEXT_OP;                     /* SETOI */
+OP (0476):  mb = ONES; WR; NEXT_OP;                     /* SETOM */
+OP (0477):  mb = ONES; WR; AC(ac) = ONES; NEXT_OP;      /* SETOB */
 
 /* Halfword instructions (0500 - 0577) - checked against KS10 ucode */
 
-case 0500:  RD; AC(ac) = LL (mb, AC(ac)); break;        /* HLL */
-case 0501:  AC(ac) = LL (IM, AC(ac)); break;            /* HLLI */
-case 0502:  RM; mb = LL (AC(ac), mb); WR; break;        /* HLLM */
-case 0503:  RM; mb = LL (mb, mb); WR; LAC; break;       /* HLLS */
-case 0504:  RD; AC(ac) = RL (mb, AC(ac)); break;        /* HRL */
-case 0505:  AC(ac) = RL (IM, AC(ac)); break;            /* HRLI */
-case 0506:  RM; mb = RL (AC(ac), mb); WR; break;        /* HRLM */
-case 0507:  RM; mb = RL (mb, mb); WR; LAC; break;       /* HRLS */
-case 0510:  RD; AC(ac) = LLZ (mb); break;               /* HLLZ */
-case 0511:  AC(ac) = LLZ (IM); break;                   /* HLLZI */
-case 0512:  mb = LLZ (AC(ac)); WR; break;               /* HLLZM */
-case 0513:  RM; mb = LLZ (mb); WR; LAC; break;          /* HLLZS */
-case 0514:  RD; AC(ac) = RLZ (mb); break;               /* HRLZ */
-case 0515:  AC(ac) = RLZ (IM); break;                   /* HRLZI */
-case 0516:  mb = RLZ (AC(ac)); WR; break;               /* HRLZM */
-case 0517:  RM; mb = RLZ (mb); WR; LAC; break;          /* HRLZS */
-case 0520:  RD; AC(ac) = LLO (mb); break;               /* HLLO */
-case 0521:  AC(ac) = LLO (IM); break;                   /* HLLOI */
-case 0522:  mb = LLO (AC(ac)); WR; break;               /* HLLOM */
-case 0523:  RM; mb = LLO (mb); WR; LAC; break;          /* HLLOS */
-case 0524:  RD; AC(ac) = RLO (mb); break;               /* HRLO */
-case 0525:  AC(ac) = RLO (IM); break;                   /* HRLOI */
-case 0526:  mb = RLO (AC(ac)); WR; break;               /* HRLOM */
-case 0527:  RM; mb = RLO (mb); WR; LAC; break;          /* HRLOS */
-case 0530:  RD; AC(ac) = LLE (mb); break;               /* HLLE */
-case 0531:  AC(ac) = LLE (IM); break;                   /* HLLEI */
-case 0532:  mb = LLE (AC(ac)); WR; break;               /* HLLEM */
-case 0533:  RM; mb = LLE (mb); WR; LAC; break;          /* HLLES */
-case 0534:  RD; AC(ac) = RLE (mb); break;               /* HRLE */
-case 0535:  AC(ac) = RLE (IM); break;                   /* HRLEI */
-case 0536:  mb = RLE (AC(ac)); WR; break;               /* HRLEM */
-case 0537:  RM; mb = RLE (mb); WR; LAC; break;          /* HRLES */
-case 0540:  RD; AC(ac) = RR (mb, AC(ac)); break;        /* HRR */
-case 0541:  AC(ac) = RR (IM, AC(ac)); break;            /* HRRI */
-case 0542:  RM; mb = RR (AC(ac), mb); WR; break;        /* HRRM */
-case 0543:  RM; mb = RR (mb, mb); WR; LAC; break;       /* HRRS */
-case 0544:  RD; AC(ac) = LR (mb, AC(ac)); break;        /* HLR */
-case 0545:  AC(ac) = LR (IM, AC(ac)); break;            /* HLRI */
-case 0546:  RM; mb = LR (AC(ac), mb); WR; break;        /* HLRM */
-case 0547:  RM; mb = LR (mb, mb); WR; LAC; break;       /* HLRS */
-case 0550:  RD; AC(ac) = RRZ (mb); break;               /* HRRZ */
-case 0551:  AC(ac) = RRZ (IM); break;                   /* HRRZI */
-case 0552:  mb = RRZ (AC(ac)); WR; break;               /* HRRZM */
-case 0553:  RM; mb = RRZ(mb); WR; LAC; break;           /* HRRZS */
-case 0554:  RD; AC(ac) = LRZ (mb); break;               /* HLRZ */
-case 0555:  AC(ac) = LRZ (IM); break;                   /* HLRZI */
-case 0556:  mb = LRZ (AC(ac)); WR; break;               /* HLRZM */
-case 0557:  RM; mb = LRZ (mb); WR; LAC; break;          /* HLRZS */
-case 0560:  RD; AC(ac) = RRO (mb); break;               /* HRRO */
-case 0561:  AC(ac) = RRO (IM); break;                   /* HRROI */
-case 0562:  mb = RRO (AC(ac)); WR; break;               /* HRROM */
-case 0563:  RM; mb = RRO (mb); WR; LAC; break;          /* HRROS */
-case 0564:  RD; AC(ac) = LRO (mb); break;               /* HLRO */
-case 0565:  AC(ac) = LRO (IM); break;                   /* HLROI */
-case 0566:  mb = LRO (AC(ac)); WR; break;               /* HLROM */
-case 0567:  RM; mb = LRO (mb); WR; LAC; break;          /* HLROS */
-case 0570:  RD; AC(ac) = RRE (mb); break;               /* HRRE */
-case 0571:  AC(ac) = RRE (IM); break;                   /* HRREI */
-case 0572:  mb = RRE (AC(ac)); WR; break;               /* HRREM */
-case 0573:  RM; mb = RRE (mb); WR; LAC; break;          /* HRRES */
-case 0574:  RD; AC(ac) = LRE (mb); break;               /* HLRE */
-case 0575:  AC(ac) = LRE (IM); break;                   /* HLREI */
-case 0576:  mb = LRE (AC(ac)); WR; break;               /* HLREM */
-case 0577:  RM; mb = LRE (mb); WR; LAC; break;          /* HLRES */
+OP (0500):  RD; AC(ac) = LL (mb, AC(ac)); NEXT_OP;      /* HLL */
+OP (0501):  AC(ac) = LL (IM, AC(ac)); NEXT_OP;          /* HLLI */
+OP (0502):  RM; mb = LL (AC(ac), mb); WR; NEXT_OP;      /* HLLM */
+OP (0503):  RM; mb = LL (mb, mb); WR; LAC; NEXT_OP;     /* HLLS */
+OP (0504):  RD; AC(ac) = RL (mb, AC(ac)); NEXT_OP;      /* HRL */
+OP (0505):  AC(ac) = RL (IM, AC(ac)); NEXT_OP;          /* HRLI */
+OP (0506):  RM; mb = RL (AC(ac), mb); WR; NEXT_OP;      /* HRLM */
+OP (0507):  RM; mb = RL (mb, mb); WR; LAC; NEXT_OP;     /* HRLS */
+OP (0510):  RD; AC(ac) = LLZ (mb); NEXT_OP;             /* HLLZ */
+OP (0511):  AC(ac) = LLZ (IM); NEXT_OP;                 /* HLLZI */
+OP (0512):  mb = LLZ (AC(ac)); WR; NEXT_OP;             /* HLLZM */
+OP (0513):  RM; mb = LLZ (mb); WR; LAC; NEXT_OP;        /* HLLZS */
+OP (0514):  RD; AC(ac) = RLZ (mb); NEXT_OP;             /* HRLZ */
+OP (0515):  AC(ac) = RLZ (IM); NEXT_OP;                 /* HRLZI */
+OP (0516):  mb = RLZ (AC(ac)); WR; NEXT_OP;             /* HRLZM */
+OP (0517):  RM; mb = RLZ (mb); WR; LAC; NEXT_OP;        /* HRLZS */
+OP (0520):  RD; AC(ac) = LLO (mb); NEXT_OP;             /* HLLO */
+OP (0521):  AC(ac) = LLO (IM); NEXT_OP;                 /* HLLOI */
+OP (0522):  mb = LLO (AC(ac)); WR; NEXT_OP;             /* HLLOM */
+OP (0523):  RM; mb = LLO (mb); WR; LAC; NEXT_OP;        /* HLLOS */
+OP (0524):  RD; AC(ac) = RLO (mb); NEXT_OP;             /* HRLO */
+OP (0525):  AC(ac) = RLO (IM); NEXT_OP;                 /* HRLOI */
+OP (0526):  mb = RLO (AC(ac)); WR; NEXT_OP;             /* HRLOM */
+OP (0527):  RM; mb = RLO (mb); WR; LAC; NEXT_OP;        /* HRLOS */
+OP (0530):  RD; AC(ac) = LLE (mb); NEXT_OP;             /* HLLE */
+OP (0531):  AC(ac) = LLE (IM); NEXT_OP;                 /* HLLEI */
+OP (0532):  mb = LLE (AC(ac)); WR; NEXT_OP;             /* HLLEM */
+OP (0533):  RM; mb = LLE (mb); WR; LAC; NEXT_OP;        /* HLLES */
+OP (0534):  RD; AC(ac) = RLE (mb); NEXT_OP;             /* HRLE */
+OP (0535):  AC(ac) = RLE (IM); NEXT_OP;                 /* HRLEI */
+OP (0536):  mb = RLE (AC(ac)); WR; NEXT_OP;             /* HRLEM */
+OP (0537):  RM; mb = RLE (mb); WR; LAC; NEXT_OP;        /* HRLES */
+OP (0540):  RD; AC(ac) = RR (mb, AC(ac)); NEXT_OP;      /* HRR */
+OP (0541):  AC(ac) = RR (IM, AC(ac)); NEXT_OP;          /* HRRI */
+OP (0542):  RM; mb = RR (AC(ac), mb); WR; NEXT_OP;      /* HRRM */
+OP (0543):  RM; mb = RR (mb, mb); WR; LAC; NEXT_OP;     /* HRRS */
+OP (0544):  RD; AC(ac) = LR (mb, AC(ac)); NEXT_OP;      /* HLR */
+OP (0545):  AC(ac) = LR (IM, AC(ac)); NEXT_OP;          /* HLRI */
+OP (0546):  RM; mb = LR (AC(ac), mb); WR; NEXT_OP;      /* HLRM */
+OP (0547):  RM; mb = LR (mb, mb); WR; LAC; NEXT_OP;     /* HLRS */
+OP (0550):  RD; AC(ac) = RRZ (mb); NEXT_OP;             /* HRRZ */
+OP (0551):  AC(ac) = RRZ (IM); NEXT_OP;                 /* HRRZI */
+OP (0552):  mb = RRZ (AC(ac)); WR; NEXT_OP;             /* HRRZM */
+OP (0553):  RM; mb = RRZ(mb); WR; LAC; NEXT_OP;         /* HRRZS */
+OP (0554):  RD; AC(ac) = LRZ (mb); NEXT_OP;             /* HLRZ */
+OP (0555):  AC(ac) = LRZ (IM); NEXT_OP;                 /* HLRZI */
+OP (0556):  mb = LRZ (AC(ac)); WR; NEXT_OP;             /* HLRZM */
+OP (0557):  RM; mb = LRZ (mb); WR; LAC; NEXT_OP;        /* HLRZS */
+OP (0560):  RD; AC(ac) = RRO (mb); NEXT_OP;             /* HRRO */
+OP (0561):  AC(ac) = RRO (IM); NEXT_OP;                 /* HRROI */
+OP (0562):  mb = RRO (AC(ac)); WR; NEXT_OP;             /* HRROM */
+OP (0563):  RM; mb = RRO (mb); WR; LAC; NEXT_OP;        /* HRROS */
+OP (0564):  RD; AC(ac) = LRO (mb); NEXT_OP;             /* HLRO */
+OP (0565):  AC(ac) = LRO (IM); NEXT_OP;                 /* HLROI */
+OP (0566):  mb = LRO (AC(ac)); WR; NEXT_OP;             /* HLROM */
+OP (0567):  RM; mb = LRO (mb); WR; LAC; NEXT_OP;        /* HLROS */
+OP (0570):  RD; AC(ac) = RRE (mb); NEXT_OP;             /* HRRE */
+OP (0571):  AC(ac) = RRE (IM); NEXT_OP;                 /* HRREI */
+OP (0572):  mb = RRE (AC(ac)); WR; NEXT_OP;             /* HRREM */
+OP (0573):  RM; mb = RRE (mb); WR; LAC; NEXT_OP;        /* HRRES */
+OP (0574):  RD; AC(ac) = LRE (mb); NEXT_OP;             /* HLRE */
+OP (0575):  AC(ac) = LRE (IM); NEXT_OP;                 /* HLREI */
+OP (0576):  mb = LRE (AC(ac)); WR; NEXT_OP;             /* HLREM */
+OP (0577):  RM; mb = LRE (mb); WR; LAC; NEXT_OP;        /* HLRES */
 
 /* Test instructions (0600 - 0677) - checked against KS10 ucode
    In the KS10 ucode, TDN and TSN do not fetch an operand; the Processor
    Reference Manual describes them as NOPs that reference memory.
 */
 
-case 0600:  break;                                      /* TRN */
-case 0601:  break;                                      /* TLN */
-case 0602:  TR_; T__E; break;                           /* TRNE */
-case 0603:  TL_; T__E; break;                           /* TLNE */
-case 0604:  T__A; break;                                /* TRNA */
-case 0605:  T__A; break;                                /* TLNA */
-case 0606:  TR_; T__N; break;                           /* TRNN */
-case 0607:  TL_; T__N; break;                           /* TLNN */
-case 0610:  TD_; break;                                 /* TDN */
-case 0611:  TS_; break;                                 /* TSN */
-case 0612:  TD_; T__E; break;                           /* TDNE */
-case 0613:  TS_; T__E; break;                           /* TSNE */
-case 0614:  TD_; T__A; break;                           /* TDNA */
-case 0615:  TS_; T__A; break;                           /* TSNA */
-case 0616:  TD_; T__N; break;                           /* TDNN */
-case 0617:  TS_; T__N; break;                           /* TSNN */
-case 0620:  TR_; T_Z; break;                            /* TRZ */
-case 0621:  TL_; T_Z; break;                            /* TLZ */
-case 0622:  TR_; T__E; T_Z; break;                      /* TRZE */
-case 0623:  TL_; T__E; T_Z; break;                      /* TLZE */
-case 0624:  TR_; T__A; T_Z; break;                      /* TRZA */
-case 0625:  TL_; T__A; T_Z; break;                      /* TLZA */
-case 0626:  TR_; T__N; T_Z; break;                      /* TRZN */
-case 0627:  TL_; T__N; T_Z; break;                      /* TLZN */
-case 0630:  TD_; T_Z; break;                            /* TDZ */
-case 0631:  TS_; T_Z; break;                            /* TSZ */
-case 0632:  TD_; T__E; T_Z; break;                      /* TDZE */
-case 0633:  TS_; T__E; T_Z; break;                      /* TSZE */
-case 0634:  TD_; T__A; T_Z; break;                      /* TDZA */
-case 0635:  TS_; T__A; T_Z; break;                      /* TSZA */
-case 0636:  TD_; T__N; T_Z; break;                      /* TDZN */
-case 0637:  TS_; T__N; T_Z; break;                      /* TSZN */
-case 0640:  TR_; T_C; break;                            /* TRC */
-case 0641:  TL_; T_C; break;                            /* TLC */
-case 0642:  TR_; T__E; T_C; break;                      /* TRCE */
-case 0643:  TL_; T__E; T_C; break;                      /* TLCE */
-case 0644:  TR_; T__A; T_C; break;                      /* TRCA */
-case 0645:  TL_; T__A; T_C; break;                      /* TLCA */
-case 0646:  TR_; T__N; T_C; break;                      /* TRCN */
-case 0647:  TL_; T__N; T_C; break;                      /* TLCN */
-case 0650:  TD_; T_C; break;                            /* TDC */
-case 0651:  TS_; T_C; break;                            /* TSC */
-case 0652:  TD_; T__E; T_C; break;                      /* TDCE */
-case 0653:  TS_; T__E; T_C; break;                      /* TSCE */
-case 0654:  TD_; T__A; T_C; break;                      /* TDCA */
-case 0655:  TS_; T__A; T_C; break;                      /* TSCA */
-case 0656:  TD_; T__N; T_C; break;                      /* TDCN */
-case 0657:  TS_; T__N; T_C; break;                      /* TSCN */
-case 0660:  TR_; T_O; break;                            /* TRO */
-case 0661:  TL_; T_O; break;                            /* TLO */
-case 0662:  TR_; T__E; T_O; break;                      /* TROE */
-case 0663:  TL_; T__E; T_O; break;                      /* TLOE */
-case 0664:  TR_; T__A; T_O; break;                      /* TROA */
-case 0665:  TL_; T__A; T_O; break;                      /* TLOA */
-case 0666:  TR_; T__N; T_O; break;                      /* TRON */
-case 0667:  TL_; T__N; T_O; break;                      /* TLON */
-case 0670:  TD_; T_O; break;                            /* TDO */
-case 0671:  TS_; T_O; break;                            /* TSO */
-case 0672:  TD_; T__E; T_O; break;                      /* TDOE */
-case 0673:  TS_; T__E; T_O; break;                      /* TSOE */
-case 0674:  TD_; T__A; T_O; break;                      /* TDOA */
-case 0675:  TS_; T__A; T_O; break;                      /* TSOA */
-case 0676:  TD_; T__N; T_O; break;                      /* TDON */
-case 0677:  TS_; T__N; T_O; break;                      /* TSON */
+OP (0600):  NEXT_OP;                                    /* TRN */
+OP (0601):  NEXT_OP;                                    /* TLN */
+OP (0602):  TR_; T__E; NEXT_OP;                         /* TRNE */
+OP (0603):  TL_; T__E; NEXT_OP;                         /* TLNE */
+OP (0604):  T__A; NEXT_OP;                              /* TRNA */
+OP (0605):  T__A; NEXT_OP;                              /* TLNA */
+OP (0606):  TR_; T__N; NEXT_OP;                         /* TRNN */
+OP (0607):  TL_; T__N; NEXT_OP;                         /* TLNN */
+OP (0610):  TD_; NEXT_OP;                               /* TDN */
+OP (0611):  TS_; NEXT_OP;                               /* TSN */
+OP (0612):  TD_; T__E; NEXT_OP;                         /* TDNE */
+OP (0613):  TS_; T__E; NEXT_OP;                         /* TSNE */
+OP (0614):  TD_; T__A; NEXT_OP;                         /* TDNA */
+OP (0615):  TS_; T__A; NEXT_OP;                         /* TSNA */
+OP (0616):  TD_; T__N; NEXT_OP;                         /* TDNN */
+OP (0617):  TS_; T__N; NEXT_OP;                         /* TSNN */
+OP (0620):  TR_; T_Z; NEXT_OP;                          /* TRZ */
+OP (0621):  TL_; T_Z; NEXT_OP;                          /* TLZ */
+OP (0622):  TR_; T__E; T_Z; NEXT_OP;                    /* TRZE */
+OP (0623):  TL_; T__E; T_Z; NEXT_OP;                    /* TLZE */
+OP (0624):  TR_; T__A; T_Z; NEXT_OP;                    /* TRZA */
+OP (0625):  TL_; T__A; T_Z; NEXT_OP;                    /* TLZA */
+OP (0626):  TR_; T__N; T_Z; NEXT_OP;                    /* TRZN */
+OP (0627):  TL_; T__N; T_Z; NEXT_OP;                    /* TLZN */
+OP (0630):  TD_; T_Z; NEXT_OP;                          /* TDZ */
+OP (0631):  TS_; T_Z; NEXT_OP;                          /* TSZ */
+OP (0632):  TD_; T__E; T_Z; NEXT_OP;                    /* TDZE */
+OP (0633):  TS_; T__E; T_Z; NEXT_OP;                    /* TSZE */
+OP (0634):  TD_; T__A; T_Z; NEXT_OP;                    /* TDZA */
+OP (0635):  TS_; T__A; T_Z; NEXT_OP;                    /* TSZA */
+OP (0636):  TD_; T__N; T_Z; NEXT_OP;                    /* TDZN */
+OP (0637):  TS_; T__N; T_Z; NEXT_OP;                    /* TSZN */
+OP (0640):  TR_; T_C; NEXT_OP;                          /* TRC */
+OP (0641):  TL_; T_C; NEXT_OP;                          /* TLC */
+OP (0642):  TR_; T__E; T_C; NEXT_OP;                    /* TRCE */
+OP (0643):  TL_; T__E; T_C; NEXT_OP;                    /* TLCE */
+OP (0644):  TR_; T__A; T_C; NEXT_OP;                    /* TRCA */
+OP (0645):  TL_; T__A; T_C; NEXT_OP;                    /* TLCA */
+OP (0646):  TR_; T__N; T_C; NEXT_OP;                    /* TRCN */
+OP (0647):  TL_; T__N; T_C; NEXT_OP;                    /* TLCN */
+OP (0650):  TD_; T_C; NEXT_OP;                          /* TDC */
+OP (0651):  TS_; T_C; NEXT_OP;                          /* TSC */
+OP (0652):  TD_; T__E; T_C; NEXT_OP;                    /* TDCE */
+OP (0653):  TS_; T__E; T_C; NEXT_OP;                    /* TSCE */
+OP (0654):  TD_; T__A; T_C; NEXT_OP;                    /* TDCA */
+OP (0655):  TS_; T__A; T_C; NEXT_OP;                    /* TSCA */
+OP (0656):  TD_; T__N; T_C; NEXT_OP;                    /* TDCN */
+OP (0657):  TS_; T__N; T_C; NEXT_OP;                    /* TSCN */
+OP (0660):  TR_; T_O; NEXT_OP;                          /* TRO */
+OP (0661):  TL_; T_O; NEXT_OP;                          /* TLO */
+OP (0662):  TR_; T__E; T_O; NEXT_OP;                    /* TROE */
+OP (0663):  TL_; T__E; T_O; NEXT_OP;                    /* TLOE */
+OP (0664):  TR_; T__A; T_O; NEXT_OP;                    /* TROA */
+OP (0665):  TL_; T__A; T_O; NEXT_OP;                    /* TLOA */
+OP (0666):  TR_; T__N; T_O; NEXT_OP;                    /* TRON */
+OP (0667):  TL_; T__N; T_O; NEXT_OP;                    /* TLON */
+OP (0670):  TD_; T_O; NEXT_OP;                          /* TDO */
+OP (0671):  TS_; T_O; NEXT_OP;                          /* TSO */
+OP (0672):  TD_; T__E; T_O; NEXT_OP;                    /* TDOE */
+OP (0673):  TS_; T__E; T_O; NEXT_OP;                    /* TSOE */
+OP (0674):  TD_; T__A; T_O; NEXT_OP;                    /* TDOA */
+OP (0675):  TS_; T__A; T_O; NEXT_OP;                    /* TSOA */
+OP (0676):  TD_; T__N; T_O; NEXT_OP;                    /* TDON */
+OP (0677):  TS_; T__N; T_O; NEXT_OP;                    /* TSON */
 
 /* I/O instructions (0700 - 0777)
 
@@ -1395,25 +1567,25 @@ case 0677:  TS_; T__N; T_O; break;                      /* TSON */
    calculation required by TOPS-10 and TOPS-20.
 */
 
-case 0700:  IO7 (io700i, io700d); break;                /* I/O 0 */
-case 0701:  IO7 (io701i, io701d); break;                /* I/O 1 */
-case 0702:  IO7 (io702i, io702d); break;                /* I/O 2 */
-case 0704:  IOC; AC(ac) = Read (ea, OPND_PXCT); break;  /* UMOVE */
-case 0705:  IOC; Write (ea, AC(ac), OPND_PXCT); break;  /* UMOVEM */
-case 0710:  IOA; if (io710 (ac, ea)) INCPC; break;      /* TIOE, IORDI */
-case 0711:  IOA; if (io711 (ac, ea)) INCPC; break;      /* TION, IORDQ */
-case 0712:  IOAM; AC(ac) = io712 (ea); break;           /* RDIO, IORD */
-case 0713:  IOAM; io713 (AC(ac), ea); break;            /* WRIO, IOWR */
-case 0714:  IOA; io714 (AC(ac), ea); break;             /* BSIO, IOWRI */
-case 0715:  IOA; io715 (AC(ac), ea); break;             /* BCIO, IOWRQ */
-case 0716:  IOC; bltu (ac, ea, pflgs, 0); break;        /* BLTBU */
-case 0717:  IOC; bltu (ac, ea, pflgs, 1); break;        /* BLTUB */
-case 0720:  IOA; if (io720 (ac, ea)) INCPC; break;      /* TIOEB, IORDBI */
-case 0721:  IOA; if (io721 (ac, ea)) INCPC; break;      /* TIONB, IORDBQ */
-case 0722:  IOAM; AC(ac) = io722 (ea); break;           /* RDIOB, IORDB */
-case 0723:  IOAM; io723 (AC(ac), ea); break;            /* WRIOB, IOWRB */
-case 0724:  IOA; io724 (AC(ac), ea); break;             /* BSIOB, IOWRBI */
-case 0725:  IOA; io725 (AC(ac), ea); break;             /* BCIOB, IOWRBQ */
+OP (0700):  IO7 (io700i, io700d); NEXT_OP;              /* I/O 0 */
+OP (0701):  IO7 (io701i, io701d); NEXT_OP;              /* I/O 1 */
+OP (0702):  IO7 (io702i, io702d); NEXT_OP;              /* I/O 2 */
+OP (0704):  IOC; AC(ac) = Read (ea, OPND_PXCT); NEXT_OP;  /* UMOVE */
+OP (0705):  IOC; Write (ea, AC(ac), OPND_PXCT); NEXT_OP;  /* UMOVEM */
+OP (0710):  IOA; if (io710 (ac, ea)) INCPC; NEXT_OP;    /* TIOE, IORDI */
+OP (0711):  IOA; if (io711 (ac, ea)) INCPC; NEXT_OP;    /* TION, IORDQ */
+OP (0712):  IOAM; AC(ac) = io712 (ea); NEXT_OP;         /* RDIO, IORD */
+OP (0713):  IOAM; io713 (AC(ac), ea); NEXT_OP;          /* WRIO, IOWR */
+OP (0714):  IOA; io714 (AC(ac), ea); NEXT_OP;           /* BSIO, IOWRI */
+OP (0715):  IOA; io715 (AC(ac), ea); NEXT_OP;           /* BCIO, IOWRQ */
+OP (0716):  IOC; bltu (ac, ea, pflgs, 0); NEXT_OP;      /* BLTBU */
+OP (0717):  IOC; bltu (ac, ea, pflgs, 1); NEXT_OP;      /* BLTUB */
+OP (0720):  IOA; if (io720 (ac, ea)) INCPC; NEXT_OP;    /* TIOEB, IORDBI */
+OP (0721):  IOA; if (io721 (ac, ea)) INCPC; NEXT_OP;    /* TIONB, IORDBQ */
+OP (0722):  IOAM; AC(ac) = io722 (ea); NEXT_OP;         /* RDIOB, IORDB */
+OP (0723):  IOAM; io723 (AC(ac), ea); NEXT_OP;          /* WRIOB, IOWRB */
+OP (0724):  IOA; io724 (AC(ac), ea); NEXT_OP;           /* BSIOB, IOWRBI */
+OP (0725):  IOA; io725 (AC(ac), ea); NEXT_OP;           /* BCIOB, IOWRBQ */
 
 /* If undefined, monitor UUO - checked against KS10 ucode
    The KS10 implements a much more limited version of MUUO flag handling.
@@ -1447,7 +1619,7 @@ MUUO:
     if (TSTF (F_USR))                                   /* set PCU */
         mb = mb | XWD (F_UIO, 0);
     set_newflags (mb, FALSE);                           /* set new flags */
-    break;
+    NEXT_OP;
 
 /* JRST - checked against KS10 ucode
    Differences from the KS10: the KS10
@@ -1457,7 +1629,7 @@ MUUO:
    ITS microcode includes extended JRST's, although they are not used
 */
 
-case 0254:                                              /* JRST */
+OP (0254):                                              /* JRST */
     i = jrst_tab[ac];                                   /* get subop flags */
     if ((i == 0) || ((i == JRST_E) && TSTF (F_USR)) ||
         ((i == JRST_UIO) && TSTF (F_USR) && !TSTF (F_UIO)))
@@ -1526,7 +1698,7 @@ case 0254:                                              /* JRST */
         JUMP (Read (ea, MM_OPND));                      /* jump to M[ea] */
         break;
         }                                               /* end case subop */
-    break;
+    NEXT_OP;
     }                                                   /* end case op */
 
 if (its_2pr) {                                          /* 1-proc trap? */
@@ -2340,7 +2512,7 @@ set_dyn_ptrs ();
 set_ac_display (ac_cur);
 pi_eval ();
 if (M == NULL)
-    M = (d10 *) calloc (MAXMEMSIZE, sizeof (d10));
+    M = (d10 *) sim_mem_alloc (MAXMEMSIZE * sizeof (d10));
 if (M == NULL)
     return SCPE_MEM;
 pcq_r = find_reg ("PCQ", NULL, dptr);
@@ -2348,6 +2520,10 @@ if (pcq_r)
     pcq_r->qptr = 0;
 else return SCPE_IERR;
 sim_brk_types = sim_brk_dflt = SWMASK ('E');
+sim_brk_wtypes = SWMASK ('R') | SWMASK ('W') | SWMASK ('M');
+sim_brk_wphys = SWMASK ('P');
+sim_brk_wshift = PAG_N_OFF;
+sim_brk_types = sim_brk_types | sim_brk_wtypes | sim_brk_wphys;
 return SCPE_OK;
 }
 
@@ -117,6 +117,7 @@ typedef t_int64         d10;                            /* PDP-10 data (36b) */
 #define STOP_CONSOLE    12                              /* FE halt */
 #define STOP_IOALIGN    13                              /* DMA word access to odd address */
 #define STOP_UNKNOWN    14                              /* unknown stop  */
+#define STOP_WBKPT      15                              /* watchpoint */
 #define PAGE_FAIL       -1                              /* page fail */
 #define INTERRUPT       -2                              /* interrupt */
 #define ABORT(x)        longjmp (save_env, (x))         /* abort */
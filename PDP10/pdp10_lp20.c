@@ -661,9 +661,14 @@ static const uint32 txcase[32] = {
     TX_INT, TX_INT, TX_INT, TX_INT, TX_INT, TX_INT, TX_INT, TX_INT
     };
 
+fnc = CSA_GETFNC (lpcsa);
+if ((fnc == FNC_PR) && (uptr->flags & UNIT_ATT) &&      /* PDF rendering behind? */
+    pdflpt_busy (uptr)) {
+    sim_activate_after (uptr, (uint32) PRTTIME);        /* busy for a line */
+    return SCPE_OK;
+    }
 lpcsa = lpcsa & ~CSA_GO;
 ba = CSA_GETUAE (lpcsa) | lpba;
-fnc = CSA_GETFNC (lpcsa);
 tbc = 010000 - lpbc;
 if (((fnc & FNC_INTERNAL) == 0) && ((uptr->flags & UNIT_ATT) == 0)) {
     update_lpcs (CSA_ERR);
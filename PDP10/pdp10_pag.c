@@ -74,6 +74,21 @@
 
    TOPS10 vs TOPS20 is selected by a bit in the EBR; ITS paging is
    "hardwired" (it required different microcode).
+
+   Pages carrying data watchpoints, by virtual or physical address, are
+   never entered in the page tables; in the physical table, their entries
+   are left invalid.  References to them always call the fill routine,
+   and the watchpoints are tested only on that path.
+
+   Each page table has a pair of host pointer tables beside it, one for
+   reads and one for writes.  Once a reference through a valid pte has
+   reached existing memory, the host address of the physical page is
+   entered in the read table, and in the write table if the pte is
+   writeable.  Normal references check the host pointer first and use it
+   directly, skipping the pte expansion and the nxm check.  A host pointer
+   is never set without the matching pte, so it is cleared by anything that
+   changes the pte: a refill, CLRPT, a pager reset (EBR, UBR, and DBR
+   changes), or a deposit into the page table.
 */
 
 #include "pdp10_defs.h"
@@ -88,6 +103,10 @@
 #define PTBL_V          (1u << 30)
 #define PTBL_MASK       (PAG_PPN | PTBL_M | PTBL_V)
 
+#define PAG_WCH(ea,xpte) (sim_brk_wsumm && \
+    (sim_brk_wpage ((ea), 0) || \
+     sim_brk_wpage (PAG_XPTEPA ((xpte), (ea)), sim_brk_wphys)))
+
 /* NXM processing */
 
 #define REF_V           0                               /* ref is virt */
@@ -116,6 +135,13 @@ int32 eptbl[PTBL_MEMSIZE];                              /* exec page table */
 int32 uptbl[PTBL_MEMSIZE];                              /* user page table */
 int32 physptbl[PTBL_MEMSIZE];                           /* phys page table */
 int32 *ptbl_cur, *ptbl_prv;
+d10 *eptbl_rd[PTBL_MEMSIZE];                            /* exec host ptrs */
+d10 *eptbl_wr[PTBL_MEMSIZE];
+d10 *uptbl_rd[PTBL_MEMSIZE];                            /* user host ptrs */
+d10 *uptbl_wr[PTBL_MEMSIZE];
+d10 *physptbl_rd[PTBL_MEMSIZE];                         /* phys host ptrs */
+d10 *physptbl_wr[PTBL_MEMSIZE];
+d10 **hrd_cur, **hrd_prv, **hwr_cur, **hwr_prv;
 int32 save_ea;
 
 int32 ptbl_fill (a10 ea, int32 *ptbl, int32 mode);
@@ -123,6 +149,9 @@ t_stat pag_ex (t_value *vptr, t_addr addr, UNIT *uptr, int32 sw);
 t_stat pag_dep (t_value val, t_addr addr, UNIT *uptr, int32 sw);
 t_stat pag_reset (DEVICE *dptr);
 void pag_nxm (a10 pa, int32 phys, int32 trap);
+static void pag_wtest (a10 ea, a10 pa, d10 val, uint32 typ);
+static void pag_hset (int32 *tbl, int32 vpn, a10 pa);
+static void pag_hclr (int32 *tbl, int32 vpn);
 
 /* Pager data structures
 
@@ -164,32 +193,48 @@ DEVICE pag_dev = {
 d10 Read (a10 ea, int32 prv)
 {
 int32 pa, vpn, xpte;
+d10 *hp;
 
 if (ea < AC_NUM)                                        /* AC request */
     return (prv? ac_prv[ea]: ac_cur[ea]);
 vpn = PAG_GETVPN (ea);                                  /* get page num */
+hp = prv? hrd_prv[vpn]: hrd_cur[vpn];                   /* get host ptr */
+if (hp)                                                 /* mapped? */
+    return hp[PAG_GETOFF (ea)];
 xpte = prv? ptbl_prv[vpn]: ptbl_cur[vpn];               /* get exp pte */
-if (xpte == 0)
+if (xpte == 0) {
     xpte = ptbl_fill (ea, prv? ptbl_prv: ptbl_cur, PTF_RD);
+    if (sim_brk_wsumm)                                  /* watchpoints? */
+        pag_wtest (ea, PAG_XPTEPA (xpte, ea), 0, SWMASK ('R'));
+    }
 pa = PAG_XPTEPA (xpte, ea);                             /* calc phys addr */
 if (MEM_ADDR_NXM (pa))                                  /* process nxm */
     pag_nxm (pa, REF_V, PF_TR);
+pag_hset (prv? ptbl_prv: ptbl_cur, vpn, pa);            /* enter host ptr */
 return M[pa];                                           /* return data */
 }
 
 d10 ReadM (a10 ea, int32 prv)
 {
 int32 pa, vpn, xpte;
+d10 *hp;
 
 if (ea < AC_NUM)                                        /* AC request */
     return (prv? ac_prv[ea]: ac_cur[ea]);
 vpn = PAG_GETVPN (ea);                                  /* get page num */
+hp = prv? hwr_prv[vpn]: hwr_cur[vpn];                   /* get host ptr */
+if (hp)                                                 /* mapped rw? */
+    return hp[PAG_GETOFF (ea)];
 xpte = prv? ptbl_prv[vpn]: ptbl_cur[vpn];               /* get exp pte */
-if (xpte >= 0)
+if (xpte >= 0) {
     xpte = ptbl_fill (ea, prv? ptbl_prv: ptbl_cur, PTF_WR);
+    if (sim_brk_wsumm)                                  /* watchpoints? */
+        pag_wtest (ea, PAG_XPTEPA (xpte, ea), 0, SWMASK ('R'));
+    }
 pa = PAG_XPTEPA (xpte, ea);                             /* calc phys addr */
 if (MEM_ADDR_NXM (pa))                                  /* process nxm */
     pag_nxm (pa, REF_V, PF_TR);
+pag_hset (prv? ptbl_prv: ptbl_cur, vpn, pa);            /* enter host ptr */
 return M[pa];                                           /* return data */
 }
 
@@ -199,15 +244,24 @@ int32 pa, vpn, xpte;
 
 if (ea < AC_NUM)                                        /* AC? use current */
     return AC(ea);
-if (!PAGING)                                            /* phys? no mapping */
+if (!PAGING) {                                          /* phys? no mapping */
+    if (sim_brk_wsumm)                                  /* watchpoints? */
+        pag_wtest (ea, ea, 0, SWMASK ('R'));
     return M[ea];
+    }
 vpn = PAG_GETVPN (ea);                                  /* get page num */
+if (eptbl_rd[vpn])                                      /* mapped? */
+    return eptbl_rd[vpn][PAG_GETOFF (ea)];
 xpte = eptbl[vpn];                                      /* get exp pte, exec tbl */
-if (xpte == 0)
+if (xpte == 0) {
     xpte = ptbl_fill (ea, eptbl, PTF_RD);
+    if (sim_brk_wsumm)                                  /* watchpoints? */
+        pag_wtest (ea, PAG_XPTEPA (xpte, ea), 0, SWMASK ('R'));
+    }
 pa = PAG_XPTEPA (xpte, ea);                             /* calc phys addr */
 if (MEM_ADDR_NXM (pa))                                  /* process nxm */
     pag_nxm (pa, REF_V, PF_TR);
+pag_hset (eptbl, vpn, pa);                              /* enter host ptr */
 return M[pa];                                           /* return data */
 }
 
@@ -223,6 +277,7 @@ return M[ea];                                           /* return data */
 void Write (a10 ea, d10 val, int32 prv)
 {
 int32 pa, vpn, xpte;
+d10 *hp;
 
 if (ea < AC_NUM) {                                      /* AC request */
     if (prv)                                            /* write AC */
@@ -231,13 +286,24 @@ if (ea < AC_NUM) {                                      /* AC request */
     }
 else {
     vpn = PAG_GETVPN (ea);                              /* get page num */
+    hp = prv? hwr_prv[vpn]: hwr_cur[vpn];               /* get host ptr */
+    if (hp) {                                           /* mapped rw? */
+        hp[PAG_GETOFF (ea)] = val;
+        return;
+        }
     xpte = prv? ptbl_prv[vpn]: ptbl_cur[vpn];           /* get exp pte */
-    if (xpte >= 0)
+    if (xpte >= 0) {
         xpte = ptbl_fill (ea, prv? ptbl_prv: ptbl_cur, PTF_WR);
+        if (sim_brk_wsumm)                              /* watchpoints? */
+            pag_wtest (ea, PAG_XPTEPA (xpte, ea), val, SWMASK ('W'));
+        }
     pa = PAG_XPTEPA (xpte, ea);                         /* calc phys addr */
     if (MEM_ADDR_NXM (pa))                              /* process nxm */
         pag_nxm (pa, REF_V, PF_TR);
-    else M[pa] = val;                                   /* write data */
+    else {
+        pag_hset (prv? ptbl_prv: ptbl_cur, vpn, pa);    /* enter host ptr */
+        M[pa] = val;                                    /* write data */
+        }
     }
 return;
 }
@@ -248,17 +314,30 @@ int32 pa, vpn, xpte;
 
 if (ea < AC_NUM)                                        /* AC? use current */
     AC(ea) = val;
-else if (!PAGING)                                       /* phys? no mapping */
+else if (!PAGING) {                                     /* phys? no mapping */
+    if (sim_brk_wsumm)                                  /* watchpoints? */
+        pag_wtest (ea, ea, val, SWMASK ('W'));
     M[ea] = val;
+    }
 else {
     vpn = PAG_GETVPN (ea);                              /* get page num */
+    if (eptbl_wr[vpn]) {                                /* mapped rw? */
+        eptbl_wr[vpn][PAG_GETOFF (ea)] = val;
+        return;
+        }
     xpte = eptbl[vpn];                                  /* get exp pte, exec tbl */
-    if (xpte >= 0)
+    if (xpte >= 0) {
         xpte = ptbl_fill (ea, eptbl, PTF_WR);
+        if (sim_brk_wsumm)                              /* watchpoints? */
+            pag_wtest (ea, PAG_XPTEPA (xpte, ea), val, SWMASK ('W'));
+        }
     pa = PAG_XPTEPA (xpte, ea);                         /* calc phys addr */
     if (MEM_ADDR_NXM (pa))                              /* process nxm */
         pag_nxm (pa, REF_V, PF_TR);
-    else M[pa] = val;                                   /* write data */
+    else {
+        pag_hset (eptbl, vpn, pa);                      /* enter host ptr */
+        M[pa] = val;                                    /* write data */
+        }
     }
 return;
 }
@@ -290,6 +369,62 @@ if (xpte)                                               /* accessible */
 return TRUE;                                            /* not accessible */
 }
 
+/* Watchpoint test, called from the fill path of a memory reference
+
+   A write that changes the stored word also matches modify watchpoints.
+*/
+
+static void pag_wtest (a10 ea, a10 pa, d10 val, uint32 typ)
+{
+if ((typ & SWMASK ('W')) && !MEM_ADDR_NXM (pa) && (M[pa] != val))
+    typ = typ | SWMASK ('M');                           /* value changes */
+if (sim_brk_wtest (ea, 1, typ) == 0)                    /* virtual, */
+    sim_brk_wtest (pa, 1, typ | sim_brk_wphys);         /* then physical */
+return;
+}
+
+/* Host pointer table routines
+
+   pag_hset is called after a reference through page table entry vpn has
+   reached physical address pa in existing memory.  If the pte is still in
+   the table (it is not, for a watched page or a console reference), the
+   host address of the physical page is entered for reads, and for writes
+   if the pte is writeable.  pag_hclr removes both host pointers.
+*/
+
+static void pag_hset (int32 *tbl, int32 vpn, a10 pa)
+{
+int32 xpte = tbl[vpn];
+d10 *hp;
+
+if (xpte == 0)                                          /* not in table? */
+    return;
+hp = &M[pa & ~PAG_M_OFF];                               /* host page addr */
+if (tbl == eptbl) {
+    eptbl_rd[vpn] = hp;
+    eptbl_wr[vpn] = (xpte < 0)? hp: NULL;
+    }
+else if (tbl == uptbl) {
+    uptbl_rd[vpn] = hp;
+    uptbl_wr[vpn] = (xpte < 0)? hp: NULL;
+    }
+else {
+    physptbl_rd[vpn] = hp;
+    physptbl_wr[vpn] = (xpte < 0)? hp: NULL;
+    }
+return;
+}
+
+static void pag_hclr (int32 *tbl, int32 vpn)
+{
+if (tbl == eptbl)
+    eptbl_rd[vpn] = eptbl_wr[vpn] = NULL;
+else if (tbl == uptbl)
+    uptbl_rd[vpn] = uptbl_wr[vpn] = NULL;
+else physptbl_rd[vpn] = physptbl_wr[vpn] = NULL;
+return;
+}
+
 void pag_nxm (a10 pa, int32 phys, int32 trap)
 {
 apr_flg = apr_flg | APRF_NXM;                           /* set APR flag */
@@ -301,6 +436,26 @@ if (PAGING && trap)                                     /* trap? */
 return;
 }
 
+/* Host address of a mapped word, for the EXTEND string routines
+
+   Returns NULL for an AC, or if the page has no host pointer for the
+   access (read or write) in the current or previous context; the caller
+   then uses the normal reference routines.
+*/
+
+d10 *pag_hptr (a10 ea, int32 prv, int32 wr)
+{
+int32 vpn = PAG_GETVPN (ea);
+d10 *hp;
+
+if (ea < AC_NUM)                                        /* AC? */
+    return NULL;
+if (wr)
+    hp = prv? hwr_prv[vpn]: hwr_cur[vpn];
+else hp = prv? hrd_prv[vpn]: hrd_cur[vpn];
+return (hp? hp + PAG_GETOFF (ea): NULL);
+}
+
 /* Page table fill
 
    This routine is called if the page table is invalid, or on a write
@@ -327,6 +482,11 @@ return;
 int32 ptbl_fill (a10 ea, int32 *tbl, int32 mode)
 {
 
+/* Paging off - only reached for a physical page with watchpoints */
+
+if (tbl == physptbl)
+    return (PAG_GETVPN (ea) << PAG_V_PN) + PTBL_M + PTBL_V;
+
 /* ITS paging is based on conventional page tables.  ITS divides each address
    space into a 128K high and low section, and uses different descriptor base
    pointers (dbr) for each.  ITS pages are twice the size of DEC standard;
@@ -358,9 +518,13 @@ if (Q_ITS) {                                            /* ITS paging */
         xpte = ((pte & PTE_ITS_PPMASK) << ITS_V_PN) | PTBL_V |
             ((acc == ITS_ACC_RW)? PTBL_M: 0);
         decvpn = PAG_GETVPN (ea);                       /* get tlb idx */
-        if (!(mode & PTF_CON)) {
+        if (!(mode & PTF_CON) &&                        /* set tbl if ~cons, */
+            !PAG_WCH ((decvpn & ~1) << PAG_V_PN, xpte) && /* ~watched */
+            !PAG_WCH ((decvpn | 1) << PAG_V_PN, xpte + PAG_SIZE)) {
             tbl[decvpn & ~1] = xpte;                    /* map lo ITS page */
             tbl[decvpn | 1] = xpte + PAG_SIZE;          /* map hi */
+            pag_hclr (tbl, decvpn & ~1);                /* drop host ptrs */
+            pag_hclr (tbl, decvpn | 1);
             }
         return (xpte + ((decvpn & 1)? PAG_SIZE: 0));
         }
@@ -400,8 +564,10 @@ else if (!T20PAG) {                                     /* TOPS-10 paging */
     if ((pte & PTE_T10_A) && (!(mode & PTF_WR) || (pte & PTE_T10_W))) {
         xpte = ((pte & PTE_PPMASK) << PAG_V_PN) |       /* calc exp pte */
             PTBL_V | ((pte & PTE_T10_W)? PTBL_M: 0);
-        if (!(mode & PTF_CON))                          /* set tbl if ~cons */
-            tbl[vpn] = xpte;
+        if (!(mode & PTF_CON) && !PAG_WCH (ea, xpte)) { /* set tbl if ~cons */
+            tbl[vpn] = xpte;                            /* and ~watched */
+            pag_hclr (tbl, vpn);                        /* drop host ptrs */
+            }
         return xpte;
         }
     PAGE_FAIL_TRAP;
@@ -568,8 +734,10 @@ else {                                                  /* TOPS-20 paging */
         ((xpte & PTBL_M)? PF_T20_M: 0) |                /* M, W, C bits */
         ((acc & PTE_T20_W)? PF_T20_W: 0) |
         ((acc & PTE_T20_C)? PF_C: 0);
-    if (!(mode & PTF_CON))                              /* set tbl if ~cons */
-        tbl[vpn] = xpte;
+    if (!(mode & PTF_CON) && !PAG_WCH (ea, xpte)) {     /* set tbl if ~cons */
+        tbl[vpn] = xpte;                                /* and ~watched */
+        pag_hclr (tbl, vpn);                            /* drop host ptrs */
+        }
     return xpte;
     }                                                   /* end TOPS20 paging */
 }
@@ -583,16 +751,32 @@ int32 t;
 if (PAGING) {
     ac_cur = &acs[UBR_GETCURAC (ubr) * AC_NUM];
     ac_prv = &acs[UBR_GETPRVAC (ubr) * AC_NUM];
-    if (TSTF (F_USR))
+    if (TSTF (F_USR)) {
         ptbl_cur = ptbl_prv = &uptbl[0];
+        hrd_cur = hrd_prv = &uptbl_rd[0];
+        hwr_cur = hwr_prv = &uptbl_wr[0];
+        }
     else {
         ptbl_cur = &eptbl[0];
-        ptbl_prv = TSTF (F_UIO)? &uptbl[0]: &eptbl[0];
+        hrd_cur = &eptbl_rd[0];
+        hwr_cur = &eptbl_wr[0];
+        if (TSTF (F_UIO)) {
+            ptbl_prv = &uptbl[0];
+            hrd_prv = &uptbl_rd[0];
+            hwr_prv = &uptbl_wr[0];
+            }
+        else {
+            ptbl_prv = &eptbl[0];
+            hrd_prv = &eptbl_rd[0];
+            hwr_prv = &eptbl_wr[0];
+            }
         }
     }
 else {
     ac_cur = ac_prv = &acs[0];
     ptbl_cur = ptbl_prv = &physptbl[0];
+    hrd_cur = hrd_prv = &physptbl_rd[0];
+    hwr_cur = hwr_prv = &physptbl_wr[0];
     }
 t = EBR_GETEBR (ebr);
 epta = t << PAG_V_PN;
@@ -661,10 +845,16 @@ if (Q_ITS) {                                            /* ITS? */
     uptbl[vpn | 1] = 0;                                 /* entries in */
     eptbl[vpn & ~1] = 0;                                /* both page tables */
     eptbl[vpn | 1] = 0;
+    pag_hclr (uptbl, vpn & ~1);                         /* and host ptrs */
+    pag_hclr (uptbl, vpn | 1);
+    pag_hclr (eptbl, vpn & ~1);
+    pag_hclr (eptbl, vpn | 1);
     }
 else {
     uptbl[vpn] = 0;                                     /* clear entries in */
     eptbl[vpn] = 0;                                     /* both page tables */
+    pag_hclr (uptbl, vpn);                              /* and host ptrs */
+    pag_hclr (eptbl, vpn);
     }
 return FALSE;
 } 
@@ -885,9 +1075,14 @@ int32 tbln = uptr - pag_unit;
 
 if (addr >= PTBL_MEMSIZE)
     return SCPE_NXM;
-if (tbln)
+if (tbln) {
     uptbl[addr] = (int32) val & PTBL_MASK;
-else eptbl[addr] = (int32) val & PTBL_MASK;
+    pag_hclr (uptbl, addr);
+    }
+else {
+    eptbl[addr] = (int32) val & PTBL_MASK;
+    pag_hclr (eptbl, addr);
+    }
 return SCPE_OK;
 }
 
@@ -897,7 +1092,12 @@ int32 i;
 
 for (i = 0; i < PTBL_MEMSIZE; i++) {
     eptbl[i] = uptbl[i] = 0;
-    physptbl[i] = (i << PAG_V_PN) + PTBL_M + PTBL_V;
+    pag_hclr (eptbl, i);                                /* clear host ptrs */
+    pag_hclr (uptbl, i);
+    pag_hclr (physptbl, i);
+    if (PAG_WCH (i << PAG_V_PN, (i << PAG_V_PN) + PTBL_M + PTBL_V))
+        physptbl[i] = 0;                                /* watched, fill */
+    else physptbl[i] = (i << PAG_V_PN) + PTBL_M + PTBL_V;
     }
 return SCPE_OK;
 }
@@ -114,7 +114,8 @@ const char *sim_stop_messages[] = {
     "Address stop",
     "Console FE halt",
     "Unaligned DMA",
-    "Panic stop"
+    "Panic stop",
+    "Watchpoint"
      };
 
 /* Binary loader, supports RIM10, SAV, EXE */
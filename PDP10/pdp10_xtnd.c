@@ -56,6 +56,17 @@
    If the AC block is not up to date, memory accessibility must be tested
    before the actual read or write is done.
 
+   The string moves, compares, and fills also have a word at a time path
+   for the common 7b and 8b byte sizes.  It is used only when the byte
+   pointers are direct (no index or indirect), are at a word boundary, and
+   point to pages that already have host pointers in the pager.  Such a
+   chunk cannot page fail.  Each chunk stops at the end of a page, so it is
+   translated once.  It leaves the lengths and byte pointers exactly as the
+   byte loop would.  Like BLT, a chunk is charged one sim_interval tick per
+   word rather than per byte, so that the instruction rate the clocks are
+   calibrated from stays in instruction units; it is limited so that it
+   never runs past the next event.
+
    The extended instruction routine returns a status code as follows:
 
         XT_NOSK         no skip completion
@@ -109,6 +120,11 @@
 #define XT_MBZ          INT64_C(0777000000000)          /* must be zero */
 #define XT_MBZE         INT64_C(0047777000000)          /* must be zero, edit */
 
+/* Word at a time strings */
+
+#define XT_BPW(s)       (36 / (s))                      /* bytes per word */
+#define XT_WDMASK(s)    (DMASK & ~bytemask[36 % (s)])   /* bytes in word */
+
 /* Register change log */
 
 #define XT_N_RLOG       5                               /* entry width */
@@ -148,11 +164,18 @@ extern d10 Read (int32 ea, int32 prv);
 extern void Write (int32 ea, d10 val, int32 prv);
 extern a10 calc_ea (d10 inst, int32 prv);
 extern int32 test_int (void);
+extern d10 *pag_hptr (a10 ea, int32 prv, int32 wr);
 d10 incbp (d10 bp);
 d10 incloadbp (int32 ac, int32 pflgs);
 void incstorebp (d10 val, int32 ac, int32 pflgs);
 d10 xlate (d10 by, a10 tblad, d10 *xflgs, int32 pflgs);
 void filldst (d10 fill, int32 ac, d10 cnt, int32 pflgs);
+static int32 xtwdbp (d10 bp, int32 s, int32 prv, int32 wr, d10 **hp);
+static int32 xtlimit (int32 nw, int32 s, d10 lnt);
+static d10 xtadvbp (d10 bp, int32 nw);
+static int32 xtcmpw (int32 ac, int32 pflgs);
+static int32 xtmovw (int32 ac, d10 fill, d10 xflgs, int32 pflgs);
+static int32 xtfillw (d10 fill, int32 lac, int32 bac, d10 cnt, int32 pflgs);
 
 static const d10 pwrs10[23][2] = {
 {           INT64_C(0),           INT64_C(0),},
@@ -224,6 +247,10 @@ switch (xop) {                                          /* case on opcode */
             if (flg && (t = test_int ()))
                 ABORT (t);
             rlog = 0;                                   /* clear log */
+            if ((t = xtcmpw (ac, pflgs)) > 0) {         /* equal words? */
+                b1 = b2 = 0;                            /* b1 == b2 */
+                continue;
+                }
             if (AC(ac))                                 /* src1 */
                 b1 = incloadbp (p1, pflgs);
             else b1 = f1;
@@ -434,6 +461,10 @@ switch (xop) {                                          /* case on opcode */
             if (flg && (t = test_int ()))
                 ABORT (t);
             rlog = 0;                                   /* clear log */
+            if ((((xop == XT_MOVSLJ) || (xop == XT_MOVSRJ)) ||
+                ((AC(ac) & XLNTMASK) == 0)) &&          /* plain move/fill? */
+                (xtmovw (ac, f1, xflgs, pflgs) > 0))    /* by words? */
+                continue;
             if (AC(ac) & XLNTMASK) {                    /* any source? */
                 b1 = incloadbp (p1, pflgs);             /* src byte */
                 if (xop == XT_MOVSO) {                  /* offset? */
@@ -718,13 +749,17 @@ return -1;
 
 void filldst (d10 fill, int32 ac, d10 cnt, int32 pflgs)
 {
-int32 i, t;
+int32 i, n, t;
 int32 p1 = ADDA (ac, 1);
 
 for (i = 0; i < cnt; i++) {
     if (i && (t = test_int ()))
         ABORT (t);
     rlog = 0;                                           /* clear log */ 
+    if ((n = xtfillw (fill, ac, p1, cnt - i, pflgs)) > 0) { /* by words? */
+        i = i + n - 1;
+        continue;
+        }
     incstorebp (fill, p1, pflgs);
     AC(ac) = (AC(ac) & XFLGMASK) | ((AC(ac) - 1) & XLNTMASK);
     }
@@ -732,6 +767,166 @@ rlog = 0;
 return;
 }
 
+/* Word at a time string routines
+
+   xtwdbp tests whether the next byte of byte pointer bp, with byte size s,
+   starts a word of a mapped page.  If so, it returns the host address of
+   that word in *hp and the number of words left in the page; else 0.
+*/
+
+static int32 xtwdbp (d10 bp, int32 s, int32 prv, int32 wr, d10 **hp)
+{
+int32 p = GET_P (bp);
+a10 wa;
+
+if ((GET_S (bp) != s) || TST_IND (bp) || GET_XR (bp))  /* wrong size, ind/idx? */
+    return 0;
+if (p == 36)                                            /* before first byte? */
+    wa = GET_ADDR (bp);
+else if (p < s)                                         /* after last byte? */
+    wa = INCR (bp);
+else return 0;
+if ((*hp = pag_hptr (wa, prv, wr)) == NULL)             /* not mapped? */
+    return 0;
+return PAG_SIZE - PAG_GETOFF (wa);
+}
+
+/* Limit a word chunk by a string length and by the event window.  The
+   caller charges one interrupt test per word after the first, as BLT
+   would, so the chunk can run at most sim_interval + 1 words. */
+
+static int32 xtlimit (int32 nw, int32 s, d10 lnt)
+{
+int32 bpw = XT_BPW (s);
+
+if (lnt / bpw < nw)                                     /* string length */
+    nw = (int32) (lnt / bpw);
+if (sim_interval < 0)                                   /* event pending */
+    return 0;
+if ((sim_interval + 1) < nw)                            /* event window */
+    nw = sim_interval + 1;
+return nw;
+}
+
+/* Advance a byte pointer at a word boundary over nw words; the result is
+   what nw * bytes per word calls on incbp would give */
+
+static d10 xtadvbp (d10 bp, int32 nw)
+{
+int32 s = GET_S (bp);
+a10 wa = (GET_P (bp) == 36)? GET_ADDR (bp): INCR (bp);
+
+return PUT_P ((bp & LMASK) | ((wa + nw - 1) & AMASK), 36 % s);
+}
+
+/* Compare equal words of two strings (CMPSx)
+
+   Returns the number of bytes of each string consumed, 0 if none.
+*/
+
+static int32 xtcmpw (int32 ac, int32 pflgs)
+{
+int32 p1 = ADDAC (ac, 1);
+int32 p3 = ADDAC (ac, 3);
+int32 p4 = ADDAC (ac, 4);
+int32 i, nw, n2, s = GET_S (AC(p1));
+d10 *hp1, *hp2, mask;
+
+if ((s != 7) && (s != 8))                               /* 7b or 8b only */
+    return 0;
+nw = xtwdbp (AC(p1), s, MM_XSRC, 0, &hp1);              /* src1 mapped? */
+n2 = xtwdbp (AC(p4), s, MM_XSRC, 0, &hp2);              /* src2 mapped? */
+if (n2 < nw)
+    nw = n2;
+nw = xtlimit (nw, s, AC(ac));                           /* limit by lengths */
+nw = xtlimit (nw, s, AC(p3));
+mask = XT_WDMASK (s);
+for (i = 0; (i < nw) && (((hp1[i] ^ hp2[i]) & mask) == 0); i++) ;
+if (i == 0)                                             /* first unequal? */
+    return 0;
+n2 = i * XT_BPW (s);                                    /* bytes consumed */
+sim_interval = sim_interval - (i - 1);                  /* charge int tests */
+AC(p1) = xtadvbp (AC(p1), i);
+AC(p4) = xtadvbp (AC(p4), i);
+AC(ac) = AC(ac) - n2;
+AC(p3) = AC(p3) - n2;
+return n2;
+}
+
+/* Move words of a string (MOVSLJ, MOVSRJ), or fill them once the source
+   is exhausted (all moves)
+
+   Returns the number of bytes stored, 0 if none.
+*/
+
+static int32 xtmovw (int32 ac, d10 fill, d10 xflgs, int32 pflgs)
+{
+int32 p1 = ADDAC (ac, 1);
+int32 p3 = ADDAC (ac, 3);
+int32 p4 = ADDAC (ac, 4);
+int32 i, n, nw, ns, s = GET_S (AC(p4));
+d10 *hps, *hpd, mask;
+
+if ((s != 7) && (s != 8))                               /* 7b or 8b only */
+    return 0;
+if ((AC(ac) & XLNTMASK) == 0)                           /* src done? fill */
+    return xtfillw (fill, p3, p4, AC(p3) & XLNTMASK, pflgs);
+nw = xtwdbp (AC(p4), s, MM_XDST, 1, &hpd);              /* dst mapped rw? */
+ns = xtwdbp (AC(p1), s, MM_XSRC, 0, &hps);              /* src mapped? */
+if (ns < nw)
+    nw = ns;
+nw = xtlimit (nw, s, AC(ac) & XLNTMASK);                /* limit by lengths */
+nw = xtlimit (nw, s, AC(p3) & XLNTMASK);
+if (nw <= 0)
+    return 0;
+mask = XT_WDMASK (s);
+for (i = 0; i < nw; i++)                                /* in order, as bytes */
+    hpd[i] = (hpd[i] & ~mask) | (hps[i] & mask);
+n = nw * XT_BPW (s);                                    /* bytes moved */
+sim_interval = sim_interval - (nw - 1);                 /* charge int tests */
+AC(p1) = xtadvbp (AC(p1), nw);
+AC(p4) = xtadvbp (AC(p4), nw);
+AC(ac) = xflgs | ((AC(ac) - n) & XLNTMASK);
+AC(p3) = (AC(p3) - n) & XLNTMASK;
+return n;
+}
+
+/* Fill words of a destination string
+
+   Arguments:
+        fill    =       fill
+        lac     =       length AC
+        bac     =       byte pointer AC
+        cnt     =       maximum fill count
+        pflgs   =       PXCT flags
+   Returns the number of bytes stored, 0 if none.
+*/
+
+static int32 xtfillw (d10 fill, int32 lac, int32 bac, d10 cnt, int32 pflgs)
+{
+int32 i, n, nw, s = GET_S (AC(bac));
+d10 *hp, wd, mask;
+
+if ((s != 7) && (s != 8))                               /* 7b or 8b only */
+    return 0;
+nw = xtwdbp (AC(bac), s, MM_XDST, 1, &hp);              /* dst mapped rw? */
+nw = xtlimit (nw, s, cnt);                              /* limit by count */
+if (nw <= 0)
+    return 0;
+mask = XT_WDMASK (s);
+for (i = 0, wd = 0; i < XT_BPW (s); i++)                /* build fill word */
+    wd = (wd << s) | (fill & bytemask[s]);
+wd = wd << (36 % s);
+for (i = 0; i < nw; i++)
+    hp[i] = (hp[i] & ~mask) | wd;
+n = nw * XT_BPW (s);                                    /* bytes stored */
+sim_interval = sim_interval - (nw - 1);                 /* charge int tests */
+AC(bac) = xtadvbp (AC(bac), nw);
+AC(lac) = (AC(lac) & XFLGMASK) | ((AC(lac) - n) & XLNTMASK);
+return n;
+}
+
+
 /* Clean up after page fault
 
    Arguments:
@@ -239,6 +239,11 @@
 #define last_pa         (cpu_unit.u4)                   /* auto save/rest */
 #define UNIT_V_MSIZE    (UNIT_V_UF + 0)                 /* dummy */
 #define UNIT_MSIZE      (1u << UNIT_V_MSIZE)
+#if defined (__GNUC__)
+#define CPU_LOOP_INLINE __inline__ __attribute__ ((always_inline))
+#else
+#define CPU_LOOP_INLINE SIM_INLINE
+#endif
 
 #define HIST_MIN        64
 #define HIST_MAX        (1u << 18)
@@ -253,6 +258,13 @@ typedef struct {
     uint16              inst[HIST_ILNT];
     } InstHistory;
 
+typedef struct {
+    uint32              lo;                             /* first valid disp */
+    uint32              rlnt;                           /* read length, 0 = slow */
+    uint32              wlnt;                           /* write length, 0 = slow */
+    int32               base;                           /* physical base */
+    } RelocEntry;
+
 /* Global state */
 
 uint16 *M = NULL;                                       /* memory */
@@ -285,6 +297,7 @@ int32 MMR3 = 0;                                         /* MMR3 - 22b status */
 int32 cpu_bme = 0;                                      /* bus map enable */
 int32 cpu_astop = 0;                                    /* address stop */
 int32 isenable = 0, dsenable = 0;                       /* i, d space flags */
+volatile int32 trapea = 0;                              /* trap addr, for setjmp */
 int32 stop_trap = 1;                                    /* stop on trap */
 int32 stop_vecabort = 1;                                /* stop on vec abort */
 int32 stop_spabort = 1;                                 /* stop on SP abort */
@@ -300,6 +313,7 @@ jmp_buf save_env;                                       /* abort handler */
 int32 hst_p = 0;                                        /* history pointer */
 int32 hst_lnt = 0;                                      /* history length */
 InstHistory *hst = NULL;                                /* instruction history */
+RelocEntry reloc_tab[64];                               /* cached relocation */
 int32 dsmask[4] = { MMR3_KDS, MMR3_SDS, 0, MMR3_UDS };  /* dspace enables */
 t_addr cpu_memsize = INIMEMSIZE;                        /* last mem addr */
 
@@ -322,6 +336,8 @@ void relocR_test (int32 va, int32 apridx);
 void relocW_test (int32 va, int32 apridx);
 t_bool PLF_test (int32 va, int32 apr);
 void reloc_abort (int32 err, int32 apridx);
+void reloc_set (int32 apridx);
+void reloc_set_all (void);
 int32 ReadE (int32 addr);
 int32 ReadW (int32 addr);
 int32 ReadB (int32 addr);
@@ -630,90 +646,25 @@ DEVICE cpu_dev = {
     NULL, &cpu_set_size, NULL
     };
 
-t_value pdp11_pc_value (void)
-{
-return (t_value)PC;
-}
-
-t_stat sim_instr (void)
-{
-int abortval, i;
-volatile int32 trapea;                                  /* used by setjmp */
-t_stat reason;
-
-sim_vm_pc_value = &pdp11_pc_value;
-
-/* Restore register state
-
-        1. PSW components
-        2. Active register file based on PSW<rs>
-        3. Active stack pointer based on PSW<cm>
-        4. Memory management control flags
-        5. Interrupt system
-*/
-
-reason = build_dib_tab ();                              /* build, chk dib_tab */
-if (reason != SCPE_OK)
-    return reason;
-if (MEMSIZE < cpu_tab[cpu_model].maxm)                  /* mem size < max? */
-    cpu_memsize = MEMSIZE;                              /* then okay */
-else cpu_memsize = cpu_tab[cpu_model].maxm - IOPAGESIZE;/* max - io page */
-cpu_type = 1u << cpu_model;                             /* reset type mask */
-cpu_bme = (MMR3 & MMR3_BME) && (cpu_opt & OPT_UBM);     /* map enabled? */
-PC = saved_PC;
-put_PSW (PSW, 0);                                       /* set PSW, call calc_xs */
-for (i = 0; i < 6; i++)
-    R[i] = REGFILE[i][rs];
-SP = STACKFILE[cm];
-isenable = calc_is (cm);
-dsenable = calc_ds (cm);
-put_PIRQ (PIRQ);                                        /* rewrite PIRQ */
-STKLIM = STKLIM & STKLIM_RW;                            /* clean up STKLIM */
-MMR0 = MMR0 | MMR0_IC;                                  /* usually on */
-
-trap_req = calc_ints (ipl, trap_req);                   /* upd int req */
-trapea = 0;
-reason = 0;
-
-/* Abort handling
-
-   If an abort occurs in memory management or memory access, the lower
-   level routine executes a longjmp to this area OUTSIDE the main
-   simulation loop.  The longjmp specifies a trap mask which is OR'd
-   into the trap_req register.  Simulation then resumes at the fetch
-   phase, and the trap is sprung.
+/* Main instruction fetch/decode loop
 
-   Aborts which occur within a trap sequence (trapea != 0) require
-   special handling.  If the abort occured on the stack pushes, and
-   the mode (encoded in trapea) is kernel, an "emergency" kernel
-   stack is created at 4, and a red zone stack trap taken.
+   Check for traps or interrupts.  If trap, locate the vector and check
+   for stop condition.  If interrupt, locate the vector.
 
-   All variables used in setjmp processing, or assumed to be valid
-   after setjmp, must be volatile or global.
+   The loop is instantiated once per entry in cpu_loop_tab.  Within it,
+   CPUT tests against the variant's model mask are resolved at compile
+   time when the mask is contained in, or disjoint from, the tested set,
+   and fall back to cpu_type only for models the variant does not fix.
+   Aborts longjmp out of the loop to sim_instr, which reenters it.
 */
 
-abortval = setjmp (save_env);                           /* set abort hdlr */
-if (abortval != 0) {
-    trap_req = trap_req | abortval;                     /* or in trap flag */
-    if ((trapea > 0) && stop_vecabort)
-        reason = STOP_VECABORT;
-    if ((trapea < 0) &&                                 /* stack push abort? */
-        (CPUT (STOP_STKA) || stop_spabort))
-        reason = STOP_SPABORT;
-    if (trapea == ~MD_KER) {                            /* kernel stk abort? */
-        setTRAP (TRAP_RED);
-        setCPUERR (CPUE_RED);
-        STACKFILE[MD_KER] = 4;
-        if (cm == MD_KER)
-            SP = 4;
-        }
-    }
+#undef CPUT
+#define CPUT(x)         ((((x) & vmask) == vmask) || \
+                         (((x) & vmask) && ((cpu_type & (x)) != 0)))
 
-/* Main instruction fetch/decode loop
-
-   Check for traps or interrupts.  If trap, locate the vector and check
-   for stop condition.  If interrupt, locate the vector.
-*/ 
+static CPU_LOOP_INLINE t_stat cpu_loop (const uint32 vmask)
+{
+t_stat reason = 0;
 
 while (reason == 0)  {
 
@@ -734,6 +685,8 @@ while (reason == 0)  {
         continue;
         }                                               /* end if sim_interval */
 
+    if (trap_req & TRAP_CHK)                            /* int reqs changed? */
+        trap_req = calc_ints (ipl, trap_req);           /* recalc int req */
     if (trap_req) {                                     /* check traps, ints */
         trapea = 0;                                     /* assume srch fails */
         if ((t = trap_req & TRAP_ALL)) {                /* if a trap */
@@ -827,6 +780,7 @@ while (reason == 0)  {
         }
     IR = ReadE (PC | isenable);                         /* fetch instruction */
     sim_interval = sim_interval - 1;
+    SIM_PROF_SAMPLE (PC, SWMASK ("KSUU"[cm]));          /* profile guest PC */
     srcspec = (IR >> 6) & 077;                          /* src, dst specs */
     dstspec = IR & 077;
     srcreg = (srcspec <= 07);                           /* src, dst = rmode? */
@@ -888,6 +842,7 @@ while (reason == 0)  {
                     MMR0 = 0;                           /* clear MMR0 */
                     MMR3 = 0;                           /* clear MMR3 */
                     cpu_bme = 0;                        /* (also clear bme) */
+                    reloc_set_all ();                   /* mmgt now off */
                     for (i = 0; i < IPL_HLVL; i++)
                         int_req[i] = 0;
                     trap_req = trap_req & ~TRAP_INT;
@@ -2101,6 +2056,140 @@ while (reason == 0)  {
         }                                               /* end switch op */
     }                                                   /* end main loop */
 
+return reason;
+}
+
+#undef CPUT
+#define CPUT(x)         ((cpu_type & (x)) != 0)
+
+static t_stat cpu_loop_70 (void)
+{
+return cpu_loop (CPUT_70);
+}
+
+static t_stat cpu_loop_j (void)
+{
+return cpu_loop (CPUT_J);
+}
+
+static t_stat cpu_loop_44 (void)
+{
+return cpu_loop (CPUT_44);
+}
+
+static t_stat cpu_loop_34 (void)
+{
+return cpu_loop (CPUT_34);
+}
+
+static t_stat cpu_loop_any (void)
+{
+return cpu_loop (CPUT_ALL);
+}
+
+static struct {
+    uint32              mask;                           /* models */
+    t_stat              (*loop)(void);                  /* specialized loop */
+    } cpu_loop_tab[] = {
+    { CPUT_70, &cpu_loop_70 },
+    { CPUT_J,  &cpu_loop_j },
+    { CPUT_44, &cpu_loop_44 },
+    { CPUT_34, &cpu_loop_34 },
+    { CPUT_ALL, &cpu_loop_any }                         /* must be last */
+    };
+
+static t_stat cpu_loop_sel (void)
+{
+int32 i;
+
+for (i = 0; !CPUT (cpu_loop_tab[i].mask); i++) ;
+return cpu_loop_tab[i].loop ();
+}
+
+t_value pdp11_pc_value (void)
+{
+return (t_value)PC;
+}
+
+t_stat sim_instr (void)
+{
+int abortval, i;
+t_stat reason;
+
+sim_vm_pc_value = &pdp11_pc_value;
+
+/* Restore register state
+
+        1. PSW components
+        2. Active register file based on PSW<rs>
+        3. Active stack pointer based on PSW<cm>
+        4. Memory management control flags
+        5. Interrupt system
+*/
+
+reason = build_dib_tab ();                              /* build, chk dib_tab */
+if (reason != SCPE_OK)
+    return reason;
+if (MEMSIZE < cpu_tab[cpu_model].maxm)                  /* mem size < max? */
+    cpu_memsize = MEMSIZE;                              /* then okay */
+else cpu_memsize = cpu_tab[cpu_model].maxm - IOPAGESIZE;/* max - io page */
+cpu_type = 1u << cpu_model;                             /* reset type mask */
+cpu_bme = (MMR3 & MMR3_BME) && (cpu_opt & OPT_UBM);     /* map enabled? */
+PC = saved_PC;
+put_PSW (PSW, 0);                                       /* set PSW, call calc_xs */
+for (i = 0; i < 6; i++)
+    R[i] = REGFILE[i][rs];
+SP = STACKFILE[cm];
+isenable = calc_is (cm);
+dsenable = calc_ds (cm);
+put_PIRQ (PIRQ);                                        /* rewrite PIRQ */
+STKLIM = STKLIM & STKLIM_RW;                            /* clean up STKLIM */
+MMR0 = MMR0 | MMR0_IC;                                  /* usually on */
+reloc_set_all ();                                       /* rebuild reloc cache */
+
+trap_req = calc_ints (ipl, trap_req);                   /* upd int req */
+trapea = 0;
+reason = 0;
+
+/* Abort handling
+
+   If an abort occurs in memory management or memory access, the lower
+   level routine executes a longjmp to this area OUTSIDE the main
+   simulation loop.  The longjmp specifies a trap mask which is OR'd
+   into the trap_req register.  Simulation then resumes at the fetch
+   phase, and the trap is sprung.
+
+   Aborts which occur within a trap sequence (trapea != 0) require
+   special handling.  If the abort occured on the stack pushes, and
+   the mode (encoded in trapea) is kernel, an "emergency" kernel
+   stack is created at 4, and a red zone stack trap taken.
+
+   All variables used in setjmp processing, or assumed to be valid
+   after setjmp, must be volatile or global.
+*/
+
+abortval = setjmp (save_env);                           /* set abort hdlr */
+if (abortval != 0) {
+    trap_req = trap_req | abortval;                     /* or in trap flag */
+    if ((trapea > 0) && stop_vecabort)
+        reason = STOP_VECABORT;
+    if ((trapea < 0) &&                                 /* stack push abort? */
+        (CPUT (STOP_STKA) || stop_spabort))
+        reason = STOP_SPABORT;
+    if (trapea == ~MD_KER) {                            /* kernel stk abort? */
+        setTRAP (TRAP_RED);
+        setCPUERR (CPUE_RED);
+        STACKFILE[MD_KER] = 4;
+        if (cm == MD_KER)
+            SP = 4;
+        }
+    }
+
+/* Main instruction fetch/decode loop, specialized for the current model */
+
+if (reason == 0)
+    reason = cpu_loop_sel ();
+
 /* Simulation halted */
 
 PSW = get_PSW ();
@@ -2487,6 +2576,8 @@ return;
    with an appropriate trap code.
 
    Notes:
+   - In-bounds references to readable pages are resolved from
+     reloc_tab with a single compare
    - The 'normal' read codes (010, 110) are done in-line; all
      others in a subroutine
    - APRFILE[UNUSED] is all zeroes, forcing non-resident abort
@@ -2496,7 +2587,10 @@ return;
 int32 relocR (int32 va)
 {
 int32 apridx, apr, pa;
+RelocEntry *rp = &reloc_tab[(va >> VA_V_APF) & 077];
 
+if (((uint32) (va & VA_DF) - rp->lo) < rp->rlnt)        /* cached, in bounds? */
+    return rp->base + (va & VA_DF);
 if (MMR0 & MMR0_MME) {                                  /* if mmgt */
     apridx = (va >> VA_V_APF) & 077;                    /* index into APR */
     apr = APRFILE[apridx];                              /* with va<18:13> */
@@ -2594,6 +2688,8 @@ return;
    with an appropriate trap code.
 
    Notes:
+   - In-bounds references to read/write pages whose W bit is
+     already set are resolved from reloc_tab with a single compare
    - The 'normal' write code (110) is done in-line; all others
      in a subroutine
    - APRFILE[UNUSED] is all zeroes, forcing non-resident abort
@@ -2603,7 +2699,10 @@ return;
 int32 relocW (int32 va)
 {
 int32 apridx, apr, pa;
+RelocEntry *rp = &reloc_tab[(va >> VA_V_APF) & 077];
 
+if (((uint32) (va & VA_DF) - rp->lo) < rp->wlnt)        /* cached, in bounds? */
+    return rp->base + (va & VA_DF);
 if (MMR0 & MMR0_MME) {                                  /* if mmgt */
     apridx = (va >> VA_V_APF) & 077;                    /* index into APR */
     apr = APRFILE[apridx];                              /* with va<18:13> */
@@ -2612,6 +2711,8 @@ if (MMR0 & MMR0_MME) {                                  /* if mmgt */
     if (PLF_test (va, apr))                             /* pg lnt error? */
         reloc_abort (MMR0_PL, apridx);
     APRFILE[apridx] = apr | PDR_W;                      /* set W */
+    if ((apr & PDR_W) == 0)                             /* first write? */
+        reloc_set (apridx);                             /* now cacheable */
     pa = ((va & VA_DF) + ((apr >> 10) & 017777700)) & PAMASK;
     if ((MMR3 & MMR3_M22E) == 0) {
         pa = pa & 0777777;
@@ -2677,6 +2778,74 @@ reloc_abort (err, apridx);
 return;
 }
 
+/* Rebuild relocation cache
+
+   Inputs:
+        apridx  =       APR index, <5:4> = mode, <3> = I/D space, <2:0> = page
+   Outputs: none
+
+   Each entry gives the range of displacements within the page that
+   pass the access control and page length tests, and the physical
+   base they relocate to.  A length of zero forces the full checks in
+   relocR/relocW.  Entries are only made fast when the whole valid
+   range relocates without 18b wraparound or partial overlap of the
+   I/O page, so that pa = base + disp holds exactly.  The cache must
+   be rebuilt whenever an APR, MMR0 or MMR3 changes.
+*/
+
+void reloc_set (int32 apridx)
+{
+RelocEntry *rp = &reloc_tab[apridx];
+int32 apr, plf, lo, hi, base;
+
+if ((MMR0 & MMR0_MME) == 0) {                           /* mmgt off? */
+    base = (apridx & 07) << VA_V_APF;                   /* 16b identity */
+    rp->lo = 0;
+    rp->rlnt = rp->wlnt = VA_DF + 1;
+    rp->base = (base >= 0160000)? 017600000 | base: base;
+    return;
+    }
+apr = APRFILE[apridx];
+plf = (apr & PDR_PLF) >> 2;                             /* page lnt in bytes */
+if (apr & PDR_ED) {                                     /* expands down? */
+    lo = plf;
+    hi = VA_DF;
+    }
+else {
+    lo = 0;
+    hi = plf | (VA_DF & ~VA_BN);
+    }
+base = (apr >> 10) & 017777700;
+rp->lo = lo;
+rp->rlnt = rp->wlnt = 0;
+rp->base = base;
+if (MMR3 & MMR3_M22E) {                                 /* 22b? */
+    if ((base + hi) > PAMASK)                           /* wraps? */
+        return;
+    }
+else if ((base + hi) > 0777777)                         /* 18b wraps? */
+    return;
+else if ((base + hi) >= 0760000) {                      /* reaches I/O page? */
+    if ((base + lo) < 0760000)                          /* straddles? */
+        return;
+    rp->base = base | 017000000;                        /* all in I/O page */
+    }
+if ((apr & PDR_PRD) == 2)                               /* readable, no trap? */
+    rp->rlnt = hi - lo + 1;
+if (((apr & PDR_ACF) == 6) && (apr & PDR_W))            /* writeable, W set? */
+    rp->wlnt = hi - lo + 1;
+return;
+}
+
+void reloc_set_all (void)
+{
+int32 i;
+
+for (i = 0; i < 64; i++)
+    reloc_set (i);
+return;
+}
+
 /* Relocate virtual address, console access
 
    Inputs:
@@ -2768,6 +2937,7 @@ switch ((pa >> 1) & 3) {                                /* decode pa<2:1> */
             data = (pa & 1)? (MMR0 & 0377) | (data << 8): (MMR0 & ~0377) | data;
         data = data & cpu_tab[cpu_model].mm0;
         MMR0 = (MMR0 & ~MMR0_WR) | (data & MMR0_WR);
+        reloc_set_all ();
         return SCPE_OK;
 
     default:                                            /* MMR1, MMR2 */
@@ -2788,6 +2958,7 @@ if (pa & 1)
 MMR3 = data & cpu_tab[cpu_model].mm3;
 cpu_bme = (MMR3 & MMR3_BME) && (cpu_opt & OPT_UBM);
 dsenable = calc_ds (cm);
+reloc_set_all ();
 return SCPE_OK;
 }
 
@@ -2845,6 +3016,7 @@ if (left)
         (((uint32) (data & cpu_tab[cpu_model].par)) << 16)) & ~(PDR_A|PDR_W);
 else APRFILE[idx] = ((APRFILE[idx] & ~0177777) |
     (data & cpu_tab[cpu_model].pdr)) & ~(PDR_A|PDR_W);
+reloc_set (idx);
 return SCPE_OK;
 }
 
@@ -2896,6 +3068,7 @@ if (rs != oldrs) {                                      /* switch reg set */
 SP = STACKFILE[cm];                                     /* switch SP */
 isenable = calc_is (cm);
 dsenable = calc_ds (cm);
+trap_req = trap_req | TRAP_CHK;                         /* ipl may have chg */
 return SCPE_OK;
 }
 
@@ -3007,10 +3180,11 @@ MMR0 = 0;
 MMR1 = 0;
 MMR2 = 0;
 MMR3 = 0;
+reloc_set_all ();
 trap_req = 0;
 wait_state = 0;
 if (M == NULL)
-    M = (uint16 *) calloc (MEMSIZE >> 1, sizeof (uint16));
+    M = (uint16 *) sim_mem_alloc ((size_t) MEMSIZE);
 if (M == NULL)
     return SCPE_MEM;
 pcq_r = find_reg ("PCQ", NULL, dptr);
@@ -1155,13 +1155,15 @@ for (i = val; i < MEMSIZE; i = i + 2)
     mc = mc | M[i >> 1];
 if ((mc != 0) && !get_yn ("Really truncate memory [N]?", FALSE))
     return SCPE_OK;
-nM = (uint16 *) calloc (val >> 1, sizeof (uint16));
+nM = (uint16 *) sim_mem_alloc ((size_t) val);
 if (nM == NULL)
     return SCPE_MEM;
 clim = (((t_addr) val) < MEMSIZE)? (uint32)val: MEMSIZE;
-for (i = 0; i < clim; i = i + 2)
-    nM[i >> 1] = M[i >> 1];
-free (M);
+for (i = 0; i < clim; i = i + 2) {                      /* copy, leaving */
+    if (M[i >> 1])                                      /* untouched pages */
+        nM[i >> 1] = M[i >> 1];                         /* unallocated */
+    }
+sim_mem_free (M, (size_t) MEMSIZE);
 M = nM;
 MEMSIZE = val;
 if (!(sim_switches & SIM_SW_REST))                      /* unless restore, */
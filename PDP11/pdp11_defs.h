@@ -442,6 +442,7 @@ typedef struct {
 #define TRAP_PWRFL      (1u << TRAP_V_PWRFL)
 #define TRAP_FPE        (1u << TRAP_V_FPE)
 #define TRAP_INT        (1u << TRAP_V_MAX)
+#define TRAP_CHK        (TRAP_INT << 1)                 /* int reqs changed */
 #define TRAP_ALL        ((1u << TRAP_V_MAX) - 1)        /* all traps */
 
 #define VEC_RED         0004                            /* trap vectors */
@@ -769,8 +770,11 @@ typedef struct pdp_dib DIB;
 
 #define IVCL(dv)        ((IPL_##dv * 32) + INT_V_##dv)
 #define IREQ(dv)        int_req[IPL_##dv]
-#define SET_INT(dv)     int_req[IPL_##dv] = int_req[IPL_##dv] | (INT_##dv)
-#define CLR_INT(dv)     int_req[IPL_##dv] = int_req[IPL_##dv] & ~(INT_##dv)
+#define SET_INT(dv)     int_req[IPL_##dv] = int_req[IPL_##dv] | (INT_##dv), \
+                        trap_req = trap_req | TRAP_CHK
+#define CLR_INT(dv)     int_req[IPL_##dv] = int_req[IPL_##dv] & ~(INT_##dv), \
+                        trap_req = trap_req | TRAP_CHK
+extern int32 trap_req;
 
 /* Massbus definitions */
 
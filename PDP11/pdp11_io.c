@@ -96,33 +96,29 @@ static const int32 int_internal[IPL_HLVL] = {
         access  =       READ, WRITE, or WRITEB
    Outputs:
         status  =       SCPE_OK or SCPE_NXM
+
+   Interrupt requests are not recalculated here.  SET_INT and CLR_INT
+   flag the change in trap_req (TRAP_CHK), and the CPU recalculates at
+   the next instruction boundary.
 */
 
 t_stat iopageR (int32 *data, uint32 pa, int32 access)
 {
 int32 idx;
-t_stat stat;
 
 idx = (pa & IOPAGEMASK) >> 1;
-if (iodispR[idx]) {
-    stat = iodispR[idx] (data, pa, access);
-    trap_req = calc_ints (ipl, trap_req);
-    return stat;
-    }
+if (iodispR[idx])
+    return iodispR[idx] (data, pa, access);
 return SCPE_NXM;
 }
 
 t_stat iopageW (int32 data, uint32 pa, int32 access)
 {
 int32 idx;
-t_stat stat;
 
 idx = (pa & IOPAGEMASK) >> 1;
-if (iodispW[idx]) {
-    stat = iodispW[idx] (data, pa, access);
-    trap_req = calc_ints (ipl, trap_req);
-    return stat;
-    }
+if (iodispW[idx])
+    return iodispW[idx] (data, pa, access);
 return SCPE_NXM;
 }
 
@@ -134,6 +130,7 @@ int32 calc_ints (int32 nipl, int32 trq)
 int32 i, t;
 t_bool all_int = (UNIBUS || (nipl < IPL_HMIN));
 
+trq = trq & ~TRAP_CHK;                                  /* now up to date */
 for (i = IPL_HLVL - 1; i > nipl; i--) {
     t = all_int? int_req[i]: (int_req[i] & int_internal[i]);
     if (t)
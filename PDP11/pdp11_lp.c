@@ -387,6 +387,10 @@ return SCPE_OK;
 
 t_stat lpt_svc (UNIT *uptr)
 {
+if ((uptr->flags & UNIT_ATT) && pdflpt_busy (uptr)) {  /* PDF rendering behind? */
+    sim_activate (uptr, uptr->wait);                    /* printer stays busy */
+    return SCPE_OK;
+    }
 lpt_csr = lpt_csr | CSR_ERR | CSR_DONE;
 if (lpt_csr & CSR_IE)
     SET_INT (LPT);
@@ -723,6 +723,7 @@ if (mb >= MBA_NUM)
     return;
 dibp = (DIB *) mba_dev[mb].ctxt;
 int_req[dibp->vloc >> 5] |= (1 << (dibp->vloc & 037));
+trap_req = trap_req | TRAP_CHK;
 return;
 }
 
@@ -734,6 +735,7 @@ if (mb >= MBA_NUM)
     return;
 dibp = (DIB *) mba_dev[mb].ctxt;
 int_req[dibp->vloc >> 5] &= ~(1 << (dibp->vloc & 037));
+trap_req = trap_req | TRAP_CHK;
 return;
 }
 
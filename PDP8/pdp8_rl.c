@@ -252,7 +252,7 @@ DEVICE rl_dev = {
     RL_NUMDR, 8, 24, 1, 8, 8,
     NULL, NULL, &rl_reset,
     &rl_boot, &rl_attach, NULL,
-    &rl_dib, DEV_DISABLE | DEV_DIS
+    &rl_dib, DEV_DISABLE | DEV_DIS | DEV_RSTDEFER
     };
 
 /* IOT routines */
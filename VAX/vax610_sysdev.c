@@ -502,7 +502,7 @@ return "system devices";
 
 t_stat cpu_set_model (UNIT *uptr, int32 val, char *cptr, void *desc)
 {
-#if defined(HAVE_LIBSDL) 
+#if defined(HAVE_LIBSDL) || defined(USE_OFFSCREEN_VIDEO)
 char gbuf[CBUFSIZE];
 
 if ((cptr == NULL) || (!*cptr))
@@ -1013,7 +1013,7 @@ return SCPE_OK;
 
 t_stat cpu_set_model (UNIT *uptr, int32 val, char *cptr, void *desc)
 {
-#if defined(HAVE_LIBSDL)
+#if defined(HAVE_LIBSDL) || defined(USE_OFFSCREEN_VIDEO)
 char gbuf[CBUFSIZE];
 
 if ((cptr == NULL) || (!*cptr))
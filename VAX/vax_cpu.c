@@ -228,6 +228,23 @@
                             R[rn + 1] = rh; \
                             }
 
+/* Opcode dispatch.  Built with SIM_COMPUTED_GOTO, each opcode case is also
+   a label in op_tab, and DISPATCH jumps through the table rather than the
+   switch's range checked jump; undefined opcodes go to the default case.
+   Operand specifiers are decoded ahead of every dispatch, so the jump is
+   not replicated at the end of each instruction.
+*/
+
+#if defined (SIM_COMPUTED_GOTO)
+#define OP(n)           case n: op_##n
+#define OP_DEFAULT      default: op_default
+#define DISPATCH(n)     goto *op_tab[n]; switch (n)
+#else
+#define OP(n)           case n
+#define OP_DEFAULT      default
+#define DISPATCH(n)     switch (n)
+#endif
+
 #define HIST_MIN        64
 #define HIST_MAX        65536
 
@@ -373,6 +390,7 @@ extern int32 BadCmPSL (int32 newpsl);
 extern int32 eval_int (void);
 extern int32 get_vector (int32 lvl);
 extern void set_map_reg (void);
+extern void zap_tb (int stb);
 extern void rom_wr_B (int32 pa, int32 val);
 extern int32 machine_check (int32 p1, int32 opc, int32 cc, int32 delta);
 extern const uint16 drom[NUM_INST][MAX_SPEC + 1];
@@ -472,7 +490,7 @@ REG cpu_reg[] = {
     { HRDATAD (ASTLVL,  ASTLVL,  4, "AST level register") },
     { FLDATAD (MAPEN,    mapen,  0, "memory management enable") },
     { FLDATAD (PME,        pme,  0, "performance monitor enable") },
-    { HRDATAD (TRPIRQ,  trpirq,  8, "trap/interrupt pending") },
+    { HRDATAD (TRPIRQ,  trpirq,  9, "trap/interrupt pending") },
     { FLDATAD (CRDERR, crd_err,  0, "correctible read data error flag") },
     { FLDATAD (MEMERR, mem_err,  0, "memory error flag") },
     { FLDATA (HLTPIN, hlt_pin,  0) },
@@ -551,6 +569,113 @@ volatile int32 opc, cc;                                 /* used by setjmp */
 volatile int32 acc;                                     /* set by setjmp */
 int abortval;
 t_stat r;
+#if defined (SIM_COMPUTED_GOTO)
+static const void *const op_tab[0x200] = {             /* opcode labels */
+    [0 ... 0x1FF] = &&op_default,
+    [CLRB] = &&op_CLRB, [CLRW] = &&op_CLRW, [CLRL] = &&op_CLRL,
+    [CLRQ] = &&op_CLRQ, [TSTB] = &&op_TSTB, [TSTW] = &&op_TSTW,
+    [TSTL] = &&op_TSTL, [INCB] = &&op_INCB, [INCW] = &&op_INCW,
+    [INCL] = &&op_INCL, [DECB] = &&op_DECB, [DECW] = &&op_DECW,
+    [DECL] = &&op_DECL, [PUSHL] = &&op_PUSHL, [PUSHAB] = &&op_PUSHAB,
+    [PUSHAW] = &&op_PUSHAW, [PUSHAL] = &&op_PUSHAL, [PUSHAQ] = &&op_PUSHAQ,
+    [MOVB] = &&op_MOVB, [MOVW] = &&op_MOVW, [MOVZBW] = &&op_MOVZBW,
+    [MOVL] = &&op_MOVL, [MOVZBL] = &&op_MOVZBL, [MOVZWL] = &&op_MOVZWL,
+    [MOVAB] = &&op_MOVAB, [MOVAW] = &&op_MOVAW, [MOVAL] = &&op_MOVAL,
+    [MOVAQ] = &&op_MOVAQ, [MCOMB] = &&op_MCOMB, [MCOMW] = &&op_MCOMW,
+    [MCOML] = &&op_MCOML, [MNEGB] = &&op_MNEGB, [MNEGW] = &&op_MNEGW,
+    [MNEGL] = &&op_MNEGL, [CVTBW] = &&op_CVTBW, [CVTBL] = &&op_CVTBL,
+    [CVTWL] = &&op_CVTWL, [CVTLB] = &&op_CVTLB, [CVTLW] = &&op_CVTLW,
+    [CVTWB] = &&op_CVTWB, [ADAWI] = &&op_ADAWI, [CMPB] = &&op_CMPB,
+    [CMPW] = &&op_CMPW, [CMPL] = &&op_CMPL, [BITB] = &&op_BITB,
+    [BITW] = &&op_BITW, [BITL] = &&op_BITL, [ADDB2] = &&op_ADDB2,
+    [ADDB3] = &&op_ADDB3, [ADDW2] = &&op_ADDW2, [ADDW3] = &&op_ADDW3,
+    [ADWC] = &&op_ADWC, [ADDL2] = &&op_ADDL2, [ADDL3] = &&op_ADDL3,
+    [SUBB2] = &&op_SUBB2, [SUBB3] = &&op_SUBB3, [SUBW2] = &&op_SUBW2,
+    [SUBW3] = &&op_SUBW3, [SBWC] = &&op_SBWC, [SUBL2] = &&op_SUBL2,
+    [SUBL3] = &&op_SUBL3, [MULB2] = &&op_MULB2, [MULB3] = &&op_MULB3,
+    [MULW2] = &&op_MULW2, [MULW3] = &&op_MULW3, [MULL2] = &&op_MULL2,
+    [MULL3] = &&op_MULL3, [DIVB2] = &&op_DIVB2, [DIVB3] = &&op_DIVB3,
+    [DIVW2] = &&op_DIVW2, [DIVW3] = &&op_DIVW3, [DIVL2] = &&op_DIVL2,
+    [DIVL3] = &&op_DIVL3, [BISB2] = &&op_BISB2, [BISB3] = &&op_BISB3,
+    [BISW2] = &&op_BISW2, [BISW3] = &&op_BISW3, [BISL2] = &&op_BISL2,
+    [BISL3] = &&op_BISL3, [BICB2] = &&op_BICB2, [BICB3] = &&op_BICB3,
+    [BICW2] = &&op_BICW2, [BICW3] = &&op_BICW3, [BICL2] = &&op_BICL2,
+    [BICL3] = &&op_BICL3, [XORB2] = &&op_XORB2, [XORB3] = &&op_XORB3,
+    [XORW2] = &&op_XORW2, [XORW3] = &&op_XORW3, [XORL2] = &&op_XORL2,
+    [XORL3] = &&op_XORL3, [MOVQ] = &&op_MOVQ, [ROTL] = &&op_ROTL,
+    [ASHL] = &&op_ASHL, [ASHQ] = &&op_ASHQ, [EMUL] = &&op_EMUL,
+    [EDIV] = &&op_EDIV, [BRB] = &&op_BRB, [BRW] = &&op_BRW,
+    [BSBB] = &&op_BSBB, [BSBW] = &&op_BSBW, [BGEQ] = &&op_BGEQ,
+    [BLSS] = &&op_BLSS, [BNEQ] = &&op_BNEQ, [BEQL] = &&op_BEQL,
+    [BVC] = &&op_BVC, [BVS] = &&op_BVS, [BGEQU] = &&op_BGEQU,
+    [BLSSU] = &&op_BLSSU, [BGTR] = &&op_BGTR, [BLEQ] = &&op_BLEQ,
+    [BGTRU] = &&op_BGTRU, [BLEQU] = &&op_BLEQU, [JSB] = &&op_JSB,
+    [JMP] = &&op_JMP, [RSB] = &&op_RSB, [SOBGEQ] = &&op_SOBGEQ,
+    [SOBGTR] = &&op_SOBGTR, [AOBLSS] = &&op_AOBLSS, [AOBLEQ] = &&op_AOBLEQ,
+    [ACBB] = &&op_ACBB, [ACBW] = &&op_ACBW, [ACBL] = &&op_ACBL,
+    [CASEB] = &&op_CASEB, [CASEW] = &&op_CASEW, [CASEL] = &&op_CASEL,
+    [BBS] = &&op_BBS, [BBC] = &&op_BBC, [BBSS] = &&op_BBSS,
+    [BBSSI] = &&op_BBSSI, [BBCC] = &&op_BBCC, [BBCCI] = &&op_BBCCI,
+    [BBSC] = &&op_BBSC, [BBCS] = &&op_BBCS, [BLBS] = &&op_BLBS,
+    [BLBC] = &&op_BLBC, [EXTV] = &&op_EXTV, [EXTZV] = &&op_EXTZV,
+    [CMPV] = &&op_CMPV, [CMPZV] = &&op_CMPZV, [FFS] = &&op_FFS,
+    [FFC] = &&op_FFC, [INSV] = &&op_INSV, [CALLS] = &&op_CALLS,
+    [CALLG] = &&op_CALLG, [RET] = &&op_RET, [HALT] = &&op_HALT,
+    [NOP] = &&op_NOP, [BPT] = &&op_BPT, [XFC] = &&op_XFC,
+    [BISPSW] = &&op_BISPSW, [BICPSW] = &&op_BICPSW, [MOVPSL] = &&op_MOVPSL,
+    [PUSHR] = &&op_PUSHR, [POPR] = &&op_POPR, [INDEX] = &&op_INDEX,
+    [INSQUE] = &&op_INSQUE, [REMQUE] = &&op_REMQUE, [INSQHI] = &&op_INSQHI,
+    [INSQTI] = &&op_INSQTI, [REMQHI] = &&op_REMQHI, [REMQTI] = &&op_REMQTI,
+    [MOVC3] = &&op_MOVC3, [MOVC5] = &&op_MOVC5, [CMPC3] = &&op_CMPC3,
+    [CMPC5] = &&op_CMPC5, [LOCC] = &&op_LOCC, [SKPC] = &&op_SKPC,
+    [SCANC] = &&op_SCANC, [SPANC] = &&op_SPANC, [TSTF] = &&op_TSTF,
+    [TSTD] = &&op_TSTD, [TSTG] = &&op_TSTG, [MOVF] = &&op_MOVF,
+    [MOVD] = &&op_MOVD, [MOVG] = &&op_MOVG, [MNEGF] = &&op_MNEGF,
+    [MNEGD] = &&op_MNEGD, [MNEGG] = &&op_MNEGG, [CMPF] = &&op_CMPF,
+    [CMPD] = &&op_CMPD, [CMPG] = &&op_CMPG, [CVTBF] = &&op_CVTBF,
+    [CVTWF] = &&op_CVTWF, [CVTLF] = &&op_CVTLF, [CVTBD] = &&op_CVTBD,
+    [CVTBG] = &&op_CVTBG, [CVTWD] = &&op_CVTWD, [CVTWG] = &&op_CVTWG,
+    [CVTLD] = &&op_CVTLD, [CVTLG] = &&op_CVTLG, [CVTFB] = &&op_CVTFB,
+    [CVTDB] = &&op_CVTDB, [CVTGB] = &&op_CVTGB, [CVTFW] = &&op_CVTFW,
+    [CVTDW] = &&op_CVTDW, [CVTGW] = &&op_CVTGW, [CVTFL] = &&op_CVTFL,
+    [CVTDL] = &&op_CVTDL, [CVTGL] = &&op_CVTGL, [CVTRFL] = &&op_CVTRFL,
+    [CVTRDL] = &&op_CVTRDL, [CVTRGL] = &&op_CVTRGL, [CVTFD] = &&op_CVTFD,
+    [CVTDF] = &&op_CVTDF, [CVTFG] = &&op_CVTFG, [CVTGF] = &&op_CVTGF,
+    [ADDF2] = &&op_ADDF2, [ADDF3] = &&op_ADDF3, [ADDD2] = &&op_ADDD2,
+    [ADDD3] = &&op_ADDD3, [ADDG2] = &&op_ADDG2, [ADDG3] = &&op_ADDG3,
+    [SUBF2] = &&op_SUBF2, [SUBF3] = &&op_SUBF3, [SUBD2] = &&op_SUBD2,
+    [SUBD3] = &&op_SUBD3, [SUBG2] = &&op_SUBG2, [SUBG3] = &&op_SUBG3,
+    [MULF2] = &&op_MULF2, [MULF3] = &&op_MULF3, [MULD2] = &&op_MULD2,
+    [MULD3] = &&op_MULD3, [MULG2] = &&op_MULG2, [MULG3] = &&op_MULG3,
+    [DIVF2] = &&op_DIVF2, [DIVF3] = &&op_DIVF3, [DIVD2] = &&op_DIVD2,
+    [DIVD3] = &&op_DIVD3, [DIVG2] = &&op_DIVG2, [DIVG3] = &&op_DIVG3,
+    [ACBF] = &&op_ACBF, [ACBD] = &&op_ACBD, [ACBG] = &&op_ACBG,
+    [EMODF] = &&op_EMODF, [EMODD] = &&op_EMODD, [EMODG] = &&op_EMODG,
+    [POLYF] = &&op_POLYF, [POLYD] = &&op_POLYD, [POLYG] = &&op_POLYG,
+    [CHMK] = &&op_CHMK, [CHME] = &&op_CHME, [CHMS] = &&op_CHMS,
+    [CHMU] = &&op_CHMU, [REI] = &&op_REI, [LDPCTX] = &&op_LDPCTX,
+    [SVPCTX] = &&op_SVPCTX, [PROBER] = &&op_PROBER, [PROBEW] = &&op_PROBEW,
+    [MTPR] = &&op_MTPR, [MFPR] = &&op_MFPR, [CVTPL] = &&op_CVTPL,
+    [MOVP] = &&op_MOVP, [CMPP3] = &&op_CMPP3, [CMPP4] = &&op_CMPP4,
+    [CVTLP] = &&op_CVTLP, [CVTPS] = &&op_CVTPS, [CVTSP] = &&op_CVTSP,
+    [CVTTP] = &&op_CVTTP, [CVTPT] = &&op_CVTPT, [ADDP4] = &&op_ADDP4,
+    [ADDP6] = &&op_ADDP6, [SUBP4] = &&op_SUBP4, [SUBP6] = &&op_SUBP6,
+    [MULP] = &&op_MULP, [DIVP] = &&op_DIVP, [ASHP] = &&op_ASHP,
+    [CRC] = &&op_CRC, [MOVTC] = &&op_MOVTC, [MOVTUC] = &&op_MOVTUC,
+    [MATCHC] = &&op_MATCHC, [EDITPC] = &&op_EDITPC, [PUSHAO] = &&op_PUSHAO,
+    [MOVAO] = &&op_MOVAO, [CLRO] = &&op_CLRO, [MOVO] = &&op_MOVO,
+    [TSTH] = &&op_TSTH, [MOVH] = &&op_MOVH, [MNEGH] = &&op_MNEGH,
+    [CMPH] = &&op_CMPH, [CVTBH] = &&op_CVTBH, [CVTWH] = &&op_CVTWH,
+    [CVTLH] = &&op_CVTLH, [CVTHB] = &&op_CVTHB, [CVTHW] = &&op_CVTHW,
+    [CVTHL] = &&op_CVTHL, [CVTRHL] = &&op_CVTRHL, [CVTFH] = &&op_CVTFH,
+    [CVTDH] = &&op_CVTDH, [CVTGH] = &&op_CVTGH, [CVTHF] = &&op_CVTHF,
+    [CVTHD] = &&op_CVTHD, [CVTHG] = &&op_CVTHG, [ADDH2] = &&op_ADDH2,
+    [ADDH3] = &&op_ADDH3, [SUBH2] = &&op_SUBH2, [SUBH3] = &&op_SUBH3,
+    [MULH2] = &&op_MULH2, [MULH3] = &&op_MULH3, [DIVH2] = &&op_DIVH2,
+    [DIVH3] = &&op_DIVH3, [ACBH] = &&op_ACBH, [POLYH] = &&op_POLYH,
+    [EMODH] = &&op_EMODH
+    };
+#endif
 
 if ((r = build_dib_tab ()) != SCPE_OK)                  /* build, chk dib_tab */
     return r;
@@ -564,6 +689,10 @@ cc = PSL & CC_MASK;                                     /* split PSL */
 PSL = PSL & ~CC_MASK;
 in_ie = 0;                                              /* not in exc */
 set_map_reg ();                                         /* set map reg */
+if (sim_brk_wchg) {                                     /* watchpoints changed? */
+    zap_tb (1);                                         /* drop cached pages */
+    sim_brk_wchg = FALSE;
+    }
 GET_CUR;                                                /* set access mask */
 SET_IRQL;                                               /* eval interrupts */
 FLUSH_ISTR;                                             /* clear prefetch */
@@ -674,6 +803,8 @@ for ( ;; ) {
             ABORT (temp);
         SET_IRQL;                                       /* update interrupts */
         }
+    if (trpirq & TIR_CHK)                               /* int reqs changed? */
+        SET_IRQL;                                       /* update interrupts */
 
 /* Test for non-instruction dispatches, in SRM order
 
@@ -733,12 +864,15 @@ for ( ;; ) {
             }
         }                                               /* end PSL event */
 
-    if (sim_brk_summ &&
-        sim_brk_test ((uint32) PC, SWMASK ('E'))) {     /* breakpoint? */
-        ABORT (STOP_IBKPT);                             /* stop simulation */
+    if (sim_brk_summ) {
+        if (sim_brk_test ((uint32) PC, SWMASK ('E')))   /* breakpoint? */
+            ABORT (STOP_IBKPT);                         /* stop simulation */
+        if (sim_brk_wpend)                              /* watchpoint hit? */
+            ABORT (STOP_WBKPT);
         }
 
     sim_interval = sim_interval - 1;                    /* count instr */
+    SIM_PROF_SAMPLE (PC, SWMASK ("KESU"[PSL_GETCUR (PSL)])); /* profile guest PC */
     GET_ISTR (opc, L_BYTE);                             /* get opcode */
     if (opc == 0xFD) {                                  /* 2 byte op? */
         GET_ISTR (opc, L_BYTE);                         /* get second byte */
@@ -1583,7 +1717,7 @@ for ( ;; ) {
 
 /* Dispatch to instructions */
 
-    switch (opc) {              
+    DISPATCH (opc) {
 
 /* Single operand instructions with dest, write only - CLRx dst.wx
 
@@ -1592,22 +1726,22 @@ for ( ;; ) {
         va      =       virtual address
 */
 
-    case CLRB:
+    OP (CLRB):
         WRITE_B (0);                                    /* store result */
         CC_ZZ1P;                                        /* set cc's */
         break;
 
-    case CLRW:
+    OP (CLRW):
         WRITE_W (0);                                    /* store result */
         CC_ZZ1P;                                        /* set cc's */
         break;
 
-    case CLRL:
+    OP (CLRL):
         WRITE_L (0);                                    /* store result */
         CC_ZZ1P;                                        /* set cc's */
         break;
 
-    case CLRQ:
+    OP (CLRQ):
         WRITE_Q (0, 0);                                 /* store result */
         CC_ZZ1P;                                        /* set cc's */
         break;
@@ -1617,15 +1751,15 @@ for ( ;; ) {
         opnd[0] =       source
 */
 
-    case TSTB:
+    OP (TSTB):
         CC_IIZZ_B (op0);                                /* set cc's */
         break;
 
-    case TSTW:
+    OP (TSTW):
         CC_IIZZ_W (op0);                                /* set cc's */
         break;
 
-    case TSTL:
+    OP (TSTL):
         CC_IIZZ_L (op0);                                /* set cc's */
         if ((cc == CC_Z) &&                             /* zero result and */
             ((((cpu_idle_mask & VAX_IDLE_ULTOLD) &&     /* running Old Ultrix or friends? */
@@ -1646,37 +1780,37 @@ for ( ;; ) {
         va      =       operand address
 */
 
-    case INCB:
+    OP (INCB):
         r = (op0 + 1) & BMASK;                          /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_ADD_B (r, 1, op0);                           /* set cc's */
         break;
 
-    case INCW:
+    OP (INCW):
         r = (op0 + 1) & WMASK;                          /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_ADD_W (r, 1, op0);                           /* set cc's */
         break;
 
-    case INCL:
+    OP (INCL):
         r = (op0 + 1) & LMASK;                          /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_ADD_L (r, 1, op0);                           /* set cc's */
         break;
 
-    case DECB:
+    OP (DECB):
         r = (op0 - 1) & BMASK;                          /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_SUB_B (r, 1, op0);                           /* set cc's */
         break;
 
-    case DECW:
+    OP (DECW):
         r = (op0 - 1) & WMASK;                          /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_SUB_W (r, 1, op0);                           /* set cc's */
         break;
 
-    case DECL:
+    OP (DECL):
         r = (op0 - 1) & LMASK;                          /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_SUB_L (r, 1, op0);                           /* set cc's */
@@ -1687,7 +1821,7 @@ for ( ;; ) {
         opnd[0] =       source
 */
 
-    case PUSHL: case PUSHAB: case PUSHAW: case PUSHAL: case PUSHAQ:
+    OP (PUSHL): OP (PUSHAB): OP (PUSHAW): OP (PUSHAL): OP (PUSHAQ):
         Write (SP - 4, op0, L_LONG, WA);                /* push operand */
         SP = SP - 4;                                    /* decr stack ptr */
         CC_IIZP_L (op0);                                /* set cc's */
@@ -1701,77 +1835,77 @@ for ( ;; ) {
         va      =       operand address
 */
 
-    case MOVB:
+    OP (MOVB):
         WRITE_B (op0);                                  /* result */
         CC_IIZP_B (op0);                                /* set cc's */
         break;
 
-    case MOVW: case MOVZBW:
+    OP (MOVW): OP (MOVZBW):
         WRITE_W (op0);                                  /* result */
         CC_IIZP_W (op0);                                /* set cc's */
         break;
 
-    case MOVL: case MOVZBL: case MOVZWL:
-    case MOVAB: case MOVAW: case MOVAL: case MOVAQ:
+    OP (MOVL): OP (MOVZBL): OP (MOVZWL):
+    OP (MOVAB): OP (MOVAW): OP (MOVAL): OP (MOVAQ):
         WRITE_L (op0);                                  /* result */
         CC_IIZP_L (op0);                                /* set cc's */
         break;
 
-    case MCOMB:
+    OP (MCOMB):
         r = op0 ^ BMASK;                                /* compl opnd */
         WRITE_B (r);                                    /* store result */
         CC_IIZP_B (r);                                  /* set cc's */
         break;
 
-    case MCOMW:
+    OP (MCOMW):
         r = op0 ^ WMASK;                                /* compl opnd */
         WRITE_W (r);                                    /* store result */
         CC_IIZP_W (r);                                  /* set cc's */
         break;
 
-    case MCOML:
+    OP (MCOML):
         r = op0 ^ LMASK;                                /* compl opnd */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
         break;
 
-    case MNEGB:
+    OP (MNEGB):
         r = (-op0) & BMASK;                             /* negate opnd */
         WRITE_B (r);                                    /* store result */
         CC_SUB_B (r, op0, 0);                           /* set cc's */
         break;
 
-    case MNEGW:
+    OP (MNEGW):
         r = (-op0) & WMASK;                             /* negate opnd */
         WRITE_W (r);                                    /* store result */
         CC_SUB_W (r, op0, 0);                           /* set cc's */
         break;
 
-    case MNEGL:
+    OP (MNEGL):
         r = (-op0) & LMASK;                             /* negate opnd */
         WRITE_L (r);                                    /* store result */
         CC_SUB_L (r, op0, 0);                           /* set cc's */
         break;
 
-    case CVTBW:
+    OP (CVTBW):
         r = SXTBW (op0);                                /* ext sign */
         WRITE_W (r);                                    /* store result */
         CC_IIZZ_W (r);                                  /* set cc's */
         break;
 
-    case CVTBL:
+    OP (CVTBL):
         r = SXTB (op0);                                 /* ext sign */
         WRITE_L (r);                                    /* store result */
         CC_IIZZ_L (r);                                  /* set cc's */
         break;
 
-    case CVTWL:
+    OP (CVTWL):
         r = SXTW (op0);                                 /* ext sign */
         WRITE_L (r);                                    /* store result */
         CC_IIZZ_L (r);                                  /* set cc's */
         break;
 
-    case CVTLB:
+    OP (CVTLB):
         r = op0 & BMASK;                                /* set result */
         WRITE_B (r);                                    /* store result */
         CC_IIZZ_B (r);                                  /* initial cc's */
@@ -1780,7 +1914,7 @@ for ( ;; ) {
             }
         break;
 
-    case CVTLW:
+    OP (CVTLW):
         r = op0 & WMASK;                                /* set result */
         WRITE_W (r);                                    /* store result */
         CC_IIZZ_W (r);                                  /* initial cc's */
@@ -1789,7 +1923,7 @@ for ( ;; ) {
             }
         break;
 
-    case CVTWB:
+    OP (CVTWB):
         r = op0 & BMASK;                                /* set result */
         WRITE_B (r);                                    /* store result */
         CC_IIZZ_B (r);                                  /* initial cc's */
@@ -1799,7 +1933,7 @@ for ( ;; ) {
             }
         break;
 
-    case ADAWI:
+    OP (ADAWI):
         if (op1 >= 0) temp = R[op1] & WMASK;            /* reg? ADDW2 */
         else {
             if (op2 & 1)                                /* mem? chk align */
@@ -1817,29 +1951,29 @@ for ( ;; ) {
         opnd[1] =       source2
 */
 
-    case CMPB:
+    OP (CMPB):
         CC_CMP_B (op0, op1);                            /* set cc's */
         break;
 
-    case CMPW:
+    OP (CMPW):
         CC_CMP_W (op0, op1);                            /* set cc's */
         break;
 
-    case CMPL:
+    OP (CMPL):
         CC_CMP_L (op0, op1);                            /* set cc's */
         break;
 
-    case BITB:
+    OP (BITB):
         r = op1 & op0;                                  /* calc result */
         CC_IIZP_B (r);                                  /* set cc's */
         break;
 
-    case BITW:
+    OP (BITW):
         r = op1 & op0;                                  /* calc result */
         CC_IIZP_W (r);                                  /* set cc's */
         break;
 
-    case BITL:
+    OP (BITL):
         r = op1 & op0;                                  /* calc result */
         CC_IIZP_L (r);                                  /* set cc's */
         if ((cc == CC_Z) &&
@@ -1862,19 +1996,19 @@ for ( ;; ) {
         va      =       memory address
 */
 
-    case ADDB2: case ADDB3:
+    OP (ADDB2): OP (ADDB3):
         r = (op1 + op0) & BMASK;                        /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_ADD_B (r, op0, op1);                         /* set cc's */
         break;
 
-    case ADDW2: case ADDW3:
+    OP (ADDW2): OP (ADDW3):
         r = (op1 + op0) & WMASK;                        /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_ADD_W (r, op0, op1);                         /* set cc's */
         break;
 
-    case ADWC:
+    OP (ADWC):
         r = (op1 + op0 + (cc & CC_C)) & LMASK;          /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_ADD_L (r, op0, op1);                         /* set cc's */
@@ -1882,25 +2016,25 @@ for ( ;; ) {
             cc = cc | CC_C;
         break;
 
-    case ADDL2: case ADDL3:
+    OP (ADDL2): OP (ADDL3):
         r = (op1 + op0) & LMASK;                        /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_ADD_L (r, op0, op1);                         /* set cc's */
         break;
 
-    case SUBB2: case SUBB3:
+    OP (SUBB2): OP (SUBB3):
         r = (op1 - op0) & BMASK;                        /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_SUB_B (r, op0, op1);                         /* set cc's */
         break;
 
-    case SUBW2: case SUBW3:
+    OP (SUBW2): OP (SUBW3):
         r = (op1 - op0) & WMASK;                        /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_SUB_W (r, op0, op1);                         /* set cc's */
         break;
 
-    case SBWC:
+    OP (SBWC):
         r = (op1 - op0 - (cc & CC_C)) & LMASK;          /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_SUB_L (r, op0, op1);                         /* set cc's */
@@ -1908,13 +2042,13 @@ for ( ;; ) {
             cc = cc | CC_C;
         break;
 
-    case SUBL2: case SUBL3:
+    OP (SUBL2): OP (SUBL3):
         r = (op1 - op0) & LMASK;                        /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_SUB_L (r, op0, op1);                         /* set cc's */
         break;
 
-    case MULB2: case MULB3:
+    OP (MULB2): OP (MULB3):
         temp = SXTB (op0) * SXTB (op1);                 /* multiply */
         r = temp & BMASK;                               /* mask to result */
         WRITE_B (r);                                    /* store result */
@@ -1924,7 +2058,7 @@ for ( ;; ) {
             }
         break;
 
-    case MULW2: case MULW3:
+    OP (MULW2): OP (MULW3):
         temp = SXTW (op0) * SXTW (op1);                 /* multiply */
         r = temp & WMASK;                               /* mask to result */
         WRITE_W (r);                                    /* store result */
@@ -1934,7 +2068,7 @@ for ( ;; ) {
             }
         break;
 
-    case MULL2: case MULL3:
+    OP (MULL2): OP (MULL3):
         r = op_emul (op0, op1, &rh);                    /* get 64b result */
         WRITE_L (r);                                    /* store result */
         CC_IIZZ_L (r);                                  /* set cc's */
@@ -1943,7 +2077,7 @@ for ( ;; ) {
             }
         break;
 
-    case DIVB2: case DIVB3:
+    OP (DIVB2): OP (DIVB3):
         if (op0 == 0) {                                 /* div by zero? */
             r = op1;
             temp = CC_V;
@@ -1964,7 +2098,7 @@ for ( ;; ) {
         cc = cc | temp;                                 /* error? set V */
         break;
 
-    case DIVW2: case DIVW3:
+    OP (DIVW2): OP (DIVW3):
         if (op0 == 0) {                                 /* div by zero? */
             r = op1;
             temp = CC_V;
@@ -1985,7 +2119,7 @@ for ( ;; ) {
         cc = cc | temp;                                 /* error? set V */
         break;
 
-    case DIVL2: case DIVL3:
+    OP (DIVL2): OP (DIVL3):
         if (op0 == 0) {                                 /* div by zero? */
             r = op1;
             temp = CC_V;
@@ -2007,55 +2141,55 @@ for ( ;; ) {
         cc = cc | temp;                                 /* error? set V */
         break;
 
-    case BISB2: case BISB3:
+    OP (BISB2): OP (BISB3):
         r = op1 | op0;                                  /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_IIZP_B (r);                                  /* set cc's */
         break;
 
-    case BISW2: case BISW3:
+    OP (BISW2): OP (BISW3):
         r = op1 | op0;                                  /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_IIZP_W (r);                                  /* set cc's */
         break;
 
-    case BISL2: case BISL3:
+    OP (BISL2): OP (BISL3):
         r = op1 | op0;                                  /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
         break;
 
-    case BICB2: case BICB3:
+    OP (BICB2): OP (BICB3):
         r = op1 & ~op0;                                 /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_IIZP_B (r);                                  /* set cc's */
         break;
 
-    case BICW2: case BICW3:
+    OP (BICW2): OP (BICW3):
         r = op1 & ~op0;                                 /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_IIZP_W (r);                                  /* set cc's */
         break;
 
-    case BICL2: case BICL3:
+    OP (BICL2): OP (BICL3):
         r = op1 & ~op0;                                 /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
         break;
 
-    case XORB2: case XORB3:
+    OP (XORB2): OP (XORB3):
         r = op1 ^ op0;                                  /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_IIZP_B (r);                                  /* set cc's */
         break;
 
-    case XORW2: case XORW3:
+    OP (XORW2): OP (XORW3):
         r = op1 ^ op0;                                  /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_IIZP_W (r);                                  /* set cc's */
         break;
 
-    case XORL2: case XORL3:
+    OP (XORL2): OP (XORL3):
         r = op1 ^ op0;                                  /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
@@ -2070,7 +2204,7 @@ for ( ;; ) {
         
 */
 
-    case MOVQ:
+    OP (MOVQ):
         WRITE_Q (op0, op1);                             /* store result */
         CC_IIZP_Q (op0, op1);
         break;
@@ -2084,7 +2218,7 @@ for ( ;; ) {
         va      =       memory address
 */
 
-    case ROTL:
+    OP (ROTL):
         j = op0 % 32;                                   /* reduce sc, mod 32 */
         if (j)
             r = ((((uint32) op1) << j) | (((uint32) op1) >> (32 - j))) & LMASK;
@@ -2093,7 +2227,7 @@ for ( ;; ) {
         CC_IIZP_L (r);                                  /* set cc's */
         break;
 
-    case ASHL:
+    OP (ASHL):
         if (op0 & BSIGN) {                              /* right shift? */
             temp = 0x100 - op0;                         /* get |shift| */
             if (temp > 31)                              /* sc > 31? */
@@ -2118,7 +2252,7 @@ for ( ;; ) {
             }
         break;
 
-    case ASHQ:
+    OP (ASHQ):
         r = op_ashq (opnd, &rh, &flg);                  /* do qw shift */
         WRITE_Q (r, rh);                                /* store results */
         CC_IIZZ_Q (r, rh);                              /* set cc's */
@@ -2135,7 +2269,7 @@ for ( ;; ) {
         op3:op4 =       destination (.wq)
 */
 
-    case EMUL:
+    OP (EMUL):
         r = op_emul (op0, op1, &rh);                    /* calc 64b result */
         r = r + op2;                                    /* add 32b value */
         rh = rh + (((uint32) r) < ((uint32) op2)) -     /* into 64b result */
@@ -2152,7 +2286,7 @@ for ( ;; ) {
         op5:op6 =       remainder address (.wl)
 */
 
-    case EDIV:
+    OP (EDIV):
         if (op5 < 0)                                    /* wtest remainder */
             Read (op6, L_LONG, WA);
         if (op0 == 0) {                                 /* divide by zero? */
@@ -2181,7 +2315,7 @@ for ( ;; ) {
 
 /* Simple branches and subroutine calls */
 
-    case BRB:
+    OP (BRB):
         BRANCHB (brdisp);                               /* branch  */
         if (PC == fault_PC) {                           /* to self? */
             if (PSL_GETIPL (PSL) == 0x1F)               /* int locked out? */
@@ -2190,7 +2324,7 @@ for ( ;; ) {
             }
         break;
 
-    case BRW:
+    OP (BRW):
         BRANCHW (brdisp);                               /* branch */
         if (PC == fault_PC) {                           /* to self? */
             if (PSL_GETIPL (PSL) == 0x1F)               /* int locked out? */
@@ -2199,34 +2333,34 @@ for ( ;; ) {
             }
         break;
 
-    case BSBB:
+    OP (BSBB):
         Write (SP - 4, PC, L_LONG, WA);                 /* push PC on stk */
         SP = SP - 4;                                    /* decr stk ptr */
         BRANCHB (brdisp);                               /* branch  */
         break;
 
-    case BSBW:
+    OP (BSBW):
         Write (SP - 4, PC, L_LONG, WA);                 /* push PC on stk */
         SP = SP - 4;                                    /* decr stk ptr */
         BRANCHW (brdisp);                               /* branch */
         break;
 
-    case BGEQ:
+    OP (BGEQ):
         if (!(cc & CC_N))                               /* br if N = 0 */
             BRANCHB (brdisp);
         break;
 
-    case BLSS:
+    OP (BLSS):
         if (cc & CC_N)                                  /* br if N = 1 */
             BRANCHB (brdisp);
         break;
 
-    case BNEQ:
+    OP (BNEQ):
         if (!(cc & CC_Z))                               /* br if Z = 0 */
             BRANCHB (brdisp);
         break;
 
-    case BEQL:
+    OP (BEQL):
         if (cc & CC_Z) {                                /* br if Z = 1 */
             BRANCHB (brdisp);
             if (((PSL & PSL_IS) != 0) &&                /* on IS? */
@@ -2237,42 +2371,42 @@ for ( ;; ) {
             }
         break;
 
-    case BVC:
+    OP (BVC):
         if (!(cc & CC_V))                               /* br if V = 0 */
             BRANCHB (brdisp);
         break;
 
-    case BVS:
+    OP (BVS):
         if (cc & CC_V)                                  /* br if V = 1 */
             BRANCHB (brdisp);
         break;
 
-    case BGEQU:
+    OP (BGEQU):
         if (!(cc & CC_C))                               /* br if C = 0 */
             BRANCHB (brdisp);
         break;
 
-    case BLSSU:
+    OP (BLSSU):
         if (cc & CC_C)                                  /* br if C = 1 */
             BRANCHB (brdisp);
         break;
 
-    case BGTR:
+    OP (BGTR):
         if (!(cc & (CC_N | CC_Z)))                      /* br if N | Z = 0 */
             BRANCHB (brdisp);
         break;
 
-    case BLEQ:
+    OP (BLEQ):
         if (cc & (CC_N | CC_Z))                         /* br if N | Z = 1 */
             BRANCHB (brdisp);
         break;
 
-    case BGTRU:
+    OP (BGTRU):
         if (!(cc & (CC_C | CC_Z)))                      /* br if C | Z = 0 */
             BRANCHB (brdisp);
         break;
 
-    case BLEQU:
+    OP (BLEQU):
         if (cc & (CC_C | CC_Z))                         /* br if C | Z = 1 */
             BRANCHB (brdisp);
         break;
@@ -2282,15 +2416,15 @@ for ( ;; ) {
         opnd[0] =       address
 */
 
-    case JSB:
+    OP (JSB):
         Write (SP - 4, PC, L_LONG, WA);                 /* push PC on stk */
         SP = SP - 4;                                    /* decr stk ptr */
 
-    case JMP:
+    OP (JMP):
         JUMP (op0);                                     /* jump */
         break;
 
-    case RSB:
+    OP (RSB):
         temp = Read (SP, L_LONG, RA);                   /* get top of stk */
         SP = SP + 4;                                    /* incr stk ptr */
         JUMP (temp);
@@ -2304,7 +2438,7 @@ for ( ;; ) {
         va      =       memory address
 */
 
-    case SOBGEQ:
+    OP (SOBGEQ):
         r = op0 - 1;                                    /* decr index */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
@@ -2313,7 +2447,7 @@ for ( ;; ) {
             BRANCHB (brdisp);
         break;
 
-    case SOBGTR:
+    OP (SOBGTR):
         r = op0 - 1;                                    /* decr index */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
@@ -2331,7 +2465,7 @@ for ( ;; ) {
         va      =       memory address
 */
 
-    case AOBLSS:
+    OP (AOBLSS):
         r = op1 + 1;                                    /* incr index */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
@@ -2340,7 +2474,7 @@ for ( ;; ) {
             BRANCHB (brdisp);
         break;
 
-    case AOBLEQ:
+    OP (AOBLEQ):
         r = op1 + 1;                                    /* incr index */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
@@ -2359,7 +2493,7 @@ for ( ;; ) {
         va      =       memory address
 */
 
-    case ACBB:
+    OP (ACBB):
         r = (op2 + op1) & BMASK;                        /* calc result */
         WRITE_B (r);                                    /* store result */
         CC_IIZP_B (r);                                  /* set cc's */
@@ -2368,7 +2502,7 @@ for ( ;; ) {
             BRANCHW (brdisp);
         break;
 
-    case ACBW:
+    OP (ACBW):
         r = (op2 + op1) & WMASK;                        /* calc result */
         WRITE_W (r);                                    /* store result */
         CC_IIZP_W (r);                                  /* set cc's */
@@ -2377,7 +2511,7 @@ for ( ;; ) {
             BRANCHW (brdisp);
         break;
 
-    case ACBL:
+    OP (ACBL):
         r = (op2 + op1) & LMASK;                        /* calc result */
         WRITE_L (r);                                    /* store result */
         CC_IIZP_L (r);                                  /* set cc's */
@@ -2393,7 +2527,7 @@ for ( ;; ) {
         opnd[2] =       limit
 */
 
-    case CASEB:
+    OP (CASEB):
         r = (op0 - op1) & BMASK;                        /* sel - base */
         CC_CMP_B (r, op2);                              /* r:limit, set cc's */
         if (r > op2)                                    /* r > limit (unsgnd)? */
@@ -2404,7 +2538,7 @@ for ( ;; ) {
             }
         break;
 
-    case CASEW:
+    OP (CASEW):
         r = (op0 - op1) & WMASK;                        /* sel - base */
         CC_CMP_W (r, op2);                              /* r:limit, set cc's */
         if (r > op2)                                    /* r > limit (unsgnd)? */
@@ -2415,7 +2549,7 @@ for ( ;; ) {
             }
         break;
 
-    case CASEL:
+    OP (CASEL):
         r = (op0 - op1) & LMASK;                        /* sel - base */
         CC_CMP_L (r, op2);                              /* r:limit, set cc's */
         if (((uint32) r) > ((uint32) op2))              /* r > limit (unsgnd)? */
@@ -2433,7 +2567,7 @@ for ( ;; ) {
         opnd[2] =       memory address, if memory
 */
 
-    case BBS:
+    OP (BBS):
         if (op_bb_n (opnd, acc)) {                      /* br if bit set */
             BRANCHB (brdisp);
             if (((PSL & PSL_IS) != 0) &&                /* on IS? */
@@ -2443,37 +2577,37 @@ for ( ;; ) {
             }
         break;
 
-    case BBC:
+    OP (BBC):
         if (!op_bb_n (opnd, acc))                       /* br if bit clr */
             BRANCHB (brdisp);
         break;
 
-    case BBSS: case BBSSI:
+    OP (BBSS): OP (BBSSI):
         if (op_bb_x (opnd, 1, acc))                     /* br if set, set */
             BRANCHB (brdisp);
         break;
 
-    case BBCC: case BBCCI:
+    OP (BBCC): OP (BBCCI):
         if (!op_bb_x (opnd, 0, acc))                    /* br if clr, clr*/
             BRANCHB (brdisp);
         break;
 
-    case BBSC:
+    OP (BBSC):
         if (op_bb_x (opnd, 0, acc))                     /* br if clr, set */
             BRANCHB (brdisp);
         break;
 
-    case BBCS:
+    OP (BBCS):
         if (!op_bb_x (opnd, 1, acc))                    /* br if set, clr */
             BRANCHB (brdisp);
         break;
 
-    case BLBS:
+    OP (BLBS):
         if (op0 & 1)                                    /* br if bit set */
             BRANCHB (brdisp);
         break;
 
-    case BLBC:
+    OP (BLBC):
         if ((op0 & 1) == 0)                             /* br if bit clear */
             BRANCHB (brdisp);
         break;
@@ -2489,7 +2623,7 @@ for ( ;; ) {
         va      =       memory address
 */
 
-    case EXTV:
+    OP (EXTV):
         r = op_extv (opnd, vfldrp1, acc);               /* get field */
         if (r & byte_sign[op1])
             r = r | ~byte_mask[op1];
@@ -2497,7 +2631,7 @@ for ( ;; ) {
         CC_IIZP_L (r);                                  /* set cc's */
         break;
 
-    case EXTZV:
+    OP (EXTZV):
         r = op_extv (opnd, vfldrp1, acc);               /* get field */
         WRITE_L (r);                                    /* store field */
         CC_IIZP_L (r);                                  /* set cc's */
@@ -2512,14 +2646,14 @@ for ( ;; ) {
         opnd[4] =       source2
 */
 
-    case CMPV:
+    OP (CMPV):
         r = op_extv (opnd, vfldrp1, acc);               /* get field */
         if (r & byte_sign[op1])
             r = r | ~byte_mask[op1];
         CC_CMP_L (r, op4);                              /* set cc's */
         break;
 
-    case CMPZV:
+    OP (CMPZV):
         r = op_extv (opnd, vfldrp1, acc);               /* get field */
         CC_CMP_L (r, op4);                              /* set cc's */
         break;
@@ -2535,14 +2669,14 @@ for ( ;; ) {
         va      =       memory address
 */
 
-    case FFS:
+    OP (FFS):
         r = op_extv (opnd, vfldrp1, acc);               /* get field */
         temp = op_ffs (r, op1);                         /* find first 1 */
         WRITE_L (op0 + temp);                           /* store result */
         cc = r? 0: CC_Z;                                /* set cc's */
         break;
 
-    case FFC:
+    OP (FFC):
         r = op_extv (opnd, vfldrp1, acc);               /* get field */
         r = r ^ byte_mask[op1];                         /* invert bits */
         temp = op_ffs (r, op1);                         /* find first 1 */
@@ -2559,7 +2693,7 @@ for ( ;; ) {
         opnd[4] =       register content/memory address
 */
 
-    case INSV:
+    OP (INSV):
         op_insv (opnd, vfldrp1, acc);                   /* insert field */
         break;
 
@@ -2569,21 +2703,21 @@ for ( ;; ) {
         opnd[1] =       procedure address
 */
 
-    case CALLS:
+    OP (CALLS):
         cc = op_call (opnd, TRUE, acc);
         break;
 
-    case CALLG:
+    OP (CALLG):
         cc = op_call (opnd, FALSE, acc);
         break;
 
-    case RET:
+    OP (RET):
         cc = op_ret (acc);
         break;
 
 /* Miscellaneous instructions */
 
-    case HALT:
+    OP (HALT):
         if (PSL & PSL_CUR)                              /* not kern? rsvd inst */
             RSVD_INST_FAULT;
         else if (cpu_unit.flags & UNIT_CONH)            /* halt to console? */
@@ -2592,51 +2726,51 @@ for ( ;; ) {
             ABORT (STOP_HALT);                          /* halt to simulator */
             }
 
-    case NOP:
+    OP (NOP):
         break;
 
-    case BPT:
+    OP (BPT):
         SETPC (fault_PC);
         PSL = PSL & ~PSL_TP;                                /* clear <tp> */
         cc = intexc (SCB_BPT, cc, 0, IE_EXC);
         GET_CUR;
         break;
 
-    case XFC:
+    OP (XFC):
         SETPC (fault_PC);
         PSL = PSL & ~PSL_TP;                                /* clear <tp> */
         cc = intexc (SCB_XFC, cc, 0, IE_EXC);
         GET_CUR;
         break;
 
-    case BISPSW:
+    OP (BISPSW):
         if (opnd[0] & PSW_MBZ)
             RSVD_OPND_FAULT;
         PSL = PSL | (opnd[0] & ~CC_MASK);
         cc = cc | (opnd[0] & CC_MASK);
         break;
 
-    case BICPSW:
+    OP (BICPSW):
         if (opnd[0] & PSW_MBZ)
             RSVD_OPND_FAULT;
         PSL = PSL & ~opnd[0];
         cc = cc & ~opnd[0];
         break;
 
-    case MOVPSL:
+    OP (MOVPSL):
         r = PSL | cc;
         WRITE_L (r);
         break;
 
-    case PUSHR:
+    OP (PUSHR):
         op_pushr (opnd, acc);
         break;
 
-    case POPR:
+    OP (POPR):
         op_popr (opnd, acc);
         break;
 
-    case INDEX:
+    OP (INDEX):
         if ((op0 < op1) || (op0 > op2))
             SET_TRAP (TRAP_SUBSCR);
         r = (op0 + op4) * op3;
@@ -2646,149 +2780,149 @@ for ( ;; ) {
 
 /* Queue and interlocked queue */
 
-    case INSQUE:
+    OP (INSQUE):
         cc = op_insque (opnd, acc);
         break;
 
-    case REMQUE:
+    OP (REMQUE):
         cc = op_remque (opnd, acc);
         break;
 
-    case INSQHI:
+    OP (INSQHI):
         cc = op_insqhi (opnd, acc);
         break;
 
-    case INSQTI:
+    OP (INSQTI):
         cc = op_insqti (opnd, acc);
         break;
 
-    case REMQHI:
+    OP (REMQHI):
         cc = op_remqhi (opnd, acc);
         break;
 
-    case REMQTI:
+    OP (REMQTI):
         cc = op_remqti (opnd, acc);
         break;
 
 /* String instructions */
 
-    case MOVC3: case MOVC5:
+    OP (MOVC3): OP (MOVC5):
         cc = op_movc (opnd, opc & 4, acc);
         break;
 
-    case CMPC3: case CMPC5:
+    OP (CMPC3): OP (CMPC5):
         cc = op_cmpc (opnd, opc & 4, acc);
         break;
 
-    case LOCC: case SKPC:
+    OP (LOCC): OP (SKPC):
         cc = op_locskp (opnd, opc & 1, acc);
         break;
 
-    case SCANC: case SPANC:
+    OP (SCANC): OP (SPANC):
         cc = op_scnspn (opnd, opc & 1, acc);
         break;
 
 /* Floating point instructions */
 
-    case TSTF: case TSTD:
+    OP (TSTF): OP (TSTD):
         r = op_movfd (op0);
         CC_IIZZ_FP (r);
         break;
 
-    case TSTG:
+    OP (TSTG):
         r = op_movg (op0);
         CC_IIZZ_FP (r);
         break;
 
-    case MOVF:
+    OP (MOVF):
         r = op_movfd (op0);
         WRITE_L (r);
         CC_IIZP_FP (r);
         break;
 
-    case MOVD:
+    OP (MOVD):
         if ((r = op_movfd (op0)) == 0)
             op1 = 0;
         WRITE_Q (r, op1);
         CC_IIZP_FP (r);
         break;
 
-    case MOVG:
+    OP (MOVG):
         if ((r = op_movg (op0)) == 0)
             op1 = 0;
         WRITE_Q (r, op1);
         CC_IIZP_FP (r);
         break;
 
-    case MNEGF:
+    OP (MNEGF):
         r = op_mnegfd (op0);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case MNEGD:
+    OP (MNEGD):
         if ((r = op_mnegfd (op0)) == 0)
             op1 = 0;
         WRITE_Q (r, op1);
         CC_IIZZ_FP (r);
         break;
 
-    case MNEGG:
+    OP (MNEGG):
         if ((r = op_mnegg (op0)) == 0)
             op1 = 0;
         WRITE_Q (r, op1);
         CC_IIZZ_FP (r);
         break;
 
-    case CMPF:
+    OP (CMPF):
         cc = op_cmpfd (op0, 0, op1, 0);
         break;
 
-    case CMPD:
+    OP (CMPD):
         cc = op_cmpfd (op0, op1, op2, op3);
         break;
 
-    case CMPG:
+    OP (CMPG):
         cc = op_cmpg (op0, op1, op2, op3);
         break;
 
-    case CVTBF:
+    OP (CVTBF):
         r = op_cvtifdg (SXTB (op0), NULL, opc);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTWF:
+    OP (CVTWF):
         r = op_cvtifdg (SXTW (op0), NULL, opc);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTLF:
+    OP (CVTLF):
         r = op_cvtifdg (op0, NULL, opc);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTBD: case CVTBG:
+    OP (CVTBD): OP (CVTBG):
         r = op_cvtifdg (SXTB (op0), &rh, opc);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTWD: case CVTWG:
+    OP (CVTWD): OP (CVTWG):
         r = op_cvtifdg (SXTW (op0), &rh, opc);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTLD: case CVTLG:
+    OP (CVTLD): OP (CVTLG):
         r = op_cvtifdg (op0, &rh, opc);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTFB: case CVTDB: case CVTGB:
+    OP (CVTFB): OP (CVTDB): OP (CVTGB):
         r = op_cvtfdgi (opnd, &flg, opc) & BMASK;
         WRITE_B (r);
         CC_IIZZ_B (r);
@@ -2797,7 +2931,7 @@ for ( ;; ) {
             }
         break;
 
-    case CVTFW: case CVTDW: case CVTGW:
+    OP (CVTFW): OP (CVTDW): OP (CVTGW):
         r = op_cvtfdgi (opnd, &flg, opc) & WMASK;
         WRITE_W (r);
         CC_IIZZ_W (r);
@@ -2806,8 +2940,8 @@ for ( ;; ) {
             }
         break;
 
-    case CVTFL: case CVTDL: case CVTGL:
-    case CVTRFL: case CVTRDL: case CVTRGL:
+    OP (CVTFL): OP (CVTDL): OP (CVTGL):
+    OP (CVTRFL): OP (CVTRDL): OP (CVTRGL):
         r = op_cvtfdgi (opnd, &flg, opc) & LMASK;
         WRITE_L (r);
         CC_IIZZ_L (r);
@@ -2816,103 +2950,103 @@ for ( ;; ) {
             }
         break;
 
-    case CVTFD:
+    OP (CVTFD):
         r = op_movfd (op0);
         WRITE_Q (r, 0);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTDF:
+    OP (CVTDF):
         r = op_cvtdf (opnd);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTFG:
+    OP (CVTFG):
         r = op_cvtfg (opnd, &rh);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case CVTGF:
+    OP (CVTGF):
         r = op_cvtgf (opnd);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case ADDF2: case ADDF3:
+    OP (ADDF2): OP (ADDF3):
         r = op_addf (opnd, FALSE);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case ADDD2: case ADDD3:
+    OP (ADDD2): OP (ADDD3):
         r = op_addd (opnd, &rh, FALSE);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case ADDG2: case ADDG3:
+    OP (ADDG2): OP (ADDG3):
         r = op_addg (opnd, &rh, FALSE);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case SUBF2: case SUBF3:
+    OP (SUBF2): OP (SUBF3):
         r = op_addf (opnd, TRUE);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case SUBD2: case SUBD3:
+    OP (SUBD2): OP (SUBD3):
         r = op_addd (opnd, &rh, TRUE);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case SUBG2: case SUBG3:
+    OP (SUBG2): OP (SUBG3):
         r = op_addg (opnd, &rh, TRUE);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case MULF2: case MULF3:
+    OP (MULF2): OP (MULF3):
         r = op_mulf (opnd);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case MULD2: case MULD3:
+    OP (MULD2): OP (MULD3):
         r = op_muld (opnd, &rh);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case MULG2: case MULG3:
+    OP (MULG2): OP (MULG3):
         r = op_mulg (opnd, &rh);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case DIVF2: case DIVF3:
+    OP (DIVF2): OP (DIVF3):
         r = op_divf (opnd);
         WRITE_L (r);
         CC_IIZZ_FP (r);
         break;
 
-    case DIVD2: case DIVD3:
+    OP (DIVD2): OP (DIVD3):
         r = op_divd (opnd, &rh);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case DIVG2: case DIVG3:
+    OP (DIVG2): OP (DIVG3):
         r = op_divg (opnd, &rh);
         WRITE_Q (r, rh);
         CC_IIZZ_FP (r);
         break;
 
-    case ACBF:
+    OP (ACBF):
         r = op_addf (opnd + 1, FALSE);                  /* add + index */
         temp = op_cmpfd (r, 0, op0, 0);                 /* result : limit */
         WRITE_L (r);                                    /* write result */
@@ -2922,7 +3056,7 @@ for ( ;; ) {
            BRANCHW (brdisp);
         break;
 
-    case ACBD:
+    OP (ACBD):
         r = op_addd (opnd + 2, &rh, FALSE);
         temp = op_cmpfd (r, rh, op0, op1);
         WRITE_Q (r, rh);
@@ -2932,7 +3066,7 @@ for ( ;; ) {
            BRANCHW (brdisp);
         break;
 
-    case ACBG:
+    OP (ACBG):
         r = op_addg (opnd + 2, &rh, FALSE);
         temp = op_cmpg (r, rh, op0, op1);
         WRITE_Q (r, rh);
@@ -2951,7 +3085,7 @@ for ( ;; ) {
         op5:op6 =       floating destination (flt.wl)
 */
 
-    case EMODF:
+    OP (EMODF):
         r = op_emodf (opnd, &temp, &flg);
         if (op5 < 0)
             Read (op6, L_LONG, WA);
@@ -2974,7 +3108,7 @@ for ( ;; ) {
         op7:op8 =       floating destination (flt.wq)
 */
 
-    case EMODD:
+    OP (EMODD):
         r = op_emodd (opnd, &rh, &temp, &flg);
         if (op7 < 0) {
             Read (op8, L_BYTE, WA);
@@ -2990,7 +3124,7 @@ for ( ;; ) {
             }
         break;
 
-    case EMODG:
+    OP (EMODG):
         r = op_emodg (opnd, &rh, &temp, &flg);
         if (op7 < 0) {
             Read (op8, L_BYTE, WA);
@@ -3008,53 +3142,53 @@ for ( ;; ) {
 
 /* POLY */
 
-    case POLYF:
+    OP (POLYF):
         op_polyf (opnd, acc);
         CC_IIZZ_FP (R[0]);
         break;
 
-    case POLYD:
+    OP (POLYD):
         op_polyd (opnd, acc);
         CC_IIZZ_FP (R[0]);
         break;
 
-    case POLYG:
+    OP (POLYG):
         op_polyg (opnd, acc);
         CC_IIZZ_FP (R[0]);
         break;
 
 /* Operating system instructions */
 
-    case CHMK: case CHME: case CHMS: case CHMU:
+    OP (CHMK): OP (CHME): OP (CHMS): OP (CHMU):
         cc = op_chm (opnd, cc, opc);                    /* CHMx */
         GET_CUR;                                        /* update cur mode */
         SET_IRQL;                                       /* update intreq */
         break;
 
-    case REI:
+    OP (REI):
         cc = op_rei (acc);                              /* REI */
         GET_CUR;                                        /* update cur mode */
         SET_IRQL;                                       /* update intreq */
         break;
 
-    case LDPCTX:
+    OP (LDPCTX):
         op_ldpctx (acc);
         break;
 
-    case SVPCTX:
+    OP (SVPCTX):
         op_svpctx (acc);
         break;
 
-    case PROBER: case PROBEW:
+    OP (PROBER): OP (PROBEW):
         cc = (cc & CC_C) | op_probe (opnd, opc & 1);
         break;
 
-    case MTPR:
+    OP (MTPR):
         cc = (cc & CC_C) | op_mtpr (opnd);
         SET_IRQL;                                       /* update intreq */
         break;
 
-    case MFPR:
+    OP (MFPR):
         r = op_mfpr (opnd);
         WRITE_L (r);
         CC_IIZP_L (r);
@@ -3062,26 +3196,26 @@ for ( ;; ) {
 
 /* CIS or emulated instructions */
 
-    case CVTPL:
-    case MOVP: case CMPP3: case CMPP4: case CVTLP:
-    case CVTPS: case CVTSP: case CVTTP: case CVTPT:
-    case ADDP4: case ADDP6: case SUBP4: case SUBP6:
-    case MULP: case DIVP: case ASHP: case CRC:
-    case MOVTC: case MOVTUC: case MATCHC: case EDITPC:
+    OP (CVTPL):
+    OP (MOVP): OP (CMPP3): OP (CMPP4): OP (CVTLP):
+    OP (CVTPS): OP (CVTSP): OP (CVTTP): OP (CVTPT):
+    OP (ADDP4): OP (ADDP6): OP (SUBP4): OP (SUBP6):
+    OP (MULP): OP (DIVP): OP (ASHP): OP (CRC):
+    OP (MOVTC): OP (MOVTUC): OP (MATCHC): OP (EDITPC):
         cc = op_cis (opnd, cc, opc, acc);
         break;
 
 /* Octaword or reserved instructions */
 
-    case PUSHAO: case MOVAO: case CLRO: case MOVO:
-    case TSTH: case MOVH: case MNEGH: case CMPH:
-    case CVTBH: case CVTWH: case CVTLH:
-    case CVTHB: case CVTHW: case CVTHL: case CVTRHL:
-    case CVTFH: case CVTDH: case CVTGH:
-    case CVTHF: case CVTHD: case CVTHG:
-    case ADDH2: case ADDH3: case SUBH2: case SUBH3:
-    case MULH2: case MULH3: case DIVH2: case DIVH3:
-    case ACBH: case POLYH: case EMODH:
+    OP (PUSHAO): OP (MOVAO): OP (CLRO): OP (MOVO):
+    OP (TSTH): OP (MOVH): OP (MNEGH): OP (CMPH):
+    OP (CVTBH): OP (CVTWH): OP (CVTLH):
+    OP (CVTHB): OP (CVTHW): OP (CVTHL): OP (CVTRHL):
+    OP (CVTFH): OP (CVTDH): OP (CVTGH):
+    OP (CVTHF): OP (CVTHD): OP (CVTHG):
+    OP (ADDH2): OP (ADDH3): OP (SUBH2): OP (SUBH3):
+    OP (MULH2): OP (MULH3): OP (DIVH2): OP (DIVH3):
+    OP (ACBH): OP (POLYH): OP (EMODH):
         cc = op_octa (opnd, cc, opc, acc, spec, va);
         if (cc & LSIGN) {                               /* ACBH branch? */
             BRANCHW (brdisp);
@@ -3089,7 +3223,7 @@ for ( ;; ) {
             }
         break;
 
-    default:
+    OP_DEFAULT:
         RSVD_INST_FAULT;
         break;
         }                                               /* end case op */
@@ -3193,11 +3327,15 @@ mapen = 0;
 FLUSH_ISTR;                             /* init I-stream */
 if (M == NULL) {                        /* first time init? */
     sim_brk_types = sim_brk_dflt = SWMASK ('E');
+    sim_brk_wtypes = SWMASK ('R') | SWMASK ('W') | SWMASK ('M');
+    sim_brk_wphys = SWMASK ('P');
+    sim_brk_wshift = VA_N_OFF;
+    sim_brk_types = sim_brk_types | sim_brk_wtypes | sim_brk_wphys;
     pcq_r = find_reg ("PCQ", NULL, dptr);
     if (pcq_r == NULL)
         return SCPE_IERR;
     pcq_r->qptr = 0;
-    M = (uint32 *) calloc (((uint32) MEMSIZE) >> 2, sizeof (uint32));
+    M = (uint32 *) sim_mem_alloc ((size_t) MEMSIZE);
     if (M == NULL)
         return SCPE_MEM;
     auto_config(NULL, 0);               /* do an initial auto configure */
@@ -3265,13 +3403,15 @@ for (i = val; i < MEMSIZE; i = i + 4)
     mc = mc | M[i >> 2];
 if ((mc != 0) && !get_yn ("Really truncate memory [N]?", FALSE))
     return SCPE_OK;
-nM = (uint32 *) calloc (uval >> 2, sizeof (uint32));
+nM = (uint32 *) sim_mem_alloc ((size_t) uval);
 if (nM == NULL)
     return SCPE_MEM;
 clim = (uint32)((uval < MEMSIZE)? uval: MEMSIZE);
-for (i = 0; i < clim; i = i + 4)
-    nM[i >> 2] = M[i >> 2];
-free (M);
+for (i = 0; i < clim; i = i + 4) {                      /* copy, leaving */
+    if (M[i >> 2])                                      /* untouched pages */
+        nM[i >> 2] = M[i >> 2];                         /* unallocated */
+    }
+sim_mem_free (M, (size_t) MEMSIZE);
 M = nM;
 MEMSIZE = uval; 
 reset_all (0);
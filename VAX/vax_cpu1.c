@@ -103,6 +103,7 @@ extern int32 ibcnt, ppc;
 extern DEVICE cpu_dev;
 
 extern int32 Test (uint32 va, int32 acc, int32 *status);
+extern uint8 *StrMap (uint32 va, int32 acc, int32 *cnt);
 extern void set_map_reg (void);
 extern void zap_tb (int stb);
 extern void zap_tb_ent (uint32 va);
@@ -789,7 +790,20 @@ if (ar == 0)                                            /* empty, cc = 0110 */
 return 0;                                               /* q can't be empty */
 }
 
-/* String instructions */
+/* String instructions
+
+   The string instructions work a page at a time: StrMap translates
+   the current source and destination addresses once, and the part of
+   the string that lies within both pages is moved, filled or scanned
+   directly in host memory.  The registers are brought up to date after
+   each chunk, and each chunk begins with its translations, so a fault
+   on a page boundary leaves exactly the state that a byte by byte
+   loop would have left, and FPD restart works unchanged.  References
+   that StrMap can't map (I/O space, watched pages) go through Read and
+   Write, one byte or aligned longword at a time.
+*/
+
+#define STR_MIN(a,b)    (((a) < (b))? (a): (b))
 
 #define MVC_FRWD        0                               /* movc state codes */
 #define MVC_BACK        1
@@ -822,9 +836,9 @@ return 0;                                               /* q can't be empty */
 
 int32 op_movc (int32 *opnd, int32 movc5, int32 acc)
 {
-int32 i, cc, fill, wd;
-int32 j, lnt, mlnt[3];
-static const int32 looplnt[3] = { L_BYTE, L_LONG, L_BYTE };
+int32 cc, fill, wd;
+int32 lnt, scnt, dcnt;
+uint8 *sp, *dp;
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -875,38 +889,46 @@ else {
 switch (R[5] & MVC_M_STATE) {                           /* case on state */
 
     case MVC_FRWD:                                      /* move forward */
-        mlnt[0] = (4 - R[3]) & 3;                       /* length to align */
-        if (mlnt[0] > R[2])                             /* cant exceed total */
-            mlnt[0] = R[2];
-        mlnt[1] = (R[2] - mlnt[0]) & ~03;               /* aligned length */
-        mlnt[2] = R[2] - mlnt[0] - mlnt[1];             /* tail */
-        for (i = 0; i < 3; i++) {                       /* head, align, tail */
-            lnt = looplnt[i];                           /* length for loop */
-            for (j = 0; j < mlnt[i]; j = j + lnt, sim_interval--) {
+        while (R[2] > 0) {
+            sp = StrMap (R[1], RA, &scnt);              /* map src, dst */
+            dp = (sp != NULL)? StrMap (R[3], WA, &dcnt): NULL;
+            if (dp == NULL) {                           /* can't, one ref */
+                lnt = (((R[1] | R[3]) & 3) || (R[2] < 4))? L_BYTE: L_LONG;
                 wd = Read (R[1], lnt, RA);              /* read src */
                 Write (R[3], wd, lnt, WA);              /* write dst */
-                R[1] = R[1] + lnt;                      /* inc src addr */
-                R[3] = R[3] + lnt;                      /* inc dst addr */
-                R[2] = R[2] - lnt;                      /* dec move lnt */
+                sim_interval--;
+                }
+            else {
+                lnt = STR_MIN (R[2], STR_MIN (scnt, dcnt));
+                memmove (dp, sp, lnt);                  /* move chunk */
+                sim_interval = sim_interval - ((lnt + 3) >> 2);
                 }
+            R[1] = R[1] + lnt;                          /* inc src addr */
+            R[3] = R[3] + lnt;                          /* inc dst addr */
+            R[2] = R[2] - lnt;                          /* dec move lnt */
             }
         goto FILL;                                      /* check for fill */
 
     case MVC_BACK:                                      /* move backward */
-        mlnt[0] = R[3] & 03;                            /* length to align */
-        if (mlnt[0] > R[2])                             /* cant exceed total */
-            mlnt[0] = R[2];
-        mlnt[1] = (R[2] - mlnt[0]) & ~03;               /* aligned length */
-        mlnt[2] = R[2] - mlnt[0] - mlnt[1];             /* tail */
-        for (i = 0; i < 3; i++) {                       /* head, align, tail */
-            lnt = looplnt[i];                           /* length for loop */
-            for (j = 0; j < mlnt[i]; j = j + lnt, sim_interval--) {
+        while (R[2] > 0) {
+            sp = StrMap (R[1] - 1, RA, &scnt);          /* map last bytes */
+            dp = (sp != NULL)? StrMap (R[3] - 1, WA, &dcnt): NULL;
+            if (dp == NULL) {                           /* can't, one ref */
+                lnt = (((R[1] | R[3]) & 3) || (R[2] < 4))? L_BYTE: L_LONG;
                 wd = Read (R[1] - lnt, lnt, RA);        /* read src */
                 Write (R[3] - lnt, wd, lnt, WA);        /* write dst */
-                R[1] = R[1] - lnt;                      /* dec src addr */
-                R[3] = R[3] - lnt;                      /* dec dst addr */
-                R[2] = R[2] - lnt;                      /* dec move lnt */
+                sim_interval--;
                 }
+            else {
+                scnt = VA_GETOFF (R[1] - 1) + 1;        /* bytes below in page */
+                dcnt = VA_GETOFF (R[3] - 1) + 1;
+                lnt = STR_MIN (R[2], STR_MIN (scnt, dcnt));
+                memmove (dp + 1 - lnt, sp + 1 - lnt, lnt); /* move chunk */
+                sim_interval = sim_interval - ((lnt + 3) >> 2);
+                }
+            R[1] = R[1] - lnt;                          /* dec src addr */
+            R[3] = R[3] - lnt;                          /* dec dst addr */
+            R[2] = R[2] - lnt;                          /* dec move lnt */
             }
         R[1] = R[1] + (R[0] & STR_LNMASK);              /* final src addr */
         R[3] = R[3] + (R[0] & STR_LNMASK);              /* final dst addr */
@@ -916,21 +938,27 @@ switch (R[5] & MVC_M_STATE) {                           /* case on state */
         if (R[4] <= 0)                                  /* any fill? */
             break;
         R[5] = R[5] | MVC_FILL;                         /* set state */
-        mlnt[0] = (4 - R[3]) & 3;                       /* length to align */
-        if (mlnt[0] > R[4])                             /* cant exceed total */
-            mlnt[0] = R[4];
-        mlnt[1] = (R[4] - mlnt[0]) & ~03;               /* aligned length */
-        mlnt[2] = R[4] - mlnt[0] - mlnt[1];             /* tail */
-        for (i = 0; i < 3; i++) {                       /* head, align, tail */
-            lnt = looplnt[i];                           /* length for loop */
-            fill = fill & BMASK;                        /* fill for loop */
-            if (lnt == L_LONG)
-                fill = (((uint32) fill) << 24) | (fill << 16) | (fill << 8) | fill;
-            for (j = 0; j < mlnt[i]; j = j + lnt, sim_interval--) {
-                Write (R[3], fill, lnt, WA);            /* write fill */
-                R[3] = R[3] + lnt;                      /* inc dst addr */
-                R[4] = R[4] - lnt;                      /* dec fill lnt */
+        fill = fill & BMASK;                            /* fill byte */
+        while (R[4] > 0) {
+            dp = StrMap (R[3], WA, &dcnt);              /* map dst */
+            if (dp == NULL) {                           /* can't, one ref */
+                if ((R[3] & 3) || (R[4] < 4)) {
+                    lnt = L_BYTE;
+                    Write (R[3], fill, L_BYTE, WA);
+                    }
+                else {
+                    lnt = L_LONG;
+                    Write (R[3], (((uint32) fill) << 24) | (fill << 16) | (fill << 8) | fill, L_LONG, WA);
+                    }
+                sim_interval--;
+                }
+            else {
+                lnt = STR_MIN (R[4], dcnt);
+                memset (dp, fill, lnt);                 /* fill chunk */
+                sim_interval = sim_interval - ((lnt + 3) >> 2);
                 }
+            R[3] = R[3] + lnt;                          /* inc dst addr */
+            R[4] = R[4] - lnt;                          /* dec fill lnt */
             }
         break;
 
@@ -969,6 +997,8 @@ return cc;
 int32 op_cmpc (int32 *opnd, int32 cmpc5, int32 acc)
 {
 int32 cc, s1, s2, fill;
+int32 i, lnt, cnt1, cnt2;
+uint8 *ap, *bp, b1, b2;
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -990,22 +1020,46 @@ else {
     PSL = PSL | PSL_FPD;
     }
 R[2] = R[2] & STR_LNMASK;                               /* mask src2len */
-for (s1 = s2 = 0; ((R[0] | R[2]) & STR_LNMASK) != 0; sim_interval--) {
-    if (R[0] & STR_LNMASK)                              /* src1? read */
-        s1 = Read (R[1], L_BYTE, RA);
-    else s1 = fill;                                     /* no, use fill */
-    if (R[2])                                           /* src2? read */
-        s2 = Read (R[3], L_BYTE, RA);
-    else s2 = fill;                                     /* no, use fill */
-    if (s1 != s2)                                       /* src1 = src2? */
-        break;
-    if (R[0] & STR_LNMASK) {                            /* if src1, decr */
-        R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - 1) & STR_LNMASK);
-        R[1] = R[1] + 1;
+for (s1 = s2 = 0; ((R[0] | R[2]) & STR_LNMASK) != 0; ) {
+    lnt = STR_LNMASK;
+    ap = bp = NULL;
+    if (R[0] & STR_LNMASK) {                            /* src1? map */
+        if ((ap = StrMap (R[1], RA, &cnt1)) == NULL) {
+            b1 = (uint8) Read (R[1], L_BYTE, RA);       /* can't, read byte */
+            ap = &b1;
+            cnt1 = 1;
+            }
+        lnt = STR_MIN (R[0] & STR_LNMASK, cnt1);
+        }
+    if (R[2]) {                                         /* src2? map */
+        if ((bp = StrMap (R[3], RA, &cnt2)) == NULL) {
+            b2 = (uint8) Read (R[3], L_BYTE, RA);       /* can't, read byte */
+            bp = &b2;
+            cnt2 = 1;
+            }
+        lnt = STR_MIN (lnt, STR_MIN (R[2], cnt2));
+        }
+    if (ap && bp) {                                     /* both strings? */
+        if (memcmp (ap, bp, lnt) == 0)
+            i = lnt;
+        else for (i = 0; ap[i] == bp[i]; i++) ;
         }
-    if (R[2]) {                                         /* if src2, decr */
-        R[2] = (R[2] - 1) & STR_LNMASK;
-        R[3] = R[3] + 1;
+    else if (ap)                                        /* src1 vs fill */
+        for (i = 0; (i < lnt) && (ap[i] == fill); i++) ;
+    else for (i = 0; (i < lnt) && (bp[i] == fill); i++) ; /* fill vs src2 */
+    if (ap) {                                           /* if src1, decr */
+        R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+        R[1] = R[1] + i;
+        }
+    if (bp) {                                           /* if src2, decr */
+        R[2] = (R[2] - i) & STR_LNMASK;
+        R[3] = R[3] + i;
+        }
+    sim_interval = sim_interval - ((i + 3) >> 2);
+    if (i < lnt) {                                      /* mismatch? */
+        s1 = ap? ap[i]: fill;
+        s2 = bp? bp[i]: fill;
+        break;
         }
     }
 PSL = PSL & ~PSL_FPD;                                   /* clear FPD */
@@ -1028,7 +1082,8 @@ return cc;
 
 int32 op_locskp (int32 *opnd, int32 skpc, int32 acc)
 {
-int32 c, match;
+int32 i, lnt, cnt, match;
+uint8 *sp, *fp, b;
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -1040,12 +1095,24 @@ else {
     R[1] = opnd[2];                                     /* src addr */
     PSL = PSL | PSL_FPD;
     }
-for ( ; (R[0] & STR_LNMASK) != 0; sim_interval-- ) {    /* loop thru string */
-    c = Read (R[1], L_BYTE, RA);                        /* get src byte */
-    if ((c == match) ^ skpc)                            /* match & locc? */
+while ((R[0] & STR_LNMASK) != 0) {                      /* loop thru string */
+    if ((sp = StrMap (R[1], RA, &cnt)) == NULL) {       /* map src */
+        b = (uint8) Read (R[1], L_BYTE, RA);            /* can't, get byte */
+        sp = &b;
+        cnt = 1;
+        }
+    lnt = STR_MIN (R[0] & STR_LNMASK, cnt);
+    if (skpc)                                           /* SKPC, find other */
+        for (i = 0; (i < lnt) && (sp[i] == match); i++) ;
+    else {                                              /* LOCC, find match */
+        fp = (uint8 *) memchr (sp, match, lnt);
+        i = fp? (int32) (fp - sp): lnt;
+        }
+    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+    R[1] = R[1] + i;                                    /* incr src1adr */
+    sim_interval = sim_interval - ((i + 3) >> 2);
+    if (i < lnt)                                        /* found? */
         break;
-    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - 1) & STR_LNMASK);
-    R[1] = R[1] + 1;                                    /* incr src1adr */
     }
 PSL = PSL & ~PSL_FPD;                                   /* clear FPD */
 R[0] = R[0] & STR_LNMASK;                               /* clear packup */
@@ -1069,6 +1136,8 @@ return (R[0]? 0: CC_Z);                                 /* set cc's */
 int32 op_scnspn (int32 *opnd, int32 spanc, int32 acc)
 {
 int32 c, t, mask;
+int32 i, lnt, cnt, tcnt;
+uint8 *sp, *tp, b;
 
 if (PSL & PSL_FPD) {                                    /* FPD set? */
     SETPC (fault_PC + STR_GETDPC (R[0]));               /* reset PC */
@@ -1081,13 +1150,34 @@ else {
     R[0] = STR_PACK (mask, opnd[0]);                    /* srclen + FPD data */
     PSL = PSL | PSL_FPD;
     }
-for ( ; (R[0] & STR_LNMASK) != 0; sim_interval-- ) {    /* loop thru string */
-    c = Read (R[1], L_BYTE, RA);                        /* get byte */
-    t = Read (R[3] + c, L_BYTE, RA);                    /* get table ent */
-    if (((t & mask) != 0) ^ spanc)                      /* test vs instr */
+tp = NULL;                                              /* table not mapped */
+while ((R[0] & STR_LNMASK) != 0) {                      /* loop thru string */
+    if ((sp = StrMap (R[1], RA, &cnt)) == NULL) {       /* map src */
+        b = (uint8) Read (R[1], L_BYTE, RA);            /* can't, get byte */
+        sp = &b;
+        cnt = 1;
+        }
+    lnt = STR_MIN (R[0] & STR_LNMASK, cnt);
+    for (i = 0; i < lnt; i++) {
+        c = sp[i];
+        if (tp != NULL)                                 /* table mapped? */
+            t = tp[c];
+        else {
+            t = Read (R[3] + c, L_BYTE, RA);            /* get table ent */
+            if ((VA_GETOFF (R[3]) + 256) <= VA_PAGSIZE) { /* table in one page? */
+                tp = StrMap (R[3] + c, RA, &tcnt);      /* map it */
+                if (tp != NULL)
+                    tp = tp - c;
+                }
+            }
+        if (((t & mask) != 0) ^ spanc)                  /* test vs instr */
+            break;
+        }
+    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - i) & STR_LNMASK);
+    R[1] = R[1] + i;
+    sim_interval = sim_interval - ((i + 3) >> 2);
+    if (i < lnt)                                        /* found? */
         break;
-    R[0] = (R[0] & ~STR_LNMASK) | ((R[0] - 1) & STR_LNMASK);
-    R[1] = R[1] + 1;
     }
 PSL = PSL & ~PSL_FPD;
 R[0] = R[0] & STR_LNMASK;                               /* clear packup */
@@ -66,6 +66,7 @@
 #define STOP_BOOT       12                              /* reboot (780) */
 #define STOP_UNKNOWN    13                              /* unknown reason */
 #define STOP_UNKABO     14                              /* unknown abort */
+#define STOP_WBKPT      15                              /* watchpoint */
 #define ABORT_INTR      -1                              /* interrupt */
 #define ABORT_MCHK      (-SCB_MCHK)                     /* machine check */
 #define ABORT_RESIN     (-SCB_RESIN)                    /* rsvd instruction */
@@ -263,6 +264,7 @@
 #define TIR_V_TRAP      5                               /* trap requests */
 #define TIR_M_TRAP      07
 #define TIR_TRAP        (TIR_M_TRAP << TIR_V_TRAP)
+#define TIR_CHK         (1u << 8)                       /* int reqs changed */
 #define TRAP_INTOV      (1 << TIR_V_TRAP)               /* integer overflow */
 #define TRAP_DIVZRO     (2 << TIR_V_TRAP)               /* divide by zero */
 #define TRAP_FLTOVF     (3 << TIR_V_TRAP)               /* flt overflow */
@@ -270,9 +272,10 @@
 #define TRAP_FLTUND     (5 << TIR_V_TRAP)               /* flt underflow */
 #define TRAP_DECOVF     (6 << TIR_V_TRAP)               /* decimal overflow */
 #define TRAP_SUBSCR     (7 << TIR_V_TRAP)               /* subscript range */
-#define SET_TRAP(x)     trpirq = (trpirq & PSL_M_IPL) | (x)
+#define SET_TRAP(x)     trpirq = (trpirq & (PSL_M_IPL | TIR_CHK)) | (x)
 #define CLR_TRAPS       trpirq = trpirq & ~TIR_TRAP
 #define SET_IRQL        trpirq = (trpirq & TIR_TRAP) | eval_int ()
+#define CHK_IRQL        trpirq = trpirq | TIR_CHK
 #define GET_TRAP(x)     (((x) >> TIR_V_TRAP) & TIR_M_TRAP)
 #define GET_IRQL(x)     (((x) >> TIR_V_IRQL) & PSL_M_IPL)
 
@@ -724,6 +727,7 @@ enum opcodes {
 #define VAX_IDLE_QUAD       0x08
 #define VAX_IDLE_BSDNEW     0x10
 extern uint32 cpu_idle_mask;                            /* idle mask */
+extern int32 trpirq;                                    /* trap/intr req */
 void cpu_idle (void);
 
 /* Model dependent definitions */
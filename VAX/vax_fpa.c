@@ -58,6 +58,8 @@
 
 #include "vax_defs.h"
 #include <setjmp.h>
+#include <float.h>
+#include <math.h>
 
 extern int32 R[16];
 extern int32 PSL;
@@ -1319,6 +1321,309 @@ return r->sign | (r->exp << G_V_EXP) |
 
 #endif
 
+/* Native floating point
+
+   F and G floating operands are converted to host IEEE doubles, the
+   add, subtract, multiply or divide is done by the host, and the result
+   is converted back, whenever the host result is known to be the one
+   the exact code below would produce.
+
+   The exact code develops enough of each result that it rounds as if
+   the result were infinitely precise, with halfway cases rounded away
+   from zero (the one exception, an effective subtract that loses bits
+   beyond the 64b fraction, is within 2^-62 of the result).  The host
+   rounds halfway cases to even, and otherwise rounds the same way.  So:
+
+   - an F product is exact in a double, and an F sum is exact unless
+     the exponents differ by more than 29; the exact double is rounded
+     to 24b directly;
+   - an F quotient is rounded by the host to 53b; it rounds the same
+     way to 24b unless it is itself a 24b halfway case;
+   - a G result is taken from the host unless the residual, computed
+     exactly with fma, puts the true result on (or, for add, near) a
+     halfway case, or the result is a power of two.  A product or
+     dividend near the bottom of the range is left to the exact code,
+     since its residual could underflow to zero.
+
+   Any operand or result that is reserved, zero divisor, out of the VAX
+   range or outside the host's normal range is left to the exact code,
+   which takes all floating faults.  G exponents convert to IEEE by
+   subtracting 2, F exponents by adding 894.
+
+   All of this assumes each host operation rounds once, to a 53b double.
+   Hosts that evaluate in a wider format (FLT_EVAL_METHOD other than 0,
+   such as x87 code) round twice, so they use the exact code only.
+
+   If VAX_FPA_VERIFY is defined, every fast result is recomputed by the
+   exact code and any difference is reported.  VAX_FPA_TEST builds the
+   module for vax_fpatest, which compares the two paths on random
+   operands (make vax-fpa-test).
+*/
+
+#if defined (USE_INT64) && (FLT_RADIX == 2) && (DBL_MANT_DIG == 53) && \
+    defined (FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0) && !defined (VAX_FPA_NOFAST)
+
+#define FPA_NATIVE      TRUE
+
+typedef union {
+    double              d;
+    t_uint64            i;
+    } FPAV;
+
+#define DBL_SIGN        0x8000000000000000
+#define DBL_FRAC        0x000FFFFFFFFFFFFF
+#define DBL_HB          0x0010000000000000
+#define DBL_V_EXP       52
+#define DBL_M_EXP       0x7FF
+#define DBL_GETEXP(x)   ((int32) (((x) >> DBL_V_EXP) & DBL_M_EXP))
+#define DBL_F_BIAS      (1023 - FD_BIAS - 1)            /* F exp to IEEE exp */
+#define DBL_G_BIAS      (G_BIAS + 1 - 1023)             /* IEEE exp to G exp */
+#define DBL_F_LO        0x000000001FFFFFFF              /* bits below F frac */
+#define DBL_F_HALF      0x0000000010000000              /* F round bit */
+#define DBL_TINY        (2 * DBL_MANT_DIG + 1)          /* residual may underflow */
+
+/* Convert F, G to double; FALSE if reserved operand or host denormal */
+
+static t_bool fpa_getf (int32 hi, double *r)
+{
+FPAV v;
+int32 exp = FD_GETEXP (hi);
+
+if (exp == 0) {                                         /* zero? */
+    *r = 0.0;
+    return ((hi & FPSIGN) == 0);                        /* rsvd if - */
+    }
+v.i = (((t_uint64) (hi & FPSIGN)) << 48) |
+    (((t_uint64) (exp + DBL_F_BIAS)) << DBL_V_EXP) |
+    (((t_uint64) (hi & FD_FRACW)) << 45) |
+    (((t_uint64) ((hi >> 16) & 0xFFFF)) << 29);
+*r = v.d;
+return TRUE;
+}
+
+static t_bool fpa_getg (int32 hi, int32 lo, double *r)
+{
+FPAV v;
+int32 exp = G_GETEXP (hi);
+
+if (exp <= DBL_G_BIAS) {                                /* zero or tiny? */
+    *r = 0.0;
+    return ((exp == 0) && ((hi & FPSIGN) == 0));        /* only true 0 ok */
+    }
+v.i = UNSCRAM (hi, lo) - (((t_uint64) DBL_G_BIAS) << DBL_V_EXP);
+*r = v.d;
+return TRUE;
+}
+
+/* Convert double to F (rounding) or G (exact); FALSE if out of range */
+
+static t_bool fpa_putf (double d, int32 *res)
+{
+FPAV v;
+t_uint64 sig;
+uint32 frac;
+int32 exp;
+
+v.d = d;
+if ((v.i & ~DBL_SIGN) == 0) {                           /* zero? */
+    *res = 0;
+    return TRUE;
+    }
+exp = DBL_GETEXP (v.i);
+if (exp == 0)                                           /* denormal? */
+    return FALSE;
+sig = (v.i & DBL_FRAC) + DBL_HB + DBL_F_HALF;           /* round to 24b */
+if (sig & (DBL_HB << 1)) {                              /* carry out? */
+    sig = sig >> 1;
+    exp = exp + 1;
+    }
+exp = exp - DBL_F_BIAS;
+if ((exp <= 0) || (exp > FD_M_EXP))                     /* F range? */
+    return FALSE;
+frac = (uint32) (sig >> 29);
+*res = (((int32) (v.i >> 48)) & FPSIGN) | (exp << FD_V_EXP) |
+    ((frac >> 16) & FD_FRACW) | ((frac & 0xFFFF) << 16);
+return TRUE;
+}
+
+static t_bool fpa_putg (double d, int32 *res, int32 *rh)
+{
+FPAV v;
+int32 exp;
+
+v.d = d;
+if ((v.i & ~DBL_SIGN) == 0) {                           /* zero? */
+    *res = *rh = 0;
+    return TRUE;
+    }
+exp = DBL_GETEXP (v.i);
+if ((exp == 0) || ((exp + DBL_G_BIAS) > G_M_EXP))       /* G range? */
+    return FALSE;
+v.i = v.i + (((t_uint64) DBL_G_BIAS) << DBL_V_EXP);
+*res = (int32) (((v.i >> 48) & 0xFFFF) | ((v.i >> 16) & 0xFFFF0000));
+*rh = (int32) (((v.i >> 16) & 0xFFFF) | ((v.i << 16) & 0xFFFF0000));
+return TRUE;
+}
+
+static int32 fpa_getexp (double d)
+{
+FPAV v;
+
+v.d = d;
+return DBL_GETEXP (v.i);
+}
+
+/* Half the unit in the last place of a G result, or 0 if the result is
+   a power of two (its halfway cases are ambiguous) or too small */
+
+static double fpa_halfulp (double d)
+{
+FPAV v;
+int32 exp;
+
+v.d = d;
+exp = DBL_GETEXP (v.i);
+if (((v.i & DBL_FRAC) == 0) || (exp <= 54))
+    return 0.0;
+v.i = ((t_uint64) (exp - 53)) << DBL_V_EXP;
+return v.d;
+}
+
+/* F operations */
+
+static t_bool fpa_addf (int32 s1, int32 s2, t_bool sub, int32 *res)
+{
+double a, b, s, bb;
+
+if (!fpa_getf (s1, &a) || !fpa_getf (s2, &b))
+    return FALSE;
+if (sub)                                                /* sub? -s1 */
+    a = -a;
+s = a + b;                                              /* sum, then */
+bb = s - a;                                             /* its error */
+if (((a - (s - bb)) + (b - bb)) != 0.0)                 /* inexact? */
+    return FALSE;
+return fpa_putf (s, res);
+}
+
+static t_bool fpa_mulf (int32 s1, int32 s2, int32 *res)
+{
+double a, b;
+
+if (!fpa_getf (s1, &a) || !fpa_getf (s2, &b))
+    return FALSE;
+return fpa_putf (a * b, res);                           /* always exact */
+}
+
+static t_bool fpa_divf (int32 s1, int32 s2, int32 *res)
+{
+FPAV q;
+double a, b;
+
+if (!fpa_getf (s1, &a) || !fpa_getf (s2, &b) || (a == 0.0))
+    return FALSE;
+q.d = b / a;
+if ((q.i & DBL_F_LO) == DBL_F_HALF)                     /* halfway case? */
+    return FALSE;
+return fpa_putf (q.d, res);
+}
+
+/* G operations */
+
+static t_bool fpa_addg (int32 *opnd, t_bool sub, int32 *res, int32 *rh)
+{
+double a, b, s, bb, err, h;
+
+if (!fpa_getg (opnd[0], opnd[1], &a) || !fpa_getg (opnd[2], opnd[3], &b))
+    return FALSE;
+if (sub)                                                /* sub? -s1 */
+    a = -a;
+s = a + b;                                              /* sum, then */
+bb = s - a;                                             /* its error */
+err = (a - (s - bb)) + (b - bb);
+if (err != 0.0) {                                       /* inexact? */
+    h = fpa_halfulp (s);
+    if (fabs (err) >= (h - (h / 128.0)))                /* near halfway? */
+        return FALSE;
+    }
+return fpa_putg (s, res, rh);
+}
+
+static t_bool fpa_mulg (int32 *opnd, int32 *res, int32 *rh)
+{
+double a, b, p, err;
+
+if (!fpa_getg (opnd[0], opnd[1], &a) || !fpa_getg (opnd[2], opnd[3], &b))
+    return FALSE;
+p = a * b;
+if (fpa_getexp (p) <= DBL_TINY)                         /* residual underflow? */
+    return FALSE;
+err = fma (a, b, -p);                                   /* exact residual */
+if ((err != 0.0) && (fabs (err) >= fpa_halfulp (p)))    /* halfway? */
+    return FALSE;
+return fpa_putg (p, res, rh);
+}
+
+static t_bool fpa_divg (int32 *opnd, int32 *res, int32 *rh)
+{
+double a, b, q, rem;
+
+if (!fpa_getg (opnd[0], opnd[1], &a) || !fpa_getg (opnd[2], opnd[3], &b) ||
+    (a == 0.0) || (fpa_getexp (b) <= DBL_TINY))         /* residual underflow? */
+    return FALSE;
+q = b / a;
+rem = fma (-q, a, b);                                   /* exact remainder */
+if ((rem != 0.0) && (fabs (rem) >= (fabs (a) * fpa_halfulp (q))))
+    return FALSE;                                       /* halfway? */
+return fpa_putg (q, res, rh);
+}
+
+#else
+
+#define FPA_NATIVE      FALSE
+#define fpa_addf(s1,s2,sub,res)         FALSE
+#define fpa_mulf(s1,s2,res)             FALSE
+#define fpa_divf(s1,s2,res)             FALSE
+#define fpa_addg(opnd,sub,res,rh)       FALSE
+#define fpa_mulg(opnd,res,rh)           FALSE
+#define fpa_divg(opnd,res,rh)           FALSE
+
+#endif
+
+#if defined (VAX_FPA_VERIFY)
+
+static t_bool fpa_fast = TRUE;
+
+static void fpa_report (const char *op, int32 *opnd, int32 nopnd,
+    int32 fh, int32 fl, int32 sh, int32 sl)
+{
+int32 i;
+
+printf ("FPA %s", op);
+for (i = 0; i < nopnd; i++)
+    printf (" %08X", opnd[i]);
+printf (": fast %08X %08X, exact %08X %08X\n", fh, fl, sh, sl);
+}
+
+#define FPA_VERIFY(op,n,fh,fl,slow) { \
+    int32 sh, sl = 0; \
+    fpa_fast = FALSE; \
+    sh = slow; \
+    fpa_fast = TRUE; \
+    if ((sh != (fh)) || (sl != (fl))) \
+        fpa_report (op, opnd, n, fh, fl, sh, sl); \
+    }
+#elif defined (VAX_FPA_TEST)
+
+t_bool fpa_fast = TRUE;                                 /* set by vax_fpatest */
+t_bool fpa_native = FPA_NATIVE;
+
+#define FPA_VERIFY(op,n,fh,fl,slow)
+#else
+#define fpa_fast                        TRUE
+#define FPA_VERIFY(op,n,fh,fl,slow)
+#endif
+
 /* Floating point instructions */
 
 /* Move/test/move negated floating
@@ -1396,7 +1701,12 @@ return rpackfd (&a, NULL);
 int32 op_addf (int32 *opnd, t_bool sub)
 {
 UFP a, b;
+int32 r;
 
+if (fpa_fast && fpa_addf (opnd[0], opnd[1], sub, &r)) {
+    FPA_VERIFY ((sub? "SUBF": "ADDF"), 2, r, 0, op_addf (opnd, sub));
+    return r;
+    }
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 if (sub)                                                /* sub? -s1 */
@@ -1420,7 +1730,12 @@ return rpackfd (&a, rh);
 int32 op_addg (int32 *opnd, int32 *rh, t_bool sub)
 {
 UFP a, b;
+int32 r;
 
+if (fpa_fast && fpa_addg (opnd, sub, &r, rh)) {
+    FPA_VERIFY ((sub? "SUBG": "ADDG"), 4, r, *rh, op_addg (opnd, &sl, sub));
+    return r;
+    }
 unpackg (opnd[0], opnd[1], &a);
 unpackg (opnd[2], opnd[3], &b);
 if (sub)                                                /* sub? -s1 */
@@ -1434,7 +1749,12 @@ return rpackg (&a, rh);                                 /* round and pack */
 int32 op_mulf (int32 *opnd)
 {
 UFP a, b;
-    
+int32 r;
+
+if (fpa_fast && fpa_mulf (opnd[0], opnd[1], &r)) {
+    FPA_VERIFY ("MULF", 2, r, 0, op_mulf (opnd));
+    return r;
+    }
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 vax_fmul (&a, &b, 0, FD_BIAS, 0, 0);                    /* do multiply */
@@ -1454,7 +1774,12 @@ return rpackfd (&a, rh);                                /* round and pack */
 int32 op_mulg (int32 *opnd, int32 *rh)
 {
 UFP a, b;
+int32 r;
 
+if (fpa_fast && fpa_mulg (opnd, &r, rh)) {
+    FPA_VERIFY ("MULG", 4, r, *rh, op_mulg (opnd, &sl));
+    return r;
+    }
 unpackg (opnd[0], opnd[1], &a);                         /* G format */
 unpackg (opnd[2], opnd[3], &b);
 vax_fmul (&a, &b, 1, G_BIAS, 0, 0);                     /* do multiply */
@@ -1466,7 +1791,12 @@ return rpackg (&a, rh);                                 /* round and pack */
 int32 op_divf (int32 *opnd)
 {
 UFP a, b;
+int32 r;
 
+if (fpa_fast && fpa_divf (opnd[0], opnd[1], &r)) {
+    FPA_VERIFY ("DIVF", 2, r, 0, op_divf (opnd));
+    return r;
+    }
 unpackf (opnd[0], &a);                                  /* F format */
 unpackf (opnd[1], &b);
 vax_fdiv (&a, &b, 26, FD_BIAS);                         /* do divide */
@@ -1486,7 +1816,12 @@ return rpackfd (&b, rh);                                /* round and pack */
 int32 op_divg (int32 *opnd, int32 *rh)
 {
 UFP a, b;
+int32 r;
 
+if (fpa_fast && fpa_divg (opnd, &r, rh)) {
+    FPA_VERIFY ("DIVG", 4, r, *rh, op_divg (opnd, &sl));
+    return r;
+    }
 unpackg (opnd[0], opnd[1], &a);                         /* G format */
 unpackg (opnd[2], opnd[3], &b);
 vax_fdiv (&a, &b, 55, G_BIAS);                          /* do divide */
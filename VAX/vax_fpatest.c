@@ -0,0 +1,334 @@
+/* vax_fpatest.c: VAX F and G floating point cross-check
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in
+   all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+   THE AUTHOR BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+   IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   Except as contained in this notice, the name of the author shall not be
+   used in advertising or otherwise to promote the sale, use or other dealings
+   in this Software without prior written authorization from the author.
+
+   Usage: vax_fpatest [-v] [count [seed]]
+
+   vax_fpa.c is compiled with VAX_FPA_TEST, which lets this program turn
+   the native F and G path on and off.  Each of ADDF, SUBF, MULF, DIVF,
+   ADDG, SUBG, MULG and DIVG is run on count (default 1000000) random
+   operand sets, once natively and once with the exact code, and the
+   results, including any fault, must be bit for bit the same.
+
+   The operands are not uniformly random bit patterns, which would almost
+   never round to a halfway case or cancel.  Each one is drawn from one of
+   several shapes: random bits, fractions with many trailing zeros, a near
+   copy of the other operand, exponents at the ends of the range, and
+   operands chosen so that the true result falls on or next to a rounding
+   boundary.  -v lists every operand set that differs; otherwise the first
+   few are shown.  The exit status is nonzero if any result differs.
+*/
+
+#include "vax_defs.h"
+#include <setjmp.h>
+
+extern t_bool fpa_fast;
+extern t_bool fpa_native;
+
+extern int32 op_addf (int32 *opnd, t_bool sub);
+extern int32 op_addg (int32 *opnd, int32 *rh, t_bool sub);
+extern int32 op_mulf (int32 *opnd);
+extern int32 op_mulg (int32 *opnd, int32 *rh);
+extern int32 op_divf (int32 *opnd);
+extern int32 op_divg (int32 *opnd, int32 *rh);
+
+/* CPU state referenced by vax_fpa.c */
+
+int32 R[16];
+int32 PSL;
+int32 p1;
+jmp_buf save_env;
+
+int32 Read (uint32 va, int32 lnt, int32 acc)
+{
+return 0;                                               /* POLYx not tested */
+}
+
+#define FPT_SHOW        10                              /* mismatches shown */
+
+#define FPT_ADDF        0
+#define FPT_SUBF        1
+#define FPT_MULF        2
+#define FPT_DIVF        3
+#define FPT_ADDG        4
+#define FPT_SUBG        5
+#define FPT_MULG        6
+#define FPT_DIVG        7
+#define FPT_NOPS        8
+
+static const char *fpt_name[FPT_NOPS] = {
+    "ADDF", "SUBF", "MULF", "DIVF", "ADDG", "SUBG", "MULG", "DIVG"
+    };
+
+typedef struct {
+    int32               abort;                          /* fault, 0 if none */
+    int32               p1;                             /* fault parameter */
+    int32               hi;                             /* result */
+    int32               lo;
+    } FPTRES;
+
+static t_uint64 fpt_seed;
+
+/* xorshift64* generator */
+
+static t_uint64 fpt_rand (void)
+{
+fpt_seed = fpt_seed ^ (fpt_seed >> 12);
+fpt_seed = fpt_seed ^ (fpt_seed << 25);
+fpt_seed = fpt_seed ^ (fpt_seed >> 27);
+return fpt_seed * 0x2545F4914F6CDD1D;
+}
+
+static uint32 fpt_range (uint32 n)
+{
+return (uint32) ((fpt_rand () >> 32) % n);
+}
+
+/* Random F or G value, in canonical form: sign, exponent, fraction from
+   the top down.  ref is the canonical form of the other operand. */
+
+static t_uint64 fpt_value (uint32 expbits, uint32 fracbits, t_uint64 ref)
+{
+t_uint64 r = fpt_rand ();
+t_uint64 fmask = (((t_uint64) 1) << fracbits) - 1;
+uint32 emax = (1u << expbits) - 1;
+uint32 exp = (uint32) ((r >> fracbits) & emax);
+t_uint64 frac = r & fmask;
+t_uint64 sign = r & (((t_uint64) 1) << (expbits + fracbits));
+int32 d;
+
+switch (fpt_range (8)) {
+
+    case 0:                                             /* random bits */
+        return r & ((((t_uint64) 2) << (expbits + fracbits)) - 1);
+
+    case 1:                                             /* few fraction bits */
+        frac = frac & ~((((t_uint64) 1) << fpt_range (fracbits + 1)) - 1);
+        break;
+
+    case 2:                                             /* near ref */
+        d = (int32) fpt_range (65) - 32;
+        frac = ((ref & fmask) + d) & fmask;
+        exp = (uint32) ((ref >> fracbits) & emax);
+        if (fpt_range (2))
+            sign = sign ^ (((t_uint64) 1) << (expbits + fracbits));
+        break;
+
+    case 3:                                             /* nearby exponent */
+        d = (int32) fpt_range (2 * fracbits + 9) - (fracbits + 4);
+        d = d + (int32) ((ref >> fracbits) & emax);
+        exp = (d < 1)? 1: ((d > (int32) emax)? emax: d);
+        break;
+
+    case 4:                                             /* range ends */
+        exp = fpt_range (2)? fpt_range (4): emax - fpt_range (4);
+        break;
+
+    case 5:                                             /* fraction all ones */
+        frac = fmask & ~((((t_uint64) 1) << fpt_range (fracbits / 2)) - 1);
+        break;
+
+    default:                                            /* normal range */
+        exp = (emax >> 1) - (emax >> 3) + fpt_range (emax >> 2);
+        break;
+        }
+return sign | (((t_uint64) exp) << fracbits) | frac;
+}
+
+/* Canonical F and G to operand words */
+
+static int32 fpt_putf (t_uint64 v)
+{
+uint32 u = (uint32) v;
+
+return (int32) (((u >> 16) & 0xFFFF) | ((u << 16) & 0xFFFF0000));
+}
+
+static void fpt_putg (t_uint64 v, int32 *hi, int32 *lo)
+{
+*hi = (int32) (((v >> 48) & 0xFFFF) | ((v >> 16) & 0xFFFF0000));
+*lo = (int32) (((v >> 16) & 0xFFFF) | ((v << 16) & 0xFFFF0000));
+}
+
+/* Keep only the top keep bits of the fraction */
+
+static t_uint64 fpt_short (t_uint64 v, uint32 fracbits, uint32 keep)
+{
+t_uint64 fmask = (((t_uint64) 1) << fracbits) - 1;
+
+return v & ~(fmask >> keep);
+}
+
+/* Operands whose true result is on or next to a rounding boundary.  For
+   add, the second operand supplies the bits just below the result's last
+   place.  For multiply, an operand with few significant bits makes the
+   exact product only a few bits longer than the result, so it is often
+   exactly halfway.  For divide, short operands give quotients that are
+   short repeating patterns, which come close to halfway. */
+
+static void fpt_boundary (int32 op, uint32 expbits, uint32 fracbits,
+    t_uint64 *a, t_uint64 *b)
+{
+uint32 emax = (1u << expbits) - 1;
+uint32 ea = (uint32) ((*a >> fracbits) & emax);
+uint32 sh = 1 + fpt_range (fracbits + 2);
+
+switch (op & 3) {
+
+    case 0: case 1:                                     /* add, sub */
+        if (ea > sh)
+            *b = fpt_short ((*b & ~(((t_uint64) emax) << fracbits)) |
+                (((t_uint64) (ea - sh)) << fracbits), fracbits, fpt_range (3));
+        break;
+
+    case 2:                                             /* mul */
+        *b = fpt_short (*b, fracbits, fpt_range (4));
+        break;
+
+    case 3:                                             /* div */
+        *a = fpt_short (*a, fracbits, fpt_range (6));
+        *b = fpt_short (*b, fracbits, fpt_range (6));
+        break;
+        }
+}
+
+/* Run one operation; faults are caught and returned as the result */
+
+static void fpt_run (int32 op, int32 *opnd, FPTRES *res)
+{
+int32 abort;
+int32 opc[4];
+
+memcpy (opc, opnd, sizeof (opc));
+res->hi = res->lo = res->p1 = 0;
+p1 = 0;
+abort = setjmp (save_env);
+if (abort != 0) {
+    res->abort = abort;
+    res->p1 = p1;
+    return;
+    }
+res->abort = 0;
+switch (op) {
+
+    case FPT_ADDF: case FPT_SUBF:
+        res->hi = op_addf (opc, op == FPT_SUBF);
+        break;
+
+    case FPT_MULF:
+        res->hi = op_mulf (opc);
+        break;
+
+    case FPT_DIVF:
+        res->hi = op_divf (opc);
+        break;
+
+    case FPT_ADDG: case FPT_SUBG:
+        res->hi = op_addg (opc, &res->lo, op == FPT_SUBG);
+        break;
+
+    case FPT_MULG:
+        res->hi = op_mulg (opc, &res->lo);
+        break;
+
+    case FPT_DIVG:
+        res->hi = op_divg (opc, &res->lo);
+        break;
+        }
+}
+
+static void fpt_show (int32 op, int32 *opnd, FPTRES *fast, FPTRES *exact)
+{
+int32 i, n = (op < FPT_ADDG)? 2: 4;
+
+printf ("%s", fpt_name[op]);
+for (i = 0; i < n; i++)
+    printf (" %08X", opnd[i]);
+printf (": native");
+if (fast->abort)
+    printf (" fault %d/%d", fast->abort, fast->p1);
+else printf (" %08X %08X", fast->hi, fast->lo);
+printf (", exact");
+if (exact->abort)
+    printf (" fault %d/%d\n", exact->abort, exact->p1);
+else printf (" %08X %08X\n", exact->hi, exact->lo);
+}
+
+int main (int argc, char *argv[])
+{
+int32 op, opnd[4];
+uint32 i, count = 1000000;
+uint32 bad[FPT_NOPS], total = 0, shown = 0;
+t_bool verbose = FALSE;
+t_uint64 a, b;
+FPTRES fast, exact;
+uint32 eb, fb;
+
+if ((argc > 1) && (strcmp (argv[1], "-v") == 0)) {
+    verbose = TRUE;
+    argc--;
+    argv++;
+    }
+if (argc > 1)
+    count = (uint32) strtoul (argv[1], NULL, 0);
+fpt_seed = (argc > 2)? (t_uint64) strtoul (argv[2], NULL, 0): 0x5EED;
+if (fpt_seed == 0)
+    fpt_seed = 1;
+printf ("VAX F/G floating point: %u operand sets per operation, seed %lu\n",
+    count, (unsigned long) fpt_seed);
+if (!fpa_native)
+    printf ("Native path is not built on this host; exact code only\n");
+
+for (op = 0; op < FPT_NOPS; op++) {
+    eb = (op < FPT_ADDG)? 8: 11;                        /* F or G layout */
+    fb = (op < FPT_ADDG)? 23: 52;
+    bad[op] = 0;
+    for (i = 0; i < count; i++) {
+        a = fpt_value (eb, fb, 0);
+        b = fpt_value (eb, fb, a);
+        if (fpt_range (4) == 0)
+            fpt_boundary (op, eb, fb, &a, &b);
+        if (op < FPT_ADDG) {
+            opnd[0] = fpt_putf (a);
+            opnd[1] = fpt_putf (b);
+            opnd[2] = opnd[3] = 0;
+            }
+        else {
+            fpt_putg (a, &opnd[0], &opnd[1]);
+            fpt_putg (b, &opnd[2], &opnd[3]);
+            }
+        fpa_fast = TRUE;
+        fpt_run (op, opnd, &fast);
+        fpa_fast = FALSE;
+        fpt_run (op, opnd, &exact);
+        if ((fast.abort != exact.abort) || (fast.p1 != exact.p1) ||
+            (fast.hi != exact.hi) || (fast.lo != exact.lo)) {
+            bad[op]++;
+            if (verbose || (shown++ < FPT_SHOW))
+                fpt_show (op, opnd, &fast, &exact);
+            }
+        }
+    printf ("%s %u differ\n", fpt_name[op], bad[op]);
+    total = total + bad[op];
+    }
+return (total == 0)? EXIT_SUCCESS: EXIT_FAILURE;
+}
@@ -248,7 +248,6 @@ iod = ReadQb (pa);                                      /* wd from Qbus */
 if (lnt < L_LONG)                                       /* bw? position */
     iod = iod << ((pa & 2)? 16: 0);
 else iod = (ReadQb (pa + 2) << 16) | iod;               /* lw, get 2nd wd */
-SET_IRQL;
 return iod;
 }
 
@@ -272,7 +271,6 @@ else {
     WriteQb (pa, val & 0xFFFF, WRITE);
     WriteQb (pa + 2, (val >> 16) & 0xFFFF, WRITE);
     }
-SET_IRQL;
 return;
 }
 
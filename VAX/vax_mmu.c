@@ -42,6 +42,7 @@
         ReadB(W)        -       read aligned physical byte (word)
         WriteB(W)       -       write aligned physical byte (word)
         Test            -       test acccess
+        StrMap          -       map a page of a string
 
         zap_tb          -       clear TB
         zap_tb_ent      -       clear TB entry
@@ -106,6 +107,7 @@ t_stat tlb_reset (DEVICE *dptr);
 char *tlb_description (DEVICE *dptr);
 
 TLBENT fill (uint32 va, int32 lnt, int32 acc, int32 *stat);
+static void wch_test (uint32 va, int32 pa, int32 pa1, int32 lnt, int32 val, int32 typ);
 extern int32 ReadIO (uint32 pa, int32 lnt);
 extern void WriteIO (uint32 pa, int32 val, int32 lnt);
 extern int32 ReadReg (uint32 pa, int32 lnt);
@@ -152,6 +154,10 @@ DEVICE tlb_dev = {
         a longword, unaligned word crossing a longword boundary.
 
    Note that these routines do not handle quad or octa references.
+
+   Pages carrying data watchpoints are never entered in the TB (see fill),
+   so references to them always take the miss path, which is the only
+   place watchpoints are tested.
 */
 
 /* Read virtual
@@ -168,6 +174,7 @@ int32 Read (uint32 va, int32 lnt, int32 acc)
 {
 int32 vpn, off, tbi, pa;
 int32 pa1, bo, sc, wl, wh;
+uint32 wch = 0;
 TLBENT xpte;
 
 mchk_va = va;
@@ -177,15 +184,20 @@ if (mapen) {                                            /* mapping on? */
     tbi = VA_GETTBI (vpn);
     xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
     if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
-        ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0)))
+        ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0))) {
         xpte = fill (va, lnt, acc, NULL);               /* fill if needed */
+        wch = sim_brk_wsumm;                            /* maybe watched */
+        }
     pa = (xpte.pte & TLB_PFN) | off;                    /* get phys addr */
     }
 else {
     pa = va & PAMASK;
     off = 0;
+    wch = sim_brk_wsumm;
     }
 if ((pa & (lnt - 1)) == 0) {                            /* aligned? */
+    if (wch)                                            /* watchpoints? */
+        wch_test (va, pa, pa, lnt, 0, SWMASK ('R'));
     if (lnt >= L_LONG)                                  /* long, quad? */
         return ReadL (pa);
     if (lnt == L_WORD)                                  /* word? */
@@ -197,11 +209,15 @@ if (mapen && ((uint32)(off + lnt) > VA_PAGSIZE)) {      /* cross page? */
     tbi = VA_GETTBI (vpn);
     xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
     if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
-        ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0)))
+        ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0))) {
         xpte = fill (va + lnt, lnt, acc, NULL);         /* fill if needed */
+        wch = sim_brk_wsumm;                            /* maybe watched */
+        }
     pa1 = (xpte.pte & TLB_PFN) | VA_GETOFF (va + 4);
     }
 else pa1 = (pa + 4) & PAMASK;                           /* not cross page */
+if (wch)                                                /* watchpoints? */
+    wch_test (va, pa, pa1, lnt, 0, SWMASK ('R'));
 bo = pa & 3;
 pa = pa & ~3;                                           /* convert to aligned */
 pa1 = pa1 & ~3;
@@ -235,6 +251,7 @@ void Write (uint32 va, int32 val, int32 lnt, int32 acc)
 {
 int32 vpn, off, tbi, pa;
 int32 pa1, bo, sc, wl, wh;
+uint32 wch = 0;
 TLBENT xpte;
 
 mchk_va = va;
@@ -244,15 +261,20 @@ if (mapen) {
     tbi = VA_GETTBI (vpn);
     xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
     if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
-        ((xpte.pte & TLB_M) == 0))
+        ((xpte.pte & TLB_M) == 0)) {
         xpte = fill (va, lnt, acc, NULL);
+        wch = sim_brk_wsumm;                            /* maybe watched */
+        }
     pa = (xpte.pte & TLB_PFN) | off;
     }
 else {
     pa = va & PAMASK;
     off = 0;
+    wch = sim_brk_wsumm;
     }
 if ((pa & (lnt - 1)) == 0) {                            /* aligned? */
+    if (wch)                                            /* watchpoints? */
+        wch_test (va, pa, pa, lnt, val, SWMASK ('W'));
     if (lnt >= L_LONG)                                  /* long, quad? */
         WriteL (pa, val);
     else if (lnt == L_WORD)                             /* word? */
@@ -265,11 +287,15 @@ if (mapen && ((uint32)(off + lnt) > VA_PAGSIZE)) {
     tbi = VA_GETTBI (vpn);
     xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
     if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
-        ((xpte.pte & TLB_M) == 0))
+        ((xpte.pte & TLB_M) == 0)) {
         xpte = fill (va + lnt, lnt, acc, NULL);
+        wch = sim_brk_wsumm;                            /* maybe watched */
+        }
     pa1 = (xpte.pte & TLB_PFN) | VA_GETOFF (va + 4);
     }
 else pa1 = (pa + 4) & PAMASK;
+if (wch)                                                /* watchpoints? */
+    wch_test (va, pa, pa1, lnt, val, SWMASK ('W'));
 bo = pa & 3;
 pa = pa & ~3;                                           /* convert to aligned */
 pa1 = pa1 & ~3;
@@ -319,6 +345,54 @@ if (mapen) {                                            /* mapping on? */
 return va & PAMASK;                                     /* ret phys addr */
 }
 
+/* Map a page of a string
+
+   Inputs:
+        va      =       virtual address
+        acc     =       access code (KESU, read or write)
+        cnt     =       pointer to returned byte count
+   Output:
+        host pointer to the byte at va, with *cnt set to the number
+        of bytes from va to the end of its page, or NULL if the page
+        is not memory, is watched, or the host cannot address simulated
+        memory by bytes.  Translation faults are taken as for a byte
+        Read or Write of va.
+
+   The string instructions use this to move or scan a page at a time
+   with one translation.  On a NULL return they make the reference
+   through Read or Write instead.
+*/
+
+uint8 *StrMap (uint32 va, int32 acc, int32 *cnt)
+{
+int32 vpn, off, tbi, pa;
+TLBENT xpte;
+
+mchk_va = va;
+off = VA_GETOFF (va);
+if (mapen) {                                            /* mapping on? */
+    vpn = VA_GETVPN (va);
+    tbi = VA_GETTBI (vpn);
+    xpte = (va & VA_S0)? stlb[tbi]: ptlb[tbi];          /* access tlb */
+    if (((xpte.pte & acc) == 0) || (xpte.tag != vpn) ||
+        ((acc & TLB_WACC) && ((xpte.pte & TLB_M) == 0))) {
+        xpte = fill (va, L_BYTE, acc, NULL);            /* fill if needed */
+        if (sim_brk_wsumm)                              /* maybe watched */
+            return NULL;
+        }
+    pa = (xpte.pte & TLB_PFN) | off;                    /* get phys addr */
+    }
+else {
+    if (sim_brk_wsumm)                                  /* maybe watched */
+        return NULL;
+    pa = va & PAMASK;
+    }
+if (!sim_end || !ADDR_IS_MEM (pa | VA_M_OFF))           /* whole page in mem? */
+    return NULL;
+*cnt = VA_PAGSIZE - off;
+return ((uint8 *) M) + pa;
+}
+
 /* Read aligned physical (in virtual context, unless indicated)
 
    Inputs:
@@ -455,8 +529,15 @@ return;
 
    If called from map (VAX PROBEx), the error status is returned
    to the caller, and no fault occurs.
+
+   A page that is watched, either by virtual or by physical address,
+   is translated but not stored in the TLB.
 */
 
+#define TLB_WCH(va,pte) (sim_brk_wsumm && \
+    (sim_brk_wpage ((va), 0) || \
+     sim_brk_wpage ((pte) & TLB_PFN, sim_brk_wphys)))
+
 #define MM_ERR(param) { \
     if (stat) { \
         *stat = param; \
@@ -471,6 +552,7 @@ TLBENT fill (uint32 va, int32 lnt, int32 acc, int32 *stat)
 int32 ptidx = (((uint32) va) >> 7) & ~03;
 int32 tlbpte, ptead, pte, tbi, vpn;
 static TLBENT zero_pte = { 0, 0 };
+TLBENT wchpte;
 
 if (va & VA_S0) {                                       /* system space? */
     if (ptidx >= d_slr)                                 /* system */
@@ -504,11 +586,15 @@ else {
 #endif
         if ((pte & PTE_V) == 0)                         /* spte TNV? */
             MM_ERR (PR_PTNV);
-        stlb[tbi].tag = vpn;                            /* set stlb tag */
-        stlb[tbi].pte = cvtacc[PTE_GETACC (pte)] |
-            ((pte << VA_N_OFF) & TLB_PFN);              /* set stlb data */
+        tlbpte = cvtacc[PTE_GETACC (pte)] |
+            ((pte << VA_N_OFF) & TLB_PFN);              /* stlb data */
+        if (!TLB_WCH (ptead, tlbpte)) {                 /* unless watched, */
+            stlb[tbi].tag = vpn;                        /* set stlb tag */
+            stlb[tbi].pte = tlbpte;                     /* set stlb data */
+            }
         }
-    ptead = (stlb[tbi].pte & TLB_PFN) | VA_GETOFF (ptead);
+    else tlbpte = stlb[tbi].pte;
+    ptead = (tlbpte & TLB_PFN) | VA_GETOFF (ptead);
 #endif
     }
 pte = ReadL (ptead);                                    /* read pte */
@@ -525,6 +611,11 @@ if (acc & TLB_WACC) {                                   /* write? */
     }
 vpn = VA_GETVPN (va);
 tbi = VA_GETTBI (vpn);
+if (TLB_WCH (va, tlbpte)) {                             /* watched page? */
+    wchpte.tag = vpn;                                   /* don't cache */
+    wchpte.pte = tlbpte;
+    return wchpte;
+    }
 if ((va & VA_S0) == 0) {                                /* process space? */
     ptlb[tbi].tag = vpn;                                /* store tlb ent */
     ptlb[tbi].pte = tlbpte;
@@ -535,6 +626,53 @@ stlb[tbi].pte = tlbpte;                                 /* store tlb ent */
 return stlb[tbi];
 }
 
+/* Watchpoint test
+
+   Called on the TB miss path for a virtual reference that may touch a
+   watched page.  The virtual range is contiguous; the physical range is
+   split at the page boundary if the reference crosses pages.  A write
+   that changes a memory location also matches modify watchpoints.
+
+   Inputs:
+        va      =       virtual address
+        pa      =       physical address of first byte
+        pa1     =       physical address of the longword holding the last byte
+        lnt     =       length code (BWL)
+        val     =       data to be written (writes only)
+        typ     =       reference type, R or W
+*/
+
+static void wch_test (uint32 va, int32 pa, int32 pa1, int32 lnt, int32 val, int32 typ)
+{
+int32 n = lnt;
+int32 bo, sc, wl, wh, old;
+
+if ((typ & SWMASK ('W')) && (sim_brk_wsumm & SWMASK ('M')) &&
+    ADDR_IS_MEM (pa) && ADDR_IS_MEM (pa1)) {            /* modify watch? */
+    bo = pa & 3;
+    wl = ReadL (pa & ~3);
+    wh = ReadL (pa1 & ~3);
+    if (lnt >= L_LONG) {
+        sc = bo << 3;
+        old = bo? ((((wl >> sc) & align[bo]) | (wh << (32 - sc))) & LMASK): wl;
+        }
+    else if (lnt == L_WORD)
+        old = (bo == 3)? (((wl >> 24) & 0xFF) | ((wh & 0xFF) << 8)):
+            ((wl >> (bo << 3)) & WMASK);
+    else old = (wl >> (bo << 3)) & BMASK;
+    if (((old ^ val) & ((lnt >= L_LONG)? LMASK: ((1 << (lnt << 3)) - 1))) != 0)
+        typ = typ | SWMASK ('M');                       /* value changes */
+    }
+if (mapen && ((uint32) (VA_GETOFF (va) + lnt) > VA_PAGSIZE))
+    n = VA_PAGSIZE - VA_GETOFF (va);                    /* bytes in 1st page */
+if (sim_brk_wtest (va, lnt, typ) ||                     /* virtual */
+    sim_brk_wtest (pa, n, typ | sim_brk_wphys) ||       /* physical */
+    (n >= lnt))
+    return;
+sim_brk_wtest (pa1 & ~VA_M_OFF, lnt - n, typ | sim_brk_wphys);
+return;
+}
+
 /* Utility routines */
 
 extern void set_map_reg (void)
@@ -0,0 +1,90 @@
+#!/bin/sh
+#
+# bench.sh - run the simulator CPU and I/O benchmarks
+#
+# Usage: bench.sh [-b baseline] [-t percent] [bindir [suite ...]]
+#
+# Runs each bench/<suite>/*.ini workload with the matching simulator from
+# bindir (default BIN) and prints one line per workload:
+#
+#   bench suite=vax workload=mix status=ok insts=... host_ns=... idle_ns=...
+#         events=... mips=... ns_per_inst=... events_per_sec=...
+#
+# mips and ns_per_inst count only executed instructions and the host time
+# spent executing them; time the simulator idled or was throttled, and the
+# instructions it skipped while idle, are left out (see SHOW RUNSTATS).
+# status is ok, or fail if the workload did not halt where its
+# "; expect: HALT at <pc>" line says.  With -b, a previous run's output
+# is read as a baseline, and any workload whose MIPS dropped by more than
+# the -t threshold (default 10 percent) is reported as status=slow.  The
+# exit status is non-zero if any workload failed or slowed down.
+#
+# The display suite, which is not run by default, is the render benchmark
+# bindir/rbench (display/rbench.c); it reports frames rendered per second
+# (fps) instead of MIPS, and that is what the baseline is compared on.
+#
+
+baseline=
+tolerance=10
+while getopts b:t: opt; do
+    case $opt in
+    b)  baseline=$OPTARG ;;
+    t)  tolerance=$OPTARG ;;
+    *)  echo "usage: $0 [-b baseline] [-t percent] [bindir [suite ...]]" >&2
+        exit 2 ;;
+    esac
+done
+shift `expr $OPTIND - 1`
+
+here=`dirname "$0"`
+bindir=${1:-BIN}
+[ $# -gt 0 ] && shift
+suites=${*:-"pdp11 vax pdp10"}
+
+scratch=`mktemp -d "${TMPDIR:-/tmp}/simh-bench.XXXXXX"` || exit 1
+trap 'rm -rf "$scratch"' 0 1 2 15
+
+status=0
+for suite in $suites; do
+    rate=mips
+    case $suite in
+    vax)    sim=microvax3900 ;;
+    display) sim=rbench rate=fps ;;
+    *)      sim=$suite ;;
+    esac
+    if [ ! -x "$bindir/$sim" ]; then
+        echo "bench suite=$suite status=missing simulator=$bindir/$sim"
+        status=1
+        continue
+    fi
+    if [ $suite = display ]; then
+        workloads=`"$bindir/$sim" -l`
+    else
+        workloads=`cd "$here/$suite" && ls *.ini | sed 's/\.ini$//'`
+    fi
+    for workload in $workloads; do
+        rm -f "$scratch"/*
+        result=ok
+        if [ $suite = display ]; then
+            stats=`"$bindir/$sim" $workload "$scratch" </dev/null 2>&1` || result=fail
+        else
+            ini="$here/$suite/$workload.ini"
+            out=`"$bindir/$sim" "$ini" "$scratch" </dev/null 2>&1`
+            expect=`tr -d '\r' <"$ini" | sed -n 's/^; expect: HALT at //p'`
+            stats=`echo "$out" | sed -n 's/^runstats last .* runs=[0-9]* //p'`
+            echo "$out" | grep "HALT instruction, PC: $expect " >/dev/null || result=fail
+        fi
+        [ -z "$stats" ] && result=fail
+        if [ $result = ok ] && [ -n "$baseline" ]; then
+            cur=`echo "$stats" | sed -n "s/.* $rate=\([0-9.]*\).*/\1/p"`
+            base=`sed -n "s/^bench suite=$suite workload=$workload .* $rate=\([0-9.]*\).*/\1/p" "$baseline"`
+            if [ -n "$base" ] &&
+               awk "BEGIN { exit !($cur < $base * (100 - $tolerance) / 100) }"; then
+                result=slow
+            fi
+        fi
+        [ $result = ok ] || status=1
+        echo "bench suite=$suite workload=$workload status=$result $stats"
+    done
+done
+exit $status
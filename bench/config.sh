@@ -0,0 +1,44 @@
+#!/bin/sh
+#
+# config.sh - check simulator configurations against saved output
+#
+# Usage: config.sh [bindir [simulator ...]]
+#
+# Runs bench/config/<simulator>.ini with the simulator from bindir
+# (default BIN) and compares its output, less the version banner, with
+# bench/config/<simulator>.txt.  Each script shows the configuration at
+# startup and again after the first GO, so a device whose power-up reset
+# is deferred (DEV_RSTDEFER) but reaches other devices shows up as a
+# change in their addresses, vectors or enables.  The saved output was
+# taken from a build that reset every device at startup.  Prints one line
+# per simulator, followed by the differences if any, and exits non-zero
+# if any simulator is missing or differs.
+#
+
+here=`dirname "$0"`
+bindir=${1:-BIN}
+[ $# -gt 0 ] && shift
+sims=${*:-"pdp8 pdp11 pdp10 microvax3900"}
+
+scratch=`mktemp -d "${TMPDIR:-/tmp}/simh-config.XXXXXX"` || exit 1
+trap 'rm -rf "$scratch"' 0 1 2 15
+
+status=0
+for sim in $sims; do
+    if [ ! -x "$bindir/$sim" ]; then
+        echo "config simulator=$sim status=missing"
+        status=1
+        continue
+    fi
+    "$bindir/$sim" "$here/config/$sim.ini" </dev/null 2>&1 |
+        tr -d '\r' | sed '/ simulator V[0-9]/d' >"$scratch/out"
+    tr -d '\r' <"$here/config/$sim.txt" >"$scratch/expect"
+    if diff "$scratch/expect" "$scratch/out" >"$scratch/diff"; then
+        echo "config simulator=$sim status=ok"
+    else
+        echo "config simulator=$sim status=differ"
+        cat "$scratch/diff"
+        status=1
+    fi
+done
+exit $status
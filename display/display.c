@@ -40,8 +40,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
-#include <limits.h>         /* for USHRT_MAX */
 #include "ws.h"
 #include "display.h"
 
@@ -227,12 +227,10 @@ static struct display displays[] = {
 };
 
 /*
- * Unit time (in microseconds) used to store display point time to
- * live at current aging level.  If this is too small, delay values
- * cannot fit in an unsigned short.  If it is too large all pixels
- * will age at once.  Perhaps a suitable value should be calculated at
- * run time?  When display_init() calculates refresh_interval it
- * sanity checks for both cases.
+ * Unit time (in microseconds) in which the aging period is measured.
+ * If it is too large the period is rounded badly.  Perhaps a suitable
+ * value should be calculated at run time?  When display_init()
+ * calculates refresh_interval it sanity checks it.
  */
 #define DELAY_UNIT 250
 
@@ -286,59 +284,78 @@ static struct display displays[] = {
  */
 
 /*
- * Each point on the display is represented by a "struct point".  When
- * a point isn't dark (intensity > 0), it is linked into a circular,
- * doubly linked delta queue (a priority queue where "delay"
- * represents the time difference from the previous entry (if any) in
- * the queue.
+ * The display is kept as two planes of bytes, one byte per pixel.
  *
- * All points are aged refresh_rate times/second, each time moved to the
- * next (logarithmically) lower intensity level.  When display_age() is
- * called, only the entries which have expired are processed.  Calling
- * display_age() often allows spreading out the workload.
+ * The TTL plane holds the time each pixel has left before going dark,
+ * in ticks of 1/AGE_STEPS of an aging period (zero means off).  All lit
+ * pixels are aged together, AGE_STEPS*refresh_rate times/second, and
+ * move to the next (logarithmically) lower intensity level once every
+ * AGE_STEPS ticks.  Since each level is a fixed fraction of the one
+ * before, one decrement of the whole plane is one step of phosphor
+ * decay.  The plane is decremented a machine word (several pixels) at a
+ * time, skipping rows and words with nothing lit, so the cost of aging
+ * follows the lit area of the screen rather than the number of points
+ * plotted.
+ *
+ * The attribute plane holds the intensity level and beam color each
+ * pixel was last drawn with, and a flag marking pixels drawn since
+ * they were last painted.  Newly drawn pixels are collected in a batch
+ * and painted together by display_age() and display_sync(), rather
+ * than one at a time from display_point().
+ *
+ * A pixel starts aging at the next tick after it is drawn, so it may
+ * appear up to one tick older than it is; the decay curve is otherwise
+ * unchanged.
  *
  * An alternative would be to have intensity levels represent linear
  * decreases in intensity, and have the decay time at each level change.
  * Inverting the decay function for a multi-component phosphor may be
  * tricky, and the two different colors would need different time tables.
- * Furthermore, it would require finding the correct location in the
- * queue when adding a point (currently only need to add points at end)
  */
 
-/*
- * 12 bytes/entry on 32-bit system when REFRESH_RATE > 15
- * (requires 3MB for 512x512 display).
- */
+typedef unsigned long word_t;   /* unit of plane aging */
 
-typedef unsigned short delay_t;
-#define DELAY_T_MAX USHRT_MAX
+/* ticks per aging period: a power of two; MAXTICK must fit in a byte */
+#ifndef AGE_STEPS
+#define AGE_STEPS 2
+#endif
+#define MAXTICK (MAXTTL*AGE_STEPS)
 
-struct point {
-    struct point *next;         /* next entry in queue */
-    struct point *prev;         /* prev entry in queue */
-    delay_t delay;              /* delta T in DELAY_UNITs */
-    unsigned char ttl;          /* zero means off, not linked in */
-    unsigned char level : 7;    /* intensity level */
-    unsigned char color : 1;    /* for VR20 (two colors) */
-};
+/* convert ticks left to a TTL (zero means off) */
+#define TTL(T) (((T) + AGE_STEPS-1) / AGE_STEPS)
+
+#define ATTR_LEVEL 0x3f         /* intensity level */
+#define ATTR_COLOR 0x40         /* for VR20 (two colors) */
+#define ATTR_FRESH 0x80         /* drawn, waiting in batch to be painted */
 
-static struct point *points;    /* allocated array of points */
-static struct point _head;
-#define head (&_head)
+static word_t *ttl_words;       /* TTL plane; rows padded to whole words */
+static unsigned char *ttls;     /* TTL plane, by pixel (in ticks) */
+static unsigned char *attrs;    /* attribute plane, same layout */
+static unsigned char *row_lit;  /* rows which may have lit pixels */
+static size_t row_bytes;        /* plane row length */
+
+/* convert X,Y to a plane offset */
+#define P(X,Y) ((X) + (Y)*row_bytes)
+
+/* convert plane offset to X and Y */
+#define X(P) ((int)((P) % row_bytes))
+#define Y(P) ((int)((P) / row_bytes))
 
 /*
- * time span of all entries in queue
- * should never exceed refresh_interval
- * (should be possible to make this a delay_t)
+ * colors[] age index for T ticks left: a new point keeps its first
+ * color through its first aging period, and index zero (off) is black
  */
-static long queue_interval;
+#define AGE(T) (TTL(T) < MAXTTL ? TTL(T) : MAXTTL-1)
 
-/* convert X,Y to a "struct point *" */
-#define P(X,Y) (points + (X) + ((Y)*(size_t)xpixels))
+/* color to paint a pixel with attributes A and T ticks left */
+#define COLOR(A,T) colors[((A) & ATTR_COLOR) != 0][(A) & ATTR_LEVEL][AGE(T)]
 
-/* convert "struct point *" to X and Y */
-#define X(P) (((P) - points) % xpixels)
-#define Y(P) (((P) - points) / xpixels)
+/* newly drawn pixels (plane offsets), painted by paint_batch() */
+#ifndef BATCH_SIZE
+#define BATCH_SIZE 4096
+#endif
+static size_t batch[BATCH_SIZE];
+static int nbatch;
 
 static int initialized = 0;
 
@@ -389,36 +406,90 @@ display_lp_radius(int r)
 }
 
 /*
- * from display_age and display_point
- * since all points age at the same rate,
- * only adds points at end of list.
+ * paint the pixels drawn since the last batch.
+ * returns true if anything on screen changed.
  */
-static void
-queue_point(struct point *p)
+static int
+paint_batch(void)
 {
-    int d;
-
-    d = refresh_interval - queue_interval;
-    queue_interval += d;
-    /* queue_interval should now be == refresh_interval */
+    int i, changed = 0;
 
-#ifdef PARANOIA
-    if (p->ttl == 0 || p->ttl > MAXTTL)
-    printf("queuing %d,%d level %d!\n", X(p), Y(p), p->level);
-    if (d > DELAY_T_MAX)
-    printf("queuing %d,%d delay %d!\n", X(p), Y(p), d);
-    if (queue_interval > DELAY_T_MAX)
-    printf("queue_interval (%d) > DELAY_T_MAX (%d)\n",
-           (int)queue_interval, DELAY_T_MAX);
-#endif /* PARANOIA defined */
+    for (i = 0; i < nbatch; i++) {
+        size_t p = batch[i];
 
-    p->next = head;
-    p->prev = head->prev;
-
-    head->prev->next = p;
-    head->prev = p;
+        /* may have been painted (or replaced) by aging since */
+        if (attrs[p] & ATTR_FRESH) {
+            attrs[p] &= ~ATTR_FRESH;
+            ws_display_point(X(p), Y(p), COLOR(attrs[p], ttls[p]));
+            changed = 1;
+            }
+        }
+    nbatch = 0;
+    return changed;
+}
 
-    p->delay = d;
+/*
+ * age every lit pixel by one tick, and paint those reaching a new level.
+ *
+ * Works on a word of pixels at a time: for each byte of v which is
+ * nonzero, "on" gets a one in that byte's low bit, so v - on is a
+ * decrement of every lit pixel with no borrows between bytes.  A lit
+ * pixel can only change color when its new tick count is a multiple of
+ * AGE_STEPS; "turn" gets the high bit of each of those bytes, and only
+ * they are looked at one by one.
+ *
+ * returns true if anything on screen changed.
+ */
+static int
+age_pixels(void)
+{
+    const word_t ones = ~(word_t)0 / 0xff;  /* 0x01 in every byte */
+    const word_t low7 = ones * 0x7f;
+    const word_t high = ones * 0x80;
+    const word_t step = ones * (AGE_STEPS-1);
+    size_t words = row_bytes / sizeof(word_t);
+    int changed = 0;
+    int y;
+
+    for (y = 0; y < ypixels; y++) {
+        word_t *wp, lit;
+        size_t w;
+
+        if (!row_lit[y])
+            continue;
+        wp = ttl_words + y * words;
+        lit = 0;
+        for (w = 0; w < words; w++) {
+            unsigned char mask[sizeof(word_t)];
+            word_t v = wp[w], on, edge, turn;
+            size_t i, p;
+            int x;
+
+            if (v == 0)
+                continue;
+            on = ((((v & low7) + low7) | v) & high) >> 7;
+            wp[w] = v - on;
+            lit |= v - on;
+
+            edge = (v - on) & step;
+            turn = ~(((edge & low7) + low7) | edge) & (on << 7);
+            if (!turn)
+                continue;
+
+            /* repaint pixels whose color changed, in memory order */
+            memcpy(mask, &turn, sizeof(mask));
+            x = (int)(w * sizeof(word_t));
+            p = P(x, y);
+            for (i = 0; i < sizeof(mask); i++, p++, x++)
+                if (mask[i] && AGE(ttls[p]+1) != AGE(ttls[p])) {
+                    attrs[p] &= ~ATTR_FRESH;
+                    ws_display_point(x, y, COLOR(attrs[p], ttls[p]));
+                    changed = 1;
+                    }
+            }
+        row_lit[y] = lit != 0;
+        }
+    return changed;
 }
 
 /*
@@ -587,70 +658,49 @@ int
 display_age(int t,          /* simulated us since last call */
         int slowdown)       /* slowdown to simulated speed */
 {
-    struct point *p;
-    static int elapsed = 0;
+    static long elapsed = 0;
+    long tick;
     int changed;
 
     if (!initialized && !display_init(DISPLAY_TYPE, PIX_SCALE))
         return 0;
 
-    display_delay(t, slowdown);
-
     changed = 0;
 
     elapsed += t;
-    if (elapsed < DELAY_UNIT)
-        return 0;
-
-    t = elapsed / DELAY_UNIT;
-    elapsed %= DELAY_UNIT;
-
-    while ((p = head->next) != head) {
-        int x, y;
-
-        /* look at oldest entry */
-        if (p->delay > t) {         /* further than our reach? */
-            p->delay -= t;          /* update head */
-            queue_interval -= t;    /* update span */
-            break;                  /* quit */
-            }
-
-        x = X(p);
-        y = Y(p);
-#ifdef PARANOIA
-        if (p->ttl == 0)
-            printf("BUG: age %d,%d ttl zero\n", x, y);
-#endif /* PARANOIA defined */
-
-        /* dequeue point */
-        p->prev->next = p->next;
-        p->next->prev = p->prev;
-
-        t -= p->delay;              /* lessen our reach */
-        queue_interval -= p->delay; /* update queue span */
+    tick = (long)refresh_interval * DELAY_UNIT / AGE_STEPS;
+    if (tick < 1)
+        tick = 1;
+    if (elapsed >= tick) {
+        long n = elapsed / tick;
+
+        elapsed %= tick;
+        if (n > MAXTICK)            /* everything is dark by then */
+            n = MAXTICK;
+        while (n-- > 0)
+            changed |= age_pixels();
+        }
 
-        ws_display_point(x, y, colors[p->color][p->level][--p->ttl]);
-        changed = 1;
+    changed |= paint_batch();
 
-        /* queue it back up, unless we just turned it off! */
-        if (p->ttl > 0)
-            queue_point(p);
-        }
+    display_delay(t, slowdown);
     return changed;
 } /* display_age */
 
 /* here from window system */
 void
 display_repaint(void) {
-    struct point *p;
+    size_t p;
     int x, y;
+
+    paint_batch();
     /*
      * bottom to top, left to right.
      */
-    for (p = points, y = 0; y < ypixels; y++)
-        for (x = 0; x < xpixels; p++, x++)
-            if (p->ttl)
-                ws_display_point(x, y, colors[p->color][p->level][p->ttl-1]);
+    for (y = 0; y < ypixels; y++)
+        for (p = P(0,y), x = 0; x < xpixels; p++, x++)
+            if (ttls[p])
+                ws_display_point(x, y, COLOR(attrs[p], ttls[p]));
     ws_sync();
 }
 
@@ -661,36 +711,28 @@ intensify(int x,            /* 0..xpixels */
       int level,            /* 0..MAXLEVEL */
       int color)            /* for VR20! 0 or 1 */
 {
-    struct point *p;
-    int bleed;
+    size_t p;
+    int attr, bleed;
 
     if (x < 0 || x >= xpixels || y < 0 || y >= ypixels)
         return 0;           /* limit to display */
 
     p = P(x,y);
-    if (p->ttl) {           /* currently lit? */
+    attr = attrs[p];
+    color &= 1;
 #ifdef LOUD
+    if (ttls[p])            /* currently lit? */
         printf("%d,%d old level %d ttl %d new %d\r\n",
-               x, y, p->level, p->ttl, level);
+               x, y, attr & ATTR_LEVEL, TTL(ttls[p]), level);
 #endif /* LOUD defined */
 
-        /* unlink from delta queue */
-        p->prev->next = p->next;
-
-        if (p->next == head)
-            queue_interval -= p->delay;
-        else
-            p->next->delay += p->delay;
-        p->next->prev = p->prev;
-        }
-
     bleed = 0;              /* no bleeding for now */
 
     /* EXP: doesn't work... yet */
     /* if "recently" drawn, same or brighter, same color, make even brighter */
-    if (p->ttl >= MAXTTL*2/3 && 
-        level >= p->level && 
-        p->color == color &&
+    if (TTL(ttls[p]) >= MAXTTL*2/3 &&
+        level >= (attr & ATTR_LEVEL) &&
+        ((attr & ATTR_COLOR) != 0) == color &&
         level < MAXLEVEL)
         level++;
 
@@ -698,14 +740,27 @@ intensify(int x,            /* 0..xpixels */
      * this allows a dim beam to suck light out of
      * a recently drawn bright spot!!
      */
-    if (p->ttl != MAXTTL || p->level != level || p->color != color) {
-        p->ttl = MAXTTL;
-        p->level = level;
-        p->color = color;   /* save color even if monochrome */
-        ws_display_point(x, y, colors[p->color][p->level][p->ttl-1]);
+    if (ttls[p] != MAXTICK || (attr & ATTR_LEVEL) != level ||
+        ((attr & ATTR_COLOR) != 0) != color) {
+        /* save color even if monochrome */
+        int nattr = level | (color ? ATTR_COLOR : 0);
+
+        /* repaint unless only the time left changed, within a level */
+        if (AGE(ttls[p]) != AGE(MAXTICK) ||
+            (attr & ~ATTR_FRESH) != nattr) {
+            if (!(attr & ATTR_FRESH)) { /* not already waiting in batch */
+                if (nbatch == BATCH_SIZE)
+                    paint_batch();
+                batch[nbatch++] = p;
+                }
+            nattr |= ATTR_FRESH;
+            }
+        else
+            nattr |= attr & ATTR_FRESH;
+        ttls[p] = MAXTICK;
+        attrs[p] = nattr;
+        row_lit[y] = 1;
         }
-
-    queue_point(p);         /* put at end of list */
     return bleed;
 }
 
@@ -851,9 +906,6 @@ display_init(enum display_type type, int sf)
         goto failed;
         }
 
-    /* Initialize display list */
-    head->next = head->prev = head;
-
     display_type = type;
     scale = sf;
 
@@ -900,14 +952,6 @@ display_init(enum display_type type, int sf)
         refresh_interval = 1;
         }
 
-    /* point lifetime in DELAY_UNITs will not fit in p->delay field! */
-    if (refresh_interval > DELAY_T_MAX) {
-        /* increase DELAY_UNIT? */
-        fprintf(stderr, "bad refresh_interval %d > DELAY_T_MAX %d\r\n",
-            refresh_interval, DELAY_T_MAX);
-        goto failed;
-        }
-
     /*
      * before phosphor_init;
      * set up relative brightness of display intensity levels
@@ -919,10 +963,15 @@ display_init(enum display_type type, int sf)
     for (i = 0; i < NLEVELS; i++)
         level_scale[i] = ((float)i+1+BOOST)/(NLEVELS+BOOST);
 
-    points = (struct point *)calloc((size_t)xpixels,
-                    ypixels * sizeof(struct point));
-    if (!points)
+    /* planes; rows padded to whole words, the padding is never lit */
+    row_bytes = ((size_t)xpixels + sizeof(word_t) - 1) / sizeof(word_t);
+    ttl_words = (word_t *)calloc(row_bytes, ypixels * sizeof(word_t));
+    row_bytes *= sizeof(word_t);
+    attrs = (unsigned char *)calloc(row_bytes, ypixels);
+    row_lit = (unsigned char *)calloc((size_t)ypixels, 1);
+    if (!ttl_words || !attrs || !row_lit)
         goto failed;
+    ttls = (unsigned char *)ttl_words;
 
     if (!ws_init(dp->name, xpixels, ypixels, ncolors))
         goto failed;
@@ -950,6 +999,7 @@ display_reset(void)
 void
 display_sync(void)
 {
+    paint_batch();
     ws_sync();
 }
 
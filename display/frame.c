@@ -0,0 +1,401 @@
+/*
+ * frame.c - write rendered frames to PNG files or a raw video stream
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the names of the authors shall
+ * not be used in advertising or otherwise to promote the sale, use or
+ * other dealings in this Software without prior written authorization
+ * from the authors.
+ */
+
+/*
+ * See frame.h for how the output is selected.
+ *
+ * PNG images are 8 bit RGB, unfiltered.  With zlib (HAVE_ZLIB) the
+ * image data is deflated at the fastest level; without it the data is
+ * written as stored (uncompressed) deflate blocks, which any PNG
+ * reader accepts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "frame.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/time.h>
+#endif
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifndef FRAME_MS
+#define FRAME_MS 100                    /* default interval between frames */
+#endif
+
+#define STORED_MAX 65535                /* largest stored deflate block */
+
+enum frame_kind {
+    FRAME_SEQUENCE,                     /* numbered PNG files */
+    FRAME_LATEST,                       /* one PNG file, rewritten */
+    FRAME_RAW                           /* raw RGB stream */
+};
+
+struct frame_out {
+    enum frame_kind kind;
+    char *name;                         /* output name (or pattern) */
+    char *path;                         /* scratch for file names */
+    FILE *stream;                       /* FRAME_RAW output */
+    int width, height;
+    unsigned long interval;             /* ms between frames */
+    unsigned long last;                 /* time of last frame */
+    unsigned long count;                /* frames written */
+    int failed;                         /* stop after an error */
+    unsigned char *image;               /* PNG scanlines, or one raw row */
+    size_t isize;
+    unsigned char *zdata;               /* zlib stream */
+    size_t zsize;
+};
+
+/* wall clock in milliseconds */
+static unsigned long
+frame_msec(void)
+{
+#ifdef _WIN32
+    return (unsigned long)GetTickCount();
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (unsigned long)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+#endif
+}
+
+/*
+ * true if name holds exactly one "%d" conversion (optionally with a
+ * zero flag and a width of at most two digits) and no other '%',
+ * so it is safe to hand to sprintf
+ */
+static int
+frame_pattern(const char *name)
+{
+    const char *p = strchr(name, '%');
+    int digits = 0;
+
+    if (p == NULL)
+        return 0;
+    for (p++; isdigit((unsigned char)*p); p++)
+        digits++;
+    return digits <= 2 && *p == 'd' && strchr(p, '%') == NULL;
+}
+
+static int
+frame_suffix(const char *name, const char *sfx)
+{
+    size_t n = strlen(name), s = strlen(sfx);
+    size_t i;
+
+    if (n < s)
+        return 0;
+    for (i = 0; i < s; i++)
+        if (tolower((unsigned char)name[n - s + i]) != sfx[i])
+            return 0;
+    return 1;
+}
+
+struct frame_out *
+frame_open(int width, int height)
+{
+    struct frame_out *fo;
+    const char *name = getenv("SIMH_FRAMES");
+    const char *ms = getenv("SIMH_FRAME_MS");
+    size_t rows;
+
+    if (name == NULL || *name == '\0' || width <= 0 || height <= 0)
+        return NULL;
+    fo = (struct frame_out *)calloc(1, sizeof(*fo));
+    if (fo == NULL)
+        return NULL;
+    fo->width = width;
+    fo->height = height;
+    fo->interval = (ms && *ms) ? strtoul(ms, NULL, 10) : FRAME_MS;
+    fo->name = (char *)malloc(strlen(name) + 1);
+    fo->path = (char *)malloc(strlen(name) + 32);
+    if (fo->name == NULL || fo->path == NULL)
+        goto failed;
+    strcpy(fo->name, name);
+
+    rows = (size_t)height * (1 + 3 * (size_t)width);
+    if (frame_pattern(name))
+        fo->kind = FRAME_SEQUENCE;
+    else if (frame_suffix(name, ".png"))
+        fo->kind = FRAME_LATEST;
+    else {
+        fo->kind = FRAME_RAW;
+        rows = 3 * (size_t)width;
+        fo->stream = fopen(name, "wb");
+        if (fo->stream == NULL) {
+            fprintf(stderr, "frames: can't create %s\r\n", name);
+            goto failed;
+        }
+    }
+    fo->isize = rows;
+    fo->image = (unsigned char *)malloc(rows);
+    if (fo->image == NULL)
+        goto failed;
+    if (fo->kind != FRAME_RAW) {
+        /* stored blocks cost 5 bytes each, plus the zlib header/trailer */
+        fo->zsize = rows + 5 * (rows / STORED_MAX + 1) + 6;
+#ifdef HAVE_ZLIB
+        if (compressBound((uLong)rows) > fo->zsize)
+            fo->zsize = compressBound((uLong)rows);
+#endif
+        fo->zdata = (unsigned char *)malloc(fo->zsize);
+        if (fo->zdata == NULL)
+            goto failed;
+    }
+    return fo;
+
+ failed:
+    frame_close(fo);
+    return NULL;
+}
+
+int
+frame_due(struct frame_out *fo, int refresh)
+{
+    if (fo == NULL || fo->failed)
+        return 0;
+    if (fo->interval == 0)
+        return refresh;
+    return fo->count == 0 || frame_msec() - fo->last >= fo->interval;
+}
+
+/*
+ * PNG encoding
+ */
+
+static unsigned long crc_table[256];
+
+static unsigned long
+png_crc(unsigned long crc, const unsigned char *p, size_t n)
+{
+    if (crc_table[1] == 0) {
+        unsigned long c;
+        int i, k;
+
+        for (i = 0; i < 256; i++) {
+            c = (unsigned long)i;
+            for (k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+            crc_table[i] = c;
+        }
+    }
+    crc ^= 0xffffffffUL;
+    while (n--)
+        crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffffUL;
+}
+
+static void
+put_be32(unsigned char *p, unsigned long v)
+{
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+static int
+png_chunk(FILE *f, const char *type, const unsigned char *data, size_t n)
+{
+    unsigned char b[8];
+    unsigned long crc;
+
+    put_be32(b, (unsigned long)n);
+    memcpy(b + 4, type, 4);
+    crc = png_crc(0, b + 4, 4);
+    crc = png_crc(crc, data, n);
+    if (fwrite(b, 1, 8, f) != 8 || (n && fwrite(data, 1, n, f) != n))
+        return 0;
+    put_be32(b, crc);
+    return fwrite(b, 1, 4, f) == 4;
+}
+
+/* zlib stream of the scanlines in fo->image; returns its length */
+static size_t
+png_deflate(struct frame_out *fo)
+{
+#ifdef HAVE_ZLIB
+    uLongf zlen = (uLongf)fo->zsize;
+
+    if (compress2(fo->zdata, &zlen, fo->image, (uLong)fo->isize,
+                  Z_BEST_SPEED) != Z_OK)
+        return 0;
+    return (size_t)zlen;
+#else
+    unsigned char *z = fo->zdata;
+    const unsigned char *p = fo->image;
+    size_t left = fo->isize;
+    unsigned long s1 = 1, s2 = 0;       /* Adler-32 */
+    size_t i;
+
+    *z++ = 0x78;                        /* deflate, 32K window */
+    *z++ = 0x01;                        /* no dictionary, fastest */
+    do {
+        size_t n = left > STORED_MAX ? STORED_MAX : left;
+
+        left -= n;
+        *z++ = left == 0;               /* BFINAL, BTYPE=00 (stored) */
+        *z++ = (unsigned char)n;
+        *z++ = (unsigned char)(n >> 8);
+        *z++ = (unsigned char)~n;
+        *z++ = (unsigned char)(~n >> 8);
+        memcpy(z, p, n);
+        for (i = 0; i < n; i++) {
+            s1 += p[i];
+            if (s1 >= 65521)
+                s1 -= 65521;
+            s2 += s1;
+            if (s2 >= 65521)
+                s2 -= 65521;
+        }
+        z += n;
+        p += n;
+    } while (left);
+    put_be32(z, (s2 << 16) | s1);
+    z += 4;
+    return (size_t)(z - fo->zdata);
+#endif
+}
+
+static int
+png_write(struct frame_out *fo, const char *path)
+{
+    static const unsigned char sig[8] = {
+        0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+    };
+    unsigned char ihdr[13];
+    size_t zlen;
+    FILE *f;
+    int ok;
+
+    zlen = png_deflate(fo);
+    if (zlen == 0)
+        return 0;
+    put_be32(ihdr, (unsigned long)fo->width);
+    put_be32(ihdr + 4, (unsigned long)fo->height);
+    ihdr[8] = 8;                        /* bit depth */
+    ihdr[9] = 2;                        /* truecolor */
+    ihdr[10] = ihdr[11] = ihdr[12] = 0; /* deflate, no filter, progressive */
+
+    f = fopen(path, "wb");
+    if (f == NULL)
+        return 0;
+    ok = fwrite(sig, 1, sizeof(sig), f) == sizeof(sig) &&
+        png_chunk(f, "IHDR", ihdr, sizeof(ihdr)) &&
+        png_chunk(f, "IDAT", fo->zdata, zlen) &&
+        png_chunk(f, "IEND", NULL, 0);
+    if (fclose(f) != 0)
+        ok = 0;
+    return ok;
+}
+
+static void
+frame_rgb(unsigned char *d, const unsigned int *s, int n)
+{
+    while (n--) {
+        unsigned int v = *s++;
+
+        *d++ = (unsigned char)(v >> 16);
+        *d++ = (unsigned char)(v >> 8);
+        *d++ = (unsigned char)v;
+    }
+}
+
+int
+frame_write(struct frame_out *fo, const unsigned int *pixels, int pitch)
+{
+    int y, ok = 1;
+
+    if (fo == NULL || fo->failed)
+        return 0;
+    fo->last = frame_msec();
+    if (fo->kind == FRAME_RAW) {
+        size_t n = 3 * (size_t)fo->width;
+
+        for (y = 0; y < fo->height && ok; y++, pixels += pitch) {
+            frame_rgb(fo->image, pixels, fo->width);
+            ok = fwrite(fo->image, 1, n, fo->stream) == n;
+        }
+        if (ok)
+            ok = fflush(fo->stream) == 0;
+    }
+    else {
+        unsigned char *row = fo->image;
+
+        for (y = 0; y < fo->height; y++, pixels += pitch) {
+            *row++ = 0;                 /* filter type None */
+            frame_rgb(row, pixels, fo->width);
+            row += 3 * fo->width;
+        }
+        if (fo->kind == FRAME_SEQUENCE) {
+            sprintf(fo->path, fo->name, (int)fo->count);
+            ok = png_write(fo, fo->path);
+        }
+        else {
+            /* write beside and rename, so readers never see half a frame */
+            sprintf(fo->path, "%s.tmp", fo->name);
+            ok = png_write(fo, fo->path);
+#ifdef _WIN32
+            if (ok)
+                remove(fo->name);
+#endif
+            if (ok)
+                ok = rename(fo->path, fo->name) == 0;
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "frames: error writing %s\r\n",
+                fo->kind == FRAME_RAW ? fo->name : fo->path);
+        fo->failed = 1;
+        return 0;
+    }
+    fo->count++;
+    return 1;
+}
+
+void
+frame_close(struct frame_out *fo)
+{
+    if (fo == NULL)
+        return;
+    if (fo->stream)
+        fclose(fo->stream);
+    free(fo->zdata);
+    free(fo->image);
+    free(fo->path);
+    free(fo->name);
+    free(fo);
+}
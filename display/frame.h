@@ -0,0 +1,63 @@
+/*
+ * frame.h - write rendered frames to PNG files or a raw video stream
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the names of the authors shall
+ * not be used in advertising or otherwise to promote the sale, use or
+ * other dealings in this Software without prior written authorization
+ * from the authors.
+ */
+
+/*
+ * Used by the offscreen (headless) renderers, offscreen.c and the
+ * sim_video.c fallback, which draw into memory instead of a window.
+ *
+ * The output is named by the SIMH_FRAMES environment variable:
+ *
+ *      frame%05d.png   one PNG file per frame, numbered from 0
+ *      screen.png      a PNG file rewritten with the latest frame
+ *      video.rgb       anything else: a raw stream of 24 bit RGB frames,
+ *                      top row first (ffmpeg -f rawvideo -pix_fmt rgb24)
+ *
+ * SIMH_FRAME_MS is the minimum wall clock interval between frames in
+ * milliseconds (default 100).  0 writes a frame at every explicit
+ * refresh (display_sync, vid_refresh) and none while merely polling.
+ * Both can be set from a simulator command file with SET ENVIRONMENT,
+ * where the % of a frame number must be written \% (frame\%05d.png).
+ *
+ * Pixels are 32 bit words holding 0xXXRRGGBB; the top byte is ignored.
+ */
+
+struct frame_out;
+
+/* open the SIMH_FRAMES output; NULL if none is configured (or on error) */
+extern struct frame_out *frame_open(int width, int height);
+
+/*
+ * true if the frame interval has passed since the last frame written;
+ * refresh is true at an explicit refresh, false when polling
+ */
+extern int frame_due(struct frame_out *, int refresh);
+
+/* write a frame; pitch is in pixels.  returns false on error */
+extern int frame_write(struct frame_out *, const unsigned int *pixels,
+                       int pitch);
+
+/* finish the output and release it */
+extern void frame_close(struct frame_out *);
@@ -0,0 +1,187 @@
+/*
+ * offscreen.c - headless display driver
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the names of the authors shall
+ * not be used in advertising or otherwise to promote the sale, use or
+ * other dealings in this Software without prior written authorization
+ * from the authors.
+ */
+
+/*
+ * Draws into an RGB image in memory instead of a window, for running
+ * graphical guests on machines without a display.  Frames are written
+ * out as PNG files or a raw video stream as described in frame.h; with
+ * no SIMH_FRAMES output configured the image is simply kept up to date.
+ *
+ * There is no keyboard or light pen input, and ws_poll never sleeps:
+ * the simulation runs as fast as the host allows.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ws.h"
+#include "frame.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/time.h>
+#endif
+
+/*
+ * light pen location
+ * see ws.h for full description
+ */
+int ws_lp_x = -1;
+int ws_lp_y = -1;
+
+static unsigned int *image;             /* xpixels by ypixels, top row first */
+static int xpixels, ypixels;
+static struct frame_out *frames;        /* NULL if not writing frames */
+
+static unsigned int black = 0x000000;
+static unsigned int white = 0xffffff;
+
+/* write the final image, so the output always ends with the last frame */
+static void
+ws_exit(void)
+{
+    if (frames) {
+        frame_write(frames, image, xpixels);
+        frame_close(frames);
+        frames = NULL;
+    }
+}
+
+int
+ws_init(char *crtname,          /* crt type name (not used) */
+    int xp, int yp,             /* screen size in pixels */
+    int colors)                 /* colors to support (not used) */
+{
+    xpixels = xp;               /* save screen size */
+    ypixels = yp;
+
+    image = (unsigned int *)calloc((size_t)xp * yp, sizeof(*image));
+    if (image == NULL)
+        return 0;
+    frames = frame_open(xp, yp);
+    if (frames)
+        atexit(ws_exit);
+    return 1;
+} /* ws_init */
+
+void *
+ws_color_black(void)
+{
+    return &black;
+}
+
+void *
+ws_color_white(void)
+{
+    return &white;
+}
+
+/* colors are allocated once, by phosphor_init */
+void *
+ws_color_rgb(int r, int g, int b)
+{
+    unsigned int *color = (unsigned int *)malloc(sizeof(*color));
+
+    if (color)
+        *color = ((r >> 8) << 16) | ((g >> 8) << 8) | (b >> 8);
+    return color;
+}
+
+/* put a point on the screen */
+void
+ws_display_point(int x, int y, void *color)
+{
+    if (x < 0 || x >= xpixels || y < 0 || y >= ypixels)
+        return;
+
+    y = ypixels - y - 1;                /* top row first */
+
+    image[y * xpixels + x] = color ? *(unsigned int *)color : black;
+}
+
+void
+ws_sync(void)
+{
+    if (frame_due(frames, 1))
+        frame_write(frames, image, xpixels);
+}
+
+/* called periodically */
+int
+ws_poll(int *valp, int maxusec)
+{
+    /* nothing to wait for; just see if a frame is due */
+    if (frame_due(frames, 0))
+        frame_write(frames, image, xpixels);
+    return 1;
+}
+
+/* utility: can be called from main program
+ * which is willing to cede control
+ */
+int
+ws_loop(void (*func)(void *), void *arg)
+{
+    int val = 0;
+
+    while (ws_poll(&val,0))
+        (*func)(arg);
+    return val;
+}
+
+void
+ws_beep(void)
+{
+}
+
+/*
+ * elapsed wall clock time since last call
+ * +INF on first call
+ */
+
+unsigned long
+os_elapsed(void)
+{
+    static int new;
+    static unsigned long t[2];          /* microseconds */
+    unsigned long ret;
+#ifdef _WIN32
+    t[new] = (unsigned long)GetTickCount() * 1000;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    t[new] = (unsigned long)tv.tv_sec * 1000000 + tv.tv_usec;
+#endif
+    if (t[!new] == 0)
+        ret = ~0L;                      /* +INF */
+    else
+        ret = t[new] - t[!new];
+    new = !new;
+    return ret;
+}
@@ -0,0 +1,233 @@
+/*
+ * rbench.c - display render benchmark
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * Except as contained in this notice, the names of the authors shall
+ * not be used in advertising or otherwise to promote the sale, use or
+ * other dealings in this Software without prior written authorization
+ * from the authors.
+ */
+
+/*
+ * Measures the host cost of rendering a frame through display.c with
+ * the offscreen driver (offscreen.c):
+ *
+ *      rbench [-n frames] workload [dir]
+ *      rbench -l                       list the workloads
+ *
+ * A frame is 20ms of simulated time on a Type 30 (the PDP-1 display),
+ * plotting RB_POINTS points and aging the phosphor as it goes.
+ *
+ *      munch   munching squares: scattered points, each plotted once
+ *      refresh a display list redrawn every frame (the Spacewar! case)
+ *      png     refresh, writing every frame as a PNG file into dir
+ *      raw     refresh, writing every frame to a raw video stream in dir
+ *
+ * The result is one line for bench/bench.sh:
+ *
+ *      frames=... host_ns=... ns_per_frame=... fps=...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/time.h>
+#endif
+
+#include "display.h"
+
+#ifndef EXIT_FAILURE
+/* SunOS4 <stdlib.h> doesn't define this */
+#define EXIT_FAILURE 1
+#endif
+
+#define RB_FRAMES 200                   /* default frames to render */
+#define RB_FRAME_US 20000               /* simulated us per frame (50Hz) */
+#define RB_POINTS 4000                  /* points plotted per frame */
+#define RB_AGE 100                      /* points between display_age calls */
+
+static unsigned long rb_switches = 04000UL;
+
+/* called from display code: */
+unsigned long
+cpu_get_switches(void) {
+    return rb_switches;
+}
+
+/* called from display code: */
+void
+cpu_set_switches(unsigned long bits) {
+    rb_switches = bits;
+}
+
+/* host wall clock in ns */
+static double
+rb_now(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER f, c;
+
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart * 1e9 / (double)f.QuadPart;
+#else
+    struct timeval tv;
+
+    gettimeofday(&tv, NULL);
+    return (double)tv.tv_sec * 1e9 + (double)tv.tv_usec * 1e3;
+#endif
+}
+
+/* one munching squares step, as in test.c */
+static void
+munch(void) {
+    static long io = 0, v = 0;
+    long ac;
+    int x, y;
+
+    ac = rb_switches;
+    ac += v;
+    if (ac & ~0777777) {
+      ac++;
+      ac &= 0777777;
+    }
+    v = ac;
+
+    ac <<= 9;
+    io <<= 9;
+    io |= ac>>18;
+    ac &= 0777777;
+    ac |= io>>18;
+    io &= 0777777;
+
+    ac ^= v;
+
+    y = (io >> 8) & 01777;
+    if (y & 01000)
+        y ^= 01000;
+    else
+        y += 511;
+
+    x = (ac >> 8) & 01777;
+    if (x & 01000)
+        x ^= 01000;
+    else
+        x += 511;
+
+    display_point(x, y, DISPLAY_INT_MAX, 0);
+}
+
+/* display list: a Lissajous figure that changes shape from frame to frame */
+static short list_x[RB_POINTS], list_y[RB_POINTS];
+
+static void
+list_init(void)
+{
+    int i;
+
+    for (i = 0; i < RB_POINTS; i++) {
+        double t = 2 * 3.14159265358979 * i / RB_POINTS;
+
+        list_x[i] = (short)(511 + 400 * sin(3 * t));
+        list_y[i] = (short)(511 + 400 * sin(4 * t));
+    }
+}
+
+static void
+refresh(int frame, int i)
+{
+    int j = (i + frame * 7) % RB_POINTS;
+
+    display_point(list_x[j], list_y[i], i % (DISPLAY_INT_MAX + 1), 0);
+}
+
+int
+main(int argc, char **argv) {
+    static char env[2][1024];
+    int nframes = RB_FRAMES;
+    int list, frame, i;
+    const char *workload, *dir = ".";
+    double start, ns;
+
+    while (argc > 1 && argv[1][0] == '-') {
+        if (strcmp(argv[1], "-l") == 0) {
+            printf("munch\nrefresh\npng\nraw\n");
+            return 0;
+        }
+        if (strcmp(argv[1], "-n") == 0 && argc > 2) {
+            nframes = atoi(argv[2]);
+            argc--, argv++;
+        }
+        else
+            break;
+        argc--, argv++;
+    }
+    if (argc < 2 || argc > 3 || nframes <= 0) {
+        fprintf(stderr, "usage: rbench [-l] [-n frames] workload [dir]\n");
+        exit(EXIT_FAILURE);
+    }
+    workload = argv[1];
+    if (argc > 2)
+        dir = argv[2];
+
+    list = 1;
+    if (strcmp(workload, "munch") == 0)
+        list = 0;
+    else if (strcmp(workload, "png") == 0)
+        sprintf(env[0], "SIMH_FRAMES=%.990s/frame%%05d.png", dir);
+    else if (strcmp(workload, "raw") == 0)
+        sprintf(env[0], "SIMH_FRAMES=%.990s/video.rgb", dir);
+    else if (strcmp(workload, "refresh") != 0) {
+        fprintf(stderr, "rbench: unknown workload %s\n", workload);
+        exit(EXIT_FAILURE);
+    }
+    if (env[0][0]) {
+        strcpy(env[1], "SIMH_FRAME_MS=0");
+        putenv(env[0]);
+        putenv(env[1]);
+    }
+
+    if (!display_init(DIS_TYPE30, RES_HALF))
+        exit(EXIT_FAILURE);
+    list_init();
+
+    start = rb_now();
+    for (frame = 0; frame < nframes; frame++) {
+        for (i = 0; i < RB_POINTS; i++) {
+            if (list)
+                refresh(frame, i);
+            else
+                munch();
+            if (i % RB_AGE == RB_AGE - 1)
+                display_age(RB_FRAME_US / (RB_POINTS / RB_AGE), 0);
+        }
+        display_sync();
+    }
+    ns = rb_now() - start;
+
+    printf("frames=%d host_ns=%.0f ns_per_frame=%.0f fps=%.1f\n",
+           nframes, ns, ns / nframes, nframes * 1e9 / ns);
+    return 0;
+}
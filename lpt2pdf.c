@@ -39,7 +39,7 @@
  * assumptions are made about the structure to simplify this code.
  */
 
-#define LPT2PDF_VERSION "1.0-006"
+#define LPT2PDF_VERSION "1.0-007"
 #define VERSION_REQUIRED "1."
 
 #include <ctype.h>
@@ -75,6 +75,10 @@ typedef __int16 int_least16_t;
 #endif
 #endif
 
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
 #define PDF_BUILD_
 #include "lpt2pdf.h"
 
@@ -567,6 +571,10 @@ typedef struct {
     char *formfile;         /* File containing form image */
     double barh;            /* Height of form bar */
     unsigned int lpp;       /* Lines per page (requested) */
+    unsigned int compress;  /* Page data compression */
+#define PDF_COMPRESS_FLATE (0)/* Flate (deflate) */
+#define PDF_COMPRESS_LZW   (1)/* LZW */
+#define PDF_COMPRESS_NONE  (2)/* None */
 } SETP;
 
 typedef struct {
@@ -661,6 +669,7 @@ typedef struct {
     size_t lzwsize;         /* Allocated size */
     size_t lzwused;         /* Bytes used */
 #define LZWBUF &pdf->lzwbuf, &pdf->lzwsize, &pdf->lzwused
+    struct flate *flate;    /* Flate encoding context */
 } PDF;
 
 #define QS(str) (str), (sizeof (str) -1)
@@ -698,6 +707,7 @@ static const PDF defaults = {
         NULL,                    /* formfile */
         0.500,                   /* barh */
         0,                       /* lines per page (requested) */
+        PDF_COMPRESS_FLATE,      /* compress */
     },
     { CHS_ASCII, CHS_ASCII, CHS_LATIN_1, CHS_LATIN_1 }, /* G0-G3 */
     CHS_ASCII, CHS_LATIN_1,      /* GL, GR */
@@ -744,7 +754,7 @@ static void barform (PDF *pdf);
 static void imageform (PDF *pdf);
 static int jpeg_image (PDF *pdf, IMG *img);
 static int png_image (PDF *pdf, IMG *img);
-static uint32_t crc32 (uint32_t initial, const uint8_t *string, uint32_t length);
+static uint32_t png_crc32 (uint32_t initial, const uint8_t *string, uint32_t length);
 static unsigned int addobj (PDF *pdf);
 static unsigned int getref (PDF *pdf, char *buf, const char *name);
 static unsigned int getint (PDF *pdf, char *buf, const char *name, const char **end);
@@ -831,7 +841,110 @@ static void lzw_flushbits (t_lzw *lzw);
 
 /* *** End LZW *** */
 
+/* Flate encoding
+ */
+
+#ifdef HAVE_ZLIB
+
+#define FLATE_ZBUF     (16384)            /* zlib output chunk */
+
+typedef struct flate {
+    FILE         *fh;                     /* File handle for output */
+    uint8_t      **outbuf;                /* Buffer for output */
+    size_t       *outsize;                /* Size of output buffer */
+    size_t       *outused;                /* Data in output buffer */
+    unsigned long count;                  /* Bytes output */
+    int           active;                 /* zs needs deflateEnd */
+    z_stream      zs;                     /* zlib deflate state */
+    uint8_t       zbuf[FLATE_ZBUF];       /* Output chunk */
+} t_flate;
+
+#else
+
+/* These constants are in the deflate spec (RFC 1951) and can not be changed.
+ */
+
+#define FLATE_WSIZE    (32768)            /* Window (maximum distance) */
+#define FLATE_WMASK    (FLATE_WSIZE -1)
+#define FLATE_MINMATCH (3)                /* Shortest match */
+#define FLATE_MAXMATCH (258)              /* Longest match */
+#define FLATE_LCODES   (286)              /* Literal/length codes */
+#define FLATE_DCODES   (30)               /* Distance codes */
+#define FLATE_BLCODES  (19)               /* Code length codes */
+#define FLATE_MAXBITS  (15)               /* Longest literal/length/distance code */
+#define FLATE_MAXBLBITS (7)               /* Longest code length code */
+
+/* These are tuning parameters.
+ */
+
+#define FLATE_HSIZE    (1 << 15)          /* Hash table size */
+#define FLATE_LOOKAHEAD (FLATE_MAXMATCH + FLATE_MINMATCH +1) /* Input held back for matching */
+#define FLATE_MAXDIST  (FLATE_WSIZE - FLATE_LOOKAHEAD) /* Furthest match considered */
+#define FLATE_CHAIN    (16)               /* Hash chain entries searched */
+#define FLATE_NICE     (128)              /* Match length that ends the search */
+#define FLATE_INSERT   (16)               /* Longest match whose strings are hashed */
+#define FLATE_SYMS     (16384)            /* Symbols per block */
+
+typedef struct flate {
+    FILE         *fh;                     /* File handle for output */
+    uint8_t      **outbuf;                /* Buffer for output */
+    size_t       *outsize;                /* Size of output buffer */
+    size_t       *outused;                /* Data in output buffer */
+    unsigned long count;                  /* Bytes output */
+    uint32_t      bitbuf;                 /* Bit packing buffer */
+    unsigned int  nbits;                  /* Number of bits pending in buffer */
+    uint32_t      adler;                  /* Adler-32 of input */
+    unsigned int  strstart;               /* Window position of next input to match */
+    unsigned int  lookahead;              /* Input in window not yet matched */
+    unsigned int  blkstart;               /* Window position of current block */
+    unsigned int  nsyms;                  /* Symbols buffered for current block */
+    uint16_t      head[FLATE_HSIZE];      /* Most recent position of each hash */
+    uint16_t      prev[FLATE_WSIZE];      /* Previous position with same hash */
+    uint8_t       window[2 * FLATE_WSIZE];/* Input data */
+    uint16_t      symll[FLATE_SYMS];      /* Literal, or match length -3 */
+    uint16_t      symdist[FLATE_SYMS];    /* Match distance, 0 for literal */
+    uint32_t      lfreq[FLATE_LCODES];    /* Literal/length code frequencies */
+    uint32_t      dfreq[FLATE_DCODES];    /* Distance code frequencies */
+} t_flate;
+
+#endif
+
+static void flate_init (t_flate *fl, int mode, ...);
+#define FLATE_FILE     (1)
+#define FLATE_BUFFER   (2)
+#define FLATE_BUFALCQ (4096)
+#define FLATE_CHUNK   (4096)              /* Page data accumulated before encoding */
+
+static void flate_encode (t_flate *fl, const char *stream, size_t len);
+static void flate_finish (t_flate *fl);
+#ifdef HAVE_ZLIB
+static void flate_end (t_flate *fl);
+static void flate_deflate (t_flate *fl, int flush);
+static void flate_write (t_flate *fl, const uint8_t *p, size_t len);
+#else
+#define flate_end(fl) ((void)0)
+static void flate_process (t_flate *fl, int flush);
+static void flate_slide (t_flate *fl);
+static void flate_block (t_flate *fl, int last);
+static unsigned int flate_lcode (unsigned int len);
+static unsigned int flate_dcode (unsigned int dist);
+static void flate_lengths (const uint32_t *freq, unsigned int n, unsigned int maxbits, uint8_t *len);
+static void flate_codes (const uint8_t *len, unsigned int n, uint16_t *code);
+static uint32_t flate_adler (uint32_t adler, const uint8_t *p, size_t len);
+static void flate_writebits (t_flate *fl, unsigned int bits, unsigned int nbits);
+static void flate_writebyte (t_flate *fl, unsigned int c);
+#endif
+
+/* *** End Flate *** */
+
 static int encstm (PDF *pdf, char *stream, size_t len);
+static t_flate *getflate (PDF *pdf);
+
+/* Page content is written to the file as it is rendered when using Flate.
+ * Each page then has two objects: the stream and its length.
+ */
+#define PAGE_STREAMED(pdf) ((pdf)->p.compress == PDF_COMPRESS_FLATE && \
+                            !((pdf)->flags & PDF_UNCOMPRESSED))
 
 
 #if defined (PDF_MAIN) || defined (FONT_IMPORT)
@@ -854,6 +967,7 @@ static const ARG argtable [] = {
     SET (bar,     BAR_HEIGHT,     NUMBER,  0.500in,     (Specifies the height of the bar on forms.))
     SET (bottom,  BOTTOM_MARGIN,  NUMBER,  0.500in,     (Specifies the height of the bottom margin in inches.  Below this there is no bar.))
     SET (columns, COLS,           INTEGER, 132,         (Specifies the number of columns to be printed.  Used to center output))
+    SET (compression, COMPRESSION, STRING, flate,       (Specifies how page data is compressed.\nFLATE is the most compact.\nLZW is readable by very old PDF viewers.\nNONE leaves the page data as text.))
     SET (cpi,     CPI,            NUMBER,  10,          (Specifies the characters per inch (horizontal pitch).  Fractional pitch is supported.))
     SET (font,    TEXT_FONT,      STRING,  Courier,     (Specifies the name of the font to use for rendering the input data.  Accepted are:%F))
     SET (form,    FORM_TYPE,      STRING,  greenbar,    (Specifies the form background to be applied. One of:%fPlain is white page.))
@@ -2086,6 +2200,20 @@ static int pdfset (PDF *pdf, int arg, va_list ap) {
         }
         return PDF_OK;
 
+    case PDF_COMPRESSION:
+        svalue = va_arg (ap, const char *);
+        REJECT_NULL
+        if (!xstrcasecmp (svalue, "FLATE")) {
+            pdf->p.compress = PDF_COMPRESS_FLATE;
+        } else if (!xstrcasecmp (svalue, "LZW")) {
+            pdf->p.compress = PDF_COMPRESS_LZW;
+        } else if (!xstrcasecmp (svalue, "NONE")) {
+            pdf->p.compress = PDF_COMPRESS_NONE;
+        } else {
+            return E(BAD_SET);
+        }
+        return PDF_OK;
+
     case PDF_FORM_TYPE:
         svalue = va_arg (ap, const char *);
         REJECT_NULL
@@ -2695,7 +2823,9 @@ static void wrhdr (PDF *pdf) {
 
 /* Write out data stream for current page.
  *
- * This is actually buffered in memory with formatting to enable compression.
+ * With Flate, the data is compressed and written as it is rendered; the
+ * length follows the stream in a separate object.  Otherwise, it is
+ * buffered in memory to enable compression and to determine the length.
  *
  * Updates page and line numbers.
  */
@@ -2705,6 +2835,7 @@ static void wrpage (PDF *pdf) {
         xp( ((pdf->p.wid - (pdf->p.margin *2)) - (pdf->p.cols/pdf->p.cpi))/2 );
 
     unsigned int obj, l;
+    t_flate *fl = NULL;
 
     pdf->pbused = 0;
 
@@ -2718,7 +2849,16 @@ static void wrpage (PDF *pdf) {
 
     /* Graphics are precomputed, so simply add the content */
 
-    wrstm (pdf, PAGEBUF, pdf->formbuf, pdf->formlen);
+    if (PAGE_STREAMED (pdf)) {
+        fl = getflate (pdf);
+        fprintf (pdf->pdf, "%u 0 obj\n"
+                 "<< /Length %u 0 R /Filter /FlateDecode >>\n"
+                 "stream\n", obj, obj +1);
+        flate_init (fl, FLATE_FILE, pdf->pdf);
+        flate_encode (fl, pdf->formbuf, pdf->formlen);
+    } else {
+        wrstm (pdf, PAGEBUF, pdf->formbuf, pdf->formlen);
+    }
 
     /* Text */
 
@@ -2794,6 +2934,10 @@ static void wrpage (PDF *pdf) {
         } else {
             wrstm (pdf, PAGEBUF, QS(" T*"));
         }
+        if (fl && pdf->pbused >= FLATE_CHUNK) {
+            flate_encode (fl, pdf->pagebuf, pdf->pbused);
+            pdf->pbused = 0;
+        }
     }
     wrstm (pdf, PAGEBUF, QS(" ET Q"));
 
@@ -2837,24 +2981,38 @@ static void wrpage (PDF *pdf) {
     }
 
     /* The rendering data is ready for the file.
-     *  Unless forbidden, see if it's compressible.
+     *  If streaming, finish the stream and write its length.
+     *  Otherwise, unless forbidden, see if it's compressible.
      *  Write the PDF stream accordingly.
      */
-    if ((pdf->flags & PDF_UNCOMPRESSED) || encstm (pdf, pdf->pagebuf, pdf->pbused)) {
+    if (fl) {
+        flate_encode (fl, pdf->pagebuf, pdf->pbused);
+        flate_finish (fl);
+        fputs ("\nendstream\n"
+                    "endobj\n"
+               "\n", pdf->pdf);
+        (void) addobj (pdf);
         fprintf (pdf->pdf, "%u 0 obj\n"
-                 "<< /Length %d >>\n"
-                 "stream\n", obj, (int)pdf->pbused);
-        fwrite (pdf->pagebuf, pdf->pbused, 1, pdf->pdf);
+                 "%lu\n"
+                 "endobj\n"
+                 "\n", obj +1, fl->count);
     } else {
-        fprintf (pdf->pdf, "%u 0 obj\n"
-                 "  << /Length %d /DL %d /Filter /LZWDecode"
-                 " /DecodeParms << /EarlyChange 0 >> >>\n"
-                 "stream\n", obj, (int)pdf->lzwused, (int)pdf->pbused);
-        fwrite (pdf->lzwbuf, pdf->lzwused, 1, pdf->pdf);
+        if ((pdf->flags & PDF_UNCOMPRESSED) || encstm (pdf, pdf->pagebuf, pdf->pbused)) {
+            fprintf (pdf->pdf, "%u 0 obj\n"
+                     "<< /Length %d >>\n"
+                     "stream\n", obj, (int)pdf->pbused);
+            fwrite (pdf->pagebuf, pdf->pbused, 1, pdf->pdf);
+        } else {
+            fprintf (pdf->pdf, "%u 0 obj\n"
+                     "  << /Length %d /DL %d /Filter /LZWDecode"
+                     " /DecodeParms << /EarlyChange 0 >> >>\n"
+                     "stream\n", obj, (int)pdf->lzwused, (int)pdf->pbused);
+            fwrite (pdf->lzwbuf, pdf->lzwused, 1, pdf->pdf);
+        }
+        fputs ("\nendstream\n"
+                    "endobj\n"
+               "\n", pdf->pdf);
     }
-    fputs ("\nendstream\n"
-                "endobj\n"
-           "\n", pdf->pdf);
 
     if (ferror (pdf->pdf)) {
         pdf->errnum = E(IO_ERROR);
@@ -3089,9 +3247,13 @@ static void imageform (PDF *pdf) {
         fprintf (pdf->pdf, " >>\nstream\n");
         fwrite (img.imgbuf, img.ibused, 1, pdf->pdf);
     } else {
-        fprintf (pdf->pdf, " /Length %d /DL %d /Filter [ /LZWDecode %s ]\n"
-                 " /DecodeParms [ << /EarlyChange 0 >> %s ]",
-                 (int)pdf->lzwused, (int)img.ibused, img.filter,
+        int lzw = (pdf->p.compress == PDF_COMPRESS_LZW);
+
+        fprintf (pdf->pdf, " /Length %d /DL %d /Filter [ %s %s ]\n"
+                 " /DecodeParms [ %s %s ]",
+                 (int)pdf->lzwused, (int)img.ibused,
+                 (lzw? "/LZWDecode": "/FlateDecode"), img.filter,
+                 (lzw? "<< /EarlyChange 0 >>": "null"),
                  (img.filterpars? img.filterpars: "null"));
         fprintf (pdf->pdf, " >>\nstream\n");
         fwrite (pdf->lzwbuf, pdf->lzwused, 1, pdf->pdf);
@@ -3261,7 +3423,7 @@ static int png_image (PDF *pdf, IMG *img) {
             if (fread (buf+8, len+4, 1, fh) != 1) {/* IHDR + CRC */
                 return E(BAD_PNG);
             }
-            if (crc32 (PNG_CRC, buf+4, 4+len) != ~PNGINT (buf+8+len)) {
+            if (png_crc32 (PNG_CRC, buf+4, 4+len) != ~PNGINT (buf+8+len)) {
                 return E(BAD_PNG);
             }
             img->width = PNGINT (buf+8+0);      /* pixels */
@@ -3290,7 +3452,7 @@ static int png_image (PDF *pdf, IMG *img) {
             if (fread (buf+8, 4, 1, fh) != 1) { /* Get CRC */
                 return E(BAD_PNG);
             }
-            if (crc32 (crc32 (PNG_CRC, buf+4, 4), 
+            if (png_crc32 (png_crc32 (PNG_CRC, buf+4, 4), 
                        (uint8_t *)palette, len) != ~PNGINT (buf+8)) {
                 return E(BAD_PNG);
             }
@@ -3304,7 +3466,7 @@ static int png_image (PDF *pdf, IMG *img) {
             if (fread (buf+8, len+4, 1, fh) != 1) {
                 return E(BAD_PNG);
             }
-            if (crc32 (PNG_CRC, buf+4, 4+len) != ~PNGINT (buf+8+len)) {
+            if (png_crc32 (PNG_CRC, buf+4, 4+len) != ~PNGINT (buf+8+len)) {
                 return E(BAD_PNG);
             }
             xppu = PNGINT(buf+8+0);             /* Pixels/unit (x) */
@@ -3359,7 +3521,7 @@ static int png_image (PDF *pdf, IMG *img) {
             if (fread (chdr+8, 4, 1, fh) != 1) {
                 return E(BAD_PNG);
             }
-            crc = crc32 (PNG_CRC, chdr+4, 4);
+            crc = png_crc32 (PNG_CRC, chdr+4, 4);
             if (crc != ~PNGINT (chdr+8)) {
                 return E(BAD_PNG);
             }
@@ -3369,13 +3531,13 @@ static int png_image (PDF *pdf, IMG *img) {
             fseek (fh, len+4, SEEK_CUR);
             continue;
         }
-        crc = crc32 (PNG_CRC, chdr+4, 4);
+        crc = png_crc32 (PNG_CRC, chdr+4, 4);
         while (len) {
             if (len > img->bufsize) {
                 if (fread (buf, img->bufsize, 1, fh) != 1) {
                     return E(BAD_PNG);
                 }
-                crc = crc32 (crc, buf, img->bufsize);
+                crc = png_crc32 (crc, buf, img->bufsize);
                 wrstm (pdf, &img->imgbuf, &img->ibsize, &img->ibused,
                        (char *) buf, img->bufsize);
                 len -= img->bufsize;
@@ -3383,7 +3545,7 @@ static int png_image (PDF *pdf, IMG *img) {
                 if (fread (buf, len, 1, fh) != 1) {
                     return E(BAD_PNG);
                 }
-                crc = crc32 (crc, buf, len);
+                crc = png_crc32 (crc, buf, len);
                 if (fread (chdr+8, 4, 1, fh) != 1) {
                     return E(BAD_PNG);
                 }
@@ -3479,7 +3641,7 @@ static int png_image (PDF *pdf, IMG *img) {
 #undef PNGINT
 }
 
-static uint32_t crc32 (uint32_t initial, const uint8_t *string, uint32_t length) {
+static uint32_t png_crc32 (uint32_t initial, const uint8_t *string, uint32_t length) {
     static const uint32_t crctab[16] = {
         0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
         0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
@@ -3632,7 +3794,7 @@ static int pdfclose (PDF *pdf, int checkpoint) {
         }
         fprintf (pdf->pdf, " /MediaBox [0 0 %f %f] /Contents %u 0 R >>\n"
                  "endobj\n\n", pdf->p.wid * PT, pdf->p.len * PT,
-                 pdf->pbase + p );
+                 pdf->pbase + (p * (PAGE_STREAMED (pdf)? 2: 1)) );
     }
 
      /* anchor pagelist for this session */
@@ -3830,6 +3992,10 @@ static void pdf_free (PDF *pdf) {
     free (pdf->parsebuf);
     free (pdf->pagebuf);
     free (pdf->lzwbuf);
+    if (pdf->flate) {
+        flate_end (pdf->flate);
+    }
+    free (pdf->flate);
 
     pdf->key[0] = '\0';
 
@@ -4538,21 +4704,36 @@ static int xstrcasecmp (const char *s1, const char *s2) {
     return tolower (*s1) - tolower (*s2);
 }
 
-/* Encode a stream, currently LZW.
- * A reasonable trade-off - deflate is better compression, but much more
- * expensive to compute.  Tests show LZW compressing LPT output 5:1.
+/* Encode a stream into lzwbuf, using the selected compression.
+ * Flate compresses LPT output about twice as well as LZW, and is
+ * faster.  LZW is retained for very old PDF readers.
  *
  * If the compression fails (unlikely, but possible, with worst-case
- * expansion of 1.125 - 1.5), returns non-zero to cause the text to be
- * written instead.
+ * expansion of 1.125 - 1.5), or is not wanted, returns non-zero to
+ * cause the text to be written instead.
  */
 
 static int encstm (PDF *pdf, char *stream, size_t len) {
     t_lzw lzw;
+    t_flate *fl;
 
     pdf->lzwused = 0;
-    lzw_init (&lzw, LZW_BUFFER, LZWBUF);
-    lzw_encode (&lzw, stream, len);
+    switch (pdf->p.compress) {
+    case PDF_COMPRESS_FLATE:
+        fl = getflate (pdf);
+        flate_init (fl, FLATE_BUFFER, LZWBUF);
+        flate_encode (fl, stream, len);
+        flate_finish (fl);
+        break;
+
+    case PDF_COMPRESS_LZW:
+        lzw_init (&lzw, LZW_BUFFER, LZWBUF);
+        lzw_encode (&lzw, stream, len);
+        break;
+
+    default:
+        return 1;
+    }
 
 #ifdef ERRDEBUG
     return 1;
@@ -4560,6 +4741,20 @@ static int encstm (PDF *pdf, char *stream, size_t len) {
     return pdf->lzwused >= len;
 }
 
+/* Obtain the Flate context, allocating it on first use.
+ * It's large, and not needed when other compression is selected.
+ */
+
+static t_flate *getflate (PDF *pdf) {
+    if (!pdf->flate) {
+        pdf->flate = (t_flate *) calloc (1, sizeof (t_flate));
+        if (!pdf->flate) {
+            ABORT (errno);
+        }
+    }
+    return pdf->flate;
+}
+
 /* *********************** LZW *********************** */
 
 /* Initialze LZW encoding context
@@ -4725,6 +4920,697 @@ static void lzw_flushbits (t_lzw *lzw) {
     }
 }
 
+/* *********************** Flate *********************** */
+
+/* Flate (zlib format, deflate compressed) encoding.
+ *
+ * With zlib (HAVE_ZLIB), its deflate does the compression.  Otherwise,
+ * as when lpt2pdf is built stand-alone without zlib, the encoder here
+ * is used: LZ77 matching with hash chains over a 32K window, and a
+ * Huffman code built for each block.  Blocks are written with whichever
+ * of the dynamic code, the fixed code or no compression is smallest.
+ *
+ * Input can be supplied in any number of pieces; output is written
+ * as it is produced, so memory use does not depend on the amount
+ * of data.
+ */
+
+#ifndef HAVE_ZLIB
+
+static const uint16_t flate_lbase[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t flate_lextra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t flate_dbase[FLATE_DCODES] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+static const uint8_t flate_dextra[FLATE_DCODES] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+/* Order in which code length code lengths are sent */
+static const uint8_t flate_blorder[FLATE_BLCODES] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+#define FLATE_HASH(p) (((((unsigned int)(p)[0]) << 10) ^ \
+                        (((unsigned int)(p)[1]) << 5) ^ (p)[2]) & (FLATE_HSIZE -1))
+#endif
+
+/* Initialize Flate encoding context and write the zlib header.
+ */
+
+static void flate_init (t_flate *fl, int mode, ...) {
+    va_list ap;
+
+    fl->fh = NULL;
+    fl->outbuf = NULL;
+    va_start (ap, mode);
+    if (mode == FLATE_FILE) {
+        fl->fh = va_arg (ap, FILE *);
+    } else {
+        fl->outbuf = va_arg (ap, uint8_t **);
+        fl->outsize = va_arg (ap, size_t *);
+        fl->outused = va_arg (ap, size_t *);
+    }
+    va_end (ap);
+
+    fl->count = 0;
+#ifdef HAVE_ZLIB
+    flate_end (fl);
+    memset (&fl->zs, 0, sizeof (fl->zs));
+    if (deflateInit (&fl->zs, Z_DEFAULT_COMPRESSION) != Z_OK) {
+        exit (ENOMEM);
+    }
+    fl->active = 1;
+#else
+    fl->bitbuf = 0;
+    fl->nbits = 0;
+    fl->adler = 1;
+    fl->strstart =
+        fl->lookahead =
+        fl->blkstart =
+        fl->nsyms = 0;
+    memset (fl->head, 0, sizeof (fl->head));
+    memset (fl->lfreq, 0, sizeof (fl->lfreq));
+    memset (fl->dfreq, 0, sizeof (fl->dfreq));
+
+    /* Deflate, 32K window, default level; check bits make 0x789C % 31 == 0 */
+    flate_writebits (fl, 0x78, 8);
+    flate_writebits (fl, 0x9C, 8);
+#endif
+
+    return;
+}
+
+#ifdef HAVE_ZLIB
+
+/* Encode a buffer; may be called any number of times before flate_finish.
+ */
+
+static void flate_encode (t_flate *fl, const char *stream, size_t len) {
+    while (len) {
+        uInt n = (len > FLATE_ZBUF)? FLATE_ZBUF: (uInt)len;
+
+        fl->zs.next_in = (Bytef *)stream;
+        fl->zs.avail_in = n;
+        flate_deflate (fl, Z_NO_FLUSH);
+        stream += n;
+        len -= n;
+    }
+
+    return;
+}
+
+/* Compress all pending data and write the zlib trailer.
+ */
+
+static void flate_finish (t_flate *fl) {
+    fl->zs.next_in = NULL;
+    fl->zs.avail_in = 0;
+    flate_deflate (fl, Z_FINISH);
+    flate_end (fl);
+
+    return;
+}
+
+/* Release zlib's state, if a stream was started and not finished.
+ */
+
+static void flate_end (t_flate *fl) {
+    if (fl->active) {
+        deflateEnd (&fl->zs);
+        fl->active = 0;
+    }
+
+    return;
+}
+
+/* Run deflate until it has taken all the input, or with Z_FINISH, until
+ * the stream is complete, writing its output as each chunk fills.
+ */
+
+static void flate_deflate (t_flate *fl, int flush) {
+    do {
+        fl->zs.next_out = fl->zbuf;
+        fl->zs.avail_out = FLATE_ZBUF;
+        (void) deflate (&fl->zs, flush);
+        flate_write (fl, fl->zbuf, FLATE_ZBUF - fl->zs.avail_out);
+    } while (fl->zs.avail_out == 0);
+
+    return;
+}
+
+/* Write compressed data to the output file or buffer.
+ */
+
+static void flate_write (t_flate *fl, const uint8_t *p, size_t len) {
+    fl->count += (unsigned long)len;
+
+    if (fl->fh) {
+        fwrite (p, 1, len, fl->fh);
+        return;
+    }
+    if (*fl->outused + len > *fl->outsize) {
+        size_t size = *fl->outsize + ((len > FLATE_BUFALCQ)? len: FLATE_BUFALCQ);
+        uint8_t *np;
+
+        np = (uint8_t *) realloc (*fl->outbuf, size);
+        if (!np) {
+            exit (errno);
+        }
+        *fl->outbuf = np;
+        *fl->outsize = size;
+    }
+    memcpy (*fl->outbuf + *fl->outused, p, len);
+    *fl->outused += len;
+}
+
+#else
+
+/* Encode a buffer; may be called any number of times before flate_finish.
+ */
+
+static void flate_encode (t_flate *fl, const char *stream, size_t len) {
+    while (len) {
+        unsigned int end = fl->strstart + fl->lookahead;
+        size_t n;
+
+        if (end == 2 * FLATE_WSIZE) {
+            flate_slide (fl);
+            end -= FLATE_WSIZE;
+        }
+        n = (2 * FLATE_WSIZE) - end;
+        if (n > len) {
+            n = len;
+        }
+        memcpy (fl->window + end, stream, n);
+        fl->adler = flate_adler (fl->adler, fl->window + end, n);
+        fl->lookahead += (unsigned int)n;
+        stream += n;
+        len -= n;
+
+        flate_process (fl, 0);
+    }
+
+    return;
+}
+
+/* Compress all pending data, write the last block and the zlib trailer.
+ */
+
+static void flate_finish (t_flate *fl) {
+    flate_process (fl, 1);
+    flate_block (fl, 1);
+    if (fl->nbits) {
+        flate_writebits (fl, 0, 8 - fl->nbits);
+    }
+    flate_writebyte (fl, (fl->adler >> 24) & 0xFF);
+    flate_writebyte (fl, (fl->adler >> 16) & 0xFF);
+    flate_writebyte (fl, (fl->adler >>  8) & 0xFF);
+    flate_writebyte (fl, fl->adler & 0xFF);
+
+    return;
+}
+
+/* Find matches for the data in the window, and buffer the resulting symbols.
+ * Unless flushing, stops when a maximum length match might not fit in the
+ * remaining data.
+ */
+
+static void flate_process (t_flate *fl, int flush) {
+    while (fl->lookahead >= FLATE_LOOKAHEAD || (flush && fl->lookahead)) {
+        unsigned int s = fl->strstart;
+        unsigned int best = FLATE_MINMATCH -1, dist = 0;
+
+        if (fl->lookahead >= FLATE_MINMATCH) {
+            unsigned int h = FLATE_HASH (fl->window + s);
+            unsigned int cand = fl->head[h];
+            unsigned int limit = (s > FLATE_MAXDIST)? s - FLATE_MAXDIST: 0;
+            unsigned int max = (fl->lookahead < FLATE_MAXMATCH)? fl->lookahead: FLATE_MAXMATCH;
+            unsigned int chain = FLATE_CHAIN;
+            const uint8_t *q = fl->window + s;
+
+            fl->prev[s & FLATE_WMASK] = (uint16_t)cand;
+            fl->head[h] = (uint16_t)s;
+
+            /* Position 0 doubles as the end of the chain */
+            while (cand > limit && chain--) {
+                const uint8_t *p = fl->window + cand;
+
+                if (p[best] == q[best] && p[0] == q[0] && p[1] == q[1]) {
+                    unsigned int l = 2;
+
+                    while (l < max && p[l] == q[l]) {
+                        l++;
+                    }
+                    if (l > best) {
+                        best = l;
+                        dist = s - cand;
+                        if (l >= FLATE_NICE || l == max) {
+                            break;
+                        }
+                    }
+                }
+                cand = fl->prev[cand & FLATE_WMASK];
+            }
+        }
+
+        if (dist) {
+            unsigned int i;
+
+            fl->symll[fl->nsyms] = (uint16_t)(best - FLATE_MINMATCH);
+            fl->symdist[fl->nsyms++] = (uint16_t)dist;
+            fl->lfreq[257 + flate_lcode (best)]++;
+            fl->dfreq[flate_dcode (dist)]++;
+
+            /* Hash the strings inside short matches too.  Long matches
+             * are mostly repeats of data that is already in the table.
+             */
+            if (best <= FLATE_INSERT) {
+                for (i = 1; i < best && fl->lookahead - i >= FLATE_MINMATCH; i++) {
+                    unsigned int h = FLATE_HASH (fl->window + s + i);
+
+                    fl->prev[(s + i) & FLATE_WMASK] = fl->head[h];
+                    fl->head[h] = (uint16_t)(s + i);
+                }
+            }
+            fl->strstart += best;
+            fl->lookahead -= best;
+        } else {
+            fl->symll[fl->nsyms] = fl->window[s];
+            fl->symdist[fl->nsyms++] = 0;
+            fl->lfreq[fl->window[s]]++;
+            fl->strstart++;
+            fl->lookahead--;
+        }
+        if (fl->nsyms == FLATE_SYMS) {
+            flate_block (fl, 0);
+        }
+    }
+
+    return;
+}
+
+/* Slide the window down by FLATE_WSIZE to make room for more input.
+ * The current block is written first, as its data would no longer
+ * be available if it was to be stored uncompressed.
+ */
+
+static void flate_slide (t_flate *fl) {
+    unsigned int i;
+
+    if (fl->nsyms) {
+        flate_block (fl, 0);
+    }
+    memmove (fl->window, fl->window + FLATE_WSIZE, FLATE_WSIZE);
+    fl->strstart -= FLATE_WSIZE;
+    fl->blkstart -= FLATE_WSIZE;
+
+    for (i = 0; i < FLATE_HSIZE; i++) {
+        fl->head[i] = (fl->head[i] >= FLATE_WSIZE)? fl->head[i] - FLATE_WSIZE: 0;
+    }
+    for (i = 0; i < FLATE_WSIZE; i++) {
+        fl->prev[i] = (fl->prev[i] >= FLATE_WSIZE)? fl->prev[i] - FLATE_WSIZE: 0;
+    }
+
+    return;
+}
+
+/* Write the buffered symbols as a block.
+ */
+
+static void flate_block (t_flate *fl, int last) {
+    uint8_t  llen[FLATE_LCODES +2], dlen[FLATE_DCODES +2], bllen[FLATE_BLCODES];
+    uint16_t lcode[FLATE_LCODES +2], dcode[FLATE_DCODES +2], blcode[FLATE_BLCODES];
+    uint8_t  rle[FLATE_LCODES + FLATE_DCODES], rlex[FLATE_LCODES + FLATE_DCODES];
+    uint32_t blfreq[FLATE_BLCODES];
+    unsigned long dyn, fix, raw, xbits;
+    unsigned int nl, nd, nbl, nrle, i, n;
+    unsigned int stored = fl->strstart - fl->blkstart;
+
+    fl->lfreq[256]++;                               /* End of block */
+
+    /* Dynamic code: trees and run-length encoded code lengths */
+
+    flate_lengths (fl->lfreq, FLATE_LCODES, FLATE_MAXBITS, llen);
+    flate_lengths (fl->dfreq, FLATE_DCODES, FLATE_MAXBITS, dlen);
+    for (nl = FLATE_LCODES; nl > 257 && !llen[nl -1]; nl--)
+        ;
+    for (nd = FLATE_DCODES; nd > 1 && !dlen[nd -1]; nd--)
+        ;
+
+    memset (blfreq, 0, sizeof (blfreq));
+    for (i = 0, nrle = 0; i < nl + nd; i += n) {
+        unsigned int l = (i < nl)? llen[i]: dlen[i - nl];
+
+        for (n = 1; i + n < nl + nd &&
+                 ((i + n < nl)? llen[i + n]: dlen[i + n - nl]) == l; n++)
+            ;
+        if (l == 0 && n >= 3) {
+            if (n > 138) {
+                n = 138;
+            }
+            rle[nrle] = (n >= 11)? 18: 17;
+            rlex[nrle++] = (uint8_t)(n - ((n >= 11)? 11: 3));
+        } else if (l != 0 && n >= 4) {
+            if (n > 7) {
+                n = 7;
+            }
+            rle[nrle] = (uint8_t)l;
+            rlex[nrle++] = 0;
+            rle[nrle] = 16;
+            rlex[nrle++] = (uint8_t)(n - 4);
+        } else {
+            n = 1;
+            rle[nrle] = (uint8_t)l;
+            rlex[nrle++] = 0;
+        }
+    }
+    for (i = 0; i < nrle; i++) {
+        blfreq[rle[i]]++;
+    }
+    flate_lengths (blfreq, FLATE_BLCODES, FLATE_MAXBLBITS, bllen);
+    for (nbl = FLATE_BLCODES; nbl > 4 && !bllen[flate_blorder[nbl -1]]; nbl--)
+        ;
+
+    /* Size of each alternative, in bits */
+
+    xbits = 0;
+    for (i = 0; i < 29; i++) {
+        xbits += fl->lfreq[257 + i] * flate_lextra[i];
+    }
+    for (i = 0; i < FLATE_DCODES; i++) {
+        xbits += fl->dfreq[i] * flate_dextra[i];
+    }
+
+    dyn = 3 + 5 + 5 + 4 + (3 * nbl) + xbits;
+    for (i = 0; i < nrle; i++) {
+        dyn += bllen[rle[i]] + ((rle[i] == 16)? 2: (rle[i] == 17)? 3: (rle[i] == 18)? 7: 0);
+    }
+    fix = 3 + xbits;
+    for (i = 0; i < FLATE_LCODES; i++) {
+        dyn += fl->lfreq[i] * llen[i];
+        fix += fl->lfreq[i] * ((i < 144)? 8: (i < 256)? 9: (i < 280)? 7: 8);
+    }
+    for (i = 0; i < FLATE_DCODES; i++) {
+        dyn += fl->dfreq[i] * dlen[i];
+        fix += fl->dfreq[i] * 5;
+    }
+    raw = 8 * ((unsigned long)stored + (5 * (1 + (stored / 65535)))) + 7;
+
+    if (raw < dyn && raw < fix) {
+        const uint8_t *p = fl->window + fl->blkstart;
+
+        do {
+            n = (stored > 65535)? 65535: stored;
+            stored -= n;
+            flate_writebits (fl, (last && !stored)? 1: 0, 1);
+            flate_writebits (fl, 0, 2);
+            if (fl->nbits) {
+                flate_writebits (fl, 0, 8 - fl->nbits);
+            }
+            flate_writebits (fl, n, 16);
+            flate_writebits (fl, ~n & 0xFFFF, 16);
+            while (n--) {
+                flate_writebyte (fl, *p++);
+            }
+        } while (stored);
+    } else {
+        if (fix <= dyn) {
+            for (i = 0; i < FLATE_LCODES +2; i++) {
+                llen[i] = (i < 144)? 8: (i < 256)? 9: (i < 280)? 7: 8;
+            }
+            for (i = 0; i < FLATE_DCODES +2; i++) {
+                dlen[i] = 5;
+            }
+            flate_codes (llen, FLATE_LCODES +2, lcode);
+            flate_codes (dlen, FLATE_DCODES +2, dcode);
+            flate_writebits (fl, last, 1);
+            flate_writebits (fl, 1, 2);
+        } else {
+            flate_codes (llen, FLATE_LCODES, lcode);
+            flate_codes (dlen, FLATE_DCODES, dcode);
+            flate_codes (bllen, FLATE_BLCODES, blcode);
+            flate_writebits (fl, last, 1);
+            flate_writebits (fl, 2, 2);
+            flate_writebits (fl, nl - 257, 5);
+            flate_writebits (fl, nd - 1, 5);
+            flate_writebits (fl, nbl - 4, 4);
+            for (i = 0; i < nbl; i++) {
+                flate_writebits (fl, bllen[flate_blorder[i]], 3);
+            }
+            for (i = 0; i < nrle; i++) {
+                flate_writebits (fl, blcode[rle[i]], bllen[rle[i]]);
+                if (rle[i] >= 16) {
+                    flate_writebits (fl, rlex[i], (rle[i] == 16)? 2: (rle[i] == 17)? 3: 7);
+                }
+            }
+        }
+
+        for (i = 0; i < fl->nsyms; i++) {
+            unsigned int v = fl->symll[i], d = fl->symdist[i], c;
+
+            if (!d) {
+                flate_writebits (fl, lcode[v], llen[v]);
+                continue;
+            }
+            c = flate_lcode (v + FLATE_MINMATCH);
+            flate_writebits (fl, lcode[257 + c], llen[257 + c]);
+            if (flate_lextra[c]) {
+                flate_writebits (fl, v + FLATE_MINMATCH - flate_lbase[c], flate_lextra[c]);
+            }
+            c = flate_dcode (d);
+            flate_writebits (fl, dcode[c], dlen[c]);
+            if (flate_dextra[c]) {
+                flate_writebits (fl, d - flate_dbase[c], flate_dextra[c]);
+            }
+        }
+        flate_writebits (fl, lcode[256], llen[256]);
+    }
+
+    memset (fl->lfreq, 0, sizeof (fl->lfreq));
+    memset (fl->dfreq, 0, sizeof (fl->dfreq));
+    fl->nsyms = 0;
+    fl->blkstart = fl->strstart;
+
+    return;
+}
+
+/* Length code (less 257) for a match length.
+ */
+
+static unsigned int flate_lcode (unsigned int len) {
+    unsigned int l = len - FLATE_MINMATCH, n = 2;
+
+    if (len == FLATE_MAXMATCH) {
+        return 28;
+    }
+    if (l < 8) {
+        return l;
+    }
+    while (l >> (n + 1)) {
+        n++;
+    }
+    return (4 * (n - 1)) + ((l >> (n - 2)) & 3);
+}
+
+/* Distance code for a match distance.
+ */
+
+static unsigned int flate_dcode (unsigned int dist) {
+    unsigned int d = dist - 1, n = 1;
+
+    if (d < 4) {
+        return d;
+    }
+    while (d >> (n + 1)) {
+        n++;
+    }
+    return (2 * n) + ((d >> (n - 1)) & 1);
+}
+
+/* Compute Huffman code lengths, limited to maxbits, from symbol frequencies.
+ * Unused symbols get length 0.  There are always at least two codes, as
+ * a decoder can't handle a tree with one leaf.
+ *
+ * The tree is built with two queues: leaves sorted by frequency, and
+ * internal nodes in order of creation (which is also their order of weight).
+ * If the tree is too deep, the frequencies are flattened and it is rebuilt.
+ */
+
+static void flate_lengths (const uint32_t *freq, unsigned int n, unsigned int maxbits, uint8_t *len) {
+    uint32_t f[FLATE_LCODES], w[2 * FLATE_LCODES];
+    uint16_t leaf[FLATE_LCODES], parent[2 * FLATE_LCODES];
+    uint8_t  depth[2 * FLATE_LCODES];
+    unsigned int i, j, nleaf, used;
+
+    for (i = 0, used = 0; i < n; i++) {
+        if ((f[i] = freq[i]) != 0) {
+            used++;
+        }
+    }
+    for (i = 0; used < 2 && i < n; i++) {
+        if (!f[i]) {
+            f[i] = 1;
+            used++;
+        }
+    }
+
+    for (;;) {
+        unsigned int li, ni, nnode, maxd;
+
+        for (i = 0, nleaf = 0; i < n; i++) {
+            if (!f[i]) {
+                continue;
+            }
+            for (j = nleaf; j > 0 && f[leaf[j -1]] > f[i]; j--) {
+                leaf[j] = leaf[j -1];
+            }
+            leaf[j] = (uint16_t)i;
+            nleaf++;
+        }
+        for (i = 0; i < nleaf; i++) {
+            w[i] = f[leaf[i]];
+        }
+
+        li = 0;
+        ni = nnode = nleaf;
+        while (nnode < (2 * nleaf) -1) {
+            unsigned int a, b;
+
+            a = (li < nleaf && (ni == nnode || w[li] <= w[ni]))? li++: ni++;
+            b = (li < nleaf && (ni == nnode || w[li] <= w[ni]))? li++: ni++;
+            w[nnode] = w[a] + w[b];
+            parent[a] = parent[b] = (uint16_t)nnode++;
+        }
+
+        depth[nnode -1] = 0;
+        maxd = 0;
+        for (i = nnode -1; i-- > 0; ) {
+            depth[i] = depth[parent[i]] + 1;
+            if (i < nleaf && depth[i] > maxd) {
+                maxd = depth[i];
+            }
+        }
+        if (maxd <= maxbits) {
+            break;
+        }
+        for (i = 0; i < n; i++) {
+            if (f[i]) {
+                f[i] = (f[i] >> 1) | 1;
+            }
+        }
+    }
+
+    memset (len, 0, n);
+    for (i = 0; i < nleaf; i++) {
+        len[leaf[i]] = depth[i];
+    }
+
+    return;
+}
+
+/* Assign canonical codes for a set of code lengths.
+ * Codes are bit-reversed, as deflate sends them starting with the MSB
+ * but packs bits starting with the LSB.
+ */
+
+static void flate_codes (const uint8_t *len, unsigned int n, uint16_t *code) {
+    unsigned int count[FLATE_MAXBITS +1], next[FLATE_MAXBITS +1];
+    unsigned int i, b, c;
+
+    memset (count, 0, sizeof (count));
+    for (i = 0; i < n; i++) {
+        count[len[i]]++;
+    }
+    count[0] = 0;
+    for (b = 1, c = 0; b <= FLATE_MAXBITS; b++) {
+        c = (c + count[b -1]) << 1;
+        next[b] = c;
+    }
+    for (i = 0; i < n; i++) {
+        unsigned int v, r;
+
+        if (!len[i]) {
+            continue;
+        }
+        v = next[len[i]]++;
+        for (b = 0, r = 0; b < len[i]; b++) {
+            r = (r << 1) | (v & 1);
+            v >>= 1;
+        }
+        code[i] = (uint16_t)r;
+    }
+
+    return;
+}
+
+/* Adler-32 checksum of the uncompressed data (zlib trailer).
+ * 5552 is the most bytes that can be summed before b can overflow.
+ */
+
+static uint32_t flate_adler (uint32_t adler, const uint8_t *p, size_t len) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+
+    while (len) {
+        size_t n = (len < 5552)? len: 5552;
+
+        len -= n;
+        while (n--) {
+            a += *p++;
+            b += a;
+        }
+        a %= 65521;
+        b %= 65521;
+    }
+    return (b << 16) | a;
+}
+
+/* Pack and write a variable number of bits to the output file or buffer.
+ * Packing is little-endian.
+ * Bits that don't fill a byte are buffered.
+ */
+
+static void flate_writebits (t_flate *fl, unsigned int bits, unsigned int nbits) {
+    fl->bitbuf |= ((uint32_t)bits) << fl->nbits;
+    fl->nbits += nbits;
+
+    while (fl->nbits >= 8) {
+        flate_writebyte (fl, fl->bitbuf & 0xFF);
+        fl->bitbuf >>= 8;
+        fl->nbits -= 8;
+    }
+}
+
+/* Write a byte to the output file or buffer.
+ */
+
+static void flate_writebyte (t_flate *fl, unsigned int c) {
+    fl->count++;
+
+    if (fl->fh) {
+        putc (c, fl->fh);
+        return;
+    }
+    if (*fl->outused >= *fl->outsize) {
+        uint8_t *p;
+
+        p = (uint8_t *) realloc (*fl->outbuf, *fl->outsize + FLATE_BUFALCQ);
+        if (!p) {
+            exit (errno);
+        }
+        *fl->outbuf = p;
+        *fl->outsize += FLATE_BUFALCQ;
+    }
+    (*fl->outbuf)[*fl->outused] = (uint8_t)c;
+    ++*fl->outused;
+}
+
+#endif /* HAVE_ZLIB */
+
 /* *********************** SHA1 *********************** */
 /* SHA1 computation
  * Used to generate ID.
@@ -83,6 +83,10 @@
  *                                                Image can be used for logos, special forms.  It is 
  *                                                scaled to fit the width of the page, less margins.
  *                                                Aspect ratio is maintained. 
+ *       PDF_COMPRESSION       keyword FLATE      Compression of page data
+ *                                    "FLATE"      - Flate (deflate); most compact
+ *                                    "LZW"        - LZW; readable by very old PDF viewers
+ *                                    "NONE"       - Uncompressed text
  *
  *    Sanity checks for values are limited; you can produce unreasonable results with unreasonable input.
  *
@@ -202,6 +206,7 @@ int pdf_set (PDF_HANDLE pdf, int arg,...);
 #define PDF_FORM_IMAGE    (17)
 #define PDF_BAR_HEIGHT    (18)
 #define PDF_LPP           (19)
+#define PDF_COMPRESSION   (20)
 
 int pdf_print (PDF_HANDLE pdf, const char *string, size_t length);
 #define PDF_USE_STRLEN ((size_t)(~0u))
@@ -325,7 +325,8 @@ pthread_cond_t sim_tmxr_poll_cond  = PTHREAD_COND_INITIALIZER;
 int32 sim_tmxr_poll_count;
 pthread_t sim_asynch_main_threadid;
 UNIT * volatile sim_asynch_queue;
-UNIT * volatile sim_wallclock_queue;
+UNIT **sim_wallclock_heap;
+int32 sim_wallclock_count;
 UNIT * volatile sim_wallclock_entry;
 UNIT * volatile sim_clock_cosched_queue;
 t_bool sim_asynch_enabled = TRUE;
@@ -360,6 +361,8 @@ t_stat show_cmd_fi (FILE *ofile, int32 flag, char *cptr);
 t_stat show_config (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
 t_stat show_queue (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
 t_stat show_time (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
+t_stat show_runstats (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
+t_stat show_profile (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
 t_stat show_mod_names (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
 t_stat show_show_commands (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
 t_stat show_log_names (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
@@ -379,6 +382,9 @@ t_stat show_one_mod (FILE *st, DEVICE *dptr, UNIT *uptr, MTAB *mptr, char *cptr,
 t_stat sim_check_console (int32 sec);
 t_stat sim_save (FILE *sfile);
 t_stat sim_rest (FILE *rfile);
+static t_stat reset_deferred (t_bool all);
+static t_stat reset_pending (DEVICE *dptr);
+static void sim_startup_phase (const char *phase);
 
 /* Breakpoint package */
 
@@ -392,6 +398,7 @@ char *sim_brk_getact (char *buf, int32 size);
 void sim_brk_clract (void);
 void sim_brk_npc (uint32 cnt);
 BRKTAB *sim_brk_new (t_addr loc);
+static t_stat sim_brk_wbuild (void);
 
 /* Commands support routines */
 
@@ -444,6 +451,7 @@ t_stat set_asynch (int32 flag, char *cptr);
 t_stat do_cmd_label (int32 flag, char *cptr, char *label);
 void int_handler (int signal);
 t_stat set_prompt (int32 flag, char *cptr);
+t_stat set_profile (int32 flag, char *cptr);
 
 /* Global data */
 
@@ -469,6 +477,15 @@ int32 sim_brk_lnt = 0;
 int32 sim_brk_ins = 0;
 t_bool sim_brk_pend[SIM_BKPT_N_SPC] = { FALSE };
 t_addr sim_brk_ploc[SIM_BKPT_N_SPC] = { 0 };
+uint32 sim_brk_wtypes = 0;                              /* watchpoint types */
+uint32 sim_brk_wphys = 0;                               /* physical qualifier */
+uint32 sim_brk_wshift = 9;                              /* watch page size */
+uint32 sim_brk_wsumm = 0;                               /* watch types set */
+uint32 sim_brk_wpend = 0;                               /* watch hit types */
+t_addr sim_brk_wloc = 0;                                /* watch hit addr */
+t_bool sim_brk_wchg = FALSE;                            /* watch set changed */
+uint8 *sim_brk_wmap[2] = { NULL, NULL };                /* watched page maps */
+t_addr sim_brk_wmlnt[2] = { 0, 0 };                     /* map lengths (pages) */
 int32 sim_quiet = 0;
 int32 sim_step = 0;
 static double sim_time;
@@ -498,6 +515,41 @@ static char sim_do_filename[MAX_DO_NEST_LVL+1][CBUFSIZE];
 static char *sim_do_label[MAX_DO_NEST_LVL+1];
 
 static t_stat sim_last_cmd_stat;                        /* Command Status */
+static t_bool sim_reset_defer = FALSE;                  /* defer reset of disabled devices */
+
+#define SIM_STARTUP_MAX 16                              /* max startup phases */
+
+static t_bool sim_startup_stats = FALSE;                /* -startup-stats given */
+static t_uint64 sim_startup_begin;                      /* time main was entered */
+static t_uint64 sim_startup_mark;                       /* end of previous phase */
+static int32 sim_startup_count = 0;
+static const char *sim_startup_name[SIM_STARTUP_MAX];
+static t_uint64 sim_startup_ns[SIM_STARTUP_MAX];
+
+t_uint64 sim_events = 0;                                /* events processed */
+static double sim_run_inst[2];                          /* run stats, last, all */
+static t_uint64 sim_run_ns[2];
+static t_uint64 sim_run_idle_ns[2];
+static t_uint64 sim_run_events[2];
+static uint32 sim_run_count = 0;
+
+#define PROF_DFLT_INTVL 1000                            /* dflt sample interval */
+#define PROF_INIT_SIZE  4096                            /* initial hash size */
+#define PROF_GAP        16                              /* max gap within range */
+#define PROF_DFLT_SHOW  20                              /* dflt ranges shown */
+
+typedef struct {
+    t_addr              pc;                             /* guest PC */
+    uint32              ctx;                            /* mode switches */
+    uint32              count;                          /* samples, 0 = free */
+    } PROFENT;
+
+int32 sim_prof_count = 0x7FFFFFFF;                      /* insts to next sample */
+static int32 sim_prof_intvl = 0;                        /* sample interval, 0 = off */
+static PROFENT *sim_prof_tab = NULL;                    /* PC histogram */
+static uint32 sim_prof_size = 0;                        /* hash size, power of 2 */
+static uint32 sim_prof_used = 0;                        /* entries in use */
+static t_uint64 sim_prof_samples = 0;                   /* total samples */
 
 static SCHTAB sim_stab;
 
@@ -627,7 +679,11 @@ static CTAB cmd_table[] = {
     { "BOOT", &run_cmd, RU_BOOT,
       "b{oot} <unit>            bootstrap unit\n", &run_cmd_message },
     { "BREAK", &brk_cmd, SSH_ST,
-      "br{eak} <list>           set breakpoints\n" },
+      "br{eak} <list>           set breakpoints\n"
+      "br{eak} -r <list>        set read watchpoints (if supported)\n"
+      "br{eak} -w <list>        set write watchpoints (if supported)\n"
+      "br{eak} -m <list>        set modify watchpoints (if supported)\n"
+      "br{eak} -p -r|w|m <list> set physical address watchpoints (if supported)\n" },
     { "NOBREAK", &brk_cmd, SSH_CL,
       "nobr{eak} <list>         clear breakpoints\n" },
     { "ATTACH", &attach_cmd, 0,
@@ -662,6 +718,8 @@ static CTAB cmd_table[] = {
       "dir {dir}                list directory files\n" },
     { "LS", &dir_cmd, 0, 
       "ls {dir}                 list directory files\n" },
+    { "CASGC", &sim_disk_cas_gc, 0,
+      "casgc <map> {<map> ...}  delete the unused blocks of a CAS disk store\n" },
     { "SET", &set_cmd, 0,
       "set console arg{,arg...} set console options\n"
       "set console WRU          specify console drop to simh char\n"
@@ -706,8 +764,14 @@ static CTAB cmd_table[] = {
       "set throttle {x{M|K|%}}|{x/t}\n"
       "                         set simulation rate\n"
       "set nothrottle           set simulation rate to maximum\n"
+      "set profile guest{=n}    start sampling the guest PC every n instructions\n"
+      "set noprofile            stop sampling the guest PC\n"
       "set asynch               enable asynchronous I/O\n"
       "set noasynch             disable asynchronous I/O\n"
+      "set diskcache {size{K|M}}{,FLUSH=msec}{,SYNC|NOSYNC}\n"
+      "                         cache SIMH format disk units, writing back\n"
+      "                         after msec (0 = when stopped); SYNC fsyncs\n"
+      "set nodiskcache          write back and disable disk caching\n"
       "set environment name=val set environment variable\n"
       "set on                   enables error checking after command execution\n"
       "set noon                 disables error checking after command execution\n"
@@ -743,8 +807,12 @@ static CTAB cmd_table[] = {
       "sh{ow} n{ames}           show logical names\n"
       "sh{ow} q{ueue}           show event queue\n"
       "sh{ow} ti{me}            show simulated time\n"
+      "sh{ow} ru{nstats}        show instruction rate of the last and all runs\n"
+      "sh{ow} pro{file} guest{=n}\n"
+      "                         show the n hottest sampled guest PC ranges\n"
       "sh{ow} th{rottle}        show simulation rate\n"
       "sh{ow} a{synch}          show asynchronouse I/O state\n" 
+      "sh{ow} dis{kcache}       show disk cache settings and statistics\n"
       "sh{ow} ve{rsion}         show simulator version\n"
       "sh{ow} def{ault}         show current directory\n" 
       "sh{ow} re{mote}          show remote console configuration\n" 
@@ -830,6 +898,7 @@ t_bool lookswitch;
 t_stat stat, stat_nomessage;
 CTAB *cmdp;
 
+sim_startup_begin = sim_startup_mark = sim_os_nsec ();
 #if defined (__MWERKS__) && defined (macintosh)
 argc = ccommand (&argv);
 #endif
@@ -842,6 +911,10 @@ for (i = 1; i < argc; i++) {                            /* loop thru args */
     if (argv[i] == NULL)                                /* paranoia */
         continue;
     if ((*argv[i] == '-') && lookswitch) {              /* switch? */
+        if (strcmp (argv[i], "-startup-stats") == 0) {  /* startup timing? */
+            sim_startup_stats = TRUE;
+            continue;
+            }
         if ((sw = get_switches (argv[i])) < 0) {
             fprintf (stderr, "Invalid switch %s\n", argv[i]);
             return 0;
@@ -861,6 +934,7 @@ for (i = 1; i < argc; i++) {                            /* loop thru args */
     }                                                   /* end for */
 sim_quiet = sim_switches & SWMASK ('Q');                /* -q means quiet */
 sim_on_inherit = sim_switches & SWMASK ('O');           /* -o means inherit on state */
+sim_startup_phase ("arguments");
 
 sim_init_sock ();                                       /* init socket capabilities */
 AIO_INIT;                                               /* init Asynch I/O */
@@ -877,31 +951,40 @@ sim_is_running = 0;
 sim_log = NULL;
 if (sim_emax <= 0)
     sim_emax = 1;
+sim_startup_phase ("vm init");
 sim_timer_init ();
+sim_startup_phase ("timer init");
 
 if ((stat = sim_ttinit ()) != SCPE_OK) {
     fprintf (stderr, "Fatal terminal initialization error\n%s\n",
         sim_error_text (stat));
     return 0;
     }
+sim_startup_phase ("console init");
 if ((sim_eval = (t_value *) calloc (sim_emax, sizeof (t_value))) == NULL) {
     fprintf (stderr, "Unable to allocate examine buffer\n");
     return 0;
     };
-if ((stat = reset_all_p (0)) != SCPE_OK) {
+sim_reset_defer = TRUE;                                 /* disabled devices wait */
+stat = reset_all_p (0);
+sim_reset_defer = FALSE;
+if (stat != SCPE_OK) {
     fprintf (stderr, "Fatal simulator initialization error\n%s\n",
         sim_error_text (stat));
     return 0;
     }
+sim_startup_phase ("device reset");
 if ((stat = sim_brk_init ()) != SCPE_OK) {
     fprintf (stderr, "Fatal breakpoint table initialization error\n%s\n",
         sim_error_text (stat));
     return 0;
     }
+sim_startup_phase ("breakpoint init");
 if (!sim_quiet) {
     printf ("\n");
     show_version (stdout, NULL, NULL, 0, NULL);
     }
+sim_startup_phase ("banner");
 if (sim_dflt_dev == NULL)                               /* if no default */
     sim_dflt_dev = sim_devices[0];
 
@@ -932,6 +1015,8 @@ else if (*argv[0]) {                                    /* sim name arg? */
     }
 
 stat = SCPE_BARE_STATUS(stat);                          /* remove possible flag */
+sim_startup_phase ("startup commands");
+sim_startup_phase (NULL);                               /* report, if not yet */
 
 while (stat != SCPE_EXIT) {                             /* in case exit */
     if ((cptr = sim_brk_getact (cbuf, sizeof(cbuf))))   /* pending action? */
@@ -983,6 +1068,44 @@ sim_cleanup_sock ();                                    /* cleanup sockets */
 return 0;
 }
 
+/* Startup timing (-startup-stats)
+
+   sim_startup_phase records the time spent since the previous call
+   against the named phase.  A NULL phase prints the report, once, and
+   is a no-op thereafter; it is called both after the startup command
+   files and just before the first instruction is simulated, whichever
+   comes first.
+*/
+
+static void sim_startup_phase (const char *phase)
+{
+t_uint64 now;
+int32 i;
+
+if (!sim_startup_stats)
+    return;
+now = sim_os_nsec ();
+if (phase != NULL) {
+    if (sim_startup_count < SIM_STARTUP_MAX) {
+        sim_startup_name[sim_startup_count] = phase;
+        sim_startup_ns[sim_startup_count++] = now - sim_startup_mark;
+        }
+    sim_startup_mark = now;
+    return;
+    }
+sim_startup_stats = FALSE;                              /* report once */
+printf ("Startup timing:\n");
+for (i = 0; i < sim_startup_count; i++)
+    printf ("  %-22s %10.3f ms\n", sim_startup_name[i], sim_startup_ns[i] / 1000000.0);
+printf ("  %-22s %10.3f ms\n", "total", (now - sim_startup_begin) / 1000000.0);
+if (sim_log) {
+    fprintf (sim_log, "Startup timing:\n");
+    for (i = 0; i < sim_startup_count; i++)
+        fprintf (sim_log, "  %-22s %10.3f ms\n", sim_startup_name[i], sim_startup_ns[i] / 1000000.0);
+    fprintf (sim_log, "  %-22s %10.3f ms\n", "total", (now - sim_startup_begin) / 1000000.0);
+    }
+}
+
 /* Set prompt routine */
 
 t_stat set_prompt (int32 flag, char *cptr)
@@ -2275,6 +2398,8 @@ static CTAB set_glob_tab[] = {
     { "NOTHROTTLE", &sim_set_throt, 0 },
     { "ASYNCH", &sim_set_asynch, 1 },
     { "NOASYNCH", &sim_set_asynch, 0 },
+    { "DISKCACHE", &sim_disk_set_cache, 1 },
+    { "NODISKCACHE", &sim_disk_set_cache, 0 },
     { "ENVIRONMENT", &sim_set_environment, 1 },
     { "ON", &set_on, 1 },
     { "NOON", &set_on, 0 },
@@ -2287,6 +2412,8 @@ static CTAB set_glob_tab[] = {
     { "QUIET", &set_quiet, 1 },
     { "NOQUIET", &set_quiet, 0 },
     { "PROMPT", &set_prompt, 0 },
+    { "PROFILE", &set_profile, 1 },
+    { "NOPROFILE", &set_profile, 0 },
     { NULL, NULL, 0 }
     };
 
@@ -2348,6 +2475,8 @@ else {
 if (*cptr == 0)                                         /* must be more */
     return SCPE_2FARG;
 GET_SWITCHES (cptr);                                    /* get more switches */
+if ((r = reset_pending (dptr)) != SCPE_OK)              /* powered up yet? */
+    return r;
 
 while (*cptr != 0) {                                    /* do all mods */
     cptr = get_glyph (svptr = cptr, gbuf, ',');         /* get modifier */
@@ -2473,6 +2602,8 @@ else {
         }
     dptr->flags = dptr->flags | DEV_DIS;                /* disable */
     }
+if (dptr->flags & DEV_RSTPEND)                          /* never reset? */
+    return reset_pending (dptr);                        /* power it up now */
 if (dptr->reset)                                        /* reset device */
     return dptr->reset (dptr);
 else return SCPE_OK;
@@ -2556,6 +2687,7 @@ return r;
 t_stat show_cmd_fi (FILE *ofile, int32 flag, char *cptr)
 {
 uint32 lvl = 0xFFFFFFFF;
+t_stat r;
 char gbuf[CBUFSIZE], *cvptr;
 DEVICE *dptr;
 UNIT *uptr;
@@ -2568,6 +2700,8 @@ static SHTAB show_glob_tab[] = {
     { "FEATURES", &show_config, 2 },
     { "QUEUE", &show_queue, 0 },
     { "TIME", &show_time, 0 },
+    { "RUNSTATS", &show_runstats, 0 },
+    { "PROFILE", &show_profile, 0 },
     { "MODIFIERS", &show_mod_names, 0 },
     { "NAMES", &show_log_names, 0 },
     { "SHOW", &show_show_commands, 0 },
@@ -2581,6 +2715,7 @@ static SHTAB show_glob_tab[] = {
     { "DEBUG", &sim_show_debug, 0 },                    /* deprecated */
     { "THROTTLE", &sim_show_throt, 0 },
     { "ASYNCH", &sim_show_asynch, 0 },
+    { "DISKCACHE", &sim_disk_show_cache, 0 },
     { "ETHERNET", &eth_show_devices, 0 },
     { "SERIAL", &sim_show_serial, 0 },
     { "MULTIPLEXER", &tmxr_show_open_devices, 0 },
@@ -2640,6 +2775,8 @@ else {
     if (!dptr)
         return SCPE_NXDEV;                              /* no match */
     }
+if ((r = reset_pending (dptr)) != SCPE_OK)              /* powered up yet? */
+    return r;
 
 if (*cptr == 0) {                                       /* now eol? */
     return (lvl == MTAB_VDV)?
@@ -2976,13 +3113,17 @@ else {
     }
 #if defined (SIM_ASYNCH_IO)
 pthread_mutex_lock (&sim_timer_lock);
-if (sim_wallclock_queue == QUEUE_LIST_END)
+_sim_wallclock_drain ();
+if (sim_wallclock_count == 0)
     fprintf (st, "%s wall clock event queue empty, time = %.0f\n",
              sim_name, sim_time);
 else {
+    int32 i;
+
     fprintf (st, "%s wall clock event queue status, time = %.0f\n",
              sim_name, sim_time);
-    for (uptr = sim_wallclock_queue; uptr != QUEUE_LIST_END; uptr = uptr->a_next) {
+    for (i = 1; i <= sim_wallclock_count; i++) {        /* heap order */
+        uptr = sim_wallclock_heap[i];
         if ((dptr = find_dev_from_unit (uptr)) != NULL) {
             fprintf (st, "  %s", sim_dname (dptr));
             if (dptr->numunits > 1)
@@ -3038,6 +3179,271 @@ fprintf (st, "Time:\t%.0f\n", sim_time);
 return SCPE_OK;
 }
 
+/* Show run statistics
+
+   One line each for the last run and for all runs since startup, as
+   keyword=value pairs so that scripts can pick them out.  Instructions
+   are the simulator's own time base (sim_gtime), which for most CPUs
+   counts instructions, less the time skipped while idle; events are event
+   queue entries processed.  idle_ns is the host time spent idling or
+   throttled.  mips and ns_per_inst exclude both, so they measure only
+   the time spent executing instructions; events_per_sec is over host_ns.
+*/
+
+t_stat show_runstats (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr)
+{
+int32 i;
+double sec, busy;
+
+if (cptr && (*cptr != 0))
+    return SCPE_2MARG;
+for (i = 0; i < 2; i++) {
+    sec = sim_run_ns[i] / 1000000000.0;
+    busy = (sim_run_ns[i] > sim_run_idle_ns[i])?        /* executing time */
+        (sim_run_ns[i] - sim_run_idle_ns[i]) / 1000000000.0: 0.0;
+    fprintf (st, "runstats %s sim=\"%s\" runs=%u insts=%.0f host_ns=%" LL_FMT "u idle_ns=%" LL_FMT "u events=%" LL_FMT "u",
+        i? "all": "last", sim_name, i? sim_run_count: (sim_run_count? 1: 0),
+        sim_run_inst[i], sim_run_ns[i], sim_run_idle_ns[i], sim_run_events[i]);
+    fprintf (st, " mips=%.3f ns_per_inst=%.3f events_per_sec=%.0f\n",
+        (busy > 0.0)? sim_run_inst[i] / busy / 1000000.0: 0.0,
+        (sim_run_inst[i] > 0.0)? busy * 1000000000.0 / sim_run_inst[i]: 0.0,
+        (sec > 0.0)? sim_run_events[i] / sec: 0.0);
+    }
+return SCPE_OK;
+}
+
+/* Guest PC profile
+
+   While SET PROFILE GUEST is in effect, the CPU calls sim_prof_sample with
+   its PC and context (mode switches) every n instructions.  Samples are counted in
+   an open addressed hash table keyed by PC and context, which doubles when
+   three quarters full.  SHOW PROFILE GUEST sorts the samples by address,
+   merges nearby PCs in the same context into ranges, and lists the ranges
+   with the most samples along with the instruction at the hottest PC,
+   examined virtually in the sampled mode.
+   SET NOPROFILE stops sampling but keeps the histogram for display.
+*/
+
+static uint32 sim_prof_hash (t_addr pc, uint32 ctx)
+{
+return (((uint32) pc) * 2654435761u) ^ (ctx * 40503u);
+}
+
+static t_bool sim_prof_grow (void)
+{
+PROFENT *ntab;
+uint32 i, h, nsize = sim_prof_size? sim_prof_size << 1: PROF_INIT_SIZE;
+
+ntab = (PROFENT *) calloc (nsize, sizeof (PROFENT));
+if (ntab == NULL)
+    return FALSE;
+for (i = 0; i < sim_prof_size; i++) {                   /* rehash old entries */
+    if (sim_prof_tab[i].count == 0)
+        continue;
+    h = sim_prof_hash (sim_prof_tab[i].pc, sim_prof_tab[i].ctx) & (nsize - 1);
+    while (ntab[h].count != 0)
+        h = (h + 1) & (nsize - 1);
+    ntab[h] = sim_prof_tab[i];
+    }
+free (sim_prof_tab);
+sim_prof_tab = ntab;
+sim_prof_size = nsize;
+return TRUE;
+}
+
+void sim_prof_sample (t_addr pc, uint32 ctx)
+{
+uint32 h;
+
+if (sim_prof_intvl == 0) {                              /* not profiling? */
+    sim_prof_count = 0x7FFFFFFF;
+    return;
+    }
+sim_prof_count = sim_prof_intvl;                        /* next sample */
+if ((sim_prof_used >= (sim_prof_size - (sim_prof_size >> 2))) &&
+    !sim_prof_grow ())                                  /* full, can't grow? */
+    return;
+h = sim_prof_hash (pc, ctx) & (sim_prof_size - 1);
+while ((sim_prof_tab[h].count != 0) &&                  /* probe for entry */
+    ((sim_prof_tab[h].pc != pc) || (sim_prof_tab[h].ctx != ctx)))
+    h = (h + 1) & (sim_prof_size - 1);
+if (sim_prof_tab[h].count == 0) {                       /* new PC? */
+    sim_prof_tab[h].pc = pc;
+    sim_prof_tab[h].ctx = ctx;
+    sim_prof_used++;
+    }
+sim_prof_tab[h].count++;
+sim_prof_samples++;
+}
+
+/* Set profile routine - flag = 1 for PROFILE, 0 for NOPROFILE */
+
+t_stat set_profile (int32 flag, char *cptr)
+{
+char gbuf[CBUFSIZE];
+int32 intvl = PROF_DFLT_INTVL;
+t_stat r;
+
+if (flag == 0) {                                        /* NOPROFILE */
+    if (cptr && (*cptr != 0))
+        return SCPE_2MARG;
+    sim_prof_intvl = 0;
+    sim_prof_count = 0x7FFFFFFF;
+    return SCPE_OK;
+    }
+if ((cptr == NULL) || (*cptr == 0))
+    return SCPE_2FARG;
+cptr = get_glyph (cptr, gbuf, '=');                     /* get GUEST */
+if (strcmp (gbuf, "GUEST") != 0)
+    return SCPE_ARG;
+if (*cptr != 0) {                                       /* interval given? */
+    intvl = (int32) get_uint (cptr, 10, 0x7FFFFFFF, &r);
+    if ((r != SCPE_OK) || (intvl == 0))
+        return SCPE_ARG;
+    }
+free (sim_prof_tab);                                    /* start afresh */
+sim_prof_tab = NULL;
+sim_prof_size = sim_prof_used = 0;
+sim_prof_samples = 0;
+if (!sim_prof_grow ())
+    return SCPE_MEM;
+sim_prof_intvl = sim_prof_count = intvl;
+return SCPE_OK;
+}
+
+static int sim_prof_addr_cmp (const void *pa, const void *pb)
+{
+const PROFENT *a = (const PROFENT *) pa, *b = (const PROFENT *) pb;
+
+if (a->ctx != b->ctx)
+    return (a->ctx < b->ctx)? -1: 1;
+if (a->pc != b->pc)
+    return (a->pc < b->pc)? -1: 1;
+return 0;
+}
+
+typedef struct {
+    t_addr              lo, hi;                         /* PC range */
+    t_addr              hot;                            /* hottest PC */
+    uint32              hotcnt;                         /* its samples */
+    uint32              ctx;                            /* mode switches */
+    t_uint64            count;                          /* samples in range */
+    } PROFRNG;
+
+static int sim_prof_count_cmp (const void *pa, const void *pb)
+{
+const PROFRNG *a = (const PROFRNG *) pa, *b = (const PROFRNG *) pb;
+
+if (a->count != b->count)
+    return (a->count > b->count)? -1: 1;
+return (a->lo < b->lo)? -1: (a->lo > b->lo);
+}
+
+static void sim_prof_fprint_addr (FILE *st, t_addr addr)
+{
+if (sim_vm_fprint_addr)
+    sim_vm_fprint_addr (st, sim_dflt_dev, addr);
+else if (sim_PC)
+    fprint_val (st, (t_value) addr, sim_PC->radix, sim_PC->width, PV_RZRO);
+else fprint_val (st, (t_value) addr, sim_dflt_dev->aradix, sim_dflt_dev->awidth, PV_RZRO);
+}
+
+t_stat show_profile (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr)
+{
+char gbuf[CBUFSIZE];
+PROFENT *ent;
+PROFRNG *rng;
+DEVICE *cdev = sim_dflt_dev;
+uint32 i, j, n, nrng, show = PROF_DFLT_SHOW;
+int32 k;
+t_addr a;
+t_stat r;
+
+if ((cptr == NULL) || (*cptr == 0))
+    return SCPE_2FARG;
+cptr = get_glyph (cptr, gbuf, '=');                     /* get GUEST */
+if (strcmp (gbuf, "GUEST") != 0)
+    return SCPE_ARG;
+if (*cptr != 0) {                                       /* count given? */
+    show = (uint32) get_uint (cptr, 10, 0xFFFFFFFF, &r);
+    if (r != SCPE_OK)
+        return SCPE_ARG;
+    }
+fprintf (st, "Guest PC profile: %" LL_FMT "u samples", sim_prof_samples);
+if (sim_prof_intvl)
+    fprintf (st, ", 1 per %d instructions", sim_prof_intvl);
+else fprintf (st, ", sampling off");
+fprintf (st, ", %u distinct PCs\n", sim_prof_used);
+if (sim_prof_used == 0)
+    return SCPE_OK;
+ent = (PROFENT *) malloc (sim_prof_used * sizeof (PROFENT));
+rng = (PROFRNG *) malloc (sim_prof_used * sizeof (PROFRNG));
+if ((ent == NULL) || (rng == NULL)) {
+    free (ent);
+    free (rng);
+    return SCPE_MEM;
+    }
+for (i = n = 0; i < sim_prof_size; i++) {               /* collect entries */
+    if (sim_prof_tab[i].count)
+        ent[n++] = sim_prof_tab[i];
+    }
+qsort (ent, n, sizeof (PROFENT), sim_prof_addr_cmp);
+for (i = nrng = 0; i < n; i++) {                        /* merge into ranges */
+    if ((nrng == 0) || (ent[i].ctx != rng[nrng - 1].ctx) ||
+        ((ent[i].pc - rng[nrng - 1].hi) > PROF_GAP)) {
+        rng[nrng].lo = rng[nrng].hi = rng[nrng].hot = ent[i].pc;
+        rng[nrng].ctx = ent[i].ctx;
+        rng[nrng].hotcnt = 0;
+        rng[nrng].count = 0;
+        nrng++;
+        }
+    rng[nrng - 1].hi = ent[i].pc;
+    rng[nrng - 1].count += ent[i].count;
+    if (ent[i].count > rng[nrng - 1].hotcnt) {
+        rng[nrng - 1].hot = ent[i].pc;
+        rng[nrng - 1].hotcnt = ent[i].count;
+        }
+    }
+qsort (rng, nrng, sizeof (PROFRNG), sim_prof_count_cmp);
+fprintf (st, "    %%    samples mode  range, hottest PC (instruction)\n");
+for (i = 0; (i < nrng) && (i < show); i++) {
+    char mode[8];
+
+    for (k = j = 0; (k < 26) && (j < sizeof (mode) - 1); k++) {
+        if ((rng[i].ctx >> k) & 1)
+            mode[j++] = (char) ('A' + k);
+        }
+    mode[j] = 0;
+    fprintf (st, "%6.2f %10" LL_FMT "u %4s  ",
+        (100.0 * rng[i].count) / sim_prof_samples, rng[i].count, mode);
+    sim_prof_fprint_addr (st, rng[i].lo);
+    fprintf (st, "-");
+    sim_prof_fprint_addr (st, rng[i].hi);
+    fprintf (st, ", ");
+    sim_prof_fprint_addr (st, rng[i].hot);
+    if ((cdev != NULL) && (cdev->examine != NULL)) {    /* symbolize hot PC */
+        r = SCPE_NXM;                                   /* none examined yet */
+        for (k = 0; k < sim_emax; k++)
+            sim_eval[k] = 0;
+        for (k = 0, a = rng[i].hot; k < sim_emax; k++, a = a + cdev->aincr) {
+            if ((r = cdev->examine (&sim_eval[k], a, cdev->units,
+                SWMASK ('V') | rng[i].ctx)) != SCPE_OK)
+                break;
+            }
+        if ((r == SCPE_OK) || (k > 0)) {
+            fprintf (st, " (");
+            if (fprint_sym (st, rng[i].hot, sim_eval, NULL, SWMASK ('M')) > 0)
+                fprint_val (st, sim_eval[0], cdev->dradix, cdev->dwidth, PV_RZRO);
+            fprintf (st, ")");
+            }
+        }
+    fprintf (st, "\n");
+    }
+free (ent);
+free (rng);
+return SCPE_OK;
+}
+
 t_stat show_break (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr)
 {
 t_stat r;
@@ -3608,7 +4014,15 @@ for (i = 0; i < start; i++) {
     if (sim_devices[i] == NULL)
         return SCPE_IERR;
     }
+if (!sim_reset_defer && ((reason = reset_deferred (TRUE)) != SCPE_OK))
+    return reason;
 for (i = start; (dptr = sim_devices[i]) != NULL; i++) {
+    if (sim_reset_defer &&                              /* disabled at startup */
+        ((dptr->flags & (DEV_DIS | DEV_RSTDEFER)) ==    /*    and safe to defer? */
+         (DEV_DIS | DEV_RSTDEFER))) {
+        dptr->flags = dptr->flags | DEV_RSTPEND;        /* reset when needed */
+        continue;
+        }
     if (dptr->reset != NULL) {
         reason = dptr->reset (dptr);
         if (reason != SCPE_OK)
@@ -3644,6 +4058,62 @@ sim_switches = old_sw;
 return r;
 }
 
+/* Perform deferred power-up resets
+
+   Devices which are disabled when the simulator starts, and whose DEVICE
+   flags include DEV_RSTDEFER, are not reset then; many simulators
+   configure optional controllers that are never used, and each reset
+   costs buffer allocations and table setup.  Such a device is marked
+   DEV_RSTPEND and is given its power-up reset the first time it can
+   matter: when it is enabled, before the simulator runs, before a SAVE
+   or RESTORE, before any other reset, or before a SET, SHOW, EXAMINE,
+   DEPOSIT, ATTACH or DETACH refers to it.
+
+   DEV_RSTDEFER is opt-in: a device may set it only if its reset changes
+   nothing outside the device itself.  Bus devices whose reset runs
+   auto_config, or which enable and disable a shared adapter (the PDP-11
+   TU and RS resets turn RHB and RHC off), must be reset at startup like
+   any other, or the configuration the guest sees would depend on when
+   they are first touched.
+
+   Inputs:
+        all     =       TRUE to reset disabled devices as well
+   Outputs:
+        status  =       error status
+*/
+
+static t_stat reset_deferred (t_bool all)
+{
+DEVICE *dptr;
+uint32 i;
+t_stat r = SCPE_OK;
+
+for (i = 0; (r == SCPE_OK) && ((dptr = sim_devices[i]) != NULL); i++) {
+    if (!all && (dptr->flags & DEV_DIS))
+        continue;
+    r = reset_pending (dptr);
+    }
+return r;
+}
+
+/* Perform one device's deferred power-up reset, if it is still pending */
+
+static t_stat reset_pending (DEVICE *dptr)
+{
+int32 old_sw = sim_switches;
+t_stat r = SCPE_OK;
+
+if ((dptr == NULL) || ((dptr->flags & DEV_RSTPEND) == 0))
+    return SCPE_OK;
+dptr->flags = dptr->flags & ~DEV_RSTPEND;
+if (dptr->reset != NULL) {
+    sim_switches = SWMASK ('P');
+    r = dptr->reset (dptr);
+    sim_switches = old_sw;
+    }
+return r;
+}
+
 /* Load and dump commands
 
    lo[ad] filename {arg}        load specified file
@@ -3693,6 +4163,8 @@ if (dptr == NULL)                                       /* found dev? */
     return SCPE_NXDEV;
 if (uptr == NULL)                                       /* valid unit? */
     return SCPE_NXUN;
+if ((r = reset_pending (dptr)) != SCPE_OK)              /* powered up yet? */
+    return r;
 if (uptr->flags & UNIT_ATT) {                           /* already attached? */
     if (!(uptr->dynflags & UNIT_ATTMULT) &&             /* and only single attachable */
         !(dptr->flags & DEV_DONTAUTO)) {                /* and auto detachable */
@@ -3831,6 +4303,7 @@ t_stat detach_cmd (int32 flag, char *cptr)
 char gbuf[CBUFSIZE];
 DEVICE *dptr;
 UNIT *uptr;
+t_stat r;
 
 GET_SWITCHES (cptr);                                    /* get switches */
 if (*cptr == 0)                                         /* must be more */
@@ -3845,6 +4318,8 @@ if (dptr == NULL)                                       /* found dev? */
     return SCPE_NXDEV;
 if (uptr == NULL)                                        /* valid unit? */
     return SCPE_NXUN;
+if ((r = reset_pending (dptr)) != SCPE_OK)              /* powered up yet? */
+    return r;
 return scp_detach_unit (dptr, uptr);                    /* detach */
 }
 
@@ -4067,6 +4542,9 @@ REG *rptr;
 
 #define WRITE_I(xx) sim_fwrite (&(xx), sizeof (xx), 1, sfile)
 
+if ((r = reset_deferred (TRUE)) != SCPE_OK)             /* save powered up state */
+    return r;
+
 fprintf (sfile, "%s\n%s\n%s\n%s\n%s\n%.0f\n",
     save_vercur,                                        /* [V2.5] save format */
     sim_name,                                           /* sim name */
@@ -4208,6 +4686,8 @@ t_bool force_restore = sim_switches & SWMASK ('F');
 #define READ_I(xx) if (sim_fread (&xx, sizeof (xx), 1, rfile) == 0) \
     return SCPE_IOERR;
 
+if ((r = reset_deferred (TRUE)) != SCPE_OK)             /* restore over power-up */
+    return r;
 fstat (fileno (rfile), &rstat);
 READ_S (buf);                                           /* [V2.5+] read version */
 v35 = v32 = FALSE;
@@ -4479,6 +4959,8 @@ DEVICE *dptr;
 UNIT *uptr;
 
 GET_SWITCHES (cptr);                                    /* get switches */
+if ((r = reset_deferred (FALSE)) != SCPE_OK)            /* power up late enables */
+    return r;
 sim_step = 0;
 if ((flag == RU_RUN) || (flag == RU_GO)) {              /* run or go */
     if (*cptr != 0) {                                   /* argument? */
@@ -4581,9 +5063,25 @@ if (sim_log)                                            /* flush log if enabled
     fflush (sim_log);
 sim_throt_sched ();                                     /* set throttle */
 sim_brk_clract ();                                      /* defang actions */
+sim_brk_wpend = 0;                                      /* no watch hit */
 sim_rtcn_init_all ();                                   /* re-init clocks */
 sim_start_timer_services ();                            /* enable wall clock timing */
+sim_startup_phase ("to first instruction");
+sim_startup_phase (NULL);                               /* report, if not yet */
+sim_run_inst[0] = sim_gtime () - sim_idle_cyc;          /* mark run stats */
+sim_run_events[0] = sim_events;
+sim_run_idle_ns[0] = sim_idle_ns;
+sim_run_ns[0] = sim_os_nsec ();
 r = sim_instr();
+sim_run_ns[0] = sim_os_nsec () - sim_run_ns[0];         /* get run stats */
+sim_run_idle_ns[0] = sim_idle_ns - sim_run_idle_ns[0];
+sim_run_events[0] = sim_events - sim_run_events[0];
+sim_run_inst[0] = (sim_gtime () - sim_idle_cyc) - sim_run_inst[0];
+sim_run_inst[1] = sim_run_inst[1] + sim_run_inst[0];    /* accumulate */
+sim_run_ns[1] = sim_run_ns[1] + sim_run_ns[0];
+sim_run_idle_ns[1] = sim_run_idle_ns[1] + sim_run_idle_ns[0];
+sim_run_events[1] = sim_run_events[1] + sim_run_events[0];
+sim_run_count = sim_run_count + 1;
 
 sim_is_running = 0;                                     /* flag idle */
 sim_stop_timer_services ();                             /* disable wall clock timing */
@@ -4686,6 +5184,18 @@ if ((dptr != NULL) && (dptr->examine != NULL)) {
         }
     }
 fprintf (st, "\n");
+if (sim_brk_wpend && (dptr != NULL)) {                  /* watchpoint hit? */
+    fprintf (st, "Watchpoint ");
+    for (i = 0; i < 26; i++) {
+        if ((sim_brk_wpend >> i) & 1)
+            fputc (i + 'A', st);
+        }
+    fprintf (st, " at ");
+    if (sim_vm_fprint_addr)
+        sim_vm_fprint_addr (st, dptr, sim_brk_wloc);
+    else fprint_val (st, sim_brk_wloc, dptr->aradix, dptr->awidth, PV_LEFT);
+    fprintf (st, "\n");
+    }
 return;
 }
 
@@ -4764,6 +5274,8 @@ cptr = get_glyph (cptr, gbuf, 0);                       /* get list */
 if ((flag == EX_D) && (*cptr == 0))                     /* deposit needs more */
     return SCPE_2FARG;
 ofile = sim_ofile? sim_ofile: stdout;                   /* no ofile? use stdout */
+if ((reason = reset_pending (sim_dfdev)) != SCPE_OK)    /* powered up yet? */
+    return reason;
 
 for (gptr = gbuf, reason = SCPE_OK;
     (*gptr != 0) && (reason == SCPE_OK); gptr = tptr) {
@@ -4784,6 +5296,8 @@ for (gptr = gbuf, reason = SCPE_OK;
     if ((lowr = find_reg (gptr, &tptr, tdptr)) ||       /* local reg or */
         (!(sim_opt_out & CMD_OPT_DFT) &&                /* no dflt, global? */
         (lowr = find_reg_glob (gptr, &tptr, &tdptr)))) {
+        if ((reason = reset_pending (tdptr)) != SCPE_OK)
+            return reason;
         low = high = 0;
         if ((*tptr == '-') || (*tptr == ':')) {
             highr = find_reg (tptr + 1, &tptr, tdptr);
@@ -6301,6 +6815,7 @@ do {
     sim_clock_queue = uptr->next;                       /* remove first */
     uptr->next = NULL;                                  /* hygiene */
     uptr->time = 0;
+    sim_events = sim_events + 1;                        /* count event */
     if (sim_clock_queue != QUEUE_LIST_END)
         sim_interval = sim_clock_queue->time;
     else
@@ -6590,6 +7105,21 @@ return cnt;
    is the bitwise OR of all the type fields).  A simulator need only check for
    a breakpoint of type X if bit SWMASK('X') is set in sim_brk_sum.
 
+   Data watchpoints are breakpoints whose types are listed in sim_brk_wtypes
+   (typically R for read, W for write, and M for a write that changes the
+   stored value).  If the simulator defines a physical qualifier type in
+   sim_brk_wphys, a watchpoint carrying that type watches a physical address;
+   otherwise it watches a virtual address.  Because a breakpoint table entry
+   has a single type mask, an address is watched in only one space at a time.
+
+   Every set or clear rebuilds a bitmap of watched pages (page size is
+   2**sim_brk_wshift) for each space and sets sim_brk_wchg.  A simulator
+   consults the bitmap with sim_brk_wpage when it fills its translation
+   cache, declines to cache watched pages, and calls sim_brk_wtest only for
+   references that miss the cache.  Unwatched pages therefore pay nothing.
+   A watchpoint hit records the address in sim_brk_wloc and the matched types
+   in sim_brk_wpend; the simulator stops at the next instruction boundary.
+
    The package contains the following public routines:
 
         sim_brk_init            initialize
@@ -6602,6 +7132,8 @@ return cnt;
         sim_brk_npc             PC has been changed
         sim_brk_getact          get next action
         sim_brk_clract          clear pending actions
+        sim_brk_wpage           test for watched page
+        sim_brk_wtest           test for watchpoint
 
    Initialize breakpoint system.
 */
@@ -6689,6 +7221,10 @@ BRKTAB *bp;
 if (sw == 0) sw = sim_brk_dflt;
 if ((sim_brk_types & sw) == 0)
     return SCPE_NOFNC;
+if ((sw & sim_brk_wphys) &&                             /* phys qualifier only */
+    ((sw & sim_brk_wtypes) == 0 ||                      /* valid on watchpoints */
+     (sw & ~(sim_brk_wtypes | sim_brk_wphys))))
+    return SCPE_ARG;
 bp = sim_brk_fnd (loc);                                 /* present? */
 if (!bp)                                                /* no, allocate */
     bp = sim_brk_new (loc);
@@ -6708,6 +7244,11 @@ if ((act != NULL) && (*act != 0)) {                     /* new action? */
     bp->act = newp;                                     /* set pointer */
     }
 sim_brk_summ = sim_brk_summ | sw;
+if ((sw & sim_brk_wtypes) &&                            /* watchpoint? */
+    (sim_brk_wbuild () != SCPE_OK)) {                   /* can't watch it? */
+    sim_brk_clr (loc, sw);                              /* don't keep it */
+    return SCPE_MEM;
+    }
 return SCPE_OK;
 }
 
@@ -6722,8 +7263,13 @@ if (!bp)                                                /* not there? ok */
 if (sw == 0)
     sw = SIM_BRK_ALLTYP;
 bp->typ = bp->typ & ~sw;
-if (bp->typ)                                            /* clear all types? */
+if ((bp->typ & ~sim_brk_wphys) == 0)                    /* qualifier only left? */
+    bp->typ = 0;
+if (bp->typ) {                                          /* clear all types? */
+    if (sw & sim_brk_wtypes)                            /* watchpoint? */
+        return sim_brk_wbuild ();
     return SCPE_OK;
+    }
 if (bp->act != NULL)                                    /* deallocate action */
     free (bp->act);
 for ( ; bp < (sim_brk_tab + sim_brk_ent - 1); bp++)     /* erase entry */
@@ -6732,6 +7278,8 @@ sim_brk_ent = sim_brk_ent - 1;                          /* decrement count */
 sim_brk_summ = 0;                                       /* recalc summary */
 for (bp = sim_brk_tab; bp < (sim_brk_tab + sim_brk_ent); bp++)
     sim_brk_summ = sim_brk_summ | bp->typ;
+if (sw & sim_brk_wtypes)                                /* watchpoint? */
+    return sim_brk_wbuild ();
 return SCPE_OK;
 }
 
@@ -6880,6 +7428,105 @@ if (spc < SIM_BKPT_N_SPC) {
 return;
 }
 
+/* Rebuild the watched page maps and the watchpoint summary
+
+   A watchpoint whose page can't be mapped is left out of the summary,
+   and SCPE_MEM is returned so that the BREAK command reports it.
+*/
+
+static t_stat sim_brk_wbuild (void)
+{
+BRKTAB *bp;
+t_addr pg, lnt;
+uint8 *newp;
+uint32 spc;
+t_stat r = SCPE_OK;
+
+sim_brk_wsumm = 0;
+for (spc = 0; spc < 2; spc++) {                         /* clear maps */
+    if (sim_brk_wmap[spc])
+        memset (sim_brk_wmap[spc], 0, (size_t) ((sim_brk_wmlnt[spc] + 7) >> 3));
+    }
+for (bp = sim_brk_tab; bp < (sim_brk_tab + sim_brk_ent); bp++) {
+    if ((bp->typ & sim_brk_wtypes) == 0)                /* not a watchpoint? */
+        continue;
+    spc = (bp->typ & sim_brk_wphys)? 1: 0;
+    pg = bp->addr >> sim_brk_wshift;
+    if (pg >= sim_brk_wmlnt[spc]) {                     /* map too small? */
+        lnt = (pg + 64) & ~((t_addr) 63);
+        newp = (uint8 *) realloc (sim_brk_wmap[spc], (size_t) (lnt >> 3));
+        if (newp == NULL) {                             /* can't extend? */
+            r = SCPE_MEM;
+            continue;
+            }
+        memset (newp + (sim_brk_wmlnt[spc] >> 3), 0,
+            (size_t) ((lnt - sim_brk_wmlnt[spc]) >> 3));
+        sim_brk_wmap[spc] = newp;
+        sim_brk_wmlnt[spc] = lnt;
+        }
+    sim_brk_wmap[spc][pg >> 3] |= (uint8) (1u << (pg & 7));
+    sim_brk_wsumm = sim_brk_wsumm | (bp->typ & sim_brk_wtypes);
+    }
+sim_brk_wchg = TRUE;                                    /* VM must flush caches */
+return r;
+}
+
+/* Test for a watched page
+
+   Inputs:
+        loc     =       address within the page
+        btyp    =       reference type; sim_brk_wphys selects physical space
+   Outputs:
+        TRUE if any watchpoint is set within the page
+*/
+
+t_bool sim_brk_wpage (t_addr loc, uint32 btyp)
+{
+uint32 spc = (btyp & sim_brk_wphys)? 1: 0;
+t_addr pg = loc >> sim_brk_wshift;
+
+if (pg >= sim_brk_wmlnt[spc])
+    return FALSE;
+return (sim_brk_wmap[spc][pg >> 3] >> (pg & 7)) & 1;
+}
+
+/* Test for a watchpoint
+
+   Inputs:
+        loc     =       first address referenced
+        lnt     =       number of addresses referenced
+        btyp    =       reference types (plus sim_brk_wphys if physical)
+   Outputs:
+        matched types, or 0 if no watchpoint was hit
+*/
+
+uint32 sim_brk_wtest (t_addr loc, uint32 lnt, uint32 btyp)
+{
+BRKTAB *bp;
+uint32 spc = btyp & sim_brk_wphys;
+uint32 typ, i;
+t_addr a;
+
+if ((btyp & sim_brk_wsumm) == 0)                        /* none of this type? */
+    return 0;
+for (i = 0, a = loc; i < lnt; i++, a++) {               /* count, addr may wrap */
+    if (!sim_brk_wpage (a, btyp))                       /* page not watched? */
+        continue;
+    bp = sim_brk_fnd (a);
+    if ((bp == NULL) || ((bp->typ & sim_brk_wphys) != spc))
+        continue;
+    typ = bp->typ & btyp & sim_brk_wtypes;
+    if ((typ == 0) || (--bp->cnt > 0))                  /* type match, count? */
+        continue;
+    bp->cnt = 0;                                        /* reset count */
+    sim_brk_wloc = a;                                   /* save location */
+    sim_brk_wpend = typ | spc;                          /* flag hit */
+    sim_brk_act[sim_do_depth] = bp->act;                /* set up actions */
+    return typ;
+    }
+return 0;
+}
+
 /* Message Text */
 
 const char *sim_error_text (t_stat stat)
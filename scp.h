@@ -98,6 +98,7 @@ t_stat sim_cancel (UNIT *uptr);
 t_bool sim_is_active (UNIT *uptr);
 int32 sim_activate_time (UNIT *uptr);
 double sim_gtime (void);
+void sim_prof_sample (t_addr pc, uint32 ctx);
 uint32 sim_grtime (void);
 int32 sim_qcount (void);
 t_stat attach_unit (UNIT *uptr, char *cptr);
@@ -135,6 +136,8 @@ SHTAB *find_shtab (SHTAB *tab, char *gbuf);
 BRKTAB *sim_brk_fnd (t_addr loc);
 uint32 sim_brk_test (t_addr bloc, uint32 btyp);
 void sim_brk_clrspc (uint32 spc);
+t_bool sim_brk_wpage (t_addr loc, uint32 btyp);
+uint32 sim_brk_wtest (t_addr loc, uint32 lnt, uint32 btyp);
 char *match_ext (char *fnam, char *ext);
 t_stat show_version (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
 t_stat set_dev_debug (DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
@@ -171,6 +174,7 @@ t_stat scp_vhelpFromFile (FILE *st, struct sim_device *dptr,
 
 extern DEVICE *sim_dflt_dev;
 extern int32 sim_interval;
+extern int32 sim_prof_count;                            /* profile countdown */
 extern int32 sim_switches;
 extern int32 sim_quiet;
 extern int32 sim_step;
@@ -188,6 +192,13 @@ extern volatile int32 stop_cpu;
 extern uint32 sim_brk_types;                            /* breakpoint info */
 extern uint32 sim_brk_dflt;
 extern uint32 sim_brk_summ;
+extern uint32 sim_brk_wtypes;                           /* watchpoint info */
+extern uint32 sim_brk_wphys;
+extern uint32 sim_brk_wshift;
+extern uint32 sim_brk_wsumm;
+extern uint32 sim_brk_wpend;
+extern t_addr sim_brk_wloc;
+extern t_bool sim_brk_wchg;
 extern t_bool sim_asynch_enabled;
 
 /* VM interface */
@@ -215,5 +226,18 @@ extern void (*sim_vm_fprint_addr) (FILE *st, DEVICE *dptr, t_addr addr);
 extern t_addr (*sim_vm_parse_addr) (DEVICE *dptr, char *cptr, char **tptr);
 extern t_value (*sim_vm_pc_value) (void);
 
+/* Guest PC profiling: a CPU invokes SIM_PROF_SAMPLE once per instruction
+   with the instruction's PC and its context, as the examine switches that
+   select the mode the PC was in (e.g. SWMASK ('U')), or 0.  While SET
+   PROFILE GUEST is not in effect, sim_prof_count is set to the largest
+   int32, so the countdown still expires, but only once every 2**31
+   instructions; sim_prof_sample then just rearms it. */
+
+#define SIM_PROF_SAMPLE(pc,ctx) do {                                    \
+                                if (--sim_prof_count <= 0)              \
+                                    sim_prof_sample ((t_addr) (pc),     \
+                                        (uint32) (ctx));                \
+                                } while (0)
+
 
 #endif
@@ -223,6 +223,14 @@ typedef uint32          t_addr;
 
 #define SIM_INLINE
 
+/* Threaded dispatch: CPU instruction loops may jump through tables of
+   case label addresses instead of a switch when built with
+   USE_COMPUTED_GOTO by a compiler that supports them (gcc, clang) */
+
+#if defined (USE_COMPUTED_GOTO) && defined (__GNUC__)
+#define SIM_COMPUTED_GOTO       1
+#endif
+
 /* System independent definitions */
 
 #define FLIP_SIZE       (1 << 16)                       /* flip buf size */
@@ -392,6 +400,8 @@ struct sim_device {
 #define DEV_V_SECTORS   7                               /* Unit Capacity is in 512byte sectors */
 #define DEV_V_DONTAUTO  8                               /* Do not auto detach already attached units */
 #define DEV_V_FLATHELP  9                               /* Use traditional (unstructured) help */
+#define DEV_V_RSTPEND   10                              /* power-up reset deferred */
+#define DEV_V_RSTDEFER  11                              /* power-up reset deferrable */
 #define DEV_V_UF_31     12                              /* user flags, V3.1 */
 #define DEV_V_UF        16                              /* user flags */
 #define DEV_V_RSV       31                              /* reserved */
@@ -403,6 +413,8 @@ struct sim_device {
 #define DEV_SECTORS     (1 << DEV_V_SECTORS)            /* capacity is 512 byte sectors */
 #define DEV_DONTAUTO    (1 << DEV_V_DONTAUTO)           /* Do not auto detach already attached units */
 #define DEV_FLATHELP    (1 << DEV_V_FLATHELP)           /* Use traditional (unstructured) help */
+#define DEV_RSTPEND     (1 << DEV_V_RSTPEND)            /* power-up reset not yet done (internal) */
+#define DEV_RSTDEFER    (1 << DEV_V_RSTDEFER)           /* reset touches only this device, can wait while disabled */
 #define DEV_NET         0                               /* Deprecated - meaningless */
 
 
@@ -466,6 +478,7 @@ struct sim_unit {
     double              a_skew;                         /* accumulated skew being corrected */
     double              a_last_fired_time;              /* time last event fired */
     int32               a_usec_delay;                   /* time delay for timer event */
+    int32               a_heap_pos;                     /* wallclock heap slot, 0 if none */
 #endif
     };
 
@@ -747,19 +760,23 @@ extern pthread_mutex_t sim_asynch_lock;
 extern pthread_cond_t sim_asynch_wake;
 extern pthread_mutex_t sim_timer_lock;
 extern pthread_cond_t sim_timer_wake;
-extern t_bool sim_timer_event_canceled;
 extern int32 sim_tmxr_poll_count;
 extern pthread_cond_t sim_tmxr_poll_cond;
 extern pthread_mutex_t sim_tmxr_poll_lock;
 extern pthread_t sim_asynch_main_threadid;
 extern UNIT * volatile sim_asynch_queue;
-extern UNIT * volatile sim_wallclock_queue;
+extern UNIT **sim_wallclock_heap;
+extern int32 sim_wallclock_count;
 extern UNIT * volatile sim_wallclock_entry;
 extern UNIT * volatile sim_clock_cosched_queue;
 extern volatile t_bool sim_idle_wait;
 extern int32 sim_asynch_check;
 extern int32 sim_asynch_latency;
 extern int32 sim_asynch_inst_latency;
+void sim_idle_wake (void);
+t_bool _sim_wallclock_drain (void);
+void _sim_timer_cancel (UNIT *uptr);
+int32 _sim_timer_activate_time (UNIT *uptr);
 
 /* Thread local storage */
 #if defined(__GNUC__) && !defined(__APPLE__) && !defined(__hpux) && !defined(__OpenBSD__) && !defined(_AIX)
@@ -808,54 +825,8 @@ extern int32 sim_asynch_inst_latency;
         (uptr)->a_cancel (uptr);                                  \
     else {                                                        \
         AIO_UPDATE_QUEUE;                                         \
-        if ((uptr)->a_next) {                                     \
-            UNIT *cptr;                                           \
-            pthread_mutex_lock (&sim_timer_lock);                 \
-            if ((uptr) == sim_wallclock_queue) {                  \
-                sim_wallclock_queue = (uptr)->a_next;             \
-                (uptr)->a_next = NULL;                            \
-                sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Timer Event for %s\n", sim_uname(uptr));\
-                sim_timer_event_canceled = TRUE;                  \
-                pthread_cond_signal (&sim_timer_wake);            \
-                }                                                 \
-            else                                                  \
-                for (cptr = sim_wallclock_queue;                  \
-                    (cptr != QUEUE_LIST_END);                     \
-                    cptr = cptr->a_next)                          \
-                    if (cptr->a_next == (uptr)) {                 \
-                        cptr->a_next = (uptr)->a_next;            \
-                        (uptr)->a_next = NULL;                    \
-                        sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Timer Event for %s\n", sim_uname(uptr));\
-                        break;                                    \
-                        }                                         \
-            if ((uptr)->a_next == NULL)                           \
-                (uptr)->a_due_time = (uptr)->a_usec_delay = 0;    \
-            else {                                                \
-                if ((uptr) == sim_clock_cosched_queue) {          \
-                    sim_clock_cosched_queue = (uptr)->a_next;     \
-                    (uptr)->a_next = NULL;                        \
-                    }                                             \
-                else                                              \
-                    for (cptr = sim_clock_cosched_queue;          \
-                        (cptr != QUEUE_LIST_END);                 \
-                        cptr = cptr->a_next)                      \
-                        if (cptr->a_next == (uptr)) {             \
-                            cptr->a_next = (uptr)->a_next;        \
-                            (uptr)->a_next = NULL;                \
-                            break;                                \
-                            }                                     \
-                if ((uptr)->a_next == NULL) {                     \
-                    sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Clock Coscheduling Event for %s\n", sim_uname(uptr));\
-                    }                                             \
-                }                                                 \
-            while (sim_timer_event_canceled) {                    \
-                pthread_mutex_unlock (&sim_timer_lock);           \
-                sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Waiting for Timer Event cancelation for %s\n", sim_uname(uptr));\
-                sim_os_ms_sleep (0);                              \
-                pthread_mutex_lock (&sim_timer_lock);             \
-                }                                                 \
-            pthread_mutex_unlock (&sim_timer_lock);               \
-            }                                                     \
+        if ((uptr)->a_next)                                       \
+            _sim_timer_cancel (uptr);                             \
         }
 #endif
 #if defined(SIM_ASYNCH_MUX) && !defined(SIM_ASYNCH_CLOCKS)
@@ -883,74 +854,17 @@ extern int32 sim_asynch_inst_latency;
             sim_tmxr_poll_count -= (uptr)->a_poll_waiter_count;   \
             (uptr)->a_poll_waiter_count = 0;                      \
             }                                                     \
-        if ((uptr)->a_next) {                                     \
-            UNIT *cptr;                                           \
-            pthread_mutex_lock (&sim_timer_lock);                 \
-            if ((uptr) == sim_wallclock_queue) {                  \
-                sim_wallclock_queue = (uptr)->a_next;             \
-                (uptr)->a_next = NULL;                            \
-                sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Timer Event for %s\n", sim_uname(uptr));\
-                sim_timer_event_canceled = TRUE;                  \
-                pthread_cond_signal (&sim_timer_wake);            \
-                }                                                 \
-            else                                                  \
-                for (cptr = sim_wallclock_queue;                  \
-                    (cptr != QUEUE_LIST_END);                     \
-                    cptr = cptr->a_next)                          \
-                    if (cptr->a_next == (uptr)) {                 \
-                        cptr->a_next = (uptr)->a_next;            \
-                        (uptr)->a_next = NULL;                    \
-                        sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Timer Event for %s\n", sim_uname(uptr));\
-                        break;                                    \
-                        }                                         \
-            if ((uptr)->a_next == NULL)                           \
-                (uptr)->a_due_time = (uptr)->a_usec_delay = 0;    \
-            else {                                                \
-                if ((uptr) == sim_clock_cosched_queue) {          \
-                    sim_clock_cosched_queue = (uptr)->a_next;     \
-                    (uptr)->a_next = NULL;                        \
-                    }                                             \
-                else                                              \
-                    for (cptr = sim_clock_cosched_queue;          \
-                        (cptr != QUEUE_LIST_END);                 \
-                        cptr = cptr->a_next)                      \
-                        if (cptr->a_next == (uptr)) {             \
-                            cptr->a_next = (uptr)->a_next;        \
-                            (uptr)->a_next = NULL;                \
-                            break;                                \
-                            }                                     \
-                if ((uptr)->a_next == NULL) {                     \
-                    sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Clock Coscheduling Event for %s\n", sim_uname(uptr));\
-                    }                                             \
-                }                                                 \
-            while (sim_timer_event_canceled) {                    \
-                pthread_mutex_unlock (&sim_timer_lock);           \
-                sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Waiting for Timer Event cancelation for %s\n", sim_uname(uptr));\
-                sim_os_ms_sleep (0);                              \
-                pthread_mutex_lock (&sim_timer_lock);             \
-                }                                                 \
-            pthread_mutex_unlock (&sim_timer_lock);               \
-            }                                                     \
+        if ((uptr)->a_next)                                       \
+            _sim_timer_cancel (uptr);                             \
         }
 #endif
 #if defined(SIM_ASYNCH_CLOCKS)
 #define AIO_RETURN_TIME(uptr)                                     \
     if (1) {                                                      \
-        pthread_mutex_lock (&sim_timer_lock);                     \
-        for (cptr = sim_wallclock_queue;                          \
-             cptr != QUEUE_LIST_END;                              \
-             cptr = cptr->a_next)                                 \
-            if ((uptr) == cptr) {                                 \
-                double inst_per_sec = sim_timer_inst_per_sec ();  \
-                int32 result;                                     \
+        int32 _result = _sim_timer_activate_time (uptr);          \
                                                                   \
-                result = (int32)(((uptr)->a_due_time - sim_timenow_double())*inst_per_sec);\
-                if (result < 0)                                   \
-                    result = 0;                                   \
-                pthread_mutex_unlock (&sim_timer_lock);           \
-                return result + 1;                                \
-                }                                                 \
-        pthread_mutex_unlock (&sim_timer_lock);                   \
+        if (_result >= 0)                                         \
+            return _result;                                       \
         if ((uptr)->a_next) /* On asynch queue? */                \
             return (uptr)->a_event_time + 1;                      \
         }                                                         \
@@ -1003,8 +917,7 @@ extern int32 sim_asynch_inst_latency;
          This allows NULL in an entry's a_next pointer to         \
          indicate that the entry is not currently in any list */  \
       sim_asynch_queue = QUEUE_LIST_END;                          \
-      sim_wallclock_queue = QUEUE_LIST_END;                       \
-      sim_wallclock_entry = NULL;                                 \
+      sim_wallclock_entry = QUEUE_LIST_END;                       \
       sim_clock_cosched_queue = QUEUE_LIST_END;                   \
       }                                                           \
     else                                                          \
@@ -1082,8 +995,8 @@ extern int32 sim_asynch_inst_latency;
       sim_asynch_check = 0;                             /* try to force check */ \
       if (sim_idle_wait) {                                                       \
         sim_debug (TIMER_DBG_IDLE, &sim_timer_dev, "waking due to event on %s after %d instructions\n", sim_uname(ouptr), event_time);\
-        pthread_cond_signal (&sim_asynch_wake);                                  \
         }                                                                        \
+      sim_idle_wake ();                                                          \
       return SCPE_OK;                                                            \
     } else (void)0
 #define AIO_ACTIVATE_LIST(caller, list, event_time)                              \
@@ -1112,8 +1025,8 @@ extern int32 sim_asynch_inst_latency;
       sim_asynch_check = 0;                             /* try to force check */ \
       if (sim_idle_wait) {                                                       \
         sim_debug (TIMER_DBG_IDLE, &sim_timer_dev, "waking due to event on %s after %d instructions\n", sim_uname(ouptr), event_time);\
-        pthread_cond_signal (&sim_asynch_wake);                                  \
         }                                                                        \
+      sim_idle_wake ();                                                          \
       } else (void)0
 #else /* !USE_AIO_INTRINSICS */
 /* This approach uses a pthread mutex to manage access to the link list     */
@@ -1133,8 +1046,7 @@ extern int32 sim_asynch_inst_latency;
          This allows NULL in an entry's a_next pointer to         \
          indicate that the entry is not currently in any list */  \
       sim_asynch_queue = QUEUE_LIST_END;                          \
-      sim_wallclock_queue = QUEUE_LIST_END;                       \
-      sim_wallclock_entry = NULL;                                 \
+      sim_wallclock_entry = QUEUE_LIST_END;                       \
       sim_clock_cosched_queue = QUEUE_LIST_END;                   \
       }                                                           \
     else                                                          \
@@ -1191,8 +1103,8 @@ extern int32 sim_asynch_inst_latency;
       }                                                                \
       if (sim_idle_wait) {                                             \
         sim_debug (TIMER_DBG_IDLE, &sim_timer_dev, "waking due to event on %s after %d instructions\n", sim_uname(uptr), event_time);\
-        pthread_cond_signal (&sim_asynch_wake);                        \
         }                                                              \
+      sim_idle_wake ();                                                \
       AIO_UNLOCK;                                                      \
       sim_asynch_check = 0;                                            \
       return SCPE_OK;                                                  \
@@ -1214,8 +1126,8 @@ extern int32 sim_asynch_inst_latency;
       sim_asynch_check = 0;                             /* try to force check */ \
       if (sim_idle_wait) {                                                       \
         sim_debug (TIMER_DBG_IDLE, &sim_timer_dev, "waking due to event on %s after %d instructions\n", sim_uname(list), event_time);\
-        pthread_cond_signal (&sim_asynch_wake);                                  \
         }                                                                        \
+      sim_idle_wake ();                                                          \
       AIO_UNLOCK;                                                                \
       } else (void)0
 #endif /* USE_AIO_INTRINSICS */
@@ -50,6 +50,9 @@ Public routines:
    sim_disk_show_capac       show disk capacity
    sim_disk_set_async        enable asynchronous operation
    sim_disk_clr_async        disable asynchronous operation
+   sim_disk_set_cache        configure the sector cache (SET DISKCACHE)
+   sim_disk_show_cache       show sector cache settings and statistics
+   sim_disk_cas_gc           delete unused blocks from a CAS store (CASGC)
    sim_disk_data_trace       debug support
 
 Internal routines:
@@ -69,6 +72,16 @@ Internal routines:
    sim_vhd_disk_rdsect       platform independent read virtual disk sectors
    sim_vhd_disk_wrsect       platform independent write virtual disk sectors
 
+   sim_cas_disk_open         open content addressed disk block map
+   sim_cas_disk_create       create content addressed disk block map
+   sim_cas_disk_close        close content addressed disk
+   sim_cas_disk_size         content addressed disk size
+   sim_cas_disk_rdsect       read content addressed disk sectors
+   sim_cas_disk_wrsect       write content addressed disk sectors
+
+   _sim_disk_cache_attach    give a SIMH format unit a write back cache
+   _sim_disk_cache_detach    write back and release a unit's cache
+   _sim_disk_cache_flush     write back a unit's cache (a barrier)
 
 */
 
@@ -84,6 +97,15 @@ Internal routines:
 #if defined SIM_ASYNCH_IO
 #include <pthread.h>
 #endif
+#if defined (_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#include <dirent.h>
+#endif
+
+struct disk_cache;
 
 struct disk_context {
     DEVICE              *dptr;              /* Device for unit (access to debug flags) */
@@ -94,6 +116,7 @@ struct disk_context {
     uint32              storage_sector_size;/* Sector size of the containing storage */
     uint32              removable;          /* Removable device flag */
     uint32              auto_format;        /* Format determined dynamically */
+    struct disk_cache   *cache;             /* SIMH format sector cache */
 #if defined _WIN32
     HANDLE              disk_handle;        /* OS specific Raw device handle */
 #endif
@@ -290,6 +313,20 @@ static t_stat sim_os_disk_info_raw (FILE *f, uint32 *sector_size, uint32 *remova
 static t_stat sim_disk_pdp11_bad_block (UNIT *uptr, int32 sec);
 static char *HostPathToVhdPath (const char *szHostPath, char *szVhdPath, size_t VhdPathSize);
 static char *VhdPathToHostPath (const char *szVhdPath, char *szHostPath, size_t HostPathSize);
+static FILE *sim_cas_disk_open (const char *mapfilename, const char *openmode);
+static FILE *sim_cas_disk_create (const char *mapfilename, t_offset desiredsize);
+static int sim_cas_disk_close (FILE *f);
+static void sim_cas_disk_flush (FILE *f);
+static t_offset sim_cas_disk_size (FILE *f);
+static t_bool sim_cas_disk_check (const char *mapfilename);
+static t_stat sim_cas_disk_rdsect (UNIT *uptr, t_lba lba, uint8 *buf, t_seccnt *sectsread, t_seccnt sects);
+static t_stat sim_cas_disk_wrsect (UNIT *uptr, t_lba lba, uint8 *buf, t_seccnt *sectswritten, t_seccnt sects);
+static t_stat _dkc_rdsect (struct disk_cache *c, t_lba lba, uint8 *buf, t_seccnt *sectsread, t_seccnt sects);
+static t_stat _dkc_wrsect (struct disk_cache *c, t_lba lba, uint8 *buf, t_seccnt *sectswritten, t_seccnt sects);
+static t_offset _dkc_size (struct disk_cache *c);
+static void _sim_disk_cache_attach (UNIT *uptr);
+static t_stat _sim_disk_cache_detach (UNIT *uptr);
+static t_stat _sim_disk_cache_flush (UNIT *uptr);
 
 struct sim_disk_fmt {
     char                *name;                          /* name */
@@ -302,6 +339,7 @@ static struct sim_disk_fmt fmts[DKUF_N_FMT] = {
     { "SIMH", 0, DKUF_F_STD, NULL},
     { "RAW",  0, DKUF_F_RAW, sim_os_disk_implemented_raw},
     { "VHD",  0, DKUF_F_VHD, sim_vhd_disk_implemented},
+    { "CAS",  0, DKUF_F_CAS, NULL},
     { NULL,   0, 0}
     };
 
@@ -396,6 +434,8 @@ switch (DK_GET_FMT (uptr)) {                            /* case on format */
     case DKUF_F_VHD:                                    /* VHD format */
         return TRUE;
         break;
+    case DKUF_F_CAS:                                    /* Content addressed */
+        return TRUE;
     case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
         return sim_os_disk_isavailable_raw (uptr->fileref);
         break;
@@ -426,10 +466,14 @@ t_offset sim_disk_size (UNIT *uptr)
 {
 switch (DK_GET_FMT (uptr)) {                            /* case on format */
     case DKUF_F_STD:                                    /* SIMH format */
+        if (uptr->disk_ctx && ((struct disk_context *)uptr->disk_ctx)->cache)
+            return _dkc_size (((struct disk_context *)uptr->disk_ctx)->cache);
         return sim_fsize_ex (uptr->fileref);
     case DKUF_F_VHD:                                    /* VHD format */
         return sim_vhd_disk_size (uptr->fileref);
         break;
+    case DKUF_F_CAS:                                    /* Content addressed */
+        return sim_cas_disk_size (uptr->fileref);
     case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
         return sim_os_disk_size_raw (uptr->fileref);
         break;
@@ -515,6 +559,8 @@ struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
 
 sim_debug (ctx->dbit, ctx->dptr, "_sim_disk_rdsect(unit=%d, lba=0x%X, sects=%d)\n", (int)(uptr-ctx->dptr->units), lba, sects);
 
+if (ctx->cache)
+    return _dkc_rdsect (ctx->cache, lba, buf, sectsread, sects);
 da = ((t_offset)lba) * ctx->sector_size;
 tbc = sects * ctx->sector_size;
 if (sectsread)
@@ -556,6 +602,9 @@ if ((0 == (ctx->sector_size & (ctx->storage_sector_size - 1))) ||   /* Sector Al
         case DKUF_F_VHD:                                /* VHD format */
             r = sim_vhd_disk_rdsect (uptr, lba, buf, &sread, sects);
             break;
+        case DKUF_F_CAS:                                /* Content addressed */
+            r = sim_cas_disk_rdsect (uptr, lba, buf, &sread, sects);
+            break;
         case DKUF_F_RAW:                                /* Raw Physical Disk Access */
             r = sim_os_disk_rdsect (uptr, lba, buf, &sread, sects);
             break;
@@ -589,6 +638,11 @@ else { /* Unaligned and/or partial sector transfers */
             if (r == SCPE_OK)
                 sim_buf_swap_data (tbuf, ctx->xfer_element_size, (sread * ctx->sector_size) / ctx->xfer_element_size);
             break;
+        case DKUF_F_CAS:                                /* Content addressed */
+            r = sim_cas_disk_rdsect (uptr, tlba, tbuf, &sread, tsects);
+            if (r == SCPE_OK)
+                sim_buf_swap_data (tbuf, ctx->xfer_element_size, (sread * ctx->sector_size) / ctx->xfer_element_size);
+            break;
         case DKUF_F_RAW:                                /* Raw Physical Disk Access */
             r = sim_os_disk_rdsect (uptr, tlba, tbuf, &sread, tsects);
             if (r == SCPE_OK)
@@ -631,6 +685,8 @@ struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
 
 sim_debug (ctx->dbit, ctx->dptr, "_sim_disk_wrsect(unit=%d, lba=0x%X, sects=%d)\n", (int)(uptr-ctx->dptr->units), lba, sects);
 
+if (ctx->cache)
+    return _dkc_wrsect (ctx->cache, lba, buf, sectswritten, sects);
 da = ((t_offset)lba) * ctx->sector_size;
 tbc = sects * ctx->sector_size;
 if (sectswritten)
@@ -664,6 +720,8 @@ if ((0 == (ctx->sector_size & (ctx->storage_sector_size - 1))) ||   /* Sector Al
         switch (DK_GET_FMT (uptr)) {                            /* case on format */
             case DKUF_F_VHD:                                    /* VHD format */
                 return sim_vhd_disk_wrsect  (uptr, lba, buf, sectswritten, sects);
+            case DKUF_F_CAS:                                    /* Content addressed */
+                return sim_cas_disk_wrsect  (uptr, lba, buf, sectswritten, sects);
             case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
                 return sim_os_disk_wrsect  (uptr, lba, buf, sectswritten, sects);
             default:
@@ -679,6 +737,9 @@ if ((0 == (ctx->sector_size & (ctx->storage_sector_size - 1))) ||   /* Sector Al
         case DKUF_F_VHD:                                    /* VHD format */
             r = sim_vhd_disk_wrsect (uptr, lba, tbuf, sectswritten, sects);
             break;
+        case DKUF_F_CAS:                                    /* Content addressed */
+            r = sim_cas_disk_wrsect (uptr, lba, tbuf, sectswritten, sects);
+            break;
         case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
             r = sim_os_disk_wrsect (uptr, lba, tbuf, sectswritten, sects);
             break;
@@ -705,6 +766,9 @@ else { /* Unaligned and/or partial sector transfers */
             case DKUF_F_VHD:                                    /* VHD format */
                 sim_vhd_disk_rdsect (uptr, tlba, tbuf, NULL, sspsts);
                 break;
+            case DKUF_F_CAS:                                    /* Content addressed */
+                sim_cas_disk_rdsect (uptr, tlba, tbuf, NULL, sspsts);
+                break;
             case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
                 sim_os_disk_rdsect (uptr, tlba, tbuf, NULL, sspsts);
                 break;
@@ -720,6 +784,11 @@ else { /* Unaligned and/or partial sector transfers */
                                      tbuf + (tsects - sspsts) * ctx->sector_size,
                                      NULL, sspsts);
                 break;
+            case DKUF_F_CAS:                                    /* Content addressed */
+                sim_cas_disk_rdsect (uptr, tlba + tsects - sspsts,
+                                     tbuf + (tsects - sspsts) * ctx->sector_size,
+                                     NULL, sspsts);
+                break;
             case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
                 sim_os_disk_rdsect (uptr, tlba + tsects - sspsts,
                                     tbuf + (tsects - sspsts) * ctx->sector_size,
@@ -735,6 +804,9 @@ else { /* Unaligned and/or partial sector transfers */
         case DKUF_F_VHD:                                    /* VHD format */
             r = sim_vhd_disk_wrsect (uptr, tlba, tbuf, sectswritten, tsects);
             break;
+        case DKUF_F_CAS:                                    /* Content addressed */
+            r = sim_cas_disk_wrsect (uptr, tlba, tbuf, sectswritten, tsects);
+            break;
         case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
             r = sim_os_disk_wrsect (uptr, tlba, tbuf, sectswritten, tsects);
             break;
@@ -766,6 +838,7 @@ t_stat sim_disk_unload (UNIT *uptr)
 switch (DK_GET_FMT (uptr)) {                            /* case on format */
     case DKUF_F_STD:                                    /* Simh */
     case DKUF_F_VHD:                                    /* VHD format */
+    case DKUF_F_CAS:                                    /* Content addressed */
         return sim_disk_detach (uptr);
     case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
         return sim_os_disk_unload_raw (uptr->fileref);  /* remove/eject disk */
@@ -782,21 +855,26 @@ switch (DK_GET_FMT (uptr)) {                            /* case on format */
 static void _sim_disk_io_flush (UNIT *uptr)
 {
 uint32 f = DK_GET_FMT (uptr);
-
-#if defined (SIM_ASYNCH_IO)
 struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
 
+#if defined (SIM_ASYNCH_IO)
 sim_disk_clr_async (uptr);
 if (sim_asynch_enabled)
     sim_disk_set_async (uptr, ctx->asynch_io_latency);
 #endif
 switch (f) {                                            /* case on format */
     case DKUF_F_STD:                                    /* Simh */
-        fflush (uptr->fileref);
+        if (ctx->cache)
+            _sim_disk_cache_flush (uptr);
+        else
+            fflush (uptr->fileref);
         break;
     case DKUF_F_VHD:                                    /* Virtual Disk */
         sim_vhd_disk_flush (uptr->fileref);
         break;
+    case DKUF_F_CAS:                                    /* Content addressed */
+        sim_cas_disk_flush (uptr->fileref);
+        break;
     case DKUF_F_RAW:                                    /* Physical */
         sim_os_disk_flush_raw (uptr->fileref);
         break;
@@ -862,11 +940,16 @@ if (sim_switches & SWMASK ('C')) {                      /* create vhd disk & cop
     int32 saved_sim_quiet = sim_quiet;
     uint32 capac_factor;
     t_stat r;
+    t_bool cas = (DK_GET_FMT (uptr) == DKUF_F_CAS);     /* copy into a block map? */
+    char *copy_fmt = cas ? "CAS" : "VHD";
+    int (*copy_close)(FILE *f) = cas ? sim_cas_disk_close : sim_vhd_disk_close;
 
-    sim_switches = sim_switches & ~(SWMASK ('C'));
+    sim_switches = sim_switches & ~(SWMASK ('C') | SWMASK ('F'));
     cptr = get_glyph_nc (cptr, gbuf, 0);                /* get spec */
     if (*cptr == 0)                                     /* must be more */
         return SCPE_2FARG;
+    if (cas)                                            /* source format autodetected */
+        sim_disk_set_fmt (uptr, 0, "SIMH", NULL);
     sim_switches |= SWMASK ('R') | SWMASK ('E');
     sim_quiet = TRUE;
     /* First open the source of the copy operation */
@@ -882,7 +965,10 @@ if (sim_switches & SWMASK ('C')) {                      /* create vhd disk & cop
             fprintf (sim_log, "%s%d: creating new virtual disk '%s'\n", sim_dname (dptr), (int)(uptr-dptr->units), gbuf);
         }
     capac_factor = ((dptr->dwidth / dptr->aincr) == 16) ? 2 : 1; /* capacity units (word: 2, byte: 1) */
-    vhd = sim_vhd_disk_create (gbuf, ((t_offset)uptr->capac)*capac_factor*((dptr->flags & DEV_SECTORS) ? 512 : 1));
+    if (cas)
+        vhd = sim_cas_disk_create (gbuf, ((t_offset)uptr->capac)*capac_factor*((dptr->flags & DEV_SECTORS) ? 512 : 1));
+    else
+        vhd = sim_vhd_disk_create (gbuf, ((t_offset)uptr->capac)*capac_factor*((dptr->flags & DEV_SECTORS) ? 512 : 1));
     if (!vhd) {
         if (!sim_quiet) {
             printf ("%s%d: can't create virtual disk '%s'\n", sim_dname (dptr), (int)(uptr-dptr->units), gbuf);
@@ -899,7 +985,7 @@ if (sim_switches & SWMASK ('C')) {                      /* create vhd disk & cop
         t_seccnt sects = sectors_per_buffer;
 
         if (!copy_buf) {
-            sim_vhd_disk_close(vhd);
+            copy_close (vhd);
             remove (gbuf);
             return SCPE_MEM;
             }
@@ -917,7 +1003,7 @@ if (sim_switches & SWMASK ('C')) {                      /* create vhd disk & cop
                 uint32 saved_unit_flags = uptr->flags;
                 FILE *save_unit_fileref = uptr->fileref;
 
-                sim_disk_set_fmt (uptr, 0, "VHD", NULL);
+                sim_disk_set_fmt (uptr, 0, copy_fmt, NULL);
                 uptr->fileref = vhd;
                 r = sim_disk_wrsect (uptr, lba, copy_buf, NULL, sects);
                 uptr->fileref = save_unit_fileref;
@@ -940,7 +1026,7 @@ if (sim_switches & SWMASK ('C')) {                      /* create vhd disk & cop
             uint8 *verify_buf = (uint8*) malloc (1024*1024);
 
             if (!verify_buf) {
-                sim_vhd_disk_close(vhd);
+                copy_close (vhd);
                 remove (gbuf);
                 free (copy_buf);
                 return SCPE_MEM;
@@ -959,7 +1045,7 @@ if (sim_switches & SWMASK ('C')) {                      /* create vhd disk & cop
                     uint32 saved_unit_flags = uptr->flags;
                     FILE *save_unit_fileref = uptr->fileref;
 
-                    sim_disk_set_fmt (uptr, 0, "VHD", NULL);
+                    sim_disk_set_fmt (uptr, 0, copy_fmt, NULL);
                     uptr->fileref = vhd;
                     r = sim_disk_rdsect (uptr, lba, verify_buf, NULL, sects);
                     uptr->fileref = save_unit_fileref;
@@ -998,13 +1084,13 @@ if (sim_switches & SWMASK ('C')) {                      /* create vhd disk & cop
             free (verify_buf);
             }
         free (copy_buf);
-        sim_vhd_disk_close (vhd);
+        copy_close (vhd);
         sim_disk_detach (uptr);
         if (r == SCPE_OK) {
             created = TRUE;
             copied = TRUE;
             strcpy (cptr, gbuf);
-            sim_disk_set_fmt (uptr, 0, "VHD", NULL);
+            sim_disk_set_fmt (uptr, 0, copy_fmt, NULL);
             sim_switches = saved_sim_switches;
             }
         else
@@ -1032,6 +1118,13 @@ else if (sim_switches & SWMASK ('M')) {                 /* merge difference disk
 
 switch (DK_GET_FMT (uptr)) {                            /* case on format */
     case DKUF_F_STD:                                    /* SIMH format */
+        if (sim_cas_disk_check (cptr)) {                /* block map? */
+            sim_disk_set_fmt (uptr, 0, "CAS", NULL);
+            auto_format = TRUE;
+            open_function = sim_cas_disk_open;
+            size_function = sim_cas_disk_size;
+            break;
+            }
         if (NULL == (uptr->fileref = sim_vhd_disk_open (cptr, "rb"))) {
             open_function = sim_fopen;
             size_function = sim_fsize_ex;
@@ -1052,6 +1145,11 @@ switch (DK_GET_FMT (uptr)) {                            /* case on format */
         size_function = sim_os_disk_size_raw;
         storage_function = sim_os_disk_info_raw;
         break;
+    case DKUF_F_CAS:                                    /* Content addressed */
+        open_function = sim_cas_disk_open;
+        create_function = sim_cas_disk_create;
+        size_function = sim_cas_disk_size;
+        break;
     default:
         return SCPE_IERR;
     }
@@ -1186,6 +1284,7 @@ if (capac && (capac != (t_offset)-1)) {
 sim_disk_set_async (uptr, completion_delay);
 #endif
 uptr->io_flush = _sim_disk_io_flush;
+_sim_disk_cache_attach (uptr);                          /* if SET DISKCACHE */
 
 return SCPE_OK;
 }
@@ -1212,6 +1311,9 @@ switch (DK_GET_FMT (uptr)) {                            /* case on format */
     case DKUF_F_VHD:                                    /* Virtual Disk */
         close_function = sim_vhd_disk_close;
         break;
+    case DKUF_F_CAS:                                    /* Content addressed */
+        close_function = sim_cas_disk_close;
+        break;
     case DKUF_F_RAW:                                    /* Physical */
         close_function = sim_os_disk_close_raw;
         break;
@@ -1230,6 +1332,7 @@ if (uptr->io_flush)
     uptr->io_flush (uptr);                              /* flush buffered data */
 
 sim_disk_clr_async (uptr);
+_sim_disk_cache_detach (uptr);                          /* write back, release */
 
 uptr->flags &= ~(UNIT_ATT | UNIT_RO);
 uptr->dynflags &= ~UNIT_NO_FIO;
@@ -1250,14 +1353,16 @@ t_stat sim_disk_attach_help(FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char
 {
 fprintf (st, "%s Disk Attach Help\n\n", dptr->name);
 
-fprintf (st, "Disk container files can be one of 3 different types:\n\n");
+fprintf (st, "Disk container files can be one of 4 different types:\n\n");
 fprintf (st, "    SIMH   A disk is an unstructured binary file of the size appropriate\n");
 fprintf (st, "           for the disk drive being simulated\n");
 fprintf (st, "    VHD    Virtual Disk format which is described in the \"Microsoft\n");
 fprintf (st, "           Virtual Hard Disk (VHD) Image Format Specification\".  The\n");
 fprintf (st, "           VHD implementation includes support for 1) Fixed (Preallocated)\n");
 fprintf (st, "           disks, 2) Dynamically Expanding disks, and 3) Differencing disks.\n");
-fprintf (st, "    RAW    platform specific access to physical disk or CDROM drives\n\n");
+fprintf (st, "    RAW    platform specific access to physical disk or CDROM drives\n");
+fprintf (st, "    CAS    A per-unit block map onto a content addressed store of disk\n");
+fprintf (st, "           blocks that is shared by all disks which use the same store.\n\n");
 fprintf (st, "Virtual (VHD) Disks  supported conform to \"Virtual Hard Disk Image Format\n");
 fprintf (st, "Specification\", Version 1.0 October 11, 2006.\n");
 fprintf (st, "Dynamically expanding disks never change their \"Virtual Size\", but they don't\n");
@@ -1269,6 +1374,18 @@ fprintf (st, "which describes the drive size and the simh device type in use whe
 fprintf (st, "was created.  This metadata is therefore available whenever that VHD is\n");
 fprintf (st, "attached to an emulated disk device in the future so the device type and\n");
 fprintf (st, "size can be automatically be configured.\n\n");
+fprintf (st, "Content addressed (CAS) disks keep only a map in the attached file.  The data\n");
+fprintf (st, "lives in a store directory, one file per distinct 64KB block, named by the\n");
+fprintf (st, "SHA-256 hash of its contents.  Identical blocks written by any disk using the\n");
+fprintf (st, "store are kept once, and writes never modify a stored block, so many copies\n");
+fprintf (st, "of one system disk cost little more than one.  A new map uses the store\n");
+fprintf (st, "named by the SIMH_DISK_STORE environment variable, or else a simh-store\n");
+fprintf (st, "directory next to the map.\n");
+fprintf (st, "  sim> att rq0 -c -f cas node1.cas system.dsk\n\n");
+fprintf (st, "Blocks that no map uses any longer are only removed by the CASGC command,\n");
+fprintf (st, "which must be given every map that uses the store, and be run while no\n");
+fprintf (st, "simulator is using it:\n");
+fprintf (st, "  sim> casgc node1.cas node2.cas\n\n");
 
 if (0 == (uptr-dptr->units)) {
     if (dptr->numunits > 1) {
@@ -1292,6 +1409,7 @@ fprintf (st, "                is to autodetect VHD defaulting to simh if the ind
 fprintf (st, "                container is not a VHD).\n");
 fprintf (st, "    -C          Create a VHD and copy its contents from another disk (simh, VHD,\n");
 fprintf (st, "                or RAW format). Add a -V switch to verify a copy operation.\n");
+fprintf (st, "                With -F CAS, a CAS block map is created instead of a VHD.\n");
 fprintf (st, "    -V          Perform a verification pass to confirm successful data copy\n");
 fprintf (st, "                operation.\n");
 fprintf (st, "    -X          When creating a VHD, create a fixed sized VHD (vs a Dynamically\n");
@@ -1387,6 +1505,7 @@ switch (DK_GET_FMT (uptr)) {                            /* case on format */
     case DKUF_F_STD:                                    /* SIMH format */
     case DKUF_F_VHD:                                    /* VHD format */
     case DKUF_F_RAW:                                    /* Raw Physical Disk Access */
+    case DKUF_F_CAS:                                    /* Content addressed */
         perror (msg);
     default:
         ;
@@ -3947,3 +4066,1286 @@ struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
 return WriteVirtualDiskSectors(hVHD, buf, sects, sectswritten, ctx->sector_size, lba);
 }
 #endif
+
+/* Content addressed (CAS) disk support
+
+   A CAS disk is a block map.  The attached file holds a header and, for
+   each CAS_BLKSIZE block of the simulated disk, the SHA-256 digest of the
+   block's contents; the contents live in a store directory as files named
+   by their digest.  A block that has never been written (or is all zero)
+   has a zero digest and no file.  Stored blocks are never rewritten:
+   a write builds the new contents of the block, stores them under their
+   own digest if that file is not already present, and points the map at
+   it.  Disks made from the same image and sharing a store therefore share
+   all their unchanged blocks, on the host disk and in the host page cache.
+
+   Each unit buffers up to CAS_NBUF blocks, reusing the least recently
+   used buffer.  A modified block is committed only when its buffer is
+   reused, and at flush and detach, so writes scattered over a working
+   set of blocks store one new block per block per flush, rather than one
+   each time I/O moves to another block.
+
+   A new store file is written under a temporary name, fsync'ed and only
+   then renamed to its digest, so a store file with a digest name is
+   always complete; one found short (left by an older or interrupted
+   writer) is replaced rather than reused.  Flush and detach sync the
+   store directory and then the map, so the map on disk never names a
+   block that is not on disk.
+
+   Blocks that no map uses any longer stay in the store until the offline
+   CASGC command removes them.
+
+   Map file layout (little endian):
+
+        0       8       CAS_MAGIC
+        8       4       version
+        12      4       block size
+        16      8       disk size in bytes
+        24      4       number of blocks
+        28      4       reserved
+        32      480     store directory, NUL terminated; relative to the
+                        directory holding the map unless absolute
+        512     32*n    block digests
+*/
+
+#define CAS_MAGIC       "SIMHCAS"                       /* including the NUL */
+#define CAS_VERSION     1
+#define CAS_HDRSIZE     512
+#define CAS_V_STORE     32                              /* store name offset */
+#define CAS_BLKSIZE     (64 * 1024)                     /* default block size */
+#define CAS_DGSIZE      32                              /* SHA-256 digest size */
+#define CAS_STORE       "simh-store"                    /* default store name */
+#define CAS_NBUF        16                              /* blocks buffered per unit */
+
+struct cas_buf {
+    uint8               *data;              /* contents, NULL until used */
+    uint32              blk;                /* block number, nblks if none */
+    uint32              used;               /* last use, for LRU */
+    t_bool              dirty;              /* modified */
+    };
+
+struct cas_disk {
+    FILE                *map;               /* block map file */
+    char                store[CBUFSIZE];    /* store directory */
+    uint32              blksize;            /* block size */
+    uint32              nblks;              /* number of blocks */
+    t_offset            size;               /* disk size */
+    uint8               *digests;           /* block digests */
+    struct cas_buf      buf[CAS_NBUF];      /* block buffers */
+    uint32              clock;              /* buffer use counter */
+    };
+
+typedef struct cas_disk *CASHANDLE;
+
+static const uint8 cas_zero_digest[CAS_DGSIZE] = { 0 };
+
+/* SHA-256, per FIPS 180-4 */
+
+static const uint32 cas_sha_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+#define CAS_ROR(x,n)    (((x) >> (n)) | ((x) << (32 - (n))))
+
+static void cas_sha256_block (uint32 *h, const uint8 *p)
+{
+uint32 w[64], a, b, c, d, e, f, g, k, t1, t2;
+int i;
+
+for (i = 0; i < 16; i++)
+    w[i] = ((uint32)p[4*i] << 24) | ((uint32)p[4*i+1] << 16) | ((uint32)p[4*i+2] << 8) | p[4*i+3];
+for (i = 16; i < 64; i++)
+    w[i] = w[i-16] + (CAS_ROR (w[i-15], 7) ^ CAS_ROR (w[i-15], 18) ^ (w[i-15] >> 3)) +
+           w[i-7] + (CAS_ROR (w[i-2], 17) ^ CAS_ROR (w[i-2], 19) ^ (w[i-2] >> 10));
+a = h[0]; b = h[1]; c = h[2]; d = h[3];
+e = h[4]; f = h[5]; g = h[6]; k = h[7];
+for (i = 0; i < 64; i++) {
+    t1 = k + (CAS_ROR (e, 6) ^ CAS_ROR (e, 11) ^ CAS_ROR (e, 25)) + ((e & f) ^ (~e & g)) + cas_sha_k[i] + w[i];
+    t2 = (CAS_ROR (a, 2) ^ CAS_ROR (a, 13) ^ CAS_ROR (a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+    k = g; g = f; f = e; e = d + t1;
+    d = c; c = b; b = a; a = t1 + t2;
+    }
+h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+h[4] += e; h[5] += f; h[6] += g; h[7] += k;
+}
+
+static void cas_sha256 (const uint8 *data, uint32 len, uint8 *digest)
+{
+uint32 h[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+uint8 tail[128];
+uint32 i, n = len & ~63, tlen;
+
+for (i = 0; i < n; i += 64)
+    cas_sha256_block (h, data + i);
+memset (tail, 0, sizeof (tail));
+memcpy (tail, data + n, len - n);
+tail[len - n] = 0x80;
+tlen = ((len - n) < 56) ? 64 : 128;
+tail[tlen - 5] = (uint8)(len >> 29);                    /* length in bits */
+tail[tlen - 4] = (uint8)(len >> 21);
+tail[tlen - 3] = (uint8)(len >> 13);
+tail[tlen - 2] = (uint8)(len >> 5);
+tail[tlen - 1] = (uint8)(len << 3);
+for (i = 0; i < tlen; i += 64)
+    cas_sha256_block (h, tail + i);
+for (i = 0; i < 8; i++) {
+    digest[4*i]   = (uint8)(h[i] >> 24);
+    digest[4*i+1] = (uint8)(h[i] >> 16);
+    digest[4*i+2] = (uint8)(h[i] >> 8);
+    digest[4*i+3] = (uint8)h[i];
+    }
+}
+
+static void cas_put (uint8 *p, t_offset v, int n)
+{
+int i;
+
+for (i = 0; i < n; i++) {
+    p[i] = (uint8)(v & 0xFF);
+    v = v >> 8;
+    }
+}
+
+static t_offset cas_get (const uint8 *p, int n)
+{
+t_offset v = 0;
+
+while (n-- > 0)
+    v = (v << 8) | p[n];
+return v;
+}
+
+/* Path of the store file holding the block with the given digest */
+
+static void cas_block_path (CASHANDLE hCAS, const uint8 *digest, char *path)
+{
+int i;
+
+sprintf (path, "%s/", hCAS->store);
+path = path + strlen (path);
+for (i = 0; i < CAS_DGSIZE; i++)
+    sprintf (path + 2*i, "%02x", digest[i]);
+}
+
+static void cas_mkdir (const char *path)
+{
+#if defined (_WIN32)
+CreateDirectoryA (path, NULL);
+#else
+mkdir (path, 0777);
+#endif
+}
+
+/* Flush a file through to the host disk; returns 0 or EOF */
+
+static int cas_sync (FILE *f)
+{
+if (fflush (f) == EOF)
+    return EOF;
+#if defined (_WIN32)
+if (_commit (_fileno (f)))
+    return EOF;
+#elif !defined (VMS)
+if (fsync (fileno (f)))
+    return EOF;
+#endif
+return 0;
+}
+
+/* Sync the store directory, so that renamed block files are on disk */
+
+static void cas_sync_store (CASHANDLE hCAS)
+{
+#if !defined (_WIN32) && !defined (VMS)
+int fd = open (hCAS->store, O_RDONLY);
+
+if (fd >= 0) {
+    fsync (fd);
+    close (fd);
+    }
+#endif
+}
+
+/* Is the block at path in the store, complete? */
+
+static t_bool cas_stored (CASHANDLE hCAS, char *path)
+{
+return (sim_fsize_name_ex (path) == (t_offset)hCAS->blksize);
+}
+
+/* Store a modified block and point the map at it */
+
+static t_stat cas_commit (CASHANDLE hCAS, struct cas_buf *b)
+{
+uint8 digest[CAS_DGSIZE];
+char path[CBUFSIZE + 2*CAS_DGSIZE + 16], tmp[CBUFSIZE + 2*CAS_DGSIZE + 48];
+uint32 i;
+t_bool ok;
+FILE *f;
+
+if (!b->dirty)
+    return SCPE_OK;
+for (i = 0; (i < hCAS->blksize) && (b->data[i] == 0); i++)
+    ;
+if (i == hCAS->blksize)                                 /* all zero? */
+    memset (digest, 0, sizeof (digest));
+else {
+    cas_sha256 (b->data, hCAS->blksize, digest);
+    cas_block_path (hCAS, digest, path);
+    if (!cas_stored (hCAS, path)) {                     /* not stored (intact)? */
+        sprintf (tmp, "%s.%08X%08X", path, (uint32)sim_os_msec (), (uint32)(size_t)hCAS);
+        if ((f = sim_fopen (tmp, "wb")) == NULL)
+            return SCPE_IOERR;
+        ok = ((sim_fwrite (b->data, 1, hCAS->blksize, f) == hCAS->blksize) &&
+              (cas_sync (f) == 0));                     /* on disk before it's named */
+        if ((fclose (f) == EOF) || !ok) {
+            remove (tmp);
+            return SCPE_IOERR;
+            }
+        if (rename (tmp, path)) {                       /* not renamed? */
+            if (cas_stored (hCAS, path))                /* another writer beat us */
+                remove (tmp);
+            else {                                      /* short file in the way */
+                remove (path);
+                if (rename (tmp, path)) {
+                    remove (tmp);
+                    return SCPE_IOERR;
+                    }
+                }
+            }
+        }
+    }
+memcpy (hCAS->digests + (size_t)b->blk * CAS_DGSIZE, digest, CAS_DGSIZE);
+if (sim_fseeko (hCAS->map, CAS_HDRSIZE + (t_offset)b->blk * CAS_DGSIZE, SEEK_SET) ||
+    (sim_fwrite (digest, 1, CAS_DGSIZE, hCAS->map) != CAS_DGSIZE))
+    return SCPE_IOERR;
+b->dirty = FALSE;
+return SCPE_OK;
+}
+
+/* Store all modified blocks, in block order */
+
+static t_stat cas_commit_all (CASHANDLE hCAS)
+{
+struct cas_buf *b, *next;
+t_stat r = SCPE_OK;
+uint32 lo = 0;
+int i;
+
+for ( ;; ) {
+    for (i = 0, next = NULL; i < CAS_NBUF; i++) {       /* lowest dirty >= lo */
+        b = &hCAS->buf[i];
+        if (b->dirty && (b->blk >= lo) &&
+            ((next == NULL) || (b->blk < next->blk)))
+            next = b;
+        }
+    if (next == NULL)
+        return r;
+    if (cas_commit (hCAS, next) != SCPE_OK)             /* stays dirty */
+        r = SCPE_IOERR;
+    lo = next->blk + 1;
+    }
+}
+
+/* Find the buffer holding block blk, or reuse the least recently used one
+   for it; the contents are only read if load is set.  NULL on error. */
+
+static struct cas_buf *cas_select (CASHANDLE hCAS, uint32 blk, t_bool load)
+{
+const uint8 *digest = hCAS->digests + (size_t)blk * CAS_DGSIZE;
+char path[CBUFSIZE + 2*CAS_DGSIZE + 16];
+struct cas_buf *b, *lru = NULL;
+size_t n = 0;
+FILE *f;
+int i;
+
+for (i = 0; i < CAS_NBUF; i++) {
+    b = &hCAS->buf[i];
+    if (b->blk == blk) {                                /* buffered? */
+        b->used = ++hCAS->clock;
+        return b;
+        }
+    if ((lru == NULL) || (b->used < lru->used))
+        lru = b;
+    }
+b = lru;
+if (cas_commit (hCAS, b) != SCPE_OK)                    /* store old contents */
+    return NULL;
+b->blk = hCAS->nblks;
+if ((b->data == NULL) &&
+    ((b->data = (uint8 *)malloc (hCAS->blksize)) == NULL))
+    return NULL;
+if (load && memcmp (digest, cas_zero_digest, CAS_DGSIZE)) {
+    cas_block_path (hCAS, digest, path);
+    if ((f = sim_fopen (path, "rb")) == NULL)
+        return NULL;
+    n = sim_fread (b->data, 1, hCAS->blksize, f);
+    fclose (f);
+    if (n != hCAS->blksize)
+        return NULL;
+    }
+else
+    memset (b->data, 0, hCAS->blksize);
+b->blk = blk;
+b->used = ++hCAS->clock;
+return b;
+}
+
+static t_bool sim_cas_disk_check (const char *mapfilename)
+{
+char magic[sizeof (CAS_MAGIC)];
+t_bool r = FALSE;
+FILE *f;
+
+if ((f = sim_fopen (mapfilename, "rb")) == NULL)
+    return FALSE;
+if ((sim_fread (magic, 1, sizeof (magic), f) == sizeof (magic)) &&
+    (0 == memcmp (magic, CAS_MAGIC, sizeof (magic))))
+    r = TRUE;
+fclose (f);
+return r;
+}
+
+static FILE *sim_cas_disk_open (const char *mapfilename, const char *openmode)
+{
+CASHANDLE hCAS = (CASHANDLE)calloc (1, sizeof (*hCAS));
+uint8 hdr[CAS_HDRSIZE];
+char *c, *d;
+size_t n;
+int i;
+
+if (hCAS == NULL)
+    return NULL;
+if ((hCAS->map = sim_fopen (mapfilename, openmode)) == NULL) {
+    free (hCAS);
+    return NULL;
+    }
+if ((sim_fread (hdr, 1, sizeof (hdr), hCAS->map) != sizeof (hdr)) ||
+    memcmp (hdr, CAS_MAGIC, sizeof (CAS_MAGIC)) ||
+    (cas_get (hdr + 8, 4) != CAS_VERSION))
+    goto Error;
+hCAS->blksize = (uint32)cas_get (hdr + 12, 4);
+hCAS->size = cas_get (hdr + 16, 8);
+hCAS->nblks = (uint32)cas_get (hdr + 24, 4);
+hdr[CAS_HDRSIZE - 1] = '\0';
+if ((hCAS->blksize < 512) || (hCAS->blksize > 16*1024*1024) ||
+    (((t_offset)hCAS->nblks) * hCAS->blksize < hCAS->size))
+    goto Error;
+hCAS->store[0] = '\0';
+if ((hdr[CAS_V_STORE] != '/') && (hdr[CAS_V_STORE] != '\\') &&  /* relative store? */
+    (strchr ((char *)hdr + CAS_V_STORE, ':') == NULL)) {
+    strncpy (hCAS->store, mapfilename, sizeof (hCAS->store) - 1);
+    c = strrchr (hCAS->store, '/');
+    d = strrchr (hCAS->store, '\\');
+    if ((c == NULL) || (d && (d > c)))
+        c = d;
+    if (c)
+        c[1] = '\0';
+    else
+        hCAS->store[0] = '\0';
+    }
+n = strlen (hCAS->store);
+strncpy (hCAS->store + n, (char *)hdr + CAS_V_STORE, sizeof (hCAS->store) - n - 1);
+hCAS->digests = (uint8 *)malloc ((size_t)hCAS->nblks * CAS_DGSIZE);
+if (hCAS->digests == NULL)
+    goto Error;
+if (sim_fread (hCAS->digests, CAS_DGSIZE, hCAS->nblks, hCAS->map) != hCAS->nblks)
+    goto Error;
+for (i = 0; i < CAS_NBUF; i++)                          /* nothing buffered */
+    hCAS->buf[i].blk = hCAS->nblks;
+return (FILE *)hCAS;
+
+Error:
+fclose (hCAS->map);
+free (hCAS->digests);
+free (hCAS);
+return NULL;
+}
+
+static FILE *sim_cas_disk_create (const char *mapfilename, t_offset desiredsize)
+{
+uint8 hdr[CAS_HDRSIZE], *digests;
+const char *store = getenv ("SIMH_DISK_STORE");
+uint32 nblks = (uint32)((desiredsize + CAS_BLKSIZE - 1) / CAS_BLKSIZE);
+CASHANDLE hCAS;
+FILE *f;
+
+if ((store == NULL) || (*store == '\0'))
+    store = CAS_STORE;
+if (strlen (store) >= CAS_HDRSIZE - CAS_V_STORE)
+    return NULL;
+if ((f = sim_fopen (mapfilename, "rb")) != NULL) {      /* don't overwrite */
+    fclose (f);
+    return NULL;
+    }
+if ((f = sim_fopen (mapfilename, "wb")) == NULL)
+    return NULL;
+memset (hdr, 0, sizeof (hdr));
+memcpy (hdr, CAS_MAGIC, sizeof (CAS_MAGIC));
+cas_put (hdr + 8, CAS_VERSION, 4);
+cas_put (hdr + 12, CAS_BLKSIZE, 4);
+cas_put (hdr + 16, desiredsize, 8);
+cas_put (hdr + 24, nblks, 4);
+strcpy ((char *)hdr + CAS_V_STORE, store);
+digests = (uint8 *)calloc (nblks ? nblks : 1, CAS_DGSIZE);
+if ((digests == NULL) ||
+    (sim_fwrite (hdr, 1, sizeof (hdr), f) != sizeof (hdr)) ||
+    (sim_fwrite (digests, CAS_DGSIZE, nblks, f) != nblks)) {
+    free (digests);
+    fclose (f);
+    remove (mapfilename);
+    return NULL;
+    }
+free (digests);
+if (fclose (f) == EOF) {
+    remove (mapfilename);
+    return NULL;
+    }
+hCAS = (CASHANDLE)sim_cas_disk_open (mapfilename, "rb+");
+if (hCAS == NULL) {
+    remove (mapfilename);
+    return NULL;
+    }
+cas_mkdir (hCAS->store);                                /* make sure the store exists */
+return (FILE *)hCAS;
+}
+
+static void sim_cas_disk_flush (FILE *f)
+{
+CASHANDLE hCAS = (CASHANDLE)f;
+
+if (hCAS == NULL)
+    return;
+cas_commit_all (hCAS);
+cas_sync_store (hCAS);
+cas_sync (hCAS->map);
+}
+
+static int sim_cas_disk_close (FILE *f)
+{
+CASHANDLE hCAS = (CASHANDLE)f;
+int i, r = 0;
+
+if (hCAS == NULL)
+    return -1;
+if (cas_commit_all (hCAS) != SCPE_OK)
+    r = EOF;
+cas_sync_store (hCAS);
+if (cas_sync (hCAS->map) == EOF)
+    r = EOF;
+if (fclose (hCAS->map) == EOF)
+    r = EOF;
+for (i = 0; i < CAS_NBUF; i++)
+    free (hCAS->buf[i].data);
+free (hCAS->digests);
+free (hCAS);
+return r;
+}
+
+static t_offset sim_cas_disk_size (FILE *f)
+{
+CASHANDLE hCAS = (CASHANDLE)f;
+
+return hCAS->size;
+}
+
+static t_stat sim_cas_disk_rdsect (UNIT *uptr, t_lba lba, uint8 *buf, t_seccnt *sectsread, t_seccnt sects)
+{
+CASHANDLE hCAS = (CASHANDLE)uptr->fileref;
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+t_offset da = ((t_offset)lba) * ctx->sector_size;
+uint32 len = sects * ctx->sector_size, off, n;
+struct cas_buf *b;
+
+if (sectsread)
+    *sectsread = 0;
+while (len > 0) {
+    if (da >= ((t_offset)hCAS->nblks) * hCAS->blksize) {/* past the map? */
+        memset (buf, 0, len);
+        break;
+        }
+    off = (uint32)(da % hCAS->blksize);
+    n = hCAS->blksize - off;
+    if (n > len)
+        n = len;
+    if ((b = cas_select (hCAS, (uint32)(da / hCAS->blksize), TRUE)) == NULL)
+        return SCPE_IOERR;
+    memcpy (buf, b->data + off, n);
+    buf = buf + n;
+    da = da + n;
+    len = len - n;
+    }
+if (sectsread)
+    *sectsread = sects;
+return SCPE_OK;
+}
+
+static t_stat sim_cas_disk_wrsect (UNIT *uptr, t_lba lba, uint8 *buf, t_seccnt *sectswritten, t_seccnt sects)
+{
+CASHANDLE hCAS = (CASHANDLE)uptr->fileref;
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+t_offset da = ((t_offset)lba) * ctx->sector_size;
+uint32 len = sects * ctx->sector_size, off, n, done = 0;
+struct cas_buf *b;
+
+if (sectswritten)
+    *sectswritten = 0;
+while (len > 0) {
+    if (da >= ((t_offset)hCAS->nblks) * hCAS->blksize)  /* past the map? */
+        return SCPE_IOERR;
+    off = (uint32)(da % hCAS->blksize);
+    n = hCAS->blksize - off;
+    if (n > len)
+        n = len;
+    if ((b = cas_select (hCAS, (uint32)(da / hCAS->blksize), (n != hCAS->blksize))) == NULL)
+        return SCPE_IOERR;
+    memcpy (b->data + off, buf, n);
+    b->dirty = TRUE;
+    buf = buf + n;
+    da = da + n;
+    len = len - n;
+    done = done + n;
+    if (sectswritten)
+        *sectswritten = done / ctx->sector_size;
+    }
+return SCPE_OK;
+}
+
+/* CASGC map {map ...}
+
+   Offline garbage collection of a CAS store.  Deletes each block file in
+   the store used by the listed maps that none of them refers to, and the
+   temporary files of interrupted writers.  All the maps must use the same
+   store, every map that uses it must be listed, and no other simulator
+   may be using it while this runs; a unit of this simulator attached to
+   it is refused.
+*/
+
+static int cas_digest_cmp (const void *a, const void *b)
+{
+return memcmp (a, b, CAS_DGSIZE);
+}
+
+static int cas_hex (char c)
+{
+if ((c >= '0') && (c <= '9'))
+    return c - '0';
+if ((c >= 'a') && (c <= 'f'))
+    return c - 'a' + 10;
+return -1;
+}
+
+/* Classify a store file name: 1 = block (digest set), 2 = temporary, 0 = other */
+
+static int cas_name (const char *name, uint8 *digest)
+{
+int i, h, l;
+
+for (i = 0; i < CAS_DGSIZE; i++) {
+    if (((h = cas_hex (name[2*i])) < 0) || ((l = cas_hex (name[2*i+1])) < 0))
+        return 0;
+    digest[i] = (uint8)((h << 4) | l);
+    }
+if (name[2*CAS_DGSIZE] == '\0')
+    return 1;
+return (name[2*CAS_DGSIZE] == '.')? 2: 0;
+}
+
+/* Delete one store file if it is a temporary or an unused block */
+
+static void cas_gc_file (const char *store, const char *name, uint8 *refs,
+                         size_t nrefs, uint32 *counts, t_offset *freed)
+{
+uint8 digest[CAS_DGSIZE];
+char path[CBUFSIZE + 2*CAS_DGSIZE + 48];
+int kind = cas_name (name, digest);
+t_offset size;
+
+if ((kind == 0) || (strlen (store) + strlen (name) + 2 > sizeof (path)))
+    return;
+if ((kind == 1) &&
+    bsearch (digest, refs, nrefs, CAS_DGSIZE, &cas_digest_cmp)) {
+    counts[0]++;                                        /* in use, kept */
+    return;
+    }
+sprintf (path, "%s/%s", store, name);
+size = sim_fsize_name_ex (path);
+if (remove (path) == 0) {
+    counts[kind]++;                                     /* blocks, temps */
+    *freed = *freed + size;
+    }
+}
+
+t_stat sim_disk_cas_gc (int32 flag, char *cptr)
+{
+char gbuf[CBUFSIZE], store[CBUFSIZE];
+uint8 *refs = NULL, *nrefs;
+size_t n = 0, i;
+uint32 counts[3] = { 0, 0, 0 };
+t_offset freed = 0;
+CASHANDLE hCAS;
+DEVICE *dptr;
+UNIT *uptr;
+uint32 d, u;
+#if defined (_WIN32)
+WIN32_FIND_DATAA File;
+HANDLE hFind;
+#else
+struct dirent *ent;
+DIR *dir;
+#endif
+
+if ((cptr == NULL) || (*cptr == 0))
+    return SCPE_2FARG;
+store[0] = '\0';
+while (*cptr != 0) {                                    /* collect digests */
+    cptr = get_glyph_nc (cptr, gbuf, 0);
+    if (!sim_cas_disk_check (gbuf) ||
+        ((hCAS = (CASHANDLE)sim_cas_disk_open (gbuf, "rb")) == NULL)) {
+        printf ("%s: not a CAS disk map\n", gbuf);
+        if (sim_log)
+            fprintf (sim_log, "%s: not a CAS disk map\n", gbuf);
+        free (refs);
+        return SCPE_OPENERR;
+        }
+    if (store[0] == '\0')
+        strcpy (store, hCAS->store);
+    if (strcmp (store, hCAS->store) != 0) {
+        printf ("%s: uses store %s, not %s\n", gbuf, hCAS->store, store);
+        if (sim_log)
+            fprintf (sim_log, "%s: uses store %s, not %s\n", gbuf, hCAS->store, store);
+        sim_cas_disk_close ((FILE *)hCAS);
+        free (refs);
+        return SCPE_ARG;
+        }
+    nrefs = (uint8 *)realloc (refs, (n + hCAS->nblks + 1) * CAS_DGSIZE);
+    if (nrefs == NULL) {
+        sim_cas_disk_close ((FILE *)hCAS);
+        free (refs);
+        return SCPE_MEM;
+        }
+    refs = nrefs;
+    memcpy (refs + n * CAS_DGSIZE, hCAS->digests, (size_t)hCAS->nblks * CAS_DGSIZE);
+    n = n + hCAS->nblks;
+    sim_cas_disk_close ((FILE *)hCAS);
+    }
+for (d = 0; (dptr = sim_devices[d]) != NULL; d++) {     /* store in use here? */
+    for (u = 0; u < dptr->numunits; u++) {
+        uptr = &dptr->units[u];
+        if ((uptr->flags & UNIT_ATT) &&
+            (uptr->io_flush == _sim_disk_io_flush) &&
+            (DK_GET_FMT (uptr) == DKUF_F_CAS) &&
+            (strcmp (((CASHANDLE)uptr->fileref)->store, store) == 0)) {
+            printf ("Store %s is in use by %s\n", store, sim_uname (uptr));
+            if (sim_log)
+                fprintf (sim_log, "Store %s is in use by %s\n", store, sim_uname (uptr));
+            free (refs);
+            return SCPE_ALATT;
+            }
+        }
+    }
+qsort (refs, n, CAS_DGSIZE, &cas_digest_cmp);
+for (i = 0; (i < n) && (memcmp (refs + i * CAS_DGSIZE, cas_zero_digest, CAS_DGSIZE) == 0); i++)
+    ;                                                   /* skip zero blocks */
+#if defined (_WIN32)
+sprintf (gbuf, "%s\\*", store);
+if ((hFind = FindFirstFileA (gbuf, &File)) != INVALID_HANDLE_VALUE) {
+    do {
+        cas_gc_file (store, File.cFileName, refs + i * CAS_DGSIZE, n - i, counts, &freed);
+        } while (FindNextFileA (hFind, &File));
+    FindClose (hFind);
+    }
+#else
+if ((dir = opendir (store)) != NULL) {
+    while ((ent = readdir (dir)) != NULL)
+        cas_gc_file (store, ent->d_name, refs + i * CAS_DGSIZE, n - i, counts, &freed);
+    closedir (dir);
+    }
+#endif
+else {
+    free (refs);
+    return SCPE_OPENERR;
+    }
+free (refs);
+printf ("Store %s: %u blocks in use, %u unused blocks and %u temporary files deleted, %" LL_FMT "dKB freed\n",
+        store, counts[0], counts[1], counts[2], (t_int64)(freed / 1024));
+if (sim_log)
+    fprintf (sim_log, "Store %s: %u blocks in use, %u unused blocks and %u temporary files deleted, %" LL_FMT "dKB freed\n",
+             store, counts[0], counts[1], counts[2], (t_int64)(freed / 1024));
+return SCPE_OK;
+}
+
+/* Disk sector cache
+
+   SET DISKCACHE gives each SIMH format disk unit a private write back
+   cache of host memory.  The cache is 4 way set associative; a line
+   holds DKC_LSECTS consecutive sectors, with one bit per sector in a
+   valid mask and in a dirty mask.  A read miss loads the whole line,
+   which serves as read ahead for the sequential transfers most guest
+   file systems issue; a write only marks the sectors written, so
+   whole line overwrites never read the container file.
+
+   Dirty sectors are written back when their line is evicted, and in a
+   flush, which sorts the dirty lines by disk address and merges adjacent
+   dirty runs (across lines) into transfers of up to DKC_STAGE bytes.
+   A flush happens:
+
+        - when the simulator stops and at detach (a durability barrier:
+          the container is also fflush'ed, and fsync'ed with SYNC),
+        - when dirty data has been held for the FLUSH interval.  With
+          asynchronous I/O available a background thread does this;
+          otherwise it is checked at each cached write.
+
+   All STD I/O of a cached unit goes through the cache, under the cache
+   lock, so the flush thread, the disk I/O thread and the simulator see
+   one consistent image.  Caches exist only while attached units are in
+   SIMH format; UNIT_BUF devices already hold their whole image in memory
+   and are not affected.
+*/
+
+#define DKC_LSECTS      64                              /* sectors per line */
+#define DKC_WAYS        4                               /* lines per set */
+#define DKC_STAGE       (1024 * 1024)                   /* max coalesced write */
+#define DKC_MINSIZE     (64 * 1024)                     /* cache size limits */
+#define DKC_MAXSIZE     (1024 * 1024 * 1024)
+#define DKC_NOLINE      ((t_lba) 0xFFFFFFFF)            /* empty line tag */
+
+struct disk_cache_line {
+    t_lba               line;                           /* lba / DKC_LSECTS */
+    t_uint64            valid;                          /* sectors present */
+    t_uint64            dirty;                          /* sectors to write back */
+    uint32              used;                           /* LRU stamp */
+    };
+
+struct disk_cache {
+    struct disk_cache   *next;                          /* all caches */
+    UNIT                *uptr;                          /* owning unit */
+    uint32              sector_size;
+    uint32              xfer_element_size;
+    uint32              line_bytes;                     /* bytes per line */
+    uint32              nsets;                          /* number of sets */
+    uint32              stage_max;                      /* sectors in stage */
+    uint32              clock;                          /* LRU clock */
+    uint32              ndirty;                         /* dirty lines */
+    uint32              dirty_time;                     /* msec first dirtied */
+    t_offset            fsize;                          /* image size incl. cache */
+    struct disk_cache_line *lines;                      /* nsets * DKC_WAYS */
+    struct disk_cache_line **order;                     /* flush sort space */
+    uint8               *data;                          /* line contents */
+    uint8               *stage;                         /* coalesced writes */
+    t_uint64            reads, read_hits;               /* statistics */
+    t_uint64            writes, wb_sects, wb_writes;
+#if defined SIM_ASYNCH_IO
+    pthread_mutex_t     lock;
+#endif
+    };
+
+static uint32 dkc_size = 0;                             /* bytes per unit, 0 = off */
+static uint32 dkc_flush_ms = 1000;                      /* write back interval */
+static t_bool dkc_sync = FALSE;                         /* fsync at barriers */
+static struct disk_cache *dkc_list = NULL;              /* attached caches */
+
+#if defined SIM_ASYNCH_IO
+static pthread_mutex_t dkc_list_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t dkc_flush_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t dkc_flush_thread;
+static t_bool dkc_flush_started = FALSE;
+#define DKC_LOCK(c)     pthread_mutex_lock (&(c)->lock)
+#define DKC_UNLOCK(c)   pthread_mutex_unlock (&(c)->lock)
+#else
+#define DKC_LOCK(c)
+#define DKC_UNLOCK(c)
+#endif
+
+static t_uint64 _dkc_mask (uint32 first, uint32 count)
+{
+if (count >= DKC_LSECTS)
+    return ~((t_uint64)0);
+return ((((t_uint64)1) << count) - 1) << first;
+}
+
+static uint8 *_dkc_line_data (struct disk_cache *c, struct disk_cache_line *l)
+{
+return c->data + (size_t)(l - c->lines) * c->line_bytes;
+}
+
+/* Write sects sectors at lba from buf to the container */
+
+static t_stat _dkc_write (struct disk_cache *c, t_lba lba, uint8 *buf, uint32 sects)
+{
+FILE *f = c->uptr->fileref;
+uint32 tbc = sects * c->sector_size;
+
+if (sim_fseeko (f, ((t_offset)lba) * c->sector_size, SEEK_SET))
+    return SCPE_IOERR;
+sim_fwrite (buf, c->xfer_element_size, tbc / c->xfer_element_size, f);
+if (ferror (f))
+    return SCPE_IOERR;
+c->wb_writes = c->wb_writes + 1;
+c->wb_sects = c->wb_sects + sects;
+return SCPE_OK;
+}
+
+/* Write back the dirty sectors of n lines, sorted by line number, merging
+   runs which are adjacent on disk into single transfers */
+
+static t_stat _dkc_writeback (struct disk_cache *c, struct disk_cache_line **lv, uint32 n)
+{
+t_lba run_lba = 0;
+uint32 i, s, e, run = 0;
+t_stat r;
+
+for (i = 0; i < n; i++) {
+    struct disk_cache_line *l = lv[i];
+    uint8 *data = _dkc_line_data (c, l);
+
+    for (s = 0; s < DKC_LSECTS; s = e) {
+        for ( ; (s < DKC_LSECTS) && !((l->dirty >> s) & 1); s++) ;
+        for (e = s; (e < DKC_LSECTS) && ((l->dirty >> e) & 1); e++) ;
+        if (s == e)                                     /* no more runs */
+            break;
+        if (run && ((run_lba + run != l->line * DKC_LSECTS + s) ||
+                    (run + (e - s) > c->stage_max))) {  /* can't extend? */
+            r = _dkc_write (c, run_lba, c->stage, run);
+            if (r != SCPE_OK)
+                return r;
+            run = 0;
+            }
+        if (run == 0)
+            run_lba = l->line * DKC_LSECTS + s;
+        memcpy (c->stage + (size_t)run * c->sector_size,
+                data + (size_t)s * c->sector_size, (e - s) * c->sector_size);
+        run = run + (e - s);
+        }
+    }
+if (run) {
+    r = _dkc_write (c, run_lba, c->stage, run);
+    if (r != SCPE_OK)
+        return r;
+    }
+for (i = 0; i < n; i++) {
+    if (lv[i]->dirty)
+        --c->ndirty;
+    lv[i]->dirty = 0;
+    }
+return SCPE_OK;
+}
+
+static int _dkc_compare (const void *a, const void *b)
+{
+t_lba la = (*(struct disk_cache_line * const *)a)->line;
+t_lba lb = (*(struct disk_cache_line * const *)b)->line;
+
+return (la < lb)? -1: (la > lb);
+}
+
+/* Write back all dirty data; a barrier also pushes it to the host disk */
+
+static t_stat _dkc_flush (struct disk_cache *c, t_bool barrier)
+{
+uint32 i, n = 0;
+t_stat r = SCPE_OK;
+
+if (c->ndirty) {
+    for (i = 0; i < c->nsets * DKC_WAYS; i++)
+        if (c->lines[i].dirty)
+            c->order[n++] = &c->lines[i];
+    qsort (c->order, n, sizeof (*c->order), _dkc_compare);
+    r = _dkc_writeback (c, c->order, n);
+    }
+if (fflush (c->uptr->fileref) == EOF)
+    r = SCPE_IOERR;
+if (barrier && dkc_sync) {
+#if defined (_WIN32)
+    _commit (_fileno (c->uptr->fileref));
+#else
+    fsync (fileno (c->uptr->fileref));
+#endif
+    }
+return r;
+}
+
+/* Find or allocate the line for line number ln */
+
+static struct disk_cache_line *_dkc_get (struct disk_cache *c, t_lba ln, t_stat *stat)
+{
+struct disk_cache_line *set = &c->lines[(ln % c->nsets) * DKC_WAYS];
+struct disk_cache_line *l = set;
+uint32 i;
+
+*stat = SCPE_OK;
+c->clock = c->clock + 1;
+for (i = 0; i < DKC_WAYS; i++) {
+    if (set[i].line == ln) {
+        set[i].used = c->clock;
+        return &set[i];
+        }
+    if ((set[i].line == DKC_NOLINE) ||                  /* pick empty or LRU */
+        ((l->line != DKC_NOLINE) &&
+         ((int32)(set[i].used - l->used) < 0)))
+        l = &set[i];
+    }
+if (l->dirty) {                                         /* evict */
+    *stat = _dkc_writeback (c, &l, 1);
+    if (*stat != SCPE_OK)
+        return NULL;
+    }
+l->line = ln;
+l->valid = 0;
+l->used = c->clock;
+return l;
+}
+
+/* Read the sectors of a line not yet present from the container */
+
+static t_stat _dkc_load (struct disk_cache *c, struct disk_cache_line *l)
+{
+FILE *f = c->uptr->fileref;
+uint8 *data = _dkc_line_data (c, l);
+uint32 s, e, tbc;
+size_t i;
+
+for (s = 0; s < DKC_LSECTS; s = e) {
+    for ( ; (s < DKC_LSECTS) && ((l->valid >> s) & 1); s++) ;
+    for (e = s; (e < DKC_LSECTS) && !((l->valid >> e) & 1); e++) ;
+    if (s == e)
+        break;
+    tbc = (e - s) * c->sector_size;
+    if (sim_fseeko (f, ((t_offset)(l->line * DKC_LSECTS + s)) * c->sector_size, SEEK_SET))
+        return SCPE_IOERR;
+    i = sim_fread (data + (size_t)s * c->sector_size, c->xfer_element_size, tbc / c->xfer_element_size, f);
+    if (i < tbc / c->xfer_element_size)                 /* past EOF reads zero */
+        memset (data + (size_t)s * c->sector_size + i * c->xfer_element_size, 0, tbc - i * c->xfer_element_size);
+    if (ferror (f))
+        return SCPE_IOERR;
+    }
+l->valid = ~((t_uint64)0);
+return SCPE_OK;
+}
+
+static t_stat _dkc_rdsect (struct disk_cache *c, t_lba lba, uint8 *buf, t_seccnt *sectsread, t_seccnt sects)
+{
+struct disk_cache_line *l;
+t_offset da = ((t_offset)lba) * c->sector_size;
+uint32 s, n, todo = sects;
+t_uint64 m;
+t_stat r = SCPE_OK;
+
+DKC_LOCK (c);
+c->reads = c->reads + 1;
+m = 1;
+while (todo) {
+    s = lba % DKC_LSECTS;
+    n = DKC_LSECTS - s;
+    if (n > todo)
+        n = todo;
+    l = _dkc_get (c, lba / DKC_LSECTS, &r);
+    if (l == NULL)
+        break;
+    if ((l->valid & _dkc_mask (s, n)) != _dkc_mask (s, n)) {
+        m = 0;                                          /* not a hit */
+        r = _dkc_load (c, l);
+        if (r != SCPE_OK)
+            break;
+        }
+    memcpy (buf, _dkc_line_data (c, l) + (size_t)s * c->sector_size, n * c->sector_size);
+    buf = buf + n * c->sector_size;
+    lba = lba + n;
+    todo = todo - n;
+    }
+c->read_hits = c->read_hits + m;
+if ((r == SCPE_OK) && sectsread) {                      /* count what the image holds */
+    if (c->fsize <= da)
+        *sectsread = 0;
+    else if ((c->fsize - da) >= ((t_offset)sects) * c->sector_size)
+        *sectsread = sects;
+    else *sectsread = (t_seccnt)((c->fsize - da + c->sector_size - 1) / c->sector_size);
+    }
+DKC_UNLOCK (c);
+return r;
+}
+
+static t_stat _dkc_wrsect (struct disk_cache *c, t_lba lba, uint8 *buf, t_seccnt *sectswritten, t_seccnt sects)
+{
+struct disk_cache_line *l;
+t_offset end = ((t_offset)lba + sects) * c->sector_size;
+uint32 s, n, todo = sects;
+t_uint64 m;
+t_stat r = SCPE_OK;
+
+DKC_LOCK (c);
+c->writes = c->writes + 1;
+while (todo) {
+    s = lba % DKC_LSECTS;
+    n = DKC_LSECTS - s;
+    if (n > todo)
+        n = todo;
+    l = _dkc_get (c, lba / DKC_LSECTS, &r);
+    if (l == NULL)
+        break;
+    m = _dkc_mask (s, n);
+    memcpy (_dkc_line_data (c, l) + (size_t)s * c->sector_size, buf, n * c->sector_size);
+    if ((l->dirty == 0) && (c->ndirty++ == 0))
+        c->dirty_time = sim_os_msec ();
+    l->valid |= m;
+    l->dirty |= m;
+    buf = buf + n * c->sector_size;
+    lba = lba + n;
+    todo = todo - n;
+    }
+if (sectswritten)
+    *sectswritten = sects - todo;
+if (end > c->fsize)
+    c->fsize = end;
+#if !defined SIM_ASYNCH_IO
+if ((r == SCPE_OK) && dkc_flush_ms && c->ndirty &&      /* held long enough? */
+    ((sim_os_msec () - c->dirty_time) >= dkc_flush_ms))
+    r = _dkc_flush (c, FALSE);
+#endif
+DKC_UNLOCK (c);
+return r;
+}
+
+static t_offset _dkc_size (struct disk_cache *c)
+{
+t_offset size;
+
+DKC_LOCK (c);
+size = c->fsize;
+DKC_UNLOCK (c);
+return size;
+}
+
+#if defined SIM_ASYNCH_IO
+/* Background write back of data held longer than the FLUSH interval */
+
+static void *_dkc_flush_thread (void *arg)
+{
+struct disk_cache *c;
+struct timespec deadline;
+uint32 wait_ms;
+
+pthread_mutex_lock (&dkc_list_lock);
+while (dkc_list && dkc_flush_ms) {
+    wait_ms = (dkc_flush_ms < 20)? 10: dkc_flush_ms / 2;
+    clock_gettime (CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += wait_ms / 1000;
+    deadline.tv_nsec += (wait_ms % 1000) * 1000000;
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_nsec -= 1000000000;
+        ++deadline.tv_sec;
+        }
+    pthread_cond_timedwait (&dkc_flush_cond, &dkc_list_lock, &deadline);
+    for (c = dkc_list; c && dkc_flush_ms; c = c->next) {
+        DKC_LOCK (c);
+        if (c->ndirty && ((sim_os_msec () - c->dirty_time) >= dkc_flush_ms))
+            _dkc_flush (c, FALSE);
+        DKC_UNLOCK (c);
+        }
+    }
+pthread_mutex_unlock (&dkc_list_lock);
+return NULL;
+}
+#endif
+
+/* Give an attached SIMH format unit a cache of the current size */
+
+static void _sim_disk_cache_attach (UNIT *uptr)
+{
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+struct disk_cache *c;
+uint32 nlines;
+
+if ((dkc_size == 0) || (ctx->cache != NULL) ||
+    (DK_GET_FMT (uptr) != DKUF_F_STD))
+    return;
+c = (struct disk_cache *)calloc (1, sizeof (*c));
+if (c == NULL)
+    return;
+c->uptr = uptr;
+c->sector_size = ctx->sector_size;
+c->xfer_element_size = ctx->xfer_element_size;
+c->line_bytes = DKC_LSECTS * c->sector_size;
+nlines = dkc_size / c->line_bytes;
+c->nsets = (nlines < DKC_WAYS)? 1: nlines / DKC_WAYS;
+c->stage_max = DKC_STAGE / c->sector_size;
+if (c->stage_max < DKC_LSECTS)
+    c->stage_max = DKC_LSECTS;
+c->fsize = sim_fsize_ex (uptr->fileref);
+c->lines = (struct disk_cache_line *)calloc (c->nsets * DKC_WAYS, sizeof (*c->lines));
+c->order = (struct disk_cache_line **)calloc (c->nsets * DKC_WAYS, sizeof (*c->order));
+c->data = (uint8 *)malloc ((size_t)c->nsets * DKC_WAYS * c->line_bytes);
+c->stage = (uint8 *)malloc ((size_t)c->stage_max * c->sector_size);
+if ((c->lines == NULL) || (c->order == NULL) || (c->data == NULL) || (c->stage == NULL)) {
+    free (c->lines);
+    free (c->order);
+    free (c->data);
+    free (c->stage);
+    free (c);
+    return;
+    }
+for (nlines = 0; nlines < c->nsets * DKC_WAYS; nlines++)
+    c->lines[nlines].line = DKC_NOLINE;
+#if defined SIM_ASYNCH_IO
+pthread_mutex_init (&c->lock, NULL);
+pthread_mutex_lock (&dkc_list_lock);
+#endif
+c->next = dkc_list;
+dkc_list = c;
+ctx->cache = c;
+#if defined SIM_ASYNCH_IO
+pthread_mutex_unlock (&dkc_list_lock);
+if (dkc_flush_ms && !dkc_flush_started)
+    dkc_flush_started = (0 == pthread_create (&dkc_flush_thread, NULL, _dkc_flush_thread, NULL));
+#endif
+}
+
+/* Write back and release a unit's cache */
+
+static t_stat _sim_disk_cache_detach (UNIT *uptr)
+{
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+struct disk_cache *c = ctx->cache, **pc;
+t_stat r;
+
+if (c == NULL)
+    return SCPE_OK;
+#if defined SIM_ASYNCH_IO
+pthread_mutex_lock (&dkc_list_lock);
+#endif
+for (pc = &dkc_list; *pc != c; pc = &(*pc)->next) ;
+*pc = c->next;
+ctx->cache = NULL;
+r = _dkc_flush (c, TRUE);
+#if defined SIM_ASYNCH_IO
+pthread_cond_signal (&dkc_flush_cond);
+pthread_mutex_unlock (&dkc_list_lock);
+if (dkc_flush_started && (dkc_list == NULL)) {          /* last one stops thread */
+    pthread_join (dkc_flush_thread, NULL);
+    dkc_flush_started = FALSE;
+    }
+pthread_mutex_destroy (&c->lock);
+#endif
+free (c->lines);
+free (c->order);
+free (c->data);
+free (c->stage);
+free (c);
+return r;
+}
+
+static t_stat _sim_disk_cache_flush (UNIT *uptr)
+{
+struct disk_context *ctx = (struct disk_context *)uptr->disk_ctx;
+t_stat r;
+
+DKC_LOCK (ctx->cache);
+r = _dkc_flush (ctx->cache, TRUE);
+DKC_UNLOCK (ctx->cache);
+return r;
+}
+
+/* Apply fn to each attached disk unit (those using our flush routine) */
+
+static void _sim_disk_cache_each (void (*fn)(UNIT *uptr))
+{
+DEVICE *dptr;
+uint32 i, j;
+
+for (i = 0; (dptr = sim_devices[i]) != NULL; i++)
+    for (j = 0; j < dptr->numunits; j++)
+        if ((dptr->units[j].flags & UNIT_ATT) &&
+            (dptr->units[j].io_flush == _sim_disk_io_flush))
+            fn (&dptr->units[j]);
+}
+
+static void _sim_disk_cache_drop (UNIT *uptr)
+{
+_sim_disk_cache_detach (uptr);
+}
+
+/* SET DISKCACHE size{K|M}{,FLUSH=msec}{,SYNC|NOSYNC} and SET NODISKCACHE */
+
+t_stat sim_disk_set_cache (int32 flag, char *cptr)
+{
+char gbuf[CBUFSIZE], *tptr;
+uint32 size = flag? (dkc_size? dkc_size: 4 * 1024 * 1024): 0;
+uint32 flush_ms = dkc_flush_ms;
+t_bool sync = dkc_sync;
+t_value val;
+
+if (flag == 0) {
+    if ((cptr != NULL) && (*cptr != 0))
+        return SCPE_2MARG;
+    }
+else while ((cptr != NULL) && (*cptr != 0)) {
+    cptr = get_glyph (cptr, gbuf, ',');
+    if (isdigit (gbuf[0])) {
+        val = strtotv (gbuf, &tptr, 10);
+        if (toupper (*tptr) == 'M') {
+            val = val * 1024 * 1024;
+            ++tptr;
+            }
+        else if (toupper (*tptr) == 'K') {
+            val = val * 1024;
+            ++tptr;
+            }
+        if ((*tptr != 0) || (val < DKC_MINSIZE) || (val > DKC_MAXSIZE))
+            return SCPE_ARG;
+        size = (uint32)val;
+        }
+    else if (strncmp (gbuf, "FLUSH=", 6) == 0) {
+        val = strtotv (gbuf + 6, &tptr, 10);
+        if ((tptr == gbuf + 6) || (*tptr != 0) || (val > 3600000))
+            return SCPE_ARG;
+        flush_ms = (uint32)val;
+        }
+    else if (strcmp (gbuf, "SYNC") == 0)
+        sync = TRUE;
+    else if (strcmp (gbuf, "NOSYNC") == 0)
+        sync = FALSE;
+    else
+        return SCPE_ARG;
+    }
+_sim_disk_cache_each (&_sim_disk_cache_drop);           /* write back and free */
+dkc_size = size;
+dkc_flush_ms = flush_ms;
+dkc_sync = sync;
+_sim_disk_cache_each (&_sim_disk_cache_attach);         /* rebuild at new size */
+return SCPE_OK;
+}
+
+t_stat sim_disk_show_cache (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr)
+{
+struct disk_cache *c;
+
+if (cptr && (*cptr != 0))
+    return SCPE_2MARG;
+if (dkc_size == 0) {
+    fprintf (st, "Disk cache disabled\n");
+    return SCPE_OK;
+    }
+fprintf (st, "Disk cache: %dKB per unit, ", dkc_size / 1024);
+if (dkc_flush_ms)
+    fprintf (st, "write back after %dms", dkc_flush_ms);
+else
+    fprintf (st, "write back when stopped");
+fprintf (st, "%s\n", dkc_sync? ", sync": "");
+for (c = dkc_list; c; c = c->next) {
+    DKC_LOCK (c);
+    fprintf (st, "  %s: %" LL_FMT "u reads (%" LL_FMT "u hits), %" LL_FMT "u writes, ",
+             sim_uname (c->uptr), c->reads, c->read_hits, c->writes);
+    fprintf (st, "%" LL_FMT "u sectors written back in %" LL_FMT "u transfers, %d lines dirty\n",
+             c->wb_sects, c->wb_writes, c->ndirty);
+    DKC_UNLOCK (c);
+    }
+return SCPE_OK;
+}
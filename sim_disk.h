@@ -45,6 +45,7 @@ typedef uint32          t_lba;                          /* disk logical block ad
 #define DKUF_F_STD       0                              /* SIMH format */
 #define DKUF_F_RAW       1                              /* Raw Physical Disk Access */
 #define DKUF_F_VHD       2                              /* VHD format */
+#define DKUF_F_CAS       3                              /* Content addressed store */
 #define DKUF_V_UF       (DKUF_V_FMT + DKUF_W_FMT)
 #define DKUF_WLK        (1u << DKUF_V_WLK)
 #define DKUF_FMT        (DKUF_M_FMT << DKUF_V_FMT)
@@ -53,6 +54,7 @@ typedef uint32          t_lba;                          /* disk logical block ad
 #define DK_F_STD        (DKUF_F_STD << DKUF_V_FMT)
 #define DK_F_RAW        (DKUF_F_RAW << DKUF_V_FMT)
 #define DK_F_VHD        (DKUF_F_VHD << DKUF_V_FMT)
+#define DK_F_CAS        (DKUF_F_CAS << DKUF_V_FMT)
 
 #define DK_GET_FMT(u)   (((u)->flags >> DKUF_V_FMT) & DKUF_M_FMT)
 
@@ -79,6 +81,9 @@ t_stat sim_disk_set_capac (UNIT *uptr, int32 val, char *cptr, void *desc);
 t_stat sim_disk_show_capac (FILE *st, UNIT *uptr, int32 val, void *desc);
 t_stat sim_disk_set_asynch (UNIT *uptr, int latency);
 t_stat sim_disk_clr_asynch (UNIT *uptr);
+t_stat sim_disk_set_cache (int32 flag, char *cptr);
+t_stat sim_disk_show_cache (FILE *st, DEVICE *dptr, UNIT *uptr, int32 flag, char *cptr);
+t_stat sim_disk_cas_gc (int32 flag, char *cptr);
 t_stat sim_disk_reset (UNIT *uptr);
 t_stat sim_disk_perror (UNIT *uptr, const char *msg);
 t_stat sim_disk_clearerr (UNIT *uptr);
@@ -50,8 +50,10 @@
    sim_fsize_name_ex -       get file size as a t_offset of named file
    sim_buf_copy_swapped -    copy data swapping elements along the way
    sim_buf_swap_data -       swap data elements inplace in buffer
+   sim_mem_alloc     -       allocate zeroed simulated memory
+   sim_mem_free      -       release simulated memory
 
-   sim_fopen and sim_fseek are OS-dependent.  The other routines are not.
+   sim_fopen, sim_fseek and sim_mem_alloc are OS-dependent.  The other routines are not.
    sim_fsize is always a 32b routine (it is used only with small capacity random
    access devices like fixed head disks and DECtapes).
 */
@@ -362,3 +364,73 @@ int sim_fseek (FILE *st, t_addr offset, int whence)
 {
 return sim_fseeko (st, (t_offset)offset, whence);
 }
+
+/* Simulated memory allocation
+
+   sim_mem_alloc returns zeroed storage for a simulated memory.  Large
+   requests are mapped directly from the host as demand-zero pages, so
+   a large configured memory costs nothing at startup; the host supplies
+   (and zeroes) a page only when the simulated program first touches it.
+   Small requests, and hosts without anonymous mappings, use calloc.
+
+   sim_mem_free must be passed the size given to sim_mem_alloc, since
+   that size selects the release mechanism.
+*/
+
+#if defined (_WIN32)
+#define S_SIM_MEM_MAP_ 1
+#include <windows.h>
+
+static void *sim_os_mem_map (size_t size)
+{
+return VirtualAlloc (NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+static void sim_os_mem_unmap (void *mem, size_t size)
+{
+VirtualFree (mem, 0, MEM_RELEASE);
+}
+
+#elif defined (__unix__) || defined (__APPLE__)
+#include <sys/mman.h>
+#if !defined (MAP_ANONYMOUS) && defined (MAP_ANON)
+#define MAP_ANONYMOUS   MAP_ANON
+#endif
+#if defined (MAP_ANONYMOUS)
+#define S_SIM_MEM_MAP_ 1
+
+static void *sim_os_mem_map (size_t size)
+{
+void *mem = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+return (mem == MAP_FAILED)? NULL: mem;
+}
+
+static void sim_os_mem_unmap (void *mem, size_t size)
+{
+munmap (mem, size);
+}
+#endif
+#endif
+
+void *sim_mem_alloc (size_t size)
+{
+#if defined (S_SIM_MEM_MAP_)
+if (size >= SIM_MEM_MAPMIN)
+    return sim_os_mem_map (size);
+#endif
+return calloc (size, 1);
+}
+
+void sim_mem_free (void *mem, size_t size)
+{
+if (mem == NULL)
+    return;
+#if defined (S_SIM_MEM_MAP_)
+if (size >= SIM_MEM_MAPMIN) {
+    sim_os_mem_unmap (mem, size);
+    return;
+    }
+#endif
+free (mem);
+}
@@ -34,6 +34,7 @@
 #define SIM_FIO_H_     0
 
 #define FLIP_SIZE       (1 << 16)                       /* flip buf size */
+#define SIM_MEM_MAPMIN  (1 << 16)                       /* min mapped memory */
 #define fxread(a,b,c,d)         sim_fread (a, b, c, d)
 #define fxwrite(a,b,c,d)        sim_fwrite (a, b, c, d)
 
@@ -62,6 +63,8 @@ t_offset sim_fsize_ex (FILE *fptr);
 t_offset sim_fsize_name_ex (char *fname);
 void sim_buf_swap_data (void *bptr, size_t size, size_t count);
 void sim_buf_copy_swapped (void *dptr, void *bptr, size_t size, size_t count);
+void *sim_mem_alloc (size_t size);
+void sim_mem_free (void *mem, size_t size);
 
 extern t_bool sim_taddr_64;         /* t_addr is > 32b and Large File Support available */
 extern t_bool sim_toffset_64;       /* Large File (>2GB) file I/O support */
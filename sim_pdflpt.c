@@ -36,6 +36,9 @@
 #include "sim_console.h"
 #include "sim_pdflpt.h" 
 #include <ctype.h>
+#if defined (SIM_ASYNCH_IO)
+#include <pthread.h>
+#endif
 
 #define DIM(x) (sizeof (x) / sizeof ((x)[0]))
 
@@ -45,6 +48,14 @@
 #define PDFLPT_IDLE_TIME (10)
 #endif
 
+/* Size (bytes) of the queue between a printer and its PDF rendering
+ * thread.  The printer is reported busy while more than half is in use.
+ */
+
+#ifndef PDFLPT_QUEUE_SIZE
+#define PDFLPT_QUEUE_SIZE (64 * 1024)
+#endif
+
 /* Template and limit for generating spool file names.
  * Names will be 1 - SPOOL_FN_MAX.
  * SPOOL_FN is inserted before the file extension,
@@ -131,6 +142,23 @@ typedef struct {
     uint32 lineposition;    /* printer column number */
     size_t bc;
     char buffer[256];
+#if defined (SIM_ASYNCH_IO)
+    t_bool asynch_io;       /* Rendering thread active */
+    pthread_t io_thread;    /* Rendering thread */
+    pthread_mutex_t io_lock;
+    pthread_cond_t io_cond; /* Work for the thread */
+    pthread_cond_t io_done; /* Thread made progress */
+    char *queue;            /* Data waiting to be rendered */
+    size_t qin;             /* Next byte to fill */
+    size_t qout;            /* Next byte to render */
+    size_t qcount;          /* Bytes in queue */
+    t_bool io_busy;         /* Thread is using the PDF handle */
+    t_bool io_checkpoint;   /* Checkpoint requested */
+    t_bool io_stop;         /* Thread exit requested */
+    int io_error;           /* First error from the thread */
+    size_t page;            /* Position after rendered data */
+    size_t line;
+#endif
 } PCTX;
 
 /* Internal functions */
@@ -145,6 +173,17 @@ static void idle_register_lpt (UNIT *uptr);
 static void idle_deregister_lpt (UNIT *uptr);
 static t_stat lpt_idle_svc (UNIT *uptr);
 static t_stat lpt_idle_reset (DEVICE *dptr);
+#if defined (SIM_ASYNCH_IO)
+static void spool_start (UNIT *uptr);
+static void spool_stop (UNIT *uptr);
+static void spool_drain (UNIT *uptr);
+static int spool_print (UNIT *uptr, const char *s, size_t length);
+#else
+#define spool_start(uptr)
+#define spool_stop(uptr)
+#define spool_drain(uptr)
+#define spool_print(uptr, s, length) pdf_print (pdf, s, length)
+#endif
 
 UNIT lpt_idle_unit = {UDATA (&lpt_idle_svc, UNIT_DIS, 0)};
 #define lpt_count (*((uint32 *)&lpt_idle_unit.u3))
@@ -250,6 +289,7 @@ static const ARG argtable[] = {
     SET (BAR-HEIGHT,    BAR_HEIGHT,     NUMBER)
     SET (BOTTOM-MARGIN, BOTTOM_MARGIN,  NUMBER)
     SET (COLUMNS,       COLS,           INTEGER)
+    SET (COMPRESSION,   COMPRESSION,    STRING)
     SET (CPI,           CPI,            NUMBER)
     SET (FONT,          TEXT_FONT,      QSTRING)
     SET (FORM,          FORM_TYPE,      STRING)
@@ -724,6 +764,8 @@ t_stat pdflpt_attach (UNIT *uptr, char *cptr) {
      */
     uptr->pos = page;
 
+    spool_start (uptr);
+
     return reason;
 }
 
@@ -778,6 +820,8 @@ t_stat pdflpt_newform (UNIT *uptr, const char *params) {
         return SCPE_OK;
     }
 
+    spool_drain (uptr);
+
     r = pdf_reopen (pdf);
     if (r != PDF_OK) {
         return SCPE_NOATT;
@@ -845,9 +889,10 @@ t_stat pdflpt_detach (UNIT *uptr) {
     }
 
     if (pdfctx->bc) {
-        pdf_print (pdf, pdfctx->buffer, pdfctx->bc);
+        spool_print (uptr, pdfctx->buffer, pdfctx->bc);
         pdfctx->bc = 0;
     }
+    spool_stop (uptr);
 
     pdf_where (pdf, &page, NULL);
 
@@ -927,6 +972,7 @@ static t_stat spool_file (UNIT *uptr) {
 
     pdf_mode = pdflpt_getmode (uptr) == PDFLPT_IS_PDF;
     if (pdf_mode) {
+        spool_drain (uptr);
         if (!pdfctx->bc && pdf_is_empty (pdf)) {
             return SCPE_EOF;
         }
@@ -1008,9 +1054,10 @@ static t_stat spool_file (UNIT *uptr) {
     /* We have a new file open.  Close the old. */
 
     if (pdfctx->bc) {
-        pdf_print (pdf, pdfctx->buffer, pdfctx->bc);
+        spool_print (uptr, pdfctx->buffer, pdfctx->bc);
         pdfctx->bc = 0;
     }
+    spool_drain (uptr);
 
     pdf_where (pdf, &page, &line);
 
@@ -1151,7 +1198,7 @@ int pdflpt_putc (UNIT *uptr, int c) {
     pdfctx->buffer[pdfctx->bc++] = c;
 
     if (c == LF || c == FF || pdfctx->bc >= sizeof (pdfctx->buffer)) {
-        r = pdf_print (pdf, pdfctx->buffer, pdfctx->bc);
+        r = spool_print (uptr, pdfctx->buffer, pdfctx->bc);
         pdfctx->bc = 0;
         if (r != PDF_OK) {
             return EOF;
@@ -1186,10 +1233,10 @@ int pdflpt_puts (UNIT *uptr, const char *s) {
     }
 
     if (pdfctx->bc) {
-        pdf_print (pdf, pdfctx->buffer, pdfctx->bc);
+        spool_print (uptr, pdfctx->buffer, pdfctx->bc);
         pdfctx->bc = 0;
     }
-    r = pdf_print (pdf, s, PDF_USE_STRLEN);
+    r = spool_print (uptr, s, strlen (s));
     if (r != PDF_OK) {
         return EOF;
     }
@@ -1227,14 +1274,14 @@ size_t pdflpt_write (UNIT *uptr, void *ptr, size_t size, size_t nmemb) {
     }
 
     if (pdfctx->bc) {
-        pdf_print (pdf, pdfctx->buffer, pdfctx->bc);
+        spool_print (uptr, pdfctx->buffer, pdfctx->bc);
         pdfctx->bc = 0;
     }
 
     for (n = 0; n < nmemb; n++) {
         int r;
 
-        r = pdf_print (pdf, ((char *)ptr), size);
+        r = spool_print (uptr, ((char *)ptr), size);
         if (r != PDF_OK) {
             return n;
         }
@@ -1246,6 +1293,9 @@ size_t pdflpt_write (UNIT *uptr, void *ptr, size_t size, size_t nmemb) {
 /* Flush
  *  Checkpoints PDF files (expensive)
  *  fflush for text files.
+ *
+ *  With a rendering thread, the checkpoint is done by the thread
+ *  once it has rendered the data queued so far.
  */
 
 void pdflpt_flush (UNIT *uptr) {
@@ -1262,9 +1312,18 @@ void pdflpt_flush (UNIT *uptr) {
     }
 
     if (pdfctx->bc) {
-        pdf_print (pdf, pdfctx->buffer, pdfctx->bc);
+        spool_print (uptr, pdfctx->buffer, pdfctx->bc);
         pdfctx->bc = 0;
     }
+#if defined (SIM_ASYNCH_IO)
+    if (pdfctx->asynch_io) {
+        pthread_mutex_lock (&pdfctx->io_lock);
+        pdfctx->io_checkpoint = TRUE;
+        pthread_cond_signal (&pdfctx->io_cond);
+        pthread_mutex_unlock (&pdfctx->io_lock);
+        return;
+    }
+#endif
     (void) pdf_checkpoint (pdf);
     return;
 }
@@ -1278,6 +1337,12 @@ int pdflpt_snapshot (UNIT *uptr, const char *filename) {
 
     SETCTX (SCPE_MEM);
 
+    if (pdfctx->bc) {
+        spool_print (uptr, pdfctx->buffer, pdfctx->bc);
+        pdfctx->bc = 0;
+    }
+    spool_drain (uptr);
+
     return pdf_snapshot (pdf, filename);
 }
 
@@ -1286,6 +1351,7 @@ int pdflpt_snapshot (UNIT *uptr, const char *filename) {
  * Returns page for progress report.  If *line is non-NULL
  * also returns line.  These are where then NEXT write will
  * go; the page may not yet exist.
+ * With a rendering thread, this lags by the data still queued.
  */
 
 t_addr pdflpt_where (UNIT *uptr, size_t *line) {
@@ -1298,6 +1364,18 @@ t_addr pdflpt_where (UNIT *uptr, size_t *line) {
         return ftell (uptr->fileref);
     }
 
+#if defined (SIM_ASYNCH_IO)
+    if (pdfctx->asynch_io) {
+        pthread_mutex_lock (&pdfctx->io_lock);
+        page = pdfctx->page;
+        if (line) {
+            *line = pdfctx->line;
+        }
+        pthread_mutex_unlock (&pdfctx->io_lock);
+        return page;
+    }
+#endif
+
     r = pdf_where (pdf, &page, line);
     if (r != PDF_OK) {
         return -1;
@@ -1305,6 +1383,26 @@ t_addr pdflpt_where (UNIT *uptr, size_t *line) {
     return page;
 }
 
+/* Printer busy
+ * TRUE while the rendering thread is behind by more than half its
+ * queue.  A device can extend its busy time until this clears.
+ */
+
+t_bool pdflpt_busy (UNIT *uptr) {
+    t_bool busy = FALSE;
+
+    SETCTX (FALSE);
+
+#if defined (SIM_ASYNCH_IO)
+    if (pdfctx->asynch_io) {
+        pthread_mutex_lock (&pdfctx->io_lock);
+        busy = pdfctx->qcount > PDFLPT_QUEUE_SIZE / 2;
+        pthread_mutex_unlock (&pdfctx->io_lock);
+    }
+#endif
+    return busy;
+}
+
 /* Get list of known form names */
 
 const char *const *pdflpt_get_formlist ( size_t *length ) {
@@ -1325,6 +1423,16 @@ int pdflpt_error (UNIT *uptr) {
     if (!pdf) {
         return ferror (uptr->fileref);
     }
+#if defined (SIM_ASYNCH_IO)
+    if (pdfctx->asynch_io) {
+        int r;
+
+        pthread_mutex_lock (&pdfctx->io_lock);
+        r = pdfctx->io_error;
+        pthread_mutex_unlock (&pdfctx->io_lock);
+        return r;
+    }
+#endif
     return pdf_error (pdf);
 }
 
@@ -1341,6 +1449,7 @@ void pdflpt_perror (UNIT *uptr, const char *s) {
     SETCTX (LPTVOID);
 
     if (pdf) {
+        spool_drain (uptr);
         pdf_perror (pdf, s);
     } else {
         perror (s);
@@ -1356,7 +1465,11 @@ void pdflpt_clearerr (UNIT *uptr) {
     if (!pdf) {
         clearerr (uptr->fileref);
     } else {
+        spool_drain (uptr);
         pdf_clearerr (pdf);
+#if defined (SIM_ASYNCH_IO)
+        pdfctx->io_error = 0;
+#endif
     }
     return;
 }
@@ -1492,6 +1605,189 @@ static t_stat lpt_idle_reset (DEVICE *dptr) {
     return SCPE_OK;
 }
 
+#if defined (SIM_ASYNCH_IO)
+/* PDF rendering thread
+ *
+ * Rendering and compressing pages and writing the file take much
+ * longer than the simulated printer takes to accept the data.  So
+ * when asynchronous I/O is enabled, output for a PDF file is queued
+ * to a thread that does the work while the simulator runs.
+ *
+ * Only the thread uses the PDF handle while it is running; anything
+ * else that needs the handle first waits for the queue to drain.  If
+ * the queue fills, output waits for the thread; devices can avoid
+ * this by treating pdflpt_busy() as printer busy.
+ */
+
+static void *_pdflpt_io (void *arg) {
+    UNIT *uptr = (UNIT *)arg;
+    PCTX *ctx = pdfctx;
+    size_t n, page, line;
+    int r;
+
+    pthread_mutex_lock (&ctx->io_lock);
+    for (;;) {
+        if (ctx->qcount) {                          /* Render queued data */
+            n = PDFLPT_QUEUE_SIZE - ctx->qout;
+            if (n > ctx->qcount) {
+                n = ctx->qcount;
+            }
+            ctx->io_busy = TRUE;
+            pthread_mutex_unlock (&ctx->io_lock);
+            r = pdf_print (pdf, ctx->queue + ctx->qout, n);
+            pdf_where (pdf, &page, &line);
+            pthread_mutex_lock (&ctx->io_lock);
+            ctx->qout = (ctx->qout + n) % PDFLPT_QUEUE_SIZE;
+            ctx->qcount -= n;
+            ctx->page = page;
+            ctx->line = line;
+        } else if (ctx->io_checkpoint) {            /* Then checkpoint */
+            ctx->io_busy = TRUE;
+            pthread_mutex_unlock (&ctx->io_lock);
+            r = pdf_checkpoint (pdf);
+            pthread_mutex_lock (&ctx->io_lock);
+            ctx->io_checkpoint = FALSE;
+        } else if (ctx->io_stop) {
+            break;
+        } else {
+            pthread_cond_wait (&ctx->io_cond, &ctx->io_lock);
+            continue;
+        }
+        if (r != PDF_OK && !ctx->io_error) {
+            ctx->io_error = r;
+        }
+        ctx->io_busy = FALSE;
+        pthread_cond_broadcast (&ctx->io_done);
+    }
+    pthread_mutex_unlock (&ctx->io_lock);
+
+    return NULL;
+}
+
+/* Start the rendering thread for a newly attached PDF file.
+ * If asynchronous I/O is disabled, or the thread can't be
+ * started, output is rendered inline.
+ */
+
+static void spool_start (UNIT *uptr) {
+    PCTX *ctx = pdfctx;
+    pthread_attr_t attr;
+
+    if (!sim_asynch_enabled || ctx->asynch_io) {
+        return;
+    }
+    ctx->queue = (char *) malloc (PDFLPT_QUEUE_SIZE);
+    if (!ctx->queue) {
+        return;
+    }
+    ctx->qin =
+        ctx->qout =
+        ctx->qcount = 0;
+    ctx->io_busy =
+        ctx->io_checkpoint =
+        ctx->io_stop = FALSE;
+    ctx->io_error = 0;
+    pdf_where (pdf, &ctx->page, &ctx->line);
+
+    pthread_mutex_init (&ctx->io_lock, NULL);
+    pthread_cond_init (&ctx->io_cond, NULL);
+    pthread_cond_init (&ctx->io_done, NULL);
+    pthread_attr_init (&attr);
+    pthread_attr_setscope (&attr, PTHREAD_SCOPE_SYSTEM);
+    ctx->asynch_io = (pthread_create (&ctx->io_thread, &attr, _pdflpt_io, (void *)uptr) == 0);
+    pthread_attr_destroy (&attr);
+
+    if (!ctx->asynch_io) {
+        pthread_mutex_destroy (&ctx->io_lock);
+        pthread_cond_destroy (&ctx->io_cond);
+        pthread_cond_destroy (&ctx->io_done);
+        free (ctx->queue);
+        ctx->queue = NULL;
+    }
+    return;
+}
+
+/* Render everything queued, then stop the thread.
+ */
+
+static void spool_stop (UNIT *uptr) {
+    PCTX *ctx = pdfctx;
+
+    if (!ctx->asynch_io) {
+        return;
+    }
+    pthread_mutex_lock (&ctx->io_lock);
+    ctx->io_stop = TRUE;
+    pthread_cond_signal (&ctx->io_cond);
+    pthread_mutex_unlock (&ctx->io_lock);
+    pthread_join (ctx->io_thread, NULL);
+
+    pthread_mutex_destroy (&ctx->io_lock);
+    pthread_cond_destroy (&ctx->io_cond);
+    pthread_cond_destroy (&ctx->io_done);
+    free (ctx->queue);
+    ctx->queue = NULL;
+    ctx->asynch_io = FALSE;
+    return;
+}
+
+/* Wait until everything queued has been rendered (and any requested
+ * checkpoint done), so that the PDF handle can be used directly.
+ */
+
+static void spool_drain (UNIT *uptr) {
+    PCTX *ctx = pdfctx;
+
+    if (!ctx->asynch_io) {
+        return;
+    }
+    pthread_mutex_lock (&ctx->io_lock);
+    while (ctx->qcount || ctx->io_busy || ctx->io_checkpoint) {
+        pthread_cond_wait (&ctx->io_done, &ctx->io_lock);
+    }
+    pthread_mutex_unlock (&ctx->io_lock);
+    return;
+}
+
+/* Queue data for the rendering thread; pdf_print if there is none.
+ * Waits if the queue is full.  Errors from the thread are reported
+ * by subsequent calls.
+ */
+
+static int spool_print (UNIT *uptr, const char *s, size_t length) {
+    PCTX *ctx = pdfctx;
+    size_t n;
+    int r;
+
+    if (!ctx->asynch_io) {
+        return pdf_print (pdf, s, length);
+    }
+
+    pthread_mutex_lock (&ctx->io_lock);
+    while (length) {
+        while (ctx->qcount == PDFLPT_QUEUE_SIZE) {
+            pthread_cond_wait (&ctx->io_done, &ctx->io_lock);
+        }
+        n = PDFLPT_QUEUE_SIZE - ctx->qin;
+        if (n > PDFLPT_QUEUE_SIZE - ctx->qcount) {
+            n = PDFLPT_QUEUE_SIZE - ctx->qcount;
+        }
+        if (n > length) {
+            n = length;
+        }
+        memcpy (ctx->queue + ctx->qin, s, n);
+        ctx->qin = (ctx->qin + n) % PDFLPT_QUEUE_SIZE;
+        ctx->qcount += n;
+        s += n;
+        length -= n;
+        pthread_cond_signal (&ctx->io_cond);
+    }
+    r = ctx->io_error;
+    pthread_mutex_unlock (&ctx->io_lock);
+
+    return r;
+}
+#endif
 
 /* Help for PDF-enabled printers */
 
@@ -1800,6 +2096,12 @@ const char pdflpt_helptext[] =
 "+might present.\n"
 " Default: \"Lineprinter data\"\n"
 "\n"
+" compression=keyword\n"
+"+Specifies how the page data in the .PDF file is compressed.  FLATE\n"
+"+gives the smallest files.  LZW is readable by very old PDF viewers.\n"
+"+NONE leaves the page data as text, which is only useful for debugging.\n"
+" Default: FLATE\n"
+"\n"
 " font=string\n"
 "+Specifies the font used for lineprinter output on the page.  Only the\n"
 "+PDF built-in fonts may be used, and of those, only the monospaced fonts\n"
@@ -77,6 +77,11 @@
  * function if it is necessary to provide user control of the value.  Minimum is 1
  * second.
  * 
+ * When asynchronous I/O is enabled, PDF output is queued to a thread that renders
+ * and writes it, so that a long print job doesn't stall the simulator.  Functions
+ * that need a consistent file (detach, snapshot, spooling, new forms) wait for the
+ * queue to empty; checkpoints are done by the thread.
+ *
  */
 
 /* Updating your device:
@@ -136,6 +141,10 @@
  *    you're done.  If you do, look at the error functions.  The error codes are defined in
  *    lpt2pdf.h.
  *
+ *    Optionally, have the device check pdflpt_busy before completing output, and if it
+ *    is set, delay as a busy printer would.  Otherwise, output waits when the PDF
+ *    rendering thread falls too far behind.
+ *
  * - And, of course whichever method you choose, test!
  */
 
@@ -278,6 +287,16 @@ size_t pdflpt_write (UNIT *uptr, void *ptr, size_t size, size_t nmemb);
 
 t_addr pdflpt_where (UNIT *uptr, size_t *line);
 
+/* Printer busy
+ *
+ * Returns TRUE while the PDF rendering thread is well behind the output.
+ * A device can hold off completion (e.g. DONE) until this clears, as a real
+ * printer would while printing.  Always FALSE for text files and when output
+ * is rendered inline.
+ */
+
+t_bool pdflpt_busy (UNIT *uptr);
+
 /* Reconfigure output form
  * Does not close file, but starts a new session.
  * Allows switching to a new form, e.g. when a new VFU is loaded.
@@ -89,6 +89,9 @@
 #include "sim_defs.h"
 #include "sim_tape.h"
 #include <ctype.h>
+#if defined (HAVE_ZLIB)
+#include <zlib.h>
+#endif
 
 #if defined SIM_ASYNCH_IO
 #include <pthread.h>
@@ -106,17 +109,64 @@ static struct sim_tape_fmt fmts[MTUF_N_FMT] = {
     { "TPC",  UNIT_RO, sizeof (t_tpclnt) - 1 },
     { "P7B",  0,       0 },
 /*  { "TPF",  UNIT_RO, 0 }, */
+    { NULL,   0,       0 },
+    { "ZTAP", UNIT_RO, sizeof (t_mtrlnt) - 1 },
     { NULL,   0,       0 }
     };
 
+#define MT_IS_SIMH(f)   (((f) == MTUF_F_STD) || ((f) == MTUF_F_E11) || ((f) == MTUF_F_ZTP))
+
 t_stat sim_tape_ioerr (UNIT *uptr);
 t_stat sim_tape_wrdata (UNIT *uptr, uint32 dat);
 uint32 sim_tape_tpc_map (UNIT *uptr, t_addr *map);
 t_addr sim_tape_tpc_fnd (UNIT *uptr, t_addr *map);
+static void sim_tape_idx_trunc (UNIT *uptr, t_addr pos);
+static void sim_tape_idx_free (UNIT *uptr);
+static t_stat sim_tape_buf_flush (UNIT *uptr);
+static void sim_tape_buf_free (UNIT *uptr);
+static int32 sim_tape_buf_read (UNIT *uptr, t_addr pos, void *buf, uint32 len);
+static int32 sim_tape_img_read (UNIT *uptr, t_addr pos, void *buf, uint32 len);
+static t_addr sim_tape_img_size (UNIT *uptr);
+static t_stat sim_tape_ztp_open (UNIT *uptr);
+static int32 sim_tape_ztp_read (UNIT *uptr, t_addr pos, uint8 *buf, uint32 len);
+static void sim_tape_ztp_close (UNIT *uptr);
+
+/* Record index entry (SIMH and E11 formats) */
+
+typedef struct {
+    t_addr              start;              /* position of record length or tape mark */
+    t_addr              end;                /* position after the record */
+    t_mtrlnt            bc;                 /* record length (with error flag) or MTR_TMK */
+    } TAPE_IDXENT;
+
+#define IDX_OPEN        0                   /* index scan can continue */
+#define IDX_EOM         1                   /* scan reached end of medium */
+#define IDX_STOP        2                   /* scan stopped (bad record, I/O error) */
 
 struct tape_context {
     DEVICE              *dptr;              /* Device for unit (access to debug flags) */
     uint32              dbit;               /* debugging bit */
+    TAPE_IDXENT         *idx;               /* record/tape mark index */
+    uint32              idx_cnt;            /* records indexed */
+    uint32              idx_max;            /* entries allocated */
+    uint32              *idx_tmk;           /* index entry numbers of tape marks */
+    uint32              idx_tmkcnt;         /* tape marks indexed */
+    uint32              idx_tmkmax;         /* entries allocated */
+    t_addr              idx_scan;           /* position the index covers up to */
+    int                 idx_state;          /* scan state */
+    uint8               *sbuf;              /* stream buffer */
+    t_addr              sbuf_pos;           /* image position of buffer */
+    uint32              sbuf_len;           /* bytes valid in buffer */
+    t_bool              sbuf_dirty;         /* buffer holds unwritten data */
+    t_offset            *ztp_idx;           /* ZTAP block positions */
+    uint32              ztp_cnt;            /* ZTAP block count */
+    uint32              ztp_bsize;          /* ZTAP block size */
+    t_addr              ztp_size;           /* ZTAP image size */
+    uint8               *ztp_blk;           /* current block, expanded */
+    uint32              ztp_cur;            /* current block number */
+    uint8               *ztp_cbuf;          /* compressed block buffer */
+    uint32              ztp_cmax;           /* largest compressed block */
+    t_bool              ztp_auto;           /* format was detected */
 #if defined SIM_ASYNCH_IO
     int                 asynch_io;          /* Asynchronous Interrupt scheduling enabled */
     int                 asynch_io_latency;  /* instructions to delay pending interrupt */
@@ -416,6 +466,8 @@ sim_tape_clr_async (uptr);
 if (sim_asynch_enabled)
     sim_tape_set_async (uptr, ctx->asynch_io_latency);
 #endif
+sim_tape_buf_flush (uptr);
+sim_tape_buf_free (uptr);
 fflush (uptr->fileref);
 }
 
@@ -471,6 +523,25 @@ uptr->tape_ctx = ctx = (struct tape_context *)calloc(1, sizeof(struct tape_conte
 ctx->dptr = dptr;                                       /* save DEVICE pointer */
 ctx->dbit = dbit;                                       /* save debug bit */
 
+if (MT_GET_FMT (uptr) == MTUF_F_STD) {                  /* look for container */
+    char magic[sizeof (ZTP_MAGIC) - 1];
+
+    sim_fseek (uptr->fileref, 0, SEEK_SET);
+    if ((sim_fread (magic, sizeof (char), sizeof (magic), uptr->fileref) == sizeof (magic)) &&
+        (memcmp (magic, ZTP_MAGIC, sizeof (magic)) == 0)) {
+        uptr->flags = (uptr->flags & ~MTUF_FMT) | MT_F_ZTP | UNIT_RO;
+        ctx->ztp_auto = TRUE;
+        }
+    clearerr (uptr->fileref);
+    }
+if (MT_GET_FMT (uptr) == MTUF_F_ZTP) {                  /* ZTAP? */
+    r = sim_tape_ztp_open (uptr);                       /* read index */
+    if (r != SCPE_OK) {
+        sim_tape_detach (uptr);
+        return r;
+        }
+    }
+
 sim_tape_rewind (uptr);
 
 #if defined (SIM_ASYNCH_IO)
@@ -485,6 +556,7 @@ return SCPE_OK;
 
 t_stat sim_tape_detach (UNIT *uptr)
 {
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
 uint32 f = MT_GET_FMT (uptr);
 t_stat r;
 
@@ -508,11 +580,19 @@ switch (f) {                                            /* case on format */
         uptr->hwmark = 0;
         break;
 
+    case MTUF_F_ZTP:                                    /* ZTAP */
+        sim_tape_ztp_close (uptr);
+        if (ctx && ctx->ztp_auto)                       /* format detected? */
+            uptr->flags = (uptr->flags & ~MTUF_FMT) | MT_F_STD;
+        break;
+
     default:
         break;
         }
 
 sim_tape_rewind (uptr);
+sim_tape_idx_free (uptr);
+sim_tape_buf_free (uptr);
 free (uptr->tape_ctx);
 uptr->tape_ctx = NULL;
 uptr->io_flush = NULL;
@@ -540,7 +620,7 @@ fprintf (st, "    -R          Attach Read Only.\n");
 fprintf (st, "    -E          Must Exist (if not specified an attempt to create the indicated\n");
 fprintf (st, "                virtual tape will be attempted).\n");
 fprintf (st, "    -F          Open the indicated tape container in a specific format (default\n");
-fprintf (st, "                is SIMH, alternatives are E11, TPC and P7B)\n");
+fprintf (st, "                is SIMH, alternatives are E11, TPC, P7B and ZTAP)\n");
 return SCPE_OK;
 }
 
@@ -585,6 +665,514 @@ if (ctx->dptr->dctrl & reason) {
     }
 }
 
+/* Record index (SIMH and E11 formats)
+
+   Spacing and reverse reads would otherwise walk the image one record
+   length at a time.  Instead, the position, length and end of every record
+   and tape mark are indexed, along with a separate list of the tape marks,
+   so that spacing over records and files is a binary search and a reverse
+   read is a single seek.  The index is built lazily, by scanning forward
+   from BOT in large reads only as far as an operation needs, following the
+   same rules as sim_tape_rdlntf (gaps are skipped, and scanning ends at an
+   end of medium marker or the physical end of file).  A record that runs
+   past the end of the file, or a read error, stops the scan; positions
+   beyond that are handled the old way.  A write discards the entries at or
+   beyond the write position, and the scan resumes from there on demand.
+   Reverse motion thus follows the leading record lengths, which matters
+   only on a damaged image whose trailing lengths disagree with them.
+*/
+
+static void sim_tape_idx_free (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (ctx == NULL)
+    return;
+free (ctx->idx);
+free (ctx->idx_tmk);
+ctx->idx = NULL;
+ctx->idx_tmk = NULL;
+ctx->idx_cnt = ctx->idx_max = 0;
+ctx->idx_tmkcnt = ctx->idx_tmkmax = 0;
+ctx->idx_scan = 0;
+ctx->idx_state = IDX_OPEN;
+}
+
+/* Discard index entries that a write at pos may have changed */
+
+static void sim_tape_idx_trunc (UNIT *uptr, t_addr pos)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (ctx == NULL)
+    return;
+while ((ctx->idx_cnt > 0) && (ctx->idx[ctx->idx_cnt - 1].end > pos))
+    ctx->idx_cnt--;
+while ((ctx->idx_tmkcnt > 0) && (ctx->idx_tmk[ctx->idx_tmkcnt - 1] >= ctx->idx_cnt))
+    ctx->idx_tmkcnt--;
+ctx->idx_scan = ctx->idx_cnt? ctx->idx[ctx->idx_cnt - 1].end: 0;
+ctx->idx_state = IDX_OPEN;
+}
+
+static t_bool sim_tape_idx_add (struct tape_context *ctx, t_addr start, t_addr end, t_mtrlnt bc)
+{
+if (ctx->idx_cnt >= ctx->idx_max) {
+    uint32 nmax = ctx->idx_max? 2 * ctx->idx_max: 1024;
+    TAPE_IDXENT *nidx = (TAPE_IDXENT *) realloc (ctx->idx, nmax * sizeof (TAPE_IDXENT));
+
+    if (nidx == NULL)
+        return FALSE;
+    ctx->idx = nidx;
+    ctx->idx_max = nmax;
+    }
+if ((bc == MTR_TMK) && (ctx->idx_tmkcnt >= ctx->idx_tmkmax)) {
+    uint32 nmax = ctx->idx_tmkmax? 2 * ctx->idx_tmkmax: 64;
+    uint32 *ntmk = (uint32 *) realloc (ctx->idx_tmk, nmax * sizeof (uint32));
+
+    if (ntmk == NULL)
+        return FALSE;
+    ctx->idx_tmk = ntmk;
+    ctx->idx_tmkmax = nmax;
+    }
+if (bc == MTR_TMK)
+    ctx->idx_tmk[ctx->idx_tmkcnt++] = ctx->idx_cnt;
+ctx->idx[ctx->idx_cnt].start = start;
+ctx->idx[ctx->idx_cnt].end = end;
+ctx->idx[ctx->idx_cnt].bc = bc;
+ctx->idx_cnt++;
+return TRUE;
+}
+
+/* Extend the index scan until it passes position upto and, beyond that,
+   until it holds nrecs records or ntmks tape marks */
+
+static void sim_tape_idx_scan (UNIT *uptr, t_addr upto, uint32 nrecs, uint32 ntmks)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+uint32 f = MT_GET_FMT (uptr);
+t_addr pos, fsize;
+t_mtrlnt bc, sbc;
+
+if (ctx->idx_state != IDX_OPEN)
+    return;
+fsize = sim_tape_img_size (uptr);
+while ((ctx->idx_scan <= upto) ||
+       ((ctx->idx_cnt < nrecs) && (ctx->idx_tmkcnt < ntmks))) {
+    pos = ctx->idx_scan;
+    if ((pos + sizeof (t_mtrlnt)) > fsize) {            /* physical eof? */
+        ctx->idx_state = IDX_EOM;
+        break;
+        }
+    if (sim_tape_buf_read (uptr, pos, &bc, sizeof (t_mtrlnt)) != sizeof (t_mtrlnt)) {
+        clearerr (uptr->fileref);
+        ctx->idx_state = IDX_STOP;
+        break;
+        }
+    if (bc == MTR_EOM) {                                /* end of medium? */
+        ctx->idx_state = IDX_EOM;
+        break;
+        }
+    pos = pos + sizeof (t_mtrlnt);                      /* spc over rec lnt */
+    if (bc == MTR_FHGAP)                                /* half gap? */
+        pos = pos + sizeof (t_mtrlnt) / 2;
+    else if (bc != MTR_GAP) {
+        if (bc != MTR_TMK) {                            /* data record? */
+            sbc = MTR_L (bc);
+            pos = pos + sizeof (t_mtrlnt) +             /* spc over record */
+                ((f == MTUF_F_E11)? sbc: ((sbc + 1) & ~1));
+            if (pos > fsize) {                          /* runs past eof? */
+                ctx->idx_state = IDX_STOP;
+                break;
+                }
+            }
+        if (!sim_tape_idx_add (ctx, ctx->idx_scan, pos, bc))
+            break;                                      /* no memory */
+        }
+    ctx->idx_scan = pos;
+    }
+}
+
+/* Find the first indexed record at or after position pos.  Returns FALSE if
+   the index is unusable at pos (unsupported format, not scanned that far,
+   or pos is inside a record). */
+
+static t_bool sim_tape_idx_find (UNIT *uptr, t_addr pos, uint32 *rec)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+uint32 f = MT_GET_FMT (uptr);
+uint32 lo, hi, p;
+
+if ((ctx == NULL) || !MT_IS_SIMH (f))
+    return FALSE;
+sim_tape_idx_scan (uptr, pos, 0, 0);
+if (pos > ctx->idx_scan)                                /* beyond the index? */
+    return FALSE;
+lo = 0;
+hi = ctx->idx_cnt;
+while (lo < hi) {                                       /* binary search */
+    p = (lo + hi) >> 1;
+    if (ctx->idx[p].start < pos)
+        lo = p + 1;
+    else hi = p;
+    }
+if ((lo > 0) && (ctx->idx[lo - 1].end > pos))           /* inside a record? */
+    return FALSE;
+*rec = lo;
+return TRUE;
+}
+
+/* Find the first indexed tape mark at or after record rec (ntmk if none) */
+
+static uint32 sim_tape_idx_tmk (struct tape_context *ctx, uint32 rec)
+{
+uint32 lo = 0, hi = ctx->idx_tmkcnt, p;
+
+while (lo < hi) {
+    p = (lo + hi) >> 1;
+    if (ctx->idx_tmk[p] < rec)
+        lo = p + 1;
+    else hi = p;
+    }
+return lo;
+}
+
+/* Space up to count records forward or reverse using the index, stopping at
+   a tape mark as sim_tape_sprecsf and sim_tape_sprecsr do.  Returns TRUE with
+   *st set if the operation is complete.  Otherwise the tape may have been
+   moved, *skipped is the number of records passed so far, and the caller
+   finishes the operation record by record. */
+
+static t_bool sim_tape_idx_space (UNIT *uptr, t_bool rev, uint32 count, uint32 *skipped, t_stat *st)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+uint32 rec, last, t, want;
+
+*skipped = 0;
+if (MT_TST_PNU (uptr) || !sim_tape_idx_find (uptr, uptr->pos, &rec))
+    return FALSE;
+if (rev) {                                              /* reverse */
+    if (rec == 0)                                       /* nothing before */
+        return FALSE;
+    last = rec - 1;
+    t = sim_tape_idx_tmk (ctx, rec);                    /* tape marks before */
+    if ((t > 0) && ((last - ctx->idx_tmk[t - 1]) < count)) {
+        *skipped = last - ctx->idx_tmk[t - 1];          /* stop at tape mark */
+        uptr->pos = ctx->idx[ctx->idx_tmk[t - 1]].start;
+        *st = MTSE_TMK;
+        return TRUE;
+        }
+    if (count <= last + 1) {                            /* count satisfied? */
+        *skipped = count;
+        uptr->pos = ctx->idx[last + 1 - count].start;
+        *st = MTSE_OK;
+        return TRUE;
+        }
+    *skipped = last + 1;                                /* back to first rec */
+    uptr->pos = ctx->idx[0].start;
+    return FALSE;                                       /* caller finds BOT */
+    }
+want = (count > (0xFFFFFFFF - rec))? 0xFFFFFFFF: rec + count;
+t = sim_tape_idx_tmk (ctx, rec);                        /* tape marks before */
+sim_tape_idx_scan (uptr, uptr->pos, want, t + 1);       /* scan far enough */
+MT_CLR_PNU (uptr);
+if ((t < ctx->idx_tmkcnt) && ((ctx->idx_tmk[t] - rec) < count)) {
+    *skipped = ctx->idx_tmk[t] - rec;                   /* stop after tape mark */
+    uptr->pos = ctx->idx[ctx->idx_tmk[t]].end;
+    *st = MTSE_TMK;
+    return TRUE;
+    }
+if (ctx->idx_cnt >= want) {                             /* count satisfied? */
+    *skipped = count;
+    uptr->pos = ctx->idx[want - 1].end;
+    *st = MTSE_OK;
+    return TRUE;
+    }
+*skipped = ctx->idx_cnt - rec;                          /* ran out of index */
+if (*skipped)
+    uptr->pos = ctx->idx[ctx->idx_cnt - 1].end;
+if (ctx->idx_state != IDX_EOM)                          /* not at eom? */
+    return FALSE;
+uptr->pos = ctx->idx_scan;                              /* at eom marker */
+MT_SET_PNU (uptr);
+*st = MTSE_EOM;
+return TRUE;
+}
+
+/* Stream buffer (SIMH and E11 formats)
+
+   Records are read and written in place through a per-unit buffer rather
+   than with a seek and several small stdio calls each.  A read that misses
+   the buffer refills it with a large read starting at the requested
+   position, so a sequential pass over the image costs one host read per
+   buffer.  Sequential writes are gathered in the same buffer and written
+   together when it fills, when a tape mark is written, when the tape is
+   rewound, when the simulator stops, at detach, and before anything else
+   reads or writes the image directly.  Write errors are thus reported at
+   the flush rather than by the write that buffered the data.
+*/
+
+#define SBUF_SIZE       (256 * 1024)                    /* stream buffer size */
+
+static void sim_tape_buf_free (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (ctx == NULL)
+    return;
+free (ctx->sbuf);
+ctx->sbuf = NULL;
+ctx->sbuf_len = 0;
+ctx->sbuf_dirty = FALSE;
+}
+
+/* Write out buffered data.  The buffer contents remain valid for reading. */
+
+static t_stat sim_tape_buf_flush (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if ((ctx == NULL) || !ctx->sbuf_dirty)
+    return MTSE_OK;
+ctx->sbuf_dirty = FALSE;
+sim_fseek (uptr->fileref, ctx->sbuf_pos, SEEK_SET);
+sim_fwrite (ctx->sbuf, sizeof (uint8), ctx->sbuf_len, uptr->fileref);
+if (ferror (uptr->fileref)) {                           /* error? */
+    ctx->sbuf_len = 0;                                  /* contents suspect */
+    return sim_tape_ioerr (uptr);
+    }
+return MTSE_OK;
+}
+
+/* Read len bytes at position pos.  Returns the number of bytes read, which
+   is short at the end of the image, or -1 on a read error (with the stream
+   error indicator left set for sim_tape_ioerr).  A refill below the current
+   window is taken as reverse motion and fills the window backward. */
+
+static int32 sim_tape_buf_read (UNIT *uptr, t_addr pos, void *buf, uint32 len)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+t_addr start;
+int32 n;
+
+if ((pos >= ctx->sbuf_pos) && (pos + len <= ctx->sbuf_pos + ctx->sbuf_len)) {
+    memcpy (buf, ctx->sbuf + (size_t) (pos - ctx->sbuf_pos), len);  /* hit */
+    return (int32) len;
+    }
+if (sim_tape_buf_flush (uptr) != MTSE_OK)               /* write out first */
+    return -1;
+if ((len >= SBUF_SIZE) ||                               /* too big to buffer? */
+    ((ctx->sbuf == NULL) && ((ctx->sbuf = (uint8 *) malloc (SBUF_SIZE)) == NULL))) {
+    ctx->sbuf_len = 0;
+    return sim_tape_img_read (uptr, pos, buf, len);
+    }
+start = pos;
+if (pos < ctx->sbuf_pos)                                /* moving backward? */
+    start = ((pos + len) > SBUF_SIZE)? pos + len - SBUF_SIZE: 0;
+ctx->sbuf_len = 0;
+n = sim_tape_img_read (uptr, start, ctx->sbuf, SBUF_SIZE);  /* refill */
+if (n < 0)
+    return -1;
+ctx->sbuf_pos = start;
+ctx->sbuf_len = (uint32) n;
+if ((start + n) <= pos)                                 /* nothing there? */
+    return 0;
+n = (int32) (start + n - pos);
+if ((uint32) n > len)
+    n = (int32) len;
+memcpy (buf, ctx->sbuf + (size_t) (pos - start), n);
+return n;
+}
+
+/* Read directly from the image, expanding compressed containers */
+
+static int32 sim_tape_img_read (UNIT *uptr, t_addr pos, void *buf, uint32 len)
+{
+uint32 n;
+
+if (MT_GET_FMT (uptr) == MTUF_F_ZTP)
+    return sim_tape_ztp_read (uptr, pos, (uint8 *) buf, len);
+sim_fseek (uptr->fileref, pos, SEEK_SET);
+n = (uint32) sim_fread (buf, sizeof (uint8), len, uptr->fileref);
+return ferror (uptr->fileref)? -1: (int32) n;
+}
+
+/* Size of the image as the tape routines see it */
+
+static t_addr sim_tape_img_size (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (MT_GET_FMT (uptr) == MTUF_F_ZTP)
+    return ctx->ztp_size;
+sim_tape_buf_flush (uptr);
+return (t_addr) sim_fsize_ex (uptr->fileref);
+}
+
+/* Write len bytes at position pos */
+
+static t_stat sim_tape_buf_write (UNIT *uptr, t_addr pos, void *buf, uint32 len)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+t_stat st;
+
+if (!ctx->sbuf_dirty ||                                 /* not appending? */
+    (pos != ctx->sbuf_pos + ctx->sbuf_len) ||
+    (ctx->sbuf_len + len > SBUF_SIZE)) {
+    if ((st = sim_tape_buf_flush (uptr)) != MTSE_OK)    /* write out old */
+        return st;
+    ctx->sbuf_len = 0;                                  /* discard read ahead */
+    if ((len >= SBUF_SIZE) ||                           /* too big to buffer? */
+        ((ctx->sbuf == NULL) && ((ctx->sbuf = (uint8 *) malloc (SBUF_SIZE)) == NULL))) {
+        sim_fseek (uptr->fileref, pos, SEEK_SET);
+        sim_fwrite (buf, sizeof (uint8), len, uptr->fileref);
+        return ferror (uptr->fileref)? sim_tape_ioerr (uptr): MTSE_OK;
+        }
+    ctx->sbuf_pos = pos;
+    ctx->sbuf_dirty = TRUE;
+    }
+memcpy (ctx->sbuf + ctx->sbuf_len, buf, len);
+ctx->sbuf_len = ctx->sbuf_len + len;
+return MTSE_OK;
+}
+
+/* ZTAP compressed container
+
+   The container holds a SIMH format image in fixed size blocks, each
+   compressed on its own (see sim_tape.h).  The block index is read at
+   attach, and reads expand one block at a time into a cached copy, so
+   that the stream buffer and the record index above work unchanged and
+   a seek costs at most one block decompression.  Containers are read
+   only; the ztap utility builds them from SIMH images.
+*/
+
+#if defined (HAVE_ZLIB)
+static t_offset sim_tape_ztp_get (const uint8 *p, int32 n)
+{
+t_offset v = 0;
+
+while (n-- > 0)                                         /* little endian */
+    v = (v << 8) | p[n];
+return v;
+}
+#endif
+
+static void sim_tape_ztp_close (UNIT *uptr)
+{
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+
+if (ctx == NULL)
+    return;
+free (ctx->ztp_idx);
+free (ctx->ztp_blk);
+free (ctx->ztp_cbuf);
+ctx->ztp_idx = NULL;
+ctx->ztp_blk = ctx->ztp_cbuf = NULL;
+ctx->ztp_cnt = 0;
+ctx->ztp_size = 0;
+}
+
+static t_stat sim_tape_ztp_open (UNIT *uptr)
+{
+#if defined (HAVE_ZLIB)
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+uint8 hdr[ZTP_HDRSIZE], *ibuf;
+t_offset ipos, fsize;
+uint32 i, n;
+
+sim_fseek (uptr->fileref, 0, SEEK_SET);
+if ((sim_fread (hdr, sizeof (uint8), ZTP_HDRSIZE, uptr->fileref) != ZTP_HDRSIZE) ||
+    (memcmp (hdr, ZTP_MAGIC, 8) != 0) ||
+    (sim_tape_ztp_get (hdr + 8, 4) != ZTP_VERSION))
+    return SCPE_FMT;
+ctx->ztp_bsize = (uint32) sim_tape_ztp_get (hdr + 12, 4);
+ctx->ztp_size = (t_addr) sim_tape_ztp_get (hdr + 16, 8);
+ctx->ztp_cnt = n = (uint32) sim_tape_ztp_get (hdr + 24, 4);
+ipos = sim_tape_ztp_get (hdr + 32, 8);
+fsize = sim_fsize_ex (uptr->fileref);
+if ((ctx->ztp_bsize < ZTP_MINBLK) || (ctx->ztp_bsize > ZTP_MAXBLK) ||
+    (((t_offset) n * ctx->ztp_bsize) < (t_offset) ctx->ztp_size) ||
+    ((n > 0) && (((t_offset) (n - 1) * ctx->ztp_bsize) >= (t_offset) ctx->ztp_size)) ||
+    (ipos < ZTP_HDRSIZE) || ((ipos + 8 * ((t_offset) n + 1)) > fsize))
+    return SCPE_FMT;
+ctx->ztp_idx = (t_offset *) calloc (n + 1, sizeof (t_offset));
+ibuf = (uint8 *) malloc (8 * ((size_t) n + 1));
+if ((ctx->ztp_idx == NULL) || (ibuf == NULL)) {
+    free (ibuf);
+    return SCPE_MEM;
+    }
+sim_fseek (uptr->fileref, ipos, SEEK_SET);
+if (sim_fread (ibuf, 8, n + 1, uptr->fileref) != (n + 1)) {
+    free (ibuf);
+    return SCPE_FMT;
+    }
+for (i = 0; i <= n; i++)
+    ctx->ztp_idx[i] = sim_tape_ztp_get (ibuf + 8 * (size_t) i, 8);
+free (ibuf);
+if ((ctx->ztp_idx[0] != ZTP_HDRSIZE) || (ctx->ztp_idx[n] != ipos))
+    return SCPE_FMT;
+ctx->ztp_cmax = 0;
+for (i = 0; i < n; i++) {                               /* find largest block */
+    if ((ctx->ztp_idx[i + 1] < ctx->ztp_idx[i]) ||
+        ((ctx->ztp_idx[i + 1] - ctx->ztp_idx[i]) > (t_offset) compressBound (ctx->ztp_bsize)))
+        return SCPE_FMT;
+    if ((ctx->ztp_idx[i + 1] - ctx->ztp_idx[i]) > ctx->ztp_cmax)
+        ctx->ztp_cmax = (uint32) (ctx->ztp_idx[i + 1] - ctx->ztp_idx[i]);
+    }
+ctx->ztp_blk = (uint8 *) malloc (ctx->ztp_bsize);
+ctx->ztp_cbuf = (uint8 *) malloc (ctx->ztp_cmax + 1);
+if ((ctx->ztp_blk == NULL) || (ctx->ztp_cbuf == NULL))
+    return SCPE_MEM;
+ctx->ztp_cur = n;                                       /* nothing cached */
+return SCPE_OK;
+#else
+char *msg = "Tape: ZTAP images are not supported in this build\r\n";
+printf ("%s", msg);
+if (sim_log) fprintf (sim_log, "%s", msg);
+return SCPE_NOFNC;
+#endif
+}
+
+/* Read from the expanded image.  A block that fails to expand is reported
+   and treated as a read error. */
+
+static int32 sim_tape_ztp_read (UNIT *uptr, t_addr pos, uint8 *buf, uint32 len)
+{
+#if defined (HAVE_ZLIB)
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+uint32 blk, off, blen, clen, n, done = 0;
+uLongf dlen;
+
+while ((done < len) && (pos < ctx->ztp_size)) {
+    blk = (uint32) (pos / ctx->ztp_bsize);
+    off = (uint32) (pos % ctx->ztp_bsize);
+    blen = ((ctx->ztp_size - (t_addr) blk * ctx->ztp_bsize) < ctx->ztp_bsize)?
+        (uint32) (ctx->ztp_size - (t_addr) blk * ctx->ztp_bsize): ctx->ztp_bsize;
+    if (blk != ctx->ztp_cur) {                          /* expand block */
+        ctx->ztp_cur = ctx->ztp_cnt;
+        clen = (uint32) (ctx->ztp_idx[blk + 1] - ctx->ztp_idx[blk]);
+        dlen = ctx->ztp_bsize;
+        sim_fseek (uptr->fileref, ctx->ztp_idx[blk], SEEK_SET);
+        if (sim_fread (ctx->ztp_cbuf, sizeof (uint8), clen, uptr->fileref) != clen)
+            return -1;
+        if ((uncompress (ctx->ztp_blk, &dlen, ctx->ztp_cbuf, clen) != Z_OK) ||
+            (dlen != blen)) {
+            printf ("%s: ZTAP block %u is damaged\n", sim_uname (uptr), blk);
+            if (sim_log) fprintf (sim_log, "%s: ZTAP block %u is damaged\n", sim_uname (uptr), blk);
+            return -1;
+            }
+        ctx->ztp_cur = blk;
+        }
+    n = ((blen - off) < (len - done))? blen - off: len - done;
+    memcpy (buf + done, ctx->ztp_blk + off, n);
+    done = done + n;
+    pos = pos + n;
+    }
+return (int32) done;
+#else
+return -1;
+#endif
+}
+
 /* Read record length forward (internal routine)
 
    Inputs:
@@ -600,6 +1188,7 @@ if (ctx->dptr->dctrl & reason) {
    end of file/medium   unchanged, PNU set
    tape mark            updated
    data record          updated, sim_fread will read record forward
+                        (TPC and P7B formats)
 
    See notes at "sim_tape_wrgap" regarding erase gap implementation.
 */
@@ -609,42 +1198,41 @@ t_stat sim_tape_rdlntf (UNIT *uptr, t_mtrlnt *bc)
 uint8 c;
 t_bool all_eof;
 uint32 f = MT_GET_FMT (uptr);
+int32 n;
 t_mtrlnt sbc;
 t_tpclnt tpcbc;
 
 MT_CLR_PNU (uptr);
 if ((uptr->flags & UNIT_ATT) == 0)                      /* not attached? */
     return MTSE_UNATT;
-sim_fseek (uptr->fileref, uptr->pos, SEEK_SET);         /* set tape pos */
 switch (f) {                                            /* switch on fmt */
 
-    case MTUF_F_STD: case MTUF_F_E11:
+    case MTUF_F_STD: case MTUF_F_E11: case MTUF_F_ZTP:
         do {
-            sim_fread (bc, sizeof (t_mtrlnt), 1, uptr->fileref);    /* read rec lnt */
+            n = sim_tape_buf_read (uptr, uptr->pos, bc, sizeof (t_mtrlnt)); /* read rec lnt */
             sbc = MTR_L (*bc);                          /* save rec lnt */
-            if (ferror (uptr->fileref)) {               /* error? */
+            if (n < 0) {                                /* error? */
                 MT_SET_PNU (uptr);                      /* pos not upd */
                 return sim_tape_ioerr (uptr);
                 }
-            if (feof (uptr->fileref) || (*bc == MTR_EOM)) {     /* eof or eom? */
+            if ((n < sizeof (t_mtrlnt)) || (*bc == MTR_EOM)) {  /* eof or eom? */
                 MT_SET_PNU (uptr);                      /* pos not upd */
                 return MTSE_EOM;
                 }
             uptr->pos = uptr->pos + sizeof (t_mtrlnt);  /* spc over rec lnt */
             if (*bc == MTR_TMK)                         /* tape mark? */
                 return MTSE_TMK;
-            if (*bc == MTR_FHGAP) {                     /* half gap? */
+            if (*bc == MTR_FHGAP)                       /* half gap? */
                 uptr->pos = uptr->pos + sizeof (t_mtrlnt) / 2;  /* half space fwd */
-                sim_fseek (uptr->fileref, uptr->pos, SEEK_SET); /* resync */
-                }
             else if (*bc != MTR_GAP)
                 uptr->pos = uptr->pos + sizeof (t_mtrlnt) +     /* spc over record */
-                    ((f == MTUF_F_STD)? ((sbc + 1) & ~1): sbc);
+                    ((f == MTUF_F_E11)? sbc: ((sbc + 1) & ~1));
             }
         while ((*bc == MTR_GAP) || (*bc == MTR_FHGAP));
         break;
 
     case MTUF_F_TPC:
+        sim_fseek (uptr->fileref, uptr->pos, SEEK_SET); /* set tape pos */
         sim_fread (&tpcbc, sizeof (t_tpclnt), 1, uptr->fileref);
         *bc = tpcbc;                                    /* save rec lnt */
         if (ferror (uptr->fileref)) {                   /* error? */
@@ -662,6 +1250,7 @@ switch (f) {                                            /* switch on fmt */
         break;
 
     case MTUF_F_P7B:
+        sim_fseek (uptr->fileref, uptr->pos, SEEK_SET); /* set tape pos */
         for (sbc = 0, all_eof = 1; ; sbc++) {           /* loop thru record */
             sim_fread (&c, sizeof (uint8), 1, uptr->fileref);
             if (ferror (uptr->fileref)) {               /* error? */
@@ -715,9 +1304,12 @@ return MTSE_OK;
 
 t_stat sim_tape_rdlntr (UNIT *uptr, t_mtrlnt *bc)
 {
+struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
 uint8 c;
 t_bool all_eof;
 uint32 f = MT_GET_FMT (uptr);
+uint32 rec;
+int32 n;
 t_addr ppos;
 t_mtrlnt sbc;
 t_tpclnt tpcbc;
@@ -727,31 +1319,36 @@ if ((uptr->flags & UNIT_ATT) == 0)                      /* not attached? */
     return MTSE_UNATT;
 if (sim_tape_bot (uptr))                                /* at BOT? */
     return MTSE_BOT;
+if (!MT_IS_SIMH (f) && (sim_tape_buf_flush (uptr) != MTSE_OK))
+    return MTSE_IOERR;                                  /* write out buffer */
 switch (f) {                                            /* switch on fmt */
 
-    case MTUF_F_STD: case MTUF_F_E11:
+    case MTUF_F_STD: case MTUF_F_E11: case MTUF_F_ZTP:
+        if (sim_tape_idx_find (uptr, uptr->pos, &rec) && (rec > 0)) {
+            rec = rec - 1;                              /* preceding record */
+            *bc = ctx->idx[rec].bc;
+            uptr->pos = ctx->idx[rec].start;            /* spc over record */
+            if (*bc == MTR_TMK)                         /* tape mark? */
+                return MTSE_TMK;
+            break;
+            }
         do {
-            sim_fseek (uptr->fileref, uptr->pos - sizeof (t_mtrlnt), SEEK_SET);
-            sim_fread (bc, sizeof (t_mtrlnt), 1, uptr->fileref);    /* read rec lnt */
+            n = sim_tape_buf_read (uptr, uptr->pos - sizeof (t_mtrlnt), bc, sizeof (t_mtrlnt));
             sbc = MTR_L (*bc);
-            if (ferror (uptr->fileref))                 /* error? */
+            if (n < 0)                                  /* error? */
                 return sim_tape_ioerr (uptr);
-            if (feof (uptr->fileref))                   /* eof? */
+            if (n < sizeof (t_mtrlnt))                  /* eof? */
                 return MTSE_EOM;
             uptr->pos = uptr->pos - sizeof (t_mtrlnt);  /* spc over rec lnt */
             if (*bc == MTR_EOM)                         /* eom? */
                 return MTSE_EOM;
             if (*bc == MTR_TMK)                         /* tape mark? */
                 return MTSE_TMK;
-            if ((*bc & MTR_M_RHGAP) == MTR_RHGAP) {     /* half gap? */
+            if ((*bc & MTR_M_RHGAP) == MTR_RHGAP)       /* half gap? */
                 uptr->pos = uptr->pos + sizeof (t_mtrlnt) / 2;  /* half space rev */
-                sim_fseek (uptr->fileref, uptr->pos, SEEK_SET); /* resync */
-                }
-            else if (*bc != MTR_GAP) {
+            else if (*bc != MTR_GAP)
                 uptr->pos = uptr->pos - sizeof (t_mtrlnt) - /* spc over record */
-                    ((f == MTUF_F_STD)? ((sbc + 1) & ~1): sbc);
-                sim_fseek (uptr->fileref, uptr->pos + sizeof (t_mtrlnt), SEEK_SET);
-                }
+                    ((f == MTUF_F_E11)? sbc: ((sbc + 1) & ~1));
             else if (sim_tape_bot (uptr))               /* backed into BOT? */
                 return MTSE_BOT;
         }
@@ -827,6 +1424,7 @@ struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
 uint32 f = MT_GET_FMT (uptr);
 t_mtrlnt i, tbc, rbc;
 t_addr opos;
+int32 n;
 t_stat st;
 
 sim_debug (ctx->dbit, ctx->dptr, "sim_tape_rdrecf(unit=%d, buf=%p, max=%d)\n", uptr-ctx->dptr->units, buf, max);
@@ -840,7 +1438,12 @@ if (rbc > max) {                                        /* rec out of range? */
     uptr->pos = opos;
     return MTSE_INVRL;
     }
-i = (t_mtrlnt)sim_fread (buf, sizeof (uint8), rbc, uptr->fileref);/* read record */
+if (MT_IS_SIMH (f)) {                                   /* read from buffer */
+    n = sim_tape_buf_read (uptr, uptr->pos - sizeof (t_mtrlnt) -
+        ((f == MTUF_F_E11)? rbc: ((rbc + 1) & ~1)), buf, rbc);
+    i = (n < 0)? 0: (t_mtrlnt) n;
+    }
+else i = (t_mtrlnt)sim_fread (buf, sizeof (uint8), rbc, uptr->fileref);/* read record */
 if (ferror (uptr->fileref)) {                           /* error? */
     MT_SET_PNU (uptr);
     uptr->pos = opos;
@@ -890,6 +1493,7 @@ t_stat sim_tape_rdrecr (UNIT *uptr, uint8 *buf, t_mtrlnt *bc, t_mtrlnt max)
 struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
 uint32 f = MT_GET_FMT (uptr);
 t_mtrlnt i, rbc, tbc;
+int32 n;
 t_stat st;
 
 sim_debug (ctx->dbit, ctx->dptr, "sim_tape_rdrecr(unit=%d, buf=%p, max=%d)\n", uptr-ctx->dptr->units, buf, max);
@@ -899,7 +1503,11 @@ if (MTSE_OK != (st = sim_tape_rdlntr (uptr, &tbc)))     /* read rec lnt */
 *bc = rbc = MTR_L (tbc);                                /* strip error flag */
 if (rbc > max)                                          /* rec out of range? */
     return MTSE_INVRL;
-i = (t_mtrlnt)sim_fread (buf, sizeof (uint8), rbc, uptr->fileref);/* read record */
+if (MT_IS_SIMH (f)) {                                   /* read from buffer */
+    n = sim_tape_buf_read (uptr, uptr->pos + sizeof (t_mtrlnt), buf, rbc);
+    i = (n < 0)? 0: (t_mtrlnt) n;
+    }
+else i = (t_mtrlnt)sim_fread (buf, sizeof (uint8), rbc, uptr->fileref);/* read record */
 if (ferror (uptr->fileref))                             /* error? */
     return sim_tape_ioerr (uptr);
 for ( ; i < rbc; i++)                                   /* fill with 0's */
@@ -951,23 +1559,23 @@ if (sim_tape_wrp (uptr))                                /* write prot? */
     return MTSE_WRP;
 if (sbc == 0)                                           /* nothing to do? */
     return MTSE_OK;
-sim_fseek (uptr->fileref, uptr->pos, SEEK_SET);         /* set pos */
+sim_tape_idx_trunc (uptr, uptr->pos);                   /* drop stale index */
 switch (f) {                                            /* case on format */
 
     case MTUF_F_STD:                                    /* standard */
         sbc = MTR_L ((bc + 1) & ~1);                    /* pad odd length */
     case MTUF_F_E11:                                    /* E11 */
-        sim_fwrite (&bc, sizeof (t_mtrlnt), 1, uptr->fileref);
-        sim_fwrite (buf, sizeof (uint8), sbc, uptr->fileref);
-        sim_fwrite (&bc, sizeof (t_mtrlnt), 1, uptr->fileref);
-        if (ferror (uptr->fileref)) {                   /* error? */
+        if ((sim_tape_buf_write (uptr, uptr->pos, &bc, sizeof (t_mtrlnt)) != MTSE_OK) ||
+            (sim_tape_buf_write (uptr, uptr->pos + sizeof (t_mtrlnt), buf, sbc) != MTSE_OK) ||
+            (sim_tape_buf_write (uptr, uptr->pos + sizeof (t_mtrlnt) + sbc, &bc, sizeof (t_mtrlnt)) != MTSE_OK)) {
             MT_SET_PNU (uptr);
-            return sim_tape_ioerr (uptr);
+            return MTSE_IOERR;
             }
         uptr->pos = uptr->pos + sbc + (2 * sizeof (t_mtrlnt));  /* move tape */
         break;
 
     case MTUF_F_P7B:                                    /* Pierce 7B */
+        sim_fseek (uptr->fileref, uptr->pos, SEEK_SET); /* set pos */
         buf[0] = buf[0] | P7B_SOR;                      /* mark start of rec */
         sim_fwrite (buf, sizeof (uint8), sbc, uptr->fileref);
         sim_fwrite (buf, sizeof (uint8), 1, uptr->fileref); /* delimit rec */
@@ -1000,11 +1608,10 @@ if ((uptr->flags & UNIT_ATT) == 0)                      /* not attached? */
     return MTSE_UNATT;
 if (sim_tape_wrp (uptr))                                /* write prot? */
     return MTSE_WRP;
-sim_fseek (uptr->fileref, uptr->pos, SEEK_SET);         /* set pos */
-sim_fwrite (&dat, sizeof (t_mtrlnt), 1, uptr->fileref);
-if (ferror (uptr->fileref)) {                           /* error? */
+sim_tape_idx_trunc (uptr, uptr->pos);                   /* drop stale index */
+if (sim_tape_buf_write (uptr, uptr->pos, &dat, sizeof (t_mtrlnt)) != MTSE_OK) {
     MT_SET_PNU (uptr);
-    return sim_tape_ioerr (uptr);
+    return MTSE_IOERR;
     }
 uptr->pos = uptr->pos + sizeof (t_mtrlnt);              /* move tape */
 return MTSE_OK;
@@ -1015,13 +1622,20 @@ return MTSE_OK;
 t_stat sim_tape_wrtmk (UNIT *uptr)
 {
 struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
+t_stat st;
 
 sim_debug (ctx->dbit, ctx->dptr, "sim_tape_wrtmk(unit=%d)\n", uptr-ctx->dptr->units);
 if (MT_GET_FMT (uptr) == MTUF_F_P7B) {                  /* P7B? */
     uint8 buf = P7B_EOF;                                /* eof mark */
     return sim_tape_wrrecf (uptr, &buf, 1);             /* write char */
     }
-return sim_tape_wrdata (uptr, MTR_TMK);
+st = sim_tape_wrdata (uptr, MTR_TMK);
+if ((st == MTSE_OK) && (sim_tape_buf_flush (uptr) != MTSE_OK)) {
+    MT_SET_PNU (uptr);                                  /* pos not upd */
+    uptr->pos = uptr->pos - sizeof (t_mtrlnt);
+    st = MTSE_IOERR;
+    }
+return st;
 }
 
 t_stat sim_tape_wrtmk_a (UNIT *uptr, TAPE_PCALLBACK callback)
@@ -1192,6 +1806,10 @@ if (format != MTUF_F_STD)                               /* not SIMH fmt? */
 if (sim_tape_wrp (uptr))                                /* write protected? */
     return MTSE_WRP;
 
+if (sim_tape_buf_flush (uptr) != MTSE_OK) {             /* write out buffer */
+    MT_SET_PNU (uptr);
+    return MTSE_IOERR;
+    }
 file_size = sim_fsize (uptr->fileref);                  /* get file size */
 sim_fseek (uptr->fileref, uptr->pos, SEEK_SET);         /* position tape */
 
@@ -1384,6 +2002,9 @@ t_mtrlnt tbc;
 sim_debug (ctx->dbit, ctx->dptr, "sim_tape_sprecsf(unit=%d, count=%d)\n", uptr-ctx->dptr->units, count);
 
 *skipped = 0;
+if ((count > 1) &&                                      /* use the index */
+    sim_tape_idx_space (uptr, FALSE, count, skipped, &st))
+    return st;
 while (*skipped < count) {                              /* loopo */
     st = sim_tape_sprecf (uptr, &tbc);                  /* spc rec */
     if (st != MTSE_OK)
@@ -1476,6 +2097,9 @@ t_mtrlnt tbc;
 sim_debug (ctx->dbit, ctx->dptr, "sim_tape_sprecsr(unit=%d, count=%d)\n", uptr-ctx->dptr->units, count);
 
 *skipped = 0;
+if ((count > 1) &&                                      /* use the index */
+    sim_tape_idx_space (uptr, TRUE, count, skipped, &st))
+    return st;
 while (*skipped < count) {                              /* loopo */
     st = sim_tape_sprecr (uptr, &tbc);                  /* spc rec rev */
     if (st != MTSE_OK)
@@ -1706,6 +2330,7 @@ struct tape_context *ctx = (struct tape_context *)uptr->tape_ctx;
 
 if (uptr->flags & UNIT_ATT) {
     sim_debug (ctx->dbit, ctx->dptr, "sim_tape_rewind(unit=%d)\n", uptr-ctx->dptr->units);
+    sim_tape_buf_flush (uptr);                          /* write out buffer */
     }
 uptr->pos = 0;
 MT_CLR_PNU (uptr);
@@ -1844,6 +2469,14 @@ if (cptr == NULL)
     return SCPE_ARG;
 for (f = 0; f < MTUF_N_FMT; f++) {
     if (fmts[f].name && (strcmp (cptr, fmts[f].name) == 0)) {
+        if (uptr->flags & UNIT_ATT) {                   /* changing under us? */
+            if ((f != MT_GET_FMT (uptr)) &&             /* container differs? */
+                ((f == MTUF_F_ZTP) || (MT_GET_FMT (uptr) == MTUF_F_ZTP)))
+                return SCPE_ALATT;
+            sim_tape_buf_flush (uptr);
+            sim_tape_buf_free (uptr);
+            sim_tape_idx_free (uptr);
+            }
         uptr->flags = (uptr->flags & ~MTUF_FMT) |
             (f << MTUF_V_FMT) | fmts[f].uflags;
         return SCPE_OK;
@@ -63,6 +63,32 @@ typedef uint16          t_tpclnt;                       /* magtape rec lnt */
 
 #define TPC_TMK         0x0000                          /* tape mark */
 
+/* ZTAP compressed tape format
+
+   A SIMH format image, cut into fixed size blocks that are each compressed
+   as an independent zlib stream, so that any position can be reached by
+   decompressing a single block.  All fields are little endian.
+
+   header   8 bytes     ZTP_MAGIC
+            4 bytes     format version (ZTP_VERSION)
+            4 bytes     block size, before compression
+            8 bytes     size of the SIMH image
+            4 bytes     number of blocks, n
+            4 bytes     reserved, zero
+            8 bytes     position of the block index
+   blocks               n compressed blocks, in order
+   index    8 bytes     position of each block, then the index position,
+                        n + 1 entries in all
+
+   The ztap utility converts between SIMH and ZTAP images.
+*/
+
+#define ZTP_MAGIC       "SIMHZTAP"                      /* file signature */
+#define ZTP_VERSION     1
+#define ZTP_HDRSIZE     40                              /* header size */
+#define ZTP_MINBLK      512                             /* block size limits */
+#define ZTP_MAXBLK      (16 * 1024 * 1024)
+
 /* Unit flags */
 
 #define MTUF_V_PNU      (UNIT_V_UF + 0)                 /* position not upd */
@@ -76,6 +102,7 @@ typedef uint16          t_tpclnt;                       /* magtape rec lnt */
 #define MTUF_F_TPC       2                              /* TPC format */
 #define MTUF_F_P7B       3                              /* P7B format */
 #define MUTF_F_TDF       4                              /* TDF format */
+#define MTUF_F_ZTP       5                              /* ZTAP format */
 #define MTUF_V_UF       (MTUF_V_FMT + MTUF_W_FMT)
 #define MTUF_PNU        (1u << MTUF_V_PNU)
 #define MTUF_WLK        (1u << MTUF_V_WLK)
@@ -87,6 +114,7 @@ typedef uint16          t_tpclnt;                       /* magtape rec lnt */
 #define MT_F_TPC        (MTUF_F_TPC << MTUF_V_FMT)
 #define MT_F_P7B        (MTUF_F_P7B << MTUF_V_FMT)
 #define MT_F_TDF        (MTUF_F_TDF << MTUF_V_FMT)
+#define MT_F_ZTP        (MTUF_F_ZTP << MTUF_V_FMT)
 
 #define MT_SET_PNU(u)   (u)->flags = (u)->flags | MTUF_PNU
 #define MT_CLR_PNU(u)   (u)->flags = (u)->flags & ~MTUF_PNU
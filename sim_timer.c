@@ -68,11 +68,20 @@
    sim_os_msec  -           return elapsed time in msec
    sim_os_sleep -           sleep specified number of seconds
    sim_os_ms_sleep -        sleep specified number of milliseconds
+   sim_os_nsec -            return monotonic time in nsec
+   sim_os_ns_sleep -        sleep specified number of nanoseconds
    sim_idle_ms_sleep -      sleep specified number of milliseconds
                             or until awakened by an asynchronous
                             event
+   sim_idle_ns_sleep -      sleep specified number of nanoseconds
+                            or until awakened by an asynchronous
+                            event
+   sim_idle_wake -          awaken sim_idle_ns_sleep
    sim_timespec_diff        subtract two timespec values
    sim_timer_activate_after schedule unit for specific time
+   _sim_wallclock_drain     move handed off timer events into the wallclock heap
+   _sim_timer_cancel        remove a unit from the wallclock or coschedule queue
+   _sim_timer_activate_time time remaining on a wallclock event
 
 
    The calibration, idle, and throttle routines are OS-independent; the _os_
@@ -85,22 +94,49 @@
 #include <ctype.h>
 #include <math.h>
 
+#if defined(SIM_ASYNCH_IO) && defined(SIM_ASYNCH_CLOCKS) && defined(__linux__)
+#define SIM_TIMER_FD 1                              /* timerfd/eventfd wakeups */
+#include <unistd.h>
+#include <poll.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#endif
+#if defined(SIM_ASYNCH_IO) && defined(__linux__)
+#define SIM_IDLE_FUTEX 1                            /* futex idle waits */
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
 t_bool sim_idle_enab = FALSE;                       /* global flag */
 volatile t_bool sim_idle_wait = FALSE;              /* global flag */
+t_uint64 sim_idle_ns = 0;                           /* host ns idled or throttled */
+double sim_idle_cyc = 0.0;                          /* cycles skipped while idle */
 
 static int32 sim_calb_tmr = -1;                     /* the system calibrated timer */
 
 static uint32 sim_idle_rate_ms = 0;
+static t_bool sim_idle_rate_known = FALSE;
 static uint32 sim_os_sleep_min_ms = 0;
+static t_uint64 sim_os_sleep_min_ns = 0;
 static uint32 sim_idle_stable = SIM_IDLE_STDFLT;
 static t_bool sim_idle_idled = FALSE;
-static uint32 sim_throt_ms_start = 0;
-static uint32 sim_throt_ms_stop = 0;
 static uint32 sim_throt_type = 0;
 static uint32 sim_throt_val = 0;
 static uint32 sim_throt_state = 0;
 static uint32 sim_throt_sleep_time = 0;
 static int32 sim_throt_wait = 0;
+static t_uint64 sim_throt_ns_mark = 0;              /* time of last pacing pass */
+static t_uint64 sim_throt_ns_resume = 0;            /* time execution resumed */
+static t_uint64 sim_throt_ns_rpt = 0;               /* start of rate window */
+static double sim_throt_gtime_mark = 0.0;           /* sim_gtime at last pass */
+static double sim_throt_gtime_rpt = 0.0;            /* sim_gtime at window start */
+static double sim_throt_cps = 0.0;                  /* desired cycles/sec */
+static double sim_throt_host_cps = 0.0;             /* unthrottled cycles/sec */
+static double sim_throt_achieved = 0.0;             /* achieved cycles/sec */
+static double sim_throt_err = 0.0;                  /* schedule error, ns */
+static double sim_throt_ierr = 0.0;                 /* integral term, ns */
 UNIT *sim_clock_unit = NULL;
 t_bool sim_asynch_timer = 
 #if defined (SIM_ASYNCH_CLOCKS)
@@ -128,35 +164,91 @@ DEBTAB sim_timer_debug[] = {
 };
 
 #if defined(SIM_ASYNCH_IO)
-uint32 sim_idle_ms_sleep (unsigned int msec)
+/* Idle waits
+
+   The CPU thread idles in sim_idle_ns_sleep, which returns early whenever
+   another thread queues an event on sim_asynch_queue.  Every asynchronous
+   activation (AIO_ACTIVATE, and through it the disk and tape I/O threads,
+   the TMXR poll thread, the Ethernet reader and the timer thread) calls
+   sim_idle_wake.
+
+   On Linux the wait is a futex on sim_idle_wake_seq, which sim_idle_wake
+   bumps before waking, so a wakeup arriving between the check of the
+   queue and the wait is never lost and no lock is taken on either side.
+   Elsewhere the wait is a condition wait on sim_asynch_wake.
+*/
+
+#if defined(SIM_IDLE_FUTEX)
+static volatile int sim_idle_wake_seq = 0;          /* futex word */
+#endif
+
+void sim_idle_wake (void)
 {
-uint32 start_time = sim_os_msec();
+#if defined(SIM_IDLE_FUTEX)
+__sync_fetch_and_add (&sim_idle_wake_seq, 1);          /* full barrier */
+if (sim_idle_wait)
+    syscall (SYS_futex, &sim_idle_wake_seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+#else
+if (sim_idle_wait) {
+    pthread_mutex_lock (&sim_asynch_lock);
+    pthread_cond_signal (&sim_asynch_wake);
+    pthread_mutex_unlock (&sim_asynch_lock);
+    }
+#endif
+}
+
+t_uint64 sim_idle_ns_sleep (t_uint64 nsec)
+{
+t_uint64 start_time = sim_os_nsec ();
+t_bool woken = FALSE;
+#if defined(SIM_IDLE_FUTEX)
+int seq = sim_idle_wake_seq;
+struct timespec treq;
+
+treq.tv_sec = (time_t) (nsec / 1000000000);
+treq.tv_nsec = (long) (nsec % 1000000000);
+sim_idle_wait = TRUE;
+__sync_synchronize ();                                  /* flag before queue check */
+if (sim_asynch_queue != QUEUE_LIST_END)                 /* already pending? */
+    woken = TRUE;
+else if ((syscall (SYS_futex, &sim_idle_wake_seq, FUTEX_WAIT_PRIVATE, seq, &treq, NULL, 0) == 0) ||
+         (errno == EAGAIN))                             /* woken, or wake raced us */
+    woken = TRUE;
+sim_idle_wait = FALSE;
+#else
 struct timespec done_time;
-t_bool timedout = FALSE;
 
 clock_gettime(CLOCK_REALTIME, &done_time);
-done_time.tv_sec += (msec/1000);
-done_time.tv_nsec += 1000000*(msec%1000);
-if (done_time.tv_nsec > 1000000000) {
+done_time.tv_sec += (time_t) (nsec / 1000000000);
+done_time.tv_nsec += (long) (nsec % 1000000000);
+if (done_time.tv_nsec >= 1000000000) {
   done_time.tv_sec += done_time.tv_nsec/1000000000;
   done_time.tv_nsec = done_time.tv_nsec%1000000000;
   }
 pthread_mutex_lock (&sim_asynch_lock);
 sim_idle_wait = TRUE;
-if (!pthread_cond_timedwait (&sim_asynch_wake, &sim_asynch_lock, &done_time))
-  sim_asynch_check = 0;                 /* force check of asynch queue now */
-else
-  timedout = TRUE;
+if ((sim_asynch_queue != QUEUE_LIST_END) ||             /* already pending? */
+    (!pthread_cond_timedwait (&sim_asynch_wake, &sim_asynch_lock, &done_time)))
+  woken = TRUE;
 sim_idle_wait = FALSE;
 pthread_mutex_unlock (&sim_asynch_lock);
-if (!timedout) {
+#endif
+if (woken) {
+    sim_asynch_check = 0;                               /* force check of asynch queue now */
     AIO_UPDATE_QUEUE;
     }
-return sim_os_msec() - start_time;
+return sim_os_nsec () - start_time;
+}
+
+uint32 sim_idle_ms_sleep (unsigned int msec)
+{
+return (uint32) ((sim_idle_ns_sleep (((t_uint64) msec) * 1000000) + 500000) / 1000000);
 }
 #define SIM_IDLE_MS_SLEEP sim_idle_ms_sleep
+#define SIM_IDLE_NS_SLEEP sim_idle_ns_sleep
 #else
 #define SIM_IDLE_MS_SLEEP sim_os_ms_sleep
+#define SIM_IDLE_NS_SLEEP sim_os_ns_sleep
 #endif
 
 /* OS-dependent timer and clock routines */
@@ -235,6 +327,23 @@ sys$waitfr (2);
 return sim_os_msec () - stime;
 }
 
+t_uint64 sim_os_nsec (void)
+{
+uint32 tod[2];
+
+sys$gettim (tod);                                       /* time 0.1usec */
+return ((((t_uint64) tod[1]) << 32) | tod[0]) * 100;
+}
+
+t_uint64 sim_os_ns_sleep (t_uint64 nsec)
+{
+t_uint64 stime = sim_os_nsec ();
+
+if (nsec)                                               /* msec resolution */
+    sim_os_ms_sleep ((unsigned int) ((nsec + 999999) / 1000000));
+return sim_os_nsec () - stime;
+}
+
 #ifdef NEED_CLOCK_GETTIME
 int clock_gettime(int clk_id, struct timespec *tp)
 {
@@ -307,6 +416,29 @@ Sleep (msec);
 return sim_os_msec () - stime;
 }
 
+t_uint64 sim_os_nsec (void)
+{
+static LARGE_INTEGER freq;
+LARGE_INTEGER now;
+t_uint64 cnt, hz;
+
+if (freq.QuadPart == 0)
+    QueryPerformanceFrequency (&freq);
+QueryPerformanceCounter (&now);
+cnt = (t_uint64) now.QuadPart;
+hz = (t_uint64) freq.QuadPart;
+return ((cnt / hz) * 1000000000) + (((cnt % hz) * 1000000000) / hz);
+}
+
+t_uint64 sim_os_ns_sleep (t_uint64 nsec)
+{
+t_uint64 stime = sim_os_nsec ();
+
+if (nsec)                                               /* msec resolution */
+    Sleep ((DWORD) ((nsec + 999999) / 1000000));
+return sim_os_nsec () - stime;
+}
+
 #if defined(NEED_CLOCK_GETTIME)
 int clock_gettime(int clk_id, struct timespec *tp)
 {
@@ -350,6 +482,16 @@ uint32 sim_os_ms_sleep (unsigned int msec)
 return 0;
 }
 
+t_uint64 sim_os_nsec (void)
+{
+return 0;
+}
+
+t_uint64 sim_os_ns_sleep (t_uint64 nsec)
+{
+return 0;
+}
+
 /* Metrowerks CodeWarrior Macintosh routines, from Ben Supnik */
 
 #elif defined (__MWERKS__) && defined (macintosh)
@@ -398,6 +540,25 @@ treq.tv_nsec = (milliseconds % MILLIS_PER_SEC) * NANOS_PER_MILLI;
 return sim_os_msec () - stime;
 }
 
+t_uint64 sim_os_nsec (void)
+{
+UnsignedWide macMicros;
+
+Microseconds (&macMicros);
+return *((unsigned long long *) &macMicros) * 1000;
+}
+
+t_uint64 sim_os_ns_sleep (t_uint64 nsec)
+{
+t_uint64 stime = sim_os_nsec ();
+struct timespec treq;
+
+treq.tv_sec = (time_t) (nsec / 1000000000);
+treq.tv_nsec = (long) (nsec % 1000000000);
+(void) nanosleep (&treq, NULL);
+return sim_os_nsec () - stime;
+}
+
 #if defined(NEED_CLOCK_GETTIME)
 int clock_gettime(int clk_id, struct timespec *tp)
 {
@@ -489,6 +650,33 @@ treq.tv_nsec = (milliseconds % MILLIS_PER_SEC) * NANOS_PER_MILLI;
 return sim_os_msec () - stime;
 }
 
+t_uint64 sim_os_nsec (void)
+{
+#if defined (CLOCK_MONOTONIC)
+struct timespec now;
+
+clock_gettime (CLOCK_MONOTONIC, &now);
+return (((t_uint64) now.tv_sec) * 1000000000) + now.tv_nsec;
+#else
+struct timeval cur;
+struct timezone foo;
+
+gettimeofday (&cur, &foo);
+return (((t_uint64) cur.tv_sec) * 1000000000) + (((t_uint64) cur.tv_usec) * 1000);
+#endif
+}
+
+t_uint64 sim_os_ns_sleep (t_uint64 nsec)
+{
+t_uint64 stime = sim_os_nsec ();
+struct timespec treq;
+
+treq.tv_sec = (time_t) (nsec / 1000000000);
+treq.tv_nsec = (long) (nsec % 1000000000);
+(void) nanosleep (&treq, NULL);
+return sim_os_nsec () - stime;
+}
+
 #endif
 
 /* diff = min - sub */
@@ -690,21 +878,53 @@ int32 sim_rtc_calb (int32 ticksper)
 return sim_rtcn_calb (ticksper, 0);
 }
 
-/* sim_timer_init - get minimum sleep time available on this host */
+/* _sim_timer_sleep_cal - get minimum sleep time available on this host
+
+   Measuring the host's sleep granularity takes a hundred or more
+   milliseconds of real sleeping, which would otherwise dominate
+   simulator startup.  Only idling, throttling and the asynchronous
+   timer thread need the answer, so it is measured the first time one
+   of them asks for it.
+*/
+
+static void _sim_timer_sleep_cal (void)
+{
+if (sim_idle_rate_known)
+    return;
+sim_idle_rate_known = TRUE;
+sim_idle_rate_ms = sim_os_ms_sleep_init ();             /* get OS timer rate */
+if (sim_idle_rate_ms) {                                 /* get shortest sleep */
+    t_uint64 tot = 0;
+    int32 i;
+
+    for (i = 0; i < SIM_IDLE_NSSAMP; i++)
+        tot += sim_os_ns_sleep (1000);
+    sim_os_sleep_min_ns = tot / SIM_IDLE_NSSAMP;
+    if (sim_os_sleep_min_ns < SIM_IDLE_NSMIN)
+        sim_os_sleep_min_ns = SIM_IDLE_NSMIN;
+    }
+sim_debug (DBG_TRC, &sim_timer_dev, "_sim_timer_sleep_cal() - %dms, shortest sleep %d usec\n", sim_idle_rate_ms, (int32) (sim_os_sleep_min_ns / 1000));
+}
+
+/* sim_timer_init - initialize timing system
+
+   The host sleep calibration is deferred (see _sim_timer_sleep_cal),
+   so this only reports whether a real time clock is available.
+*/
 
 t_bool sim_timer_init (void)
 {
 sim_debug (DBG_TRC, &sim_timer_dev, "sim_timer_init()\n");
 sim_register_internal_device (&sim_timer_dev);
 sim_idle_enab = FALSE;                                  /* init idle off */
-sim_idle_rate_ms = sim_os_ms_sleep_init ();             /* get OS timer rate */
-return (sim_idle_rate_ms != 0);
+return rtc_avail;
 }
 
 /* sim_timer_idle_capable - tell if the host is Idle capable and what the host OS tick size is */
 
 uint32 sim_timer_idle_capable (uint32 *host_tick_ms)
 {
+_sim_timer_sleep_cal ();
 if (host_tick_ms)
     *host_tick_ms = sim_os_sleep_min_ms;
 return sim_idle_rate_ms;
@@ -716,6 +936,7 @@ t_stat sim_show_timers (FILE* st, DEVICE *dptr, UNIT* uptr, int32 val, char* des
 {
 int tmr;
 
+_sim_timer_sleep_cal ();
 if (sim_clock_unit)
     fprintf (st, "%s clock device is %s\n", sim_name, sim_uname(sim_clock_unit));
 else
@@ -755,8 +976,6 @@ REG sim_timer_reg[] = {
     { DRDATAD (IDLE_STABLE,      sim_idle_stable,        32, "Idle Stable"), PV_RSPC},
     { FLDATAD (IDLE_IDLED,       sim_idle_idled,          0, ""), REG_RO},
     { DRDATAD (TMR,              sim_calb_tmr,           32, ""), PV_RSPC|REG_RO},
-    { DRDATAD (THROT_MS_START,   sim_throt_ms_start,     32, ""), PV_RSPC|REG_RO},
-    { DRDATAD (THROT_MS_STOP,    sim_throt_ms_stop,      32, ""), PV_RSPC|REG_RO},
     { DRDATAD (THROT_TYPE,       sim_throt_type,         32, ""), PV_RSPC|REG_RO},
     { DRDATAD (THROT_VAL,        sim_throt_val,          32, ""), PV_RSPC|REG_RO},
     { DRDATAD (THROT_STATE,      sim_throt_state,        32, ""), PV_RSPC|REG_RO},
@@ -823,8 +1042,8 @@ DEVICE sim_timer_dev = {
 
 t_bool sim_idle (uint32 tmr, t_bool sin_cyc)
 {
-static uint32 cyc_ms = 0;
-uint32 w_ms, w_idle, act_ms;
+double cyc_ns;
+t_uint64 w_ns, act_ns;
 int32 act_cyc;
 
 if ((!sim_idle_enab)                             ||     /* idling disabled */
@@ -865,37 +1084,35 @@ if ((!sim_idle_enab)                             ||     /* idling disabled */
    */
 //sim_idle_idled = TRUE;                                  /* record idle attempt */
 sim_debug (DBG_TRC, &sim_timer_dev, "sim_idle(tmr=%d, sin_cyc=%d)\n", tmr, sin_cyc);
-if (cyc_ms == 0)                                        /* not computed yet? */
-    cyc_ms = (rtc_currd[tmr] * rtc_hz[tmr]) / 1000;     /* cycles per msec */
-if ((sim_idle_rate_ms == 0) || (cyc_ms == 0)) {         /* not possible? */
+cyc_ns = (((double) rtc_currd[tmr]) * rtc_hz[tmr]) / 1000000000.0; /* cycles per nsec */
+if ((sim_idle_rate_ms == 0) || (cyc_ns <= 0.0)) {       /* not possible? */
     if (sin_cyc)
         sim_interval = sim_interval - 1;
-    sim_debug (DBG_IDL, &sim_timer_dev, "not possible %d - %d\n", sim_idle_rate_ms, cyc_ms);
+    sim_debug (DBG_IDL, &sim_timer_dev, "not possible %d - %.6f\n", sim_idle_rate_ms, cyc_ns);
     return FALSE;
     }
-w_ms = (uint32) sim_interval / cyc_ms;                  /* ms to wait */
-w_idle = w_ms / sim_idle_rate_ms;                       /* intervals to wait */
-if (w_idle == 0) {                                      /* none? */
+w_ns = (t_uint64) (((double) sim_interval) / cyc_ns);   /* ns to wait */
+if (w_ns < sim_os_sleep_min_ns) {                       /* too short to sleep? */
     if (sin_cyc)
         sim_interval = sim_interval - 1;
     sim_debug (DBG_IDL, &sim_timer_dev, "no wait\n");
     return FALSE;
     }
 if (sim_clock_queue == QUEUE_LIST_END)
-    sim_debug (DBG_IDL, &sim_timer_dev, "sleeping for %d ms - pending event in %d instructions\n", w_ms, sim_interval);
+    sim_debug (DBG_IDL, &sim_timer_dev, "sleeping for %d usec - pending event in %d instructions\n", (int32) (w_ns / 1000), sim_interval);
 else
-    sim_debug (DBG_IDL, &sim_timer_dev, "sleeping for %d ms - pending event on %s in %d instructions\n", w_ms, sim_uname(sim_clock_queue), sim_interval);
-act_ms = SIM_IDLE_MS_SLEEP (w_ms);                      /* wait */
-act_cyc = act_ms * cyc_ms;
-if (act_ms < w_ms)                                      /* awakened early? */
-    act_cyc += (cyc_ms * sim_idle_rate_ms) / 2;         /* account for half an interval's worth of cycles */
-if (sim_interval > act_cyc)
-    sim_interval = sim_interval - act_cyc;              /* count down sim_interval */
-else sim_interval = 0;                                  /* or fire immediately */
+    sim_debug (DBG_IDL, &sim_timer_dev, "sleeping for %d usec - pending event on %s in %d instructions\n", (int32) (w_ns / 1000), sim_uname(sim_clock_queue), sim_interval);
+act_ns = SIM_IDLE_NS_SLEEP (w_ns);                      /* wait */
+act_cyc = (int32) (((double) act_ns) * cyc_ns);         /* cycles that elapsed */
+if (act_cyc > sim_interval)
+    act_cyc = sim_interval;                             /* fire immediately */
+sim_interval = sim_interval - act_cyc;                  /* count down sim_interval */
+sim_idle_ns = sim_idle_ns + act_ns;                     /* account idle time */
+sim_idle_cyc = sim_idle_cyc + act_cyc;
 if (sim_clock_queue == QUEUE_LIST_END)
-    sim_debug (DBG_IDL, &sim_timer_dev, "slept for %d ms - pending event in %d instructions\n", act_ms, sim_interval);
+    sim_debug (DBG_IDL, &sim_timer_dev, "slept for %d usec - pending event in %d instructions\n", (int32) (act_ns / 1000), sim_interval);
 else
-    sim_debug (DBG_IDL, &sim_timer_dev, "slept for %d ms - pending event on %s in %d instructions\n", act_ms, sim_uname(sim_clock_queue), sim_interval);
+    sim_debug (DBG_IDL, &sim_timer_dev, "slept for %d usec - pending event on %s in %d instructions\n", (int32) (act_ns / 1000), sim_uname(sim_clock_queue), sim_interval);
 return TRUE;
 }
 
@@ -906,6 +1123,7 @@ t_stat sim_set_idle (UNIT *uptr, int32 val, char *cptr, void *desc)
 t_stat r;
 uint32 v;
 
+_sim_timer_sleep_cal ();
 if (sim_idle_rate_ms == 0) {
     printf ("Idling is not available, Minimum OS sleep time is %dms\n", sim_os_sleep_min_ms);
     if (sim_log)
@@ -950,8 +1168,10 @@ if (sim_idle_enab)
     fprintf (st, "idle enabled");
 else
     fprintf (st, "idle disabled");
-if (sim_switches & SWMASK ('D'))
-    fprintf (st, ", stability wait = %ds, minimum sleep resolution = %dms", sim_idle_stable, sim_os_sleep_min_ms);
+if (sim_switches & SWMASK ('D')) {
+    _sim_timer_sleep_cal ();
+    fprintf (st, ", stability wait = %ds, minimum sleep resolution = %dms (shortest sleep %d usec)", sim_idle_stable, sim_os_sleep_min_ms, (int32) (sim_os_sleep_min_ns / 1000));
+    }
 return SCPE_OK;
 }
 
@@ -962,6 +1182,8 @@ t_stat sim_set_throt (int32 arg, char *cptr)
 char *tptr, c;
 t_value val, val2 = 0;
 
+if (arg != 0)
+    _sim_timer_sleep_cal ();
 if (arg == 0) {
     if ((cptr != 0) && (*cptr != 0))
         return SCPE_ARG;
@@ -1015,6 +1237,7 @@ return SCPE_OK;
 
 t_stat sim_show_throt (FILE *st, DEVICE *dnotused, UNIT *unotused, int32 flag, char *cptr)
 {
+_sim_timer_sleep_cal ();
 if (sim_idle_rate_ms == 0)
     fprintf (st, "Throttling not available\n");
 else {
@@ -1041,9 +1264,23 @@ else {
         break;
         }
 
+    if ((sim_throt_type != SIM_THROT_NONE) &&           /* dynamic throttling? */
+        (sim_throt_type != SIM_THROT_SPC)) {
+        if (sim_throt_achieved <= 0.0)
+            fprintf (st, "Achieved rate not yet measured\n");
+        else if ((sim_throt_type == SIM_THROT_PCT) && (sim_throt_host_cps > 0.0))
+            fprintf (st, "Achieved rate = %.0f cycles/sec (%.1f%% of host)\n",
+                sim_throt_achieved, (100.0 * sim_throt_achieved) / sim_throt_host_cps);
+        else fprintf (st, "Achieved rate = %.0f cycles/sec\n", sim_throt_achieved);
+        }
     if (sim_switches & SWMASK ('D')) {
         if (sim_throt_type != 0)
             fprintf (st, "Throttle interval = %d cycles\n", sim_throt_wait);
+        if ((sim_throt_type != SIM_THROT_NONE) &&
+            (sim_throt_type != SIM_THROT_SPC)) {
+            fprintf (st, "Unthrottled rate = %.0f cycles/sec\n", sim_throt_host_cps);
+            fprintf (st, "Schedule error = %.3f ms\n", sim_throt_err / 1000000.0);
+            }
         }
     }
 if (sim_switches & SWMASK ('D'))
@@ -1065,79 +1302,102 @@ sim_cancel (&sim_throt_unit);
 
 /* Throttle service
 
-   Throttle service has three distinct states used while dynamically
-   determining a throttling interval:
+   The fixed mode (insts/delay) simply sleeps for the specified time after
+   every 'insts' instructions.
 
-       0    take initial measurement
-       1    take final measurement, calculate wait values
-       2    periodic waits to slow down the CPU
+   The dynamic modes (Kcps, Mcps and %) pace execution against the host's
+   monotonic nanosecond clock in short slices of SIM_THROT_NSLICE.  Each
+   pass credits the schedule with the time the executed cycles should
+   have taken at the desired rate and debits it with the wall time that
+   actually elapsed; the difference is the schedule error.  A PI
+   controller converts the error into a sleep.  Because the error is
+   cumulative, oversleeps and host preemption are repaid on later slices
+   rather than lost, so the long-term rate does not drift.  The error is
+   clamped at SIM_THROT_NSDRIFT, which bounds how far the simulator can
+   run ahead of, or try to catch up with, real time.
+
+   For the % mode, the unthrottled rate is tracked from the time spent
+   running between sleeps, so no separate measurement phase is needed.
+
+   Throttle service states:
+
+       0    initialize pacing
+       1    first slice measured
+       2    pacing
 */
 
 t_stat sim_throt_svc (UNIT *uptr)
 {
-uint32 delta_ms;
-double a_cps, d_cps;
+t_uint64 now;
+double gtime, cyc, busy, u;
 
-if (sim_throt_type == SIM_THROT_SPC) {                  /* Non dynamic? */
+if (sim_throt_type == SIM_THROT_SPC) {                  /* non dynamic? */
     sim_throt_state = 2;                                /* force state */
     sim_throt_wait = sim_throt_val;
+    now = sim_os_nsec ();
+    SIM_IDLE_MS_SLEEP (sim_throt_sleep_time);
+    sim_idle_ns = sim_idle_ns + (sim_os_nsec () - now); /* account sleep */
+    sim_activate (uptr, sim_throt_wait);
+    return SCPE_OK;
     }
-switch (sim_throt_state) {
-
-    case 0:                                             /* take initial reading */
-        sim_throt_ms_start = sim_os_msec ();
-        sim_throt_wait = SIM_THROT_WST;
-        sim_throt_state = 1;                            /* next state */
-        break;                                          /* reschedule */
-
-    case 1:                                             /* take final reading */
-        sim_throt_ms_stop = sim_os_msec ();
-        delta_ms = sim_throt_ms_stop - sim_throt_ms_start;
-        if (delta_ms < SIM_THROT_MSMIN) {               /* not enough time? */
-            if (sim_throt_wait >= 100000000) {          /* too many inst? */
-                sim_throt_state = 0;                    /* fails in 32b! */
-                return SCPE_OK;
-                }
-            sim_throt_wait = sim_throt_wait * SIM_THROT_WMUL;
-            sim_throt_ms_start = sim_throt_ms_stop;
-            }
-        else {                                          /* long enough */
-            a_cps = ((double) sim_throt_wait) * 1000.0 / (double) delta_ms;
-            if (sim_throt_type == SIM_THROT_MCYC)       /* calc desired cps */
-                d_cps = (double) sim_throt_val * 1000000.0;
-            else if (sim_throt_type == SIM_THROT_KCYC)
-                d_cps = (double) sim_throt_val * 1000.0;
-            else d_cps = (a_cps * ((double) sim_throt_val)) / 100.0;
-            if (d_cps >= a_cps) {
-                sim_throt_sched ();                     /* start over */
-                return SCPE_OK;
-                }
-            sim_throt_wait = (int32)                    /* time between waits */
-                ((a_cps * d_cps * ((double) sim_idle_rate_ms)) /
-                 (1000.0 * (a_cps - d_cps)));
-            if (sim_throt_wait < SIM_THROT_WMIN) {      /* not long enough? */
-                sim_throt_sched ();                     /* start over */
-                return SCPE_OK;
-                }
-            sim_throt_ms_start = sim_throt_ms_stop;
-            sim_throt_state = 2;
-//            fprintf (stderr, "Throttle values a_cps = %f, d_cps = %f, wait = %d\n",
-//                a_cps, d_cps, sim_throt_wait);
-            }
-        break;
-
-    case 2:                                             /* throttling */
-        SIM_IDLE_MS_SLEEP (sim_throt_sleep_time);
-        delta_ms = sim_os_msec () - sim_throt_ms_start;
-        if ((sim_throt_type != SIM_THROT_SPC) &&        /* when dynamic throttling */
-            (delta_ms >= 10000)) {                      /* recompute every 10 sec */
-            sim_throt_ms_start = sim_os_msec ();
-            sim_throt_wait = SIM_THROT_WST;
-            sim_throt_state = 1;                        /* next state */
-            }
-        break;
-        }
-
+now = sim_os_nsec ();
+gtime = sim_gtime ();
+if (sim_throt_state == 0) {                             /* start pacing */
+    sim_throt_ns_mark = sim_throt_ns_resume = sim_throt_ns_rpt = now;
+    sim_throt_gtime_mark = sim_throt_gtime_rpt = gtime;
+    sim_throt_err = sim_throt_ierr = 0.0;
+    sim_throt_achieved = 0.0;
+    sim_throt_wait = SIM_THROT_WST;
+    sim_throt_state = 1;
+    sim_activate (uptr, sim_throt_wait);
+    return SCPE_OK;
+    }
+cyc = gtime - sim_throt_gtime_mark;                     /* cycles this slice */
+busy = (double) (now - sim_throt_ns_resume);            /* ns spent running */
+if ((cyc > 0.0) && (busy > 0.0)) {                      /* track host rate */
+    if (sim_throt_state == 1)
+        sim_throt_host_cps = (cyc * 1000000000.0) / busy;
+    else sim_throt_host_cps = (0.9 * sim_throt_host_cps) +
+        (0.1 * ((cyc * 1000000000.0) / busy));
+    }
+if (sim_throt_type == SIM_THROT_MCYC)                   /* calc desired cps */
+    sim_throt_cps = (double) sim_throt_val * 1000000.0;
+else if (sim_throt_type == SIM_THROT_KCYC)
+    sim_throt_cps = (double) sim_throt_val * 1000.0;
+else sim_throt_cps = (sim_throt_host_cps * ((double) sim_throt_val)) / 100.0;
+if (sim_throt_cps > 0.0)                                /* credit schedule */
+    sim_throt_err = sim_throt_err + ((cyc * 1000000000.0) / sim_throt_cps);
+sim_throt_err = sim_throt_err - (double) (now - sim_throt_ns_mark);
+if (sim_throt_err > SIM_THROT_NSDRIFT)                  /* bound the drift */
+    sim_throt_err = SIM_THROT_NSDRIFT;
+else if (sim_throt_err < -SIM_THROT_NSDRIFT)
+    sim_throt_err = -SIM_THROT_NSDRIFT;
+u = (SIM_THROT_KP * sim_throt_err) + sim_throt_ierr;    /* PI output */
+if ((u > 0.0) && (u < SIM_THROT_NSDRIFT)) {             /* integrate unless */
+    sim_throt_ierr = sim_throt_ierr + (SIM_THROT_KI * sim_throt_err);
+    if (sim_throt_ierr > SIM_THROT_NSDRIFT)             /* saturated */
+        sim_throt_ierr = SIM_THROT_NSDRIFT;
+    else if (sim_throt_ierr < -SIM_THROT_NSDRIFT)
+        sim_throt_ierr = -SIM_THROT_NSDRIFT;
+    }
+sim_throt_ns_mark = now;
+if (u >= SIM_THROT_NSMIN)                               /* worth sleeping? */
+    sim_idle_ns = sim_idle_ns + sim_os_ns_sleep ((t_uint64) u);
+sim_throt_ns_resume = sim_os_nsec ();
+sim_throt_gtime_mark = gtime;
+if ((now - sim_throt_ns_rpt) >= SIM_THROT_NSRPT) {      /* rate window done? */
+    sim_throt_achieved = ((gtime - sim_throt_gtime_rpt) * 1000000000.0) /
+        (double) (now - sim_throt_ns_rpt);
+    sim_throt_ns_rpt = now;
+    sim_throt_gtime_rpt = gtime;
+    }
+u = (sim_throt_cps * SIM_THROT_NSLICE) / 1000000000.0;  /* cycles per slice */
+if (u < SIM_THROT_WMIN)
+    sim_throt_wait = SIM_THROT_WMIN;
+else if (u > 100000000.0)
+    sim_throt_wait = 100000000;
+else sim_throt_wait = (int32) u;
+sim_throt_state = 2;
 sim_activate (uptr, sim_throt_wait);                    /* reschedule */
 return SCPE_OK;
 }
@@ -1163,14 +1423,200 @@ clock_gettime(CLOCK_REALTIME, &now);
 return _timespec_to_double (&now);
 }
 
+#endif /* defined(SIM_ASYNCH_IO) && defined(SIM_ASYNCH_CLOCKS) */
+
+#if defined(SIM_ASYNCH_IO)
+
+/* Wallclock event queue
+
+   Pending wallclock events are kept in a binary min-heap ordered by due
+   time, so queueing and removing an event is O(log n) however many units
+   use sim_activate_after.  The heap is 1-based; a unit's a_heap_pos is its
+   slot, or 0 when it isn't in the heap.  The heap belongs to the holder of
+   sim_timer_lock.
+
+   The CPU thread doesn't take sim_timer_lock to schedule an event.
+   sim_timer_activate_after pushes the unit onto sim_wallclock_entry, a
+   lock free list, and whoever next holds the lock moves everything on that
+   list into the heap in one batch.  The timer thread is only woken when
+   the new event is due before the time it is already sleeping until.
+*/
+
+static int32 sim_wallclock_size = 0;                /* heap allocation */
+
+static void _sim_wallclock_place (UNIT *uptr, int32 pos)
+{
+sim_wallclock_heap[pos] = uptr;
+uptr->a_heap_pos = pos;
+}
+
+static void _sim_wallclock_up (int32 pos)
+{
+UNIT *uptr = sim_wallclock_heap[pos];
+
+while ((pos > 1) && (uptr->a_due_time < sim_wallclock_heap[pos >> 1]->a_due_time)) {
+    _sim_wallclock_place (sim_wallclock_heap[pos >> 1], pos);
+    pos = pos >> 1;
+    }
+_sim_wallclock_place (uptr, pos);
+}
+
+static void _sim_wallclock_insert (UNIT *uptr)
+{
+if ((sim_wallclock_count + 1) >= sim_wallclock_size) {
+    sim_wallclock_size = sim_wallclock_size ? 2 * sim_wallclock_size : 64;
+    sim_wallclock_heap = (UNIT **) realloc (sim_wallclock_heap, sim_wallclock_size * sizeof (*sim_wallclock_heap));
+    }
+uptr->a_next = QUEUE_LIST_END;                          /* mark as on a list */
+sim_wallclock_count = sim_wallclock_count + 1;
+sim_wallclock_heap[sim_wallclock_count] = uptr;
+_sim_wallclock_up (sim_wallclock_count);
+}
+
+#if defined(SIM_ASYNCH_CLOCKS)
+
+/* Only the timer thread takes events off the heap */
+
+static void _sim_wallclock_down (int32 pos)
+{
+UNIT *uptr = sim_wallclock_heap[pos];
+int32 child;
+
+while ((child = pos << 1) <= sim_wallclock_count) {
+    if ((child < sim_wallclock_count) &&
+        (sim_wallclock_heap[child + 1]->a_due_time < sim_wallclock_heap[child]->a_due_time))
+        child = child + 1;
+    if (uptr->a_due_time <= sim_wallclock_heap[child]->a_due_time)
+        break;
+    _sim_wallclock_place (sim_wallclock_heap[child], pos);
+    pos = child;
+    }
+_sim_wallclock_place (uptr, pos);
+}
+
+static void _sim_wallclock_remove (UNIT *uptr)
+{
+int32 pos = uptr->a_heap_pos;
+UNIT *last = sim_wallclock_heap[sim_wallclock_count];
+
+sim_wallclock_count = sim_wallclock_count - 1;
+uptr->a_heap_pos = 0;
+uptr->a_next = NULL;
+if (last != uptr) {                                     /* refill the hole */
+    _sim_wallclock_place (last, pos);
+    _sim_wallclock_up (pos);
+    _sim_wallclock_down (last->a_heap_pos);
+    }
+}
+
+#endif /* defined(SIM_ASYNCH_CLOCKS) */
+
+/* Move all handed off events into the heap; caller holds sim_timer_lock.
+   Returns TRUE if there were any. */
+
+t_bool _sim_wallclock_drain (void)
+{
+UNIT *q, *uptr;
+
+#if defined(USE_AIO_INTRINSICS)
+/* The compare and exchange doubles as a full barrier, which the timer
+   thread relies on after publishing sim_timer_wait_due */
+q = (UNIT *)InterlockedCompareExchangePointer(&sim_wallclock_entry, QUEUE_LIST_END, QUEUE_LIST_END);
+while (q != QUEUE_LIST_END) {                           /* grab the whole list */
+    uptr = (UNIT *)InterlockedCompareExchangePointer(&sim_wallclock_entry, QUEUE_LIST_END, q);
+    if (uptr == q)
+        break;
+    q = uptr;
+    }
+#else
+q = sim_wallclock_entry;
+sim_wallclock_entry = QUEUE_LIST_END;
+#endif
+if (q == QUEUE_LIST_END)
+    return FALSE;
+while (q != QUEUE_LIST_END) {
+    uptr = q;
+    q = q->a_next;
+    _sim_wallclock_insert (uptr);
+    }
+return TRUE;
+}
+
+#endif /* defined(SIM_ASYNCH_IO) */
+
+#if defined(SIM_ASYNCH_IO) && defined(SIM_ASYNCH_CLOCKS)
+
 extern int32 sim_is_running;
-extern UNIT * volatile sim_wallclock_queue;
-extern UNIT * volatile sim_wallclock_entry;
 
 pthread_t           sim_timer_thread;           /* Wall Clock Timing Thread Id */
 pthread_cond_t      sim_timer_startup_cond;
 t_bool              sim_timer_thread_running = FALSE;
-t_bool              sim_timer_event_canceled = FALSE;
+static volatile double sim_timer_wait_due = 0.0;    /* time the timer thread sleeps until */
+#if defined(SIM_TIMER_FD)
+static int          sim_timer_fd = -1;              /* timerfd for due time */
+static int          sim_timer_event_fd = -1;        /* eventfd for wakeups */
+#endif
+
+/* Wake the timer thread to rescan the wallclock queue */
+
+static void _sim_timer_wake (t_bool locked)
+{
+#if defined(SIM_TIMER_FD)
+if (sim_timer_event_fd >= 0) {
+    t_uint64 one = 1;
+
+    if (write (sim_timer_event_fd, &one, sizeof (one)) != sizeof (one)) {
+        sim_debug (DBG_TIM, &sim_timer_dev, "_sim_timer_wake() - eventfd write failed\n");
+        }
+    return;
+    }
+#endif
+if (!locked)
+    pthread_mutex_lock (&sim_timer_lock);
+pthread_cond_signal (&sim_timer_wake);
+if (!locked)
+    pthread_mutex_unlock (&sim_timer_lock);
+}
+
+/* Wait until due_time (forever if NULL) or a wakeup, holding sim_timer_lock
+   on entry and exit.  Returns TRUE if the due time was reached. */
+
+static t_bool _sim_timer_wait (struct timespec *due_time)
+{
+#if defined(SIM_TIMER_FD)
+if (sim_timer_fd >= 0) {
+    struct itimerspec its;
+    struct pollfd fds[2];
+    t_uint64 count;
+    t_bool timedout = FALSE;
+
+    memset (&its, 0, sizeof (its));                     /* zero disarms */
+    if (due_time)
+        its.it_value = *due_time;
+    timerfd_settime (sim_timer_fd, TFD_TIMER_ABSTIME, &its, NULL);
+    fds[0].fd = sim_timer_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = sim_timer_event_fd;
+    fds[1].events = POLLIN;
+    pthread_mutex_unlock (&sim_timer_lock);
+    if (poll (fds, 2, -1) > 0) {
+        if ((fds[1].revents & POLLIN) &&
+            (read (sim_timer_event_fd, &count, sizeof (count)) < 0))
+            count = 0;
+        if ((fds[0].revents & POLLIN) &&
+            (read (sim_timer_fd, &count, sizeof (count)) == sizeof (count)))
+            timedout = TRUE;
+        }
+    pthread_mutex_lock (&sim_timer_lock);
+    return timedout;
+    }
+#endif
+if (due_time == NULL) {
+    pthread_cond_wait (&sim_timer_wake, &sim_timer_lock);
+    return FALSE;
+    }
+return (0 != pthread_cond_timedwait (&sim_timer_wake, &sim_timer_lock, due_time));
+}
 
 static void *
 _timer_thread(void *arg)
@@ -1192,93 +1638,72 @@ pthread_cond_signal (&sim_timer_startup_cond);   /* Signal we're ready to go */
 while (sim_asynch_enabled && sim_asynch_timer && sim_is_running) {
     struct timespec start_time, stop_time;
     struct timespec due_time;
-    double wait_usec;
+    double wait_usec, due;
     int32 inst_delay;
     double inst_per_sec;
     UNIT *uptr;
 
-    if (sim_wallclock_entry) {                          /* something to insert in queue? */
-        UNIT *cptr, *prvptr;
-
-        sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - timing %s for %d usec\n", 
-                   sim_uname(sim_wallclock_entry), sim_wallclock_entry->time);
-
-        uptr = sim_wallclock_entry;
-        sim_wallclock_entry = NULL;
-
-        prvptr = NULL;
-        for (cptr = sim_wallclock_queue; cptr != QUEUE_LIST_END; cptr = cptr->a_next) {
-            if (uptr->a_due_time < cptr->a_due_time)
-                break;
-            prvptr = cptr;
-            }
-        if (prvptr == NULL) {                           /* insert at head */
-            cptr = uptr->a_next = sim_wallclock_queue;
-            sim_wallclock_queue = uptr;
-            }
-        else {
-            cptr = uptr->a_next = prvptr->a_next;       /* insert at prvptr */
-            prvptr->a_next = uptr;
-            }
-        }
+    _sim_wallclock_drain ();                            /* absorb handed off events */
 
     /* determine wait time */
-    if (sim_wallclock_queue != QUEUE_LIST_END) {
+    if (sim_wallclock_count) {
         /* due time adjusted by 1/2 a minimal sleep interval */
         /* the goal being to let the last fractional part of the due time */
         /* be done by counting instructions */
-        _double_to_timespec (&due_time, sim_wallclock_queue->a_due_time-(((double)sim_idle_rate_ms)*0.0005));
-        }
-    else {
-        due_time.tv_sec = 0x7FFFFFFF;                   /* Sometime when 32 bit time_t wraps */
-        due_time.tv_nsec = 0;
+        due = sim_wallclock_heap[1]->a_due_time-(((double)sim_idle_rate_ms)*0.0005);
         }
+    else
+        due = (double)0x7FFFFFFF;                       /* Sometime when 32 bit time_t wraps */
+    sim_timer_wait_due = due;                           /* publish, then recheck */
+    if (_sim_wallclock_drain ())                        /* for a racing handoff */
+        continue;
+    _double_to_timespec (&due_time, due);
     clock_gettime(CLOCK_REALTIME, &start_time);
-    wait_usec = floor(1000000.0*(_timespec_to_double (&due_time) - _timespec_to_double (&start_time)));
-    if (sim_wallclock_queue == QUEUE_LIST_END)
+    wait_usec = floor(1000000.0*(due - _timespec_to_double (&start_time)));
+    if (sim_wallclock_count == 0)
         sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - waiting forever\n");
     else
-        sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - waiting for %.0f usecs until %.6f for %s\n", wait_usec, sim_wallclock_queue->a_due_time, sim_uname(sim_wallclock_queue));
-    if ((wait_usec <= 0.0) || 
-        (0 != pthread_cond_timedwait (&sim_timer_wake, &sim_timer_lock, &due_time))) {
-        if (sim_wallclock_queue == QUEUE_LIST_END)      /* queue empty? */
-            continue;                                   /* wait again */
-        inst_per_sec = sim_timer_inst_per_sec ();
-
-        uptr = sim_wallclock_queue;
-        sim_wallclock_queue = uptr->a_next;
-        uptr->a_next = NULL;                            /* hygiene */
-
-        clock_gettime(CLOCK_REALTIME, &stop_time);
-        if (1 != sim_timespec_compare (&due_time, &stop_time)) {
-            inst_delay = 0;
-            uptr->a_last_fired_time = _timespec_to_double(&stop_time);
-            }
-        else {
-            inst_delay = (int32)(inst_per_sec*(_timespec_to_double(&due_time)-_timespec_to_double(&stop_time)));
-            uptr->a_last_fired_time = uptr->a_due_time;
-            }
-        sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - slept %.0fms - activating(%s,%d)\n", 
-                   1000.0*(_timespec_to_double (&stop_time)-_timespec_to_double (&start_time)), sim_uname(uptr), inst_delay);
-        if (sim_clock_unit == uptr) {
-            /*
-             * Some devices may depend on executing during the same instruction or immediately 
-             * after the clock tick event.  To satisfy this, we link the clock unit to the head
-             * of the clock coschedule queue and then insert that list in the asynch event 
-             * queue in a single operation
-             */
-            uptr->a_next = sim_clock_cosched_queue;
-            sim_clock_cosched_queue = QUEUE_LIST_END;
-            AIO_ACTIVATE_LIST(sim_activate, uptr, inst_delay);
-            }
-        else
-            sim_activate (uptr, inst_delay);
+        sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - waiting for %.0f usecs until %.6f for %s\n", wait_usec, sim_wallclock_heap[1]->a_due_time, sim_uname(sim_wallclock_heap[1]));
+    if ((wait_usec > 0.0) &&
+        (!_sim_timer_wait (sim_wallclock_count ? &due_time : NULL)))
+        continue;                                       /* woken to rescan the queue */
+    _sim_wallclock_drain ();
+    clock_gettime(CLOCK_REALTIME, &stop_time);
+    if ((sim_wallclock_count == 0) ||                   /* queue empty or head */
+        ((sim_wallclock_heap[1]->a_due_time-(((double)sim_idle_rate_ms)*0.0005)) >
+         _timespec_to_double (&stop_time)))             /* changed while waiting? */
+        continue;                                       /* wait again */
+    inst_per_sec = sim_timer_inst_per_sec ();
+
+    uptr = sim_wallclock_heap[1];
+    _double_to_timespec (&due_time, uptr->a_due_time-(((double)sim_idle_rate_ms)*0.0005));
+    _sim_wallclock_remove (uptr);
+
+    if (1 != sim_timespec_compare (&due_time, &stop_time)) {
+        inst_delay = 0;
+        uptr->a_last_fired_time = _timespec_to_double(&stop_time);
+        }
+    else {
+        inst_delay = (int32)(inst_per_sec*(_timespec_to_double(&due_time)-_timespec_to_double(&stop_time)));
+        uptr->a_last_fired_time = uptr->a_due_time;
         }
-    else {/* Something wants to adjust the queue since the wait condition was signaled */
-        if (sim_timer_event_canceled)
-            sim_timer_event_canceled = FALSE;           /* reset flag and continue */
+    sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - slept %.0fms - activating(%s,%d)\n", 
+               1000.0*(_timespec_to_double (&stop_time)-_timespec_to_double (&start_time)), sim_uname(uptr), inst_delay);
+    if (sim_clock_unit == uptr) {
+        /*
+         * Some devices may depend on executing during the same instruction or immediately 
+         * after the clock tick event.  To satisfy this, we link the clock unit to the head
+         * of the clock coschedule queue and then insert that list in the asynch event 
+         * queue in a single operation
+         */
+        uptr->a_next = sim_clock_cosched_queue;
+        sim_clock_cosched_queue = QUEUE_LIST_END;
+        AIO_ACTIVATE_LIST(sim_activate, uptr, inst_delay);
         }
+    else
+        sim_activate (uptr, inst_delay);
     }
+sim_timer_wait_due = 0.0;
 pthread_mutex_unlock (&sim_timer_lock);
 
 sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - exiting\n");
@@ -1286,31 +1711,103 @@ sim_debug (DBG_TIM, &sim_timer_dev, "_timer_thread() - exiting\n");
 return NULL;
 }
 
+/* Cancel a timer event.  The unit is either in the wallclock heap (or still
+   being handed off to it) or waiting in the clock coschedule queue. */
+
+void _sim_timer_cancel (UNIT *uptr)
+{
+UNIT *cptr;
+
+pthread_mutex_lock (&sim_timer_lock);
+_sim_wallclock_drain ();
+if (uptr->a_heap_pos) {
+    t_bool was_head = (uptr->a_heap_pos == 1);
+
+    _sim_wallclock_remove (uptr);
+    sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Timer Event for %s\n", sim_uname(uptr));
+    uptr->a_due_time = uptr->a_usec_delay = 0;
+    if (was_head)                                       /* timer thread waiting on it? */
+        _sim_timer_wake (TRUE);
+    }
+else {
+    if (uptr == sim_clock_cosched_queue) {
+        sim_clock_cosched_queue = uptr->a_next;
+        uptr->a_next = NULL;
+        }
+    else
+        for (cptr = sim_clock_cosched_queue; cptr != QUEUE_LIST_END; cptr = cptr->a_next)
+            if (cptr->a_next == uptr) {
+                cptr->a_next = uptr->a_next;
+                uptr->a_next = NULL;
+                break;
+                }
+    if (uptr->a_next == NULL) {
+        sim_debug (SIM_DBG_EVENT, sim_dflt_dev, "Canceling Clock Coscheduling Event for %s\n", sim_uname(uptr));
+        }
+    }
+pthread_mutex_unlock (&sim_timer_lock);
+}
+
+/* Instructions remaining until a wallclock event fires + 1, -1 if the unit
+   isn't waiting on the wallclock */
+
+int32 _sim_timer_activate_time (UNIT *uptr)
+{
+int32 result = -1;
+
+pthread_mutex_lock (&sim_timer_lock);
+_sim_wallclock_drain ();
+if (uptr->a_heap_pos) {
+    result = (int32)((uptr->a_due_time - sim_timenow_double())*sim_timer_inst_per_sec ());
+    if (result < 0)
+        result = 0;
+    result = result + 1;
+    }
+pthread_mutex_unlock (&sim_timer_lock);
+return result;
+}
+
 #endif /* defined(SIM_ASYNCH_IO) && defined(SIM_ASYNCH_CLOCKS) */
 
 void sim_start_timer_services (void)
 {
 #if defined(SIM_ASYNCH_IO) && defined(SIM_ASYNCH_CLOCKS)
+if (sim_asynch_enabled && sim_asynch_timer)
+    _sim_timer_sleep_cal ();
 pthread_mutex_lock (&sim_timer_lock);
 if (sim_asynch_enabled && sim_asynch_timer) {
     pthread_attr_t attr;
-    UNIT *cptr;
+    int32 i;
     double delta_due_time = 0;
 
     /* when restarting after being manually stopped the due times for all */
     /* timer events needs to slide so they fire in the future. (clock ticks */
     /* don't accumulate when the simulator is stopped) */
-    for (cptr = sim_wallclock_queue; cptr != QUEUE_LIST_END; cptr = cptr->a_next) {
-        if (cptr == sim_wallclock_queue) { /* Handle first entry */
-            struct timespec now;
-            double due_time;
-
-            clock_gettime(CLOCK_REALTIME, &now);
-            due_time = _timespec_to_double(&now) + ((double)(cptr->a_usec_delay)/1000000.0);
-            delta_due_time = due_time - cptr->a_due_time;
+    /* A uniform slide preserves the heap order. */
+    _sim_wallclock_drain ();
+    if (sim_wallclock_count) {
+        struct timespec now;
+        double due_time;
+
+        clock_gettime(CLOCK_REALTIME, &now);
+        due_time = _timespec_to_double(&now) + ((double)(sim_wallclock_heap[1]->a_usec_delay)/1000000.0);
+        delta_due_time = due_time - sim_wallclock_heap[1]->a_due_time;
+        }
+    for (i = 1; i <= sim_wallclock_count; i++)
+        sim_wallclock_heap[i]->a_due_time += delta_due_time;
+#if defined(SIM_TIMER_FD)
+    if (sim_timer_fd < 0) {
+        sim_timer_fd = timerfd_create (CLOCK_REALTIME, TFD_CLOEXEC);
+        sim_timer_event_fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if ((sim_timer_fd < 0) || (sim_timer_event_fd < 0)) {   /* fall back to */
+            if (sim_timer_fd >= 0)                              /* condition waits */
+                close (sim_timer_fd);
+            if (sim_timer_event_fd >= 0)
+                close (sim_timer_event_fd);
+            sim_timer_fd = sim_timer_event_fd = -1;
             }
-        cptr->a_due_time += delta_due_time;
         }
+#endif
     sim_debug (DBG_TRC, &sim_timer_dev, "sim_start_timer_services() - starting\n");
     pthread_cond_init (&sim_timer_startup_cond, NULL);
     pthread_attr_init (&attr);
@@ -1331,7 +1828,7 @@ void sim_stop_timer_services (void)
 pthread_mutex_lock (&sim_timer_lock);
 if (sim_timer_thread_running) {
     sim_debug (DBG_TRC, &sim_timer_dev, "sim_stop_timer_services() - stopping\n");
-    pthread_cond_signal (&sim_timer_wake);
+    _sim_timer_wake (TRUE);
     pthread_mutex_unlock (&sim_timer_lock);
     pthread_join (sim_timer_thread, NULL);
     sim_timer_thread_running = FALSE;
@@ -1351,13 +1848,11 @@ else {
     int32 accum = 0;
 
     sim_stop_timer_services ();
-    while (1) {
-        uptr = sim_wallclock_queue;
-        if (uptr == QUEUE_LIST_END)
-            break;
-        sim_wallclock_queue = uptr->a_next;
+    _sim_wallclock_drain ();
+    while (sim_wallclock_count) {                       /* in due time order */
+        uptr = sim_wallclock_heap[1];
+        _sim_wallclock_remove (uptr);
         accum += uptr->time;
-        uptr->a_next = NULL;
         uptr->a_due_time = 0;
         uptr->a_usec_delay = 0;
         sim_activate_after (uptr, accum);
@@ -1386,13 +1881,16 @@ return inst_per_sec;
 t_stat sim_timer_activate_after (UNIT *uptr, int32 usec_delay)
 {
 int32 inst_delay;
-double inst_per_sec;
+double inst_per_sec, inst_delay_d;
 
 AIO_VALIDATE;
 if (sim_is_active (uptr))                               /* already active? */
     return SCPE_OK;
 inst_per_sec = sim_timer_inst_per_sec ();
-inst_delay = (int32)((inst_per_sec*usec_delay)/1000000.0);
+inst_delay_d = (inst_per_sec*usec_delay)/1000000.0;
+if (inst_delay_d > 0x7FFFFFFF)                          /* saturate, a fast host */
+    inst_delay = 0x7FFFFFFF;                            /* can exceed an int32 */
+else inst_delay = (int32)inst_delay_d;
 #if defined(SIM_ASYNCH_IO) && defined(SIM_ASYNCH_CLOCKS)
 if ((sim_calb_tmr == -1) ||                             /* if No timer initialized */
     (inst_delay < rtc_currd[sim_calb_tmr]) ||           /*    or sooner than next clock tick? */
@@ -1450,17 +1948,25 @@ if (1) {
     sim_debug (DBG_TIM, &sim_timer_dev, "sim_timer_activate_after() - queue addition %s at %.6f\n", 
                sim_uname(uptr), uptr->a_due_time);
     }
-pthread_mutex_lock (&sim_timer_lock);
-while (sim_wallclock_entry) {
-    sim_debug (DBG_TIM, &sim_timer_dev, "sim_timer_activate_after() - queue insert entry %s busy waiting for 1ms\n", 
-               sim_uname(sim_wallclock_entry));
-    pthread_mutex_unlock (&sim_timer_lock);
-    sim_os_ms_sleep (1);
-    pthread_mutex_lock (&sim_timer_lock);
+#if defined(USE_AIO_INTRINSICS)
+if (1) {
+    UNIT *q;
+
+    do {                                                /* hand off lock free */
+        q = sim_wallclock_entry;
+        uptr->a_next = q;
+        } while (q != (UNIT *)InterlockedCompareExchangePointer(&sim_wallclock_entry, uptr, q));
     }
+if (uptr->a_due_time < sim_timer_wait_due)              /* sooner than the timer */
+    _sim_timer_wake (FALSE);                            /* thread will wake? */
+#else
+pthread_mutex_lock (&sim_timer_lock);
+uptr->a_next = sim_wallclock_entry;
 sim_wallclock_entry = uptr;
+if (uptr->a_due_time < sim_timer_wait_due)
+    _sim_timer_wake (TRUE);
 pthread_mutex_unlock (&sim_timer_lock);
-pthread_cond_signal (&sim_timer_wake);                  /* wake the timer thread to deal with it */
+#endif
 return SCPE_OK;
 #else
 return _sim_activate (uptr, inst_delay);                /* queue it now */
@@ -70,12 +70,18 @@ int clock_gettime(int clock_id, struct timespec *tp);
 #define SIM_IDLE_STMIN  10                          /* min sec for stability */
 #define SIM_IDLE_STDFLT 20                          /* dft sec for stability */
 #define SIM_IDLE_STMAX  600                         /* max sec for stability */
+#define SIM_IDLE_NSMIN  10000                       /* min nsec worth sleeping */
+#define SIM_IDLE_NSSAMP 10                          /* samples of shortest sleep */
 
 #define SIM_THROT_WINIT 1000                        /* cycles to skip */
 #define SIM_THROT_WST   10000                       /* initial wait */
-#define SIM_THROT_WMUL  4                           /* multiplier */
 #define SIM_THROT_WMIN  100                         /* min wait */
-#define SIM_THROT_MSMIN 10                          /* min for measurement */
+#define SIM_THROT_NSLICE 1000000                    /* ns per pacing slice */
+#define SIM_THROT_NSMIN 20000                       /* min ns worth sleeping */
+#define SIM_THROT_NSDRIFT 50000000                  /* max schedule error, ns */
+#define SIM_THROT_NSRPT 1000000000                  /* achieved rate window, ns */
+#define SIM_THROT_KP    0.75                        /* proportional gain */
+#define SIM_THROT_KI    0.10                        /* integral gain */
 #define SIM_THROT_NONE  0                           /* throttle parameters */
 #define SIM_THROT_MCYC  1                           /* MegaCycles Per Sec */
 #define SIM_THROT_KCYC  2                           /* KiloCycles Per Sec */
@@ -108,6 +114,12 @@ uint32 sim_os_msec (void);
 void sim_os_sleep (unsigned int sec);
 uint32 sim_os_ms_sleep (unsigned int msec);
 uint32 sim_os_ms_sleep_init (void);
+#if defined(SIM_ASYNCH_IO)
+uint32 sim_idle_ms_sleep (unsigned int msec);
+t_uint64 sim_idle_ns_sleep (t_uint64 nsec);
+#endif
+t_uint64 sim_os_nsec (void);
+t_uint64 sim_os_ns_sleep (t_uint64 nsec);
 void sim_start_timer_services (void);
 void sim_stop_timer_services (void);
 t_stat sim_timer_change_asynch (void);
@@ -119,6 +131,8 @@ uint32 sim_timer_idle_capable (uint32 *hoat_tick_ms);
 
 extern t_bool sim_idle_enab;                        /* idle enabled flag */
 extern volatile t_bool sim_idle_wait;               /* idle waiting flag */
+extern t_uint64 sim_idle_ns;                        /* host ns idled or throttled */
+extern double sim_idle_cyc;                         /* cycles skipped while idle */
 extern UNIT *sim_clock_unit;
 extern t_bool sim_asynch_timer;
 extern DEVICE sim_timer_dev;
@@ -45,6 +45,8 @@ extern int32 sim_is_running;
 #define EVENT_REDRAW    1                               /* redraw event for SDL */
 #define EVENT_CLOSE     2                               /* close event for SDL */
 #define MAX_EVENTS      20                              /* max events in queue */
+#define MAX_DIRTY       16                              /* max dirty regions per frame */
+#define FRAME_MS        16                              /* min ms between frames */
 
 typedef struct {
     SIM_KEY_EVENT events[MAX_EVENTS];
@@ -62,8 +64,183 @@ typedef struct {
     int32 count;
     } MOUSE_EVENT_QUEUE;
 
+typedef struct {
+    int32 x, y, w, h;
+    } VID_RECT;
+
 int vid_thread (void* arg);
 
+/*
+   Frame buffering
+
+   vid_draw copies pixels into vid_frame, the back buffer, and adds the
+   rectangle to a short list of dirty regions, merging it with any region
+   it overlaps or abuts (the line by line updates of a framebuffer device
+   collapse into one region).  vid_refresh only asks the video thread for
+   a frame; at most one request is outstanding, and the video thread draws
+   at most one frame per FRAME_MS, deferring early requests with a timer,
+   so the frame rate does not follow the rate of guest writes.  To draw a
+   frame the video thread takes the dirty list and copies those regions
+   into its front buffer under vid_lock, then uploads and presents them
+   without the lock held.
+*/
+
+SDL_mutex *vid_lock;                                    /* guards frame and dirty list */
+uint32 *vid_frame;                                      /* back buffer */
+VID_RECT vid_dirty[MAX_DIRTY];                          /* regions changed since last frame */
+int32 vid_dirty_count;
+t_bool vid_redraw_posted;                               /* redraw requested, not yet drawn */
+Uint32 vid_last_frame;                                  /* ticks at last frame */
+
+static VID_RECT vid_rect_union (VID_RECT r, VID_RECT d)
+{
+int32 x2 = ((r.x + r.w) > (d.x + d.w)) ? (r.x + r.w) : (d.x + d.w);
+int32 y2 = ((r.y + r.h) > (d.y + d.h)) ? (r.y + r.h) : (d.y + d.h);
+
+r.x = (r.x < d.x) ? r.x : d.x;
+r.y = (r.y < d.y) ? r.y : d.y;
+r.w = x2 - r.x;
+r.h = y2 - r.y;
+return r;
+}
+
+/* Add a region to the dirty list - called with vid_lock held */
+
+static void vid_dirty_add (int32 x, int32 y, int32 w, int32 h)
+{
+VID_RECT r, u;
+VID_RECT *d;
+int32 i, best, cost, best_cost;
+
+r.x = x;
+r.y = y;
+r.w = w;
+r.h = h;
+for (i = 0; i < vid_dirty_count; ) {
+    d = &vid_dirty[i];
+    if (((r.x < d->x + d->w) && (d->x < r.x + r.w) &&   /* overlap in x, */
+         (r.y <= d->y + d->h) && (d->y <= r.y + r.h)) ||/*  touch in y? */
+        ((r.y < d->y + d->h) && (d->y < r.y + r.h) &&   /* overlap in y, */
+         (r.x <= d->x + d->w) && (d->x <= r.x + r.w))) {/*  touch in x? */
+        r = vid_rect_union (r, *d);                     /* absorb it */
+        vid_dirty[i] = vid_dirty[--vid_dirty_count];
+        i = 0;                                          /* and rescan */
+        }
+    else
+        ++i;
+    }
+if (vid_dirty_count == MAX_DIRTY) {                     /* list full? */
+    best = 0;                                           /* merge where cheapest */
+    best_cost = 0x7FFFFFFF;
+    for (i = 0; i < vid_dirty_count; i++) {
+        u = vid_rect_union (r, vid_dirty[i]);
+        cost = u.w * u.h - vid_dirty[i].w * vid_dirty[i].h;
+        if (cost < best_cost) {
+            best = i;
+            best_cost = cost;
+            }
+        }
+    r = vid_rect_union (r, vid_dirty[best]);
+    vid_dirty[best] = vid_dirty[--vid_dirty_count];
+    }
+vid_dirty[vid_dirty_count++] = r;
+}
+
+/* Copy the dirty regions to the front buffer (pitch in pixels) and take
+   the list; returns the number of regions */
+
+static int32 vid_frame_take (VID_RECT *rects, uint32 *front, int32 pitch, int32 width)
+{
+int32 i, n, row;
+
+SDL_LockMutex (vid_lock);
+n = vid_dirty_count;
+for (i = 0; i < n; i++) {
+    rects[i] = vid_dirty[i];
+    for (row = rects[i].y; row < (rects[i].y + rects[i].h); row++)
+        memcpy (front + (row * pitch) + rects[i].x,
+                vid_frame + (row * width) + rects[i].x,
+                (size_t)rects[i].w * sizeof (*front));
+    }
+vid_dirty_count = 0;
+vid_redraw_posted = FALSE;
+SDL_UnlockMutex (vid_lock);
+return n;
+}
+
+static Uint32 SDLCALL vid_frame_timer (Uint32 interval, void *param)
+{
+SDL_Event user_event;
+
+user_event.type = SDL_USEREVENT;
+user_event.user.code = EVENT_REDRAW;
+user_event.user.data1 = NULL;
+user_event.user.data2 = NULL;
+
+SDL_PushEvent (&user_event);
+return 0;                                               /* one shot */
+}
+
+/* Rate limit frames - TRUE if one may be drawn now, else one is scheduled */
+
+static t_bool vid_frame_due (void)
+{
+Uint32 now = SDL_GetTicks ();
+Uint32 elapsed = now - vid_last_frame;
+
+if ((elapsed < FRAME_MS) &&
+    (SDL_AddTimer (FRAME_MS - elapsed, &vid_frame_timer, NULL) != 0))
+    return FALSE;
+vid_last_frame = now;
+return TRUE;
+}
+
+/* Allocate the back buffer, initially all dirty */
+
+static t_stat vid_frame_open (uint32 width, uint32 height)
+{
+vid_lock = SDL_CreateMutex ();
+vid_frame = (uint32 *)calloc ((size_t)width * height, sizeof (*vid_frame));
+if ((vid_lock == NULL) || (vid_frame == NULL))
+    return SCPE_MEM;
+vid_dirty_count = 0;
+vid_dirty_add (0, 0, width, height);
+vid_redraw_posted = FALSE;
+vid_last_frame = 0;
+return SCPE_OK;
+}
+
+static void vid_frame_close (void)
+{
+if (vid_lock) {
+    SDL_DestroyMutex (vid_lock);
+    vid_lock = NULL;
+    }
+free (vid_frame);
+vid_frame = NULL;
+}
+
+/* Request a frame, unless one is already on its way */
+
+void vid_refresh (void)
+{
+SDL_Event user_event;
+t_bool post;
+
+SDL_LockMutex (vid_lock);
+post = !vid_redraw_posted;
+vid_redraw_posted = TRUE;
+SDL_UnlockMutex (vid_lock);
+if (!post)
+    return;
+user_event.type = SDL_USEREVENT;
+user_event.user.code = EVENT_REDRAW;
+user_event.user.data1 = NULL;
+user_event.user.data2 = NULL;
+
+SDL_PushEvent (&user_event);
+}
+
 /* 
    Currently there are two separate video implementations which exist
    due to the fact that libSDL and libSDL2 provide vastly different APIs.
@@ -110,6 +287,10 @@ if (!vid_active) {
 
     vid_dev = dptr;
 
+    if (vid_frame_open (width, height) != SCPE_OK) {
+        vid_close ();
+        return SCPE_MEM;
+        }
     vid_thread_handle = SDL_CreateThread (vid_thread, NULL);
     if (vid_thread_handle == NULL) {
         vid_close ();
@@ -148,6 +329,7 @@ if (vid_active) {
         SDL_DestroySemaphore(vid_key_events.sem);
         vid_key_events.sem = NULL;
         }
+    vid_frame_close ();
     }
 return SCPE_OK;
 }
@@ -187,24 +369,12 @@ return SCPE_EOF;
 void vid_draw (int32 x, int32 y, int32 w, int32 h, uint32 *buf)
 {
 int32 i;
-uint32* pixels;
 
-pixels = (uint32 *)vid_image->pixels;
-
-for (i = y; i < (y + h); i++)
-    memcpy (pixels + (i * vid_width) + x, buf, (size_t)w*sizeof(*pixels));
-}
-
-void vid_refresh (void)
-{
-SDL_Event user_event;
-
-user_event.type = SDL_USEREVENT;
-user_event.user.code = EVENT_REDRAW;
-user_event.user.data1 = NULL;
-user_event.user.data2 = NULL;
-
-SDL_PushEvent (&user_event);
+SDL_LockMutex (vid_lock);
+for (i = y; i < (y + h); i++, buf += w)
+    memcpy (vid_frame + (i * vid_width) + x, buf, (size_t)w*sizeof(*vid_frame));
+vid_dirty_add (x, y, w, h);
+SDL_UnlockMutex (vid_lock);
 }
 
 int vid_map_key (int key)
@@ -688,16 +858,22 @@ if (SDL_SemWait (vid_mouse_events.sem) == 0) {
 
 void vid_update (void)
 {
-SDL_Rect vid_dst;
-
-vid_dst.x = 0;
-vid_dst.y = 0;
-vid_dst.w = vid_width;
-vid_dst.h = vid_height;
-
-sim_debug (SIM_VID_DBG_VIDEO, vid_dev, "Video Update Event: \n");
-SDL_BlitSurface (vid_image, NULL, vid_window, &vid_dst);
-SDL_UpdateRects (vid_window, 1, &vid_dst);
+VID_RECT rects[MAX_DIRTY];
+SDL_Rect vid_src, vid_dst[MAX_DIRTY];
+int32 i, n;
+
+n = vid_frame_take (rects, (uint32 *)vid_image->pixels, vid_image->pitch / sizeof (uint32), vid_width);
+sim_debug (SIM_VID_DBG_VIDEO, vid_dev, "Video Update Event: %d region%s\n", n, (n == 1) ? "" : "s");
+for (i = 0; i < n; i++) {
+    vid_src.x = (Sint16)rects[i].x;
+    vid_src.y = (Sint16)rects[i].y;
+    vid_src.w = (Uint16)rects[i].w;
+    vid_src.h = (Uint16)rects[i].h;
+    vid_dst[i] = vid_src;
+    SDL_BlitSurface (vid_image, &vid_src, vid_window, &vid_dst[i]);
+    }
+if (n)
+    SDL_UpdateRects (vid_window, n, vid_dst);
 }
 
 int vid_thread (void* arg)
@@ -740,7 +916,7 @@ static char *eventtypes[] = {
 
 sim_debug (SIM_VID_DBG_VIDEO|SIM_VID_DBG_KEY|SIM_VID_DBG_MOUSE, vid_dev, "vid_thread() - Starting\n");
 
-SDL_Init (SDL_INIT_VIDEO|SDL_INIT_NOPARACHUTE);
+SDL_Init (SDL_INIT_VIDEO|SDL_INIT_TIMER|SDL_INIT_NOPARACHUTE);
 
 vid_window = SDL_SetVideoMode (vid_width, vid_height, 8, 0);
 
@@ -780,7 +956,7 @@ while (vid_active) {
                 break;
 
             case SDL_USEREVENT:
-                if (event.user.code == EVENT_REDRAW)
+                if ((event.user.code == EVENT_REDRAW) && vid_frame_due ())
                     vid_update ();
                 break;
 
@@ -800,6 +976,7 @@ t_bool vid_mouse_captured;
 int32 vid_width;
 int32 vid_height;
 SDL_Texture *vid_texture;                               /* video buffer in GPU */
+uint32 *vid_front;                                      /* front buffer */
 SDL_Window *vid_window;                                 /* window handle */
 SDL_Renderer *vid_renderer;
 SDL_Thread *vid_thread_handle;                          /* event thread handle */
@@ -832,6 +1009,11 @@ if (!vid_active) {
 
     vid_dev = dptr;
 
+    vid_front = (uint32 *)calloc ((size_t)width * height, sizeof (*vid_front));
+    if ((vid_front == NULL) || (vid_frame_open (width, height) != SCPE_OK)) {
+        vid_close ();
+        return SCPE_MEM;
+        }
     vid_thread_handle = SDL_CreateThread (vid_thread, "vid-thread", NULL);
     if (vid_thread_handle == NULL) {
         vid_close ();
@@ -876,6 +1058,9 @@ if (vid_active) {
         SDL_DestroySemaphore(vid_key_events.sem);
         vid_key_events.sem = NULL;
         }
+    vid_frame_close ();
+    free (vid_front);
+    vid_front = NULL;
     }
 return SCPE_OK;
 }
@@ -915,26 +1100,12 @@ return SCPE_EOF;
 void vid_draw (int32 x, int32 y, int32 w, int32 h, uint32 *buf)
 {
 int32 i;
-uint32 *pixels;
-int pitch;
-
-SDL_LockTexture(vid_texture, NULL, (void *)&pixels, &pitch);
 
-for (i = y; i < (y + h); i++)
-    memcpy (pixels + (i * vid_width) + x, buf, (size_t)w*sizeof(*pixels));
-SDL_UnlockTexture(vid_texture);
-}
-
-void vid_refresh (void)
-{
-SDL_Event user_event;
-
-user_event.type = SDL_USEREVENT;
-user_event.user.code = EVENT_REDRAW;
-user_event.user.data1 = NULL;
-user_event.user.data2 = NULL;
-
-SDL_PushEvent (&user_event);
+SDL_LockMutex (vid_lock);
+for (i = y; i < (y + h); i++, buf += w)
+    memcpy (vid_frame + (i * vid_width) + x, buf, (size_t)w*sizeof(*vid_frame));
+vid_dirty_add (x, y, w, h);
+SDL_UnlockMutex (vid_lock);
 }
 
 int vid_map_key (int key)
@@ -1404,14 +1575,21 @@ if (SDL_SemWait (vid_mouse_events.sem) == 0) {
 
 void vid_update (void)
 {
+VID_RECT rects[MAX_DIRTY];
 SDL_Rect vid_dst;
-
-vid_dst.x = 0;
-vid_dst.y = 0;
-vid_dst.w = vid_width;
-vid_dst.h = vid_height;
-
-sim_debug (SIM_VID_DBG_VIDEO, vid_dev, "Video Update Event: \n");
+int32 i, n;
+
+n = vid_frame_take (rects, vid_front, vid_width, vid_width);
+sim_debug (SIM_VID_DBG_VIDEO, vid_dev, "Video Update Event: %d region%s\n", n, (n == 1) ? "" : "s");
+for (i = 0; i < n; i++) {                               /* upload changed regions */
+    vid_dst.x = rects[i].x;
+    vid_dst.y = rects[i].y;
+    vid_dst.w = rects[i].w;
+    vid_dst.h = rects[i].h;
+    SDL_UpdateTexture (vid_texture, &vid_dst,
+                       vid_front + (rects[i].y * vid_width) + rects[i].x,
+                       vid_width * sizeof (*vid_front));
+    }
 SDL_RenderClear(vid_renderer);
 SDL_RenderCopy(vid_renderer, vid_texture, NULL, NULL);
 SDL_RenderPresent(vid_renderer);
@@ -1516,7 +1694,7 @@ vid_mono_palette[1] = 0xFFFFFFFF;
 
 memset (&vid_key_state, 0, sizeof(vid_key_state));
 
-SDL_Init (SDL_INIT_VIDEO);
+SDL_Init (SDL_INIT_VIDEO|SDL_INIT_TIMER);
 
 SDL_CreateWindowAndRenderer (vid_width, vid_height, SDL_WINDOW_SHOWN, &vid_window, &vid_renderer);
 
@@ -1575,7 +1753,7 @@ while (vid_active) {
                 /* EVENT_REDRAW to update the display */
                 /* EVENT_CLOSE  to wake up this thread and let */
                 /*              it notice vid_active has changed */
-                if (event.user.code == EVENT_REDRAW)
+                if ((event.user.code == EVENT_REDRAW) && vid_frame_due ())
                     vid_update ();
                 break;
 
@@ -1635,6 +1813,110 @@ fprintf (st, "ReleaseKey=Ctrl-Right-Shift");
 return SCPE_OK;
 }
 
+#elif defined (USE_OFFSCREEN_VIDEO)
+#include "display/frame.h"
+
+/* Offscreen (headless) version: the screen is kept in memory and, when
+   SIMH_FRAMES is set, written out as PNG files or a raw video stream
+   (see display/frame.h).  There is no keyboard or mouse input. */
+
+uint32 vid_mono_palette[2];                             /* Monochrome Color Map */
+
+static int32 vid_width = 0;
+static int32 vid_height = 0;
+static uint32 *vid_image = NULL;                        /* screen contents */
+static struct frame_out *vid_frames = NULL;             /* frame output, if any */
+static DEVICE *vid_dev;
+
+static void vid_exit (void)
+{
+vid_close ();                                           /* write the last frame */
+}
+
+t_stat vid_open (DEVICE *dptr, uint32 width, uint32 height)
+{
+static t_bool exit_set = FALSE;
+
+if (!vid_active) {
+    vid_image = (uint32 *)calloc ((size_t)width * height, sizeof (*vid_image));
+    if (vid_image == NULL)
+        return SCPE_MEM;
+    vid_active = TRUE;
+    vid_width = width;
+    vid_height = height;
+    vid_mouse_xrel = 0;
+    vid_mouse_yrel = 0;
+    vid_mono_palette[0] = 0xFF000000;                   /* black */
+    vid_mono_palette[1] = 0xFFFFFFFF;                   /* white */
+    vid_dev = dptr;
+    vid_frames = frame_open (width, height);
+    if (vid_frames && !exit_set) {
+        atexit (vid_exit);
+        exit_set = TRUE;
+        }
+    sim_debug (SIM_VID_DBG_VIDEO, vid_dev, "vid_open() - Offscreen %dx%d%s\n", width, height, vid_frames ? ", writing frames" : "");
+    }
+return SCPE_OK;
+}
+
+t_stat vid_close (void)
+{
+if (vid_active) {
+    vid_active = FALSE;
+    if (vid_frames) {
+        frame_write (vid_frames, vid_image, vid_width); /* end with the last frame */
+        frame_close (vid_frames);
+        vid_frames = NULL;
+        }
+    free (vid_image);
+    vid_image = NULL;
+    vid_dev = NULL;
+    }
+return SCPE_OK;
+}
+
+t_stat vid_poll_kb (SIM_KEY_EVENT *ev)
+{
+return SCPE_EOF;
+}
+
+t_stat vid_poll_mouse (SIM_MOUSE_EVENT *ev)
+{
+return SCPE_EOF;
+}
+
+void vid_draw (int32 x, int32 y, int32 w, int32 h, uint32 *buf)
+{
+int32 row;
+
+if (vid_image == NULL)
+    return;
+for (row = 0; row < h; row++)
+    memcpy (vid_image + (size_t)(y + row) * vid_width + x, buf + (size_t)row * w, w * sizeof (*buf));
+}
+
+void vid_refresh (void)
+{
+if (frame_due (vid_frames, TRUE))
+    frame_write (vid_frames, vid_image, vid_width);
+}
+
+const char *vid_version (void)
+{
+return "Offscreen Video";
+}
+
+t_stat vid_set_release_key (FILE* st, UNIT* uptr, int32 val, void* desc)
+{
+return SCPE_NOFNC;
+}
+
+t_stat vid_show_release_key (FILE* st, UNIT* uptr, int32 val, void* desc)
+{
+fprintf (st, "no release key");
+return SCPE_OK;
+}
+
 #else
 
 /* Non-implemented versions */
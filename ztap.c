@@ -0,0 +1,253 @@
+/* ztap.c: convert between SIMH and ZTAP compressed tape images
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included in
+   all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+   THE AUTHOR BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+   IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+   CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+   Except as contained in this notice, the name of the author shall not be
+   used in advertising or otherwise to promote the sale, use or other dealings
+   in this Software without prior written authorization from the author.
+
+   Usage: ztap [-d] [-b kbytes] [-l level] infile outfile
+
+   Without -d, a SIMH format tape image is compressed into a ZTAP container,
+   which the simulators attach read only (the format is recognized without
+   SET FORMAT).  With -d, a ZTAP container is expanded back into the SIMH
+   image it was made from.  -b sets the block size, the unit of random
+   access, in kilobytes (default 64); -l sets the zlib level (default 6).
+
+   The container layout is described in sim_tape.h; the constants below
+   must match the ones there.
+*/
+
+#define _FILE_OFFSET_BITS 64
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#if defined (_MSC_VER) && _MSC_VER < 1600
+typedef unsigned __int8 uint8_t;
+typedef unsigned __int32 uint32_t;
+typedef unsigned __int64 uint64_t;
+#else
+#include <stdint.h>
+#endif
+#if defined (_WIN32)
+#define ztap_seek(f,p)  _fseeki64 (f, (__int64) (p), SEEK_SET)
+#else
+#define ztap_seek(f,p)  fseeko (f, (off_t) (p), SEEK_SET)
+#endif
+
+#define ZTP_MAGIC       "SIMHZTAP"                      /* file signature */
+#define ZTP_VERSION     1
+#define ZTP_HDRSIZE     40                              /* header size */
+#define ZTP_MINBLK      512                             /* block size limits */
+#define ZTP_MAXBLK      (16 * 1024 * 1024)
+#define ZTP_DFLTBLK     (64 * 1024)                     /* default block size */
+
+static void put_le (uint8_t *p, uint64_t v, int n)
+{
+int i;
+
+for (i = 0; i < n; i++) {
+    p[i] = (uint8_t) (v & 0xFF);
+    v = v >> 8;
+    }
+}
+
+static uint64_t get_le (const uint8_t *p, int n)
+{
+uint64_t v = 0;
+
+while (n-- > 0)
+    v = (v << 8) | p[n];
+return v;
+}
+
+static void usage (void)
+{
+fprintf (stderr, "Usage: ztap [-d] [-b kbytes] [-l level] infile outfile\n");
+fprintf (stderr, "  Compress a SIMH tape image into a ZTAP container,\n");
+fprintf (stderr, "  or with -d, expand a ZTAP container into a SIMH tape image.\n");
+fprintf (stderr, "  -b  block size in kilobytes (default %d)\n", ZTP_DFLTBLK / 1024);
+fprintf (stderr, "  -l  compression level, 1-9 (default 6)\n");
+exit (EXIT_FAILURE);
+}
+
+static int fail (const char *what, const char *name)
+{
+fprintf (stderr, "ztap: %s%s%s\n", what, name? ": ": "", name? name: "");
+return EXIT_FAILURE;
+}
+
+/* SIMH image to ZTAP container */
+
+static int compress_image (FILE *in, FILE *out, uint32_t bsize, int level)
+{
+uint8_t hdr[ZTP_HDRSIZE], ent[8];
+uint8_t *blk, *cbuf;
+uint64_t *idx = NULL, pos = ZTP_HDRSIZE, size = 0;
+uint32_t i, n = 0, nmax = 0;
+uLong cmax = compressBound (bsize);
+uLongf clen;
+size_t len;
+
+blk = (uint8_t *) malloc (bsize);
+cbuf = (uint8_t *) malloc (cmax);
+if ((blk == NULL) || (cbuf == NULL))
+    return fail ("out of memory", NULL);
+memset (hdr, 0, sizeof (hdr));                          /* placeholder */
+if (fwrite (hdr, 1, sizeof (hdr), out) != sizeof (hdr))
+    return fail ("write error", NULL);
+while ((len = fread (blk, 1, bsize, in)) > 0) {
+    if ((n == 0) && (len >= 8) && (memcmp (blk, ZTP_MAGIC, 8) == 0))
+        return fail ("input is already a ZTAP container", NULL);
+    if (n + 1 >= nmax) {                                /* grow index */
+        nmax = nmax? 2 * nmax: 1024;
+        if ((idx = (uint64_t *) realloc (idx, nmax * sizeof (*idx))) == NULL)
+            return fail ("out of memory", NULL);
+        }
+    clen = cmax;
+    if (compress2 (cbuf, &clen, blk, (uLong) len, level) != Z_OK)
+        return fail ("compression failed", NULL);
+    if (fwrite (cbuf, 1, clen, out) != clen)
+        return fail ("write error", NULL);
+    idx[n++] = pos;
+    pos = pos + clen;
+    size = size + len;
+    if (len < bsize)                                    /* short block is last */
+        break;
+    }
+if (ferror (in))
+    return fail ("read error", NULL);
+for (i = 0; i < n; i++) {                               /* block positions */
+    put_le (ent, idx[i], 8);
+    if (fwrite (ent, 1, 8, out) != 8)
+        return fail ("write error", NULL);
+    }
+put_le (ent, pos, 8);                                   /* end of last block */
+if (fwrite (ent, 1, 8, out) != 8)
+    return fail ("write error", NULL);
+memcpy (hdr, ZTP_MAGIC, 8);
+put_le (hdr + 8, ZTP_VERSION, 4);
+put_le (hdr + 12, bsize, 4);
+put_le (hdr + 16, size, 8);
+put_le (hdr + 24, n, 4);
+put_le (hdr + 32, pos, 8);
+if ((ztap_seek (out, 0) != 0) ||
+    (fwrite (hdr, 1, sizeof (hdr), out) != sizeof (hdr)))
+    return fail ("write error", NULL);
+free (idx);
+free (cbuf);
+free (blk);
+return EXIT_SUCCESS;
+}
+
+/* ZTAP container to SIMH image */
+
+static int expand_image (FILE *in, FILE *out)
+{
+uint8_t hdr[ZTP_HDRSIZE], ent[8];
+uint8_t *blk, *cbuf;
+uint64_t *idx, size, ipos, done = 0;
+uint32_t i, n, bsize;
+uLong cmax;
+uLongf dlen;
+size_t clen;
+
+if ((fread (hdr, 1, sizeof (hdr), in) != sizeof (hdr)) ||
+    (memcmp (hdr, ZTP_MAGIC, 8) != 0))
+    return fail ("input is not a ZTAP container", NULL);
+if (get_le (hdr + 8, 4) != ZTP_VERSION)
+    return fail ("unsupported ZTAP version", NULL);
+bsize = (uint32_t) get_le (hdr + 12, 4);
+size = get_le (hdr + 16, 8);
+n = (uint32_t) get_le (hdr + 24, 4);
+ipos = get_le (hdr + 32, 8);
+if ((bsize < ZTP_MINBLK) || (bsize > ZTP_MAXBLK) ||
+    (((uint64_t) n * bsize) < size))
+    return fail ("damaged ZTAP header", NULL);
+cmax = compressBound (bsize);
+idx = (uint64_t *) malloc (((size_t) n + 1) * sizeof (*idx));
+blk = (uint8_t *) malloc (bsize);
+cbuf = (uint8_t *) malloc (cmax);
+if ((idx == NULL) || (blk == NULL) || (cbuf == NULL))
+    return fail ("out of memory", NULL);
+if (ztap_seek (in, ipos) != 0)
+    return fail ("damaged ZTAP index", NULL);
+for (i = 0; i <= n; i++) {
+    if (fread (ent, 1, 8, in) != 8)
+        return fail ("damaged ZTAP index", NULL);
+    idx[i] = get_le (ent, 8);
+    }
+for (i = 0; i < n; i++) {
+    if ((idx[i + 1] < idx[i]) || ((idx[i + 1] - idx[i]) > cmax))
+        return fail ("damaged ZTAP index", NULL);
+    clen = (size_t) (idx[i + 1] - idx[i]);
+    dlen = bsize;
+    if ((ztap_seek (in, idx[i]) != 0) ||
+        (fread (cbuf, 1, clen, in) != clen) ||
+        (uncompress (blk, &dlen, cbuf, (uLong) clen) != Z_OK))
+        return fail ("damaged ZTAP block", NULL);
+    if (fwrite (blk, 1, dlen, out) != dlen)
+        return fail ("write error", NULL);
+    done = done + dlen;
+    }
+if (done != size)
+    return fail ("ZTAP image size mismatch", NULL);
+free (cbuf);
+free (blk);
+free (idx);
+return EXIT_SUCCESS;
+}
+
+int main (int argc, char **argv)
+{
+int expand = 0, level = 6, i, r;
+long kb = ZTP_DFLTBLK / 1024;
+FILE *in, *out;
+
+for (i = 1; (i < argc) && (argv[i][0] == '-') && argv[i][1]; i++) {
+    if (strcmp (argv[i], "-d") == 0)
+        expand = 1;
+    else if ((strcmp (argv[i], "-b") == 0) && (i + 1 < argc))
+        kb = strtol (argv[++i], NULL, 10);
+    else if ((strcmp (argv[i], "-l") == 0) && (i + 1 < argc))
+        level = (int) strtol (argv[++i], NULL, 10);
+    else usage ();
+    }
+if ((argc - i) != 2)
+    usage ();
+if ((kb < 1) || (kb > ZTP_MAXBLK / 1024) ||
+    (level < 1) || (level > 9))
+    usage ();
+if ((in = fopen (argv[i], "rb")) == NULL)
+    return fail ("can't open", argv[i]);
+if ((out = fopen (argv[i + 1], "wb")) == NULL) {
+    fclose (in);
+    return fail ("can't create", argv[i + 1]);
+    }
+if (expand)
+    r = expand_image (in, out);
+else r = compress_image (in, out, (uint32_t) kb * 1024, level);
+fclose (in);
+if ((fclose (out) != 0) && (r == EXIT_SUCCESS))
+    r = fail ("write error", argv[i + 1]);
+if (r != EXIT_SUCCESS)
+    remove (argv[i + 1]);
+return r;
+}